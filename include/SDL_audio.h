@@ -335,6 +335,12 @@ extern DECLSPEC const char *SDLCALL SDL_GetAudioDeviceName(int index,
  *  
  *  \return 0 on error, a valid device ID that is >= 2 on success.
  *  
+ *  A capture device is given the recorded audio in the desired format,
+ *  resampled if needed.  On the disk and PulseAudio drivers, a capture
+ *  device can also be opened with a NULL callback, and the audio read with
+ *  SDL_DequeueAudio() instead.  Other drivers fail to open it, returning 0
+ *  with the error "SDL_OpenAudio() passed a NULL callback".
+ *  
  *  SDL_OpenAudio(), unlike this function, always acts on device ID 1.
  */
 extern DECLSPEC SDL_AudioDeviceID SDLCALL SDL_OpenAudioDevice(const char
@@ -366,6 +372,45 @@ extern DECLSPEC SDL_AudioStatus SDLCALL SDL_GetAudioStatus(void);
 
 extern DECLSPEC SDL_AudioStatus SDLCALL
 SDL_GetAudioDeviceStatus(SDL_AudioDeviceID dev);
+
+/**
+ *  Timing information for an open audio device, for synchronizing other
+ *  things with the audio it plays.
+ */
+typedef struct SDL_AudioClock
+{
+    Uint64 frames_submitted;    /**< Frames given to the device so far */
+    Uint64 frames_played;       /**< Frames the device has played (estimated) */
+    Uint32 latency;             /**< Microseconds until a frame submitted now is heard */
+    Uint32 callback_ticks;      /**< Milliseconds spent in the callback so far */
+    Uint32 callback_max_ticks;  /**< Longest the callback has taken, in milliseconds */
+    Uint32 underruns;           /**< The same as SDL_GetAudioDeviceUnderruns() */
+} SDL_AudioClock;
+
+/**
+ *  Get the current timing of an audio device.  For a capture device,
+ *  frames_submitted counts the frames recorded so far, and latency is how
+ *  long ago the newest of them was recorded.
+ *
+ *  The callback times let you see how close the callback comes to taking
+ *  longer than the audio it fills.  They are measured with SDL_GetTicks(),
+ *  so only their sum over many callbacks is accurate.
+ *
+ *  \return 0 on success, or -1 if the driver can't tell where playback is.
+ *          The frames submitted, callback times and underruns are filled in
+ *          either way.
+ */
+extern DECLSPEC int SDLCALL SDL_GetAudioDeviceClock(SDL_AudioDeviceID dev,
+                                                    SDL_AudioClock * clock);
+
+/**
+ *  Get the number of times the device ran out of audio to play since it
+ *  was opened.  Not every driver can tell, in which case this stays 0.
+ *  For a capture device, this counts the buffers of recorded audio that
+ *  were dropped because they weren't dequeued in time.
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_GetAudioDeviceUnderruns(SDL_AudioDeviceID
+                                                           dev);
 /*@}*//*Audio State*/
 
 /**
@@ -383,6 +428,18 @@ extern DECLSPEC void SDLCALL SDL_PauseAudioDevice(SDL_AudioDeviceID dev,
                                                   int pause_on);
 /*@}*//*Pause audio functions*/
 
+/**
+ *  Read up to \c len bytes of recorded audio from a capture device that
+ *  was opened without a callback.  The audio is in the format given when
+ *  the device was opened, and only whole sample frames are read.  This
+ *  never waits for more audio to be recorded.
+ *  
+ *  \return the number of bytes read, or 0 if there was nothing to read or
+ *          there was an error.
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_DequeueAudio(SDL_AudioDeviceID dev,
+                                                void *data, Uint32 len);
+
 /**
  *  This function loads a WAVE from the data source, automatically freeing
  *  that source if \c freesrc is non-zero.  For example, to load a WAVE file,
@@ -400,7 +457,9 @@ extern DECLSPEC void SDLCALL SDL_PauseAudioDevice(SDL_AudioDeviceID dev,
  *
  *  This function returns NULL and sets the SDL error message if the 
  *  wave file cannot be opened, uses an unknown data format, or is 
- *  corrupt.  Currently raw and MS-ADPCM WAVE files are supported.
+ *  corrupt.  Currently raw 8, 16, 24 and 32-bit PCM, 32-bit floating
+ *  point, MS-ADPCM and IMA-ADPCM WAVE files are supported.  24-bit samples
+ *  are expanded to 32 bits.
  */
 extern DECLSPEC SDL_AudioSpec *SDLCALL SDL_LoadWAV_RW(SDL_RWops * src,
                                                       int freesrc,
@@ -420,6 +479,68 @@ extern DECLSPEC SDL_AudioSpec *SDLCALL SDL_LoadWAV_RW(SDL_RWops * src,
  */
 extern DECLSPEC void SDLCALL SDL_FreeWAV(Uint8 * audio_buf);
 
+/**
+ *  \brief A WAVE file being decoded a few frames at a time.
+ *  
+ *  \sa SDL_OpenWAVStream_RW()
+ */
+typedef struct SDL_WAVStream SDL_WAVStream;
+
+/**
+ *  Start decoding a WAVE file from a seekable data source, filling in
+ *  \c spec with the format the frames are decoded to.  Only the ADPCM
+ *  block being decoded is kept in memory, so long files can be played
+ *  straight from the data source.
+ *  
+ *  If \c freesrc is non-zero, the source will be closed along with the
+ *  stream, or right away if there was an error.
+ *  
+ *  \return the new stream, or NULL if there was an error.
+ *  
+ *  \sa SDL_ReadWAVStream()
+ *  \sa SDL_CloseWAVStream()
+ */
+extern DECLSPEC SDL_WAVStream *SDLCALL SDL_OpenWAVStream_RW(SDL_RWops * src,
+                                                            int freesrc,
+                                                            SDL_AudioSpec *
+                                                            spec);
+
+/**
+ *  Start decoding a WAVE file.
+ *  Convenience macro.
+ */
+#define SDL_OpenWAVStream(file, spec) \
+	SDL_OpenWAVStream_RW(SDL_RWFromFile(file, "rb"), 1, spec)
+
+/**
+ *  \brief Get the length of a WAVE file, in sample frames.
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_GetWAVStreamLength(SDL_WAVStream *
+                                                      stream);
+
+/**
+ *  \brief Decode up to \c frames sample frames into \c buf.
+ *  
+ *  \return the number of frames decoded, 0 at the end of the file, or -1
+ *          if there was an error.
+ */
+extern DECLSPEC int SDLCALL SDL_ReadWAVStream(SDL_WAVStream * stream,
+                                              void *buf, int frames);
+
+/**
+ *  \brief Set the sample frame the next SDL_ReadWAVStream() starts at.
+ *  
+ *  \return 0 on success, or -1 if the frame is past the end of the file or
+ *          there was an error.
+ */
+extern DECLSPEC int SDLCALL SDL_SeekWAVStream(SDL_WAVStream * stream,
+                                              Uint32 frame);
+
+/**
+ *  \brief Free a WAVE stream.
+ */
+extern DECLSPEC void SDLCALL SDL_CloseWAVStream(SDL_WAVStream * stream);
+
 /**
  *  This function takes a source format and rate and a destination format
  *  and rate, and initializes the \c cvt structure with information needed
@@ -470,6 +591,91 @@ extern DECLSPEC void SDLCALL SDL_MixAudioFormat(Uint8 * dst,
                                                 SDL_AudioFormat format,
                                                 Uint32 len, int volume);
 
+/**
+ *  Set the volume of everything an audio device plays, from 0 to
+ *  ::SDL_MIX_MAXVOLUME.  The volume is applied while mixing on SDL's float
+ *  bus, so it costs no extra pass over the audio.
+ *  
+ *  Setting SDL_AUDIO_FLOAT_BUS=1 in the environment sends every conversion
+ *  between the callback and device formats through the float bus.  It is
+ *  always used when the sample rate has to be converted.
+ *  
+ *  \return 0 on success, or -1 if the device doesn't support it.
+ */
+extern DECLSPEC int SDLCALL SDL_SetAudioDeviceVolume(SDL_AudioDeviceID dev,
+                                                     int volume);
+
+/**
+ *  \name Audio clips
+ *
+ *  A clip is a sound converted ahead of time for an open audio device, so
+ *  that any number of copies of it can be played on top of the device's
+ *  callback.  Each playing copy is a voice, with its own volume and pan.
+ *  All the voices are mixed on SDL's float bus in a single pass, so they
+ *  cost no extra conversion, and the callback keeps playing as usual.
+ *
+ *  Voices only play in the first two channels of the device.
+ */
+/*@{*/
+typedef struct SDL_AudioClip SDL_AudioClip;
+typedef Uint32 SDL_AudioVoiceID;
+
+/**
+ *  Convert \c len bytes of audio in the format \c spec to a clip that can
+ *  be played on the device \c dev.  Only the format, channels and freq
+ *  fields of \c spec are used.
+ *
+ *  \return The new clip, or NULL on error.
+ */
+extern DECLSPEC SDL_AudioClip *SDLCALL SDL_CreateAudioClip(SDL_AudioDeviceID
+                                                           dev,
+                                                           const SDL_AudioSpec
+                                                           * spec,
+                                                           const Uint8 * buf,
+                                                           Uint32 len);
+
+/**
+ *  Stop any voices playing the clip, and free it.
+ */
+extern DECLSPEC void SDLCALL SDL_FreeAudioClip(SDL_AudioClip * clip);
+
+/**
+ *  Start playing a clip, \c loops more times after the first, or forever
+ *  if \c loops is -1.  The volume ranges from 0 to ::SDL_MIX_MAXVOLUME, and
+ *  the pan from -::SDL_MIX_MAXVOLUME (left) to ::SDL_MIX_MAXVOLUME (right).
+ *
+ *  \return The new voice, or 0 on error.
+ */
+extern DECLSPEC SDL_AudioVoiceID SDLCALL SDL_PlayAudioClip(SDL_AudioClip *
+                                                           clip, int loops,
+                                                           int volume,
+                                                           int pan);
+
+/**
+ *  Change the volume and pan of a playing voice.
+ *
+ *  \return 0 on success, or -1 if the voice has finished.
+ */
+extern DECLSPEC int SDLCALL SDL_SetAudioVoiceVolume(SDL_AudioDeviceID dev,
+                                                    SDL_AudioVoiceID voice,
+                                                    int volume, int pan);
+
+/**
+ *  Stop a voice before it finishes.
+ *
+ *  \return 0 on success, or -1 if the voice has already finished.
+ */
+extern DECLSPEC int SDLCALL SDL_StopAudioVoice(SDL_AudioDeviceID dev,
+                                               SDL_AudioVoiceID voice);
+
+/**
+ *  \return SDL_TRUE if the voice is still playing.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_AudioVoicePlaying(SDL_AudioDeviceID dev,
+                                                       SDL_AudioVoiceID
+                                                       voice);
+/*@}*//*Audio clips*/
+
 /**
  *  \name Audio lock functions
  *  
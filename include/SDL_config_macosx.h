@@ -142,6 +142,7 @@
 #define SDL_VIDEO_DRIVER_X11_XINERAMA 1
 #define SDL_VIDEO_DRIVER_X11_XRANDR 1
 #define SDL_VIDEO_DRIVER_X11_XINPUT 1
+#define SDL_VIDEO_DRIVER_X11_XRENDER 1
 #define SDL_VIDEO_DRIVER_X11_SCRNSAVER 1
 #define SDL_VIDEO_DRIVER_X11_XV 1
 
@@ -107,6 +107,8 @@ typedef int (*SDL_blit) (struct SDL_Surface * src, SDL_Rect * srcrect,
  *  If the depth is greater than 8 bits, the pixel format is set using the
  *  flags '[RGB]mask'.
  *  
+ *  The pixels and each row of them start on a 64 byte boundary.
+ *  
  *  If the function runs out of memory, it will return NULL.
  *  
  *  \param flags The \c flags are obsolete and should be set to 0.
@@ -177,6 +179,70 @@ extern DECLSPEC SDL_Surface *SDLCALL SDL_LoadBMP_RW(SDL_RWops * src,
  */
 #define SDL_LoadBMP(file)	SDL_LoadBMP_RW(SDL_RWFromFile(file, "rb"), 1)
 
+/**
+ *  \brief A BMP image being decoded a band of rows at a time.
+ *  
+ *  \sa SDL_OpenBMPStream_RW()
+ */
+typedef struct SDL_BMPStream SDL_BMPStream;
+
+/**
+ *  Start decoding a BMP image from a seekable SDL data source.
+ *  
+ *  The image is decoded into a surface \c rows high, one band at a time.
+ *  If \c rows is 0 or more than the image height, the whole image is
+ *  decoded at once.
+ *  
+ *  If \c freesrc is non-zero, the source will be closed along with the
+ *  stream, or right away if there was an error.
+ *  
+ *  \return the new stream, or NULL if there was an error.
+ *  
+ *  \sa SDL_ReadBMPStream()
+ *  \sa SDL_CloseBMPStream()
+ */
+extern DECLSPEC SDL_BMPStream *SDLCALL SDL_OpenBMPStream_RW(SDL_RWops * src,
+                                                            int freesrc,
+                                                            int rows);
+
+/**
+ *  Start decoding a BMP image from a file.
+ *  
+ *  Convenience macro.
+ */
+#define SDL_OpenBMPStream(file, rows) \
+		SDL_OpenBMPStream_RW(SDL_RWFromFile(file, "rb"), 1, rows)
+
+/**
+ *  \brief Get the surface the rows of a BMP stream are decoded into.
+ *  
+ *  \param h If not NULL, filled in with the height of the whole image.
+ *  
+ *  The surface belongs to the stream and is freed by SDL_CloseBMPStream().
+ */
+extern DECLSPEC SDL_Surface *SDLCALL SDL_GetBMPStreamSurface(SDL_BMPStream *
+                                                             stream, int *h);
+
+/**
+ *  \brief Decode the next band of rows of a BMP stream.
+ *  
+ *  The rows are stored top to bottom from the start of the stream surface,
+ *  whatever the order they are stored in the file.
+ *  
+ *  \param y If not NULL, filled in with the image row of the first row in
+ *           the surface.
+ *  
+ *  \return the number of rows decoded, 0 once the whole image has been
+ *          decoded, or -1 if there was an error.
+ */
+extern DECLSPEC int SDLCALL SDL_ReadBMPStream(SDL_BMPStream * stream,
+                                              int *y);
+
+/**
+ *  \brief Free a BMP stream and its surface.
+ */
+extern DECLSPEC void SDLCALL SDL_CloseBMPStream(SDL_BMPStream * stream);
+
 /**
  *  Save a surface to a seekable SDL data source (memory or file).
  *  
@@ -206,6 +272,25 @@ extern DECLSPEC int SDLCALL SDL_SaveBMP_RW
 extern DECLSPEC int SDLCALL SDL_SetSurfaceRLE(SDL_Surface * surface,
                                               int flag);
 
+/**
+ *  \brief Encodes a surface for RLE accelerated blits to \c dst right away.
+ *  
+ *  Normally the RLE encoding is done by the first blit after the RLE hint
+ *  is set, which can take a while for large surfaces. Calling this once
+ *  the surface is loaded moves that work out of the drawing code.
+ *  
+ *  \return 0 if the surface is now RLE accelerated for blits to \c dst,
+ *          or -1 if the surfaces are not valid or the combination of
+ *          formats and blit settings can't be RLE accelerated.
+ *  
+ *  \note The encoding is dropped when blitting to another surface, or when
+ *        the colorkey or blend settings change.
+ *  
+ *  \sa SDL_SetSurfaceRLE()
+ */
+extern DECLSPEC int SDLCALL SDL_PrepareSurfaceRLE(SDL_Surface * surface,
+                                                  SDL_Surface * dst);
+
 /**
  *  \brief Sets the color key (transparent pixel) in a blittable surface.
  *  
@@ -445,6 +530,28 @@ extern DECLSPEC int SDLCALL SDL_BlendLines
     (SDL_Surface * dst, const SDL_Point * points, int count,
      int blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 
+/**
+ *  \brief Line style flags for SDL_StrokeLines().
+ */
+#define SDL_LINE_ANTIALIAS  0x00000001  /**< Smooth the edges of lines */
+
+/**
+ *  Draws a series of connected lines \c width pixels wide, with round
+ *  ends and joins, blending an RGBA value over them.
+ *
+ *  \param flags ::SDL_LINE_ANTIALIAS or 0.
+ *
+ *  Places where the lines overlap are only drawn once.  Lines 1 pixel
+ *  wide without anti-aliasing are the same as SDL_BlendLines(), or
+ *  SDL_DrawLines() for ::SDL_BLENDMODE_NONE.
+ *
+ *  \return 0 on success, or -1 on error.
+ */
+extern DECLSPEC int SDLCALL SDL_StrokeLines
+    (SDL_Surface * dst, const SDL_Point * points, int count,
+     int width, Uint32 flags,
+     int blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
 /**
  *  Draws the given rectangle with \c color.
  *  
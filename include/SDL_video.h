@@ -252,6 +252,22 @@ typedef enum
 struct SDL_Texture;
 typedef struct SDL_Texture SDL_Texture;
 
+/**
+ *  \brief A single copy for SDL_RenderCopyMany()
+ */
+typedef struct SDL_TextureCopy
+{
+    SDL_Texture *texture;       /**< The source texture */
+    SDL_Rect srcrect;           /**< The area of the texture to copy */
+    SDL_Rect dstrect;           /**< The area of the rendering target */
+} SDL_TextureCopy;
+
+/**
+ *  \brief A set of shared textures that small images are packed into
+ */
+struct SDL_TextureAtlas;
+typedef struct SDL_TextureAtlas SDL_TextureAtlas;
+
 /**
  *  \brief An opaque handle to an OpenGL context.
  */
@@ -847,6 +863,51 @@ extern DECLSPEC SDL_Texture * SDLCALL SDL_CreateTextureFromSurface(Uint32
                                                                    SDL_Surface
                                                                    * surface);
 
+/**
+ *  \brief Create a texture atlas for the current rendering context.
+ *  
+ *  \param format The format of the atlas textures, which can't be indexed
+ *                or YUV.
+ *  \param w      The width of each atlas texture.
+ *  \param h      The height of each atlas texture.
+ *  
+ *  \return The created atlas, or NULL if there was an error.
+ *  
+ *  \note Atlas textures are created as they are needed, and textures with
+ *        an alpha channel default to ::SDL_BLENDMODE_BLEND.
+ *  
+ *  \sa SDL_AddSurfaceToAtlas()
+ *  \sa SDL_DestroyTextureAtlas()
+ */
+extern DECLSPEC SDL_TextureAtlas * SDLCALL SDL_CreateTextureAtlas(Uint32
+                                                                  format,
+                                                                  int w,
+                                                                  int h);
+
+/**
+ *  \brief Pack a surface into a texture atlas.
+ *  
+ *  \param atlas   The atlas to add the surface to.
+ *  \param surface The surface containing the pixel data to add.
+ *  \param texture Filled in with the atlas texture holding the pixels.
+ *  \param rect    Filled in with the area of \c texture holding the pixels.
+ *  
+ *  \return 0 on success, or -1 if the surface is larger than the atlas
+ *          textures or a texture couldn't be created.
+ *  
+ *  \note The surface is not modified or freed by this function.
+ */
+extern DECLSPEC int SDLCALL SDL_AddSurfaceToAtlas(SDL_TextureAtlas * atlas,
+                                                  SDL_Surface * surface,
+                                                  SDL_Texture ** texture,
+                                                  SDL_Rect * rect);
+
+/**
+ *  \brief Destroy a texture atlas and all of its textures.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyTextureAtlas(SDL_TextureAtlas *
+                                                     atlas);
+
 /**
  *  \brief Query the attributes of a texture
  *  
@@ -1149,6 +1210,41 @@ extern DECLSPEC int SDLCALL SDL_SetRenderDrawBlendMode(int blendMode);
  */
 extern DECLSPEC int SDLCALL SDL_GetRenderDrawBlendMode(int *blendMode);
 
+/**
+ *  \brief Set the width and style of lines drawn on the current rendering 
+ *         target.
+ *  
+ *  \param width The line width in pixels, 1 by default.
+ *  \param flags ::SDL_LINE_ANTIALIAS to smooth the edges of lines, or 0.
+ *  
+ *  \return 0 on success, or -1 if there is no rendering context current, or 
+ *          the renderer can't draw lines in that style.
+ *  
+ *  \note Wide lines affect SDL_RenderDrawLine(), SDL_RenderDrawLines() 
+ *        and SDL_RenderDrawRect(). How their ends and joins look depends 
+ *        on the renderer: the software and dummy renderers round them, 
+ *        while the OpenGL renderer uses glLineWidth(), which leaves square 
+ *        ends, doesn't join segments, and may limit the width.
+ *  
+ *  \sa SDL_GetRenderDrawLineStyle()
+ */
+extern DECLSPEC int SDLCALL SDL_SetRenderDrawLineStyle(int width,
+                                                       Uint32 flags);
+
+/**
+ *  \brief Get the width and style of lines drawn on the current rendering 
+ *         target.
+ *  
+ *  \param width A pointer filled in with the line width, or NULL.
+ *  \param flags A pointer filled in with the line style flags, or NULL.
+ *  
+ *  \return 0 on success, or -1 if there is no rendering context current.
+ *  
+ *  \sa SDL_SetRenderDrawLineStyle()
+ */
+extern DECLSPEC int SDLCALL SDL_GetRenderDrawLineStyle(int *width,
+                                                       Uint32 * flags);
+
 /**
  *  \brief Clear the current rendering target with the drawing color
  */
@@ -1253,6 +1349,25 @@ extern DECLSPEC int SDLCALL SDL_RenderCopy(SDL_Texture * texture,
                                            const SDL_Rect * srcrect,
                                            const SDL_Rect * dstrect);
 
+/**
+ *  \brief Copy many portions of textures to the current rendering target.
+ *  
+ *  \param copies The copies to perform, in order.
+ *  \param count  The number of copies.
+ *  
+ *  \return 0 on success, or -1 if there is no rendering context current, or the
+ *          driver doesn't support the requested operation.
+ *  
+ *  \note This is the same as calling SDL_RenderCopy() for each copy, but
+ *        drivers can draw the whole set in one pass.  Sorting the copies by
+ *        texture, or using textures from an atlas, gives the best results.
+ *  
+ *  \sa SDL_RenderCopy()
+ *  \sa SDL_CreateTextureAtlas()
+ */
+extern DECLSPEC int SDLCALL SDL_RenderCopyMany(const SDL_TextureCopy * copies,
+                                               int count);
+
 /**
  *  \brief Read pixels from the current rendering target.
  *  
@@ -1271,6 +1386,33 @@ extern DECLSPEC int SDLCALL SDL_RenderReadPixels(const SDL_Rect * rect,
                                                  Uint32 format,
                                                  void *pixels, int pitch);
 
+/**
+ *  \brief Read pixels from the current rendering target without waiting for
+ *         rendering to finish.
+ *  
+ *  This starts reading \c rect and fills \c pixels with the result of the
+ *  previous call, so calling it once per frame returns the previous frame.
+ *  
+ *  \param rect   A pointer to the rectangle to read, or NULL for the entire 
+ *                render target.
+ *  \param format The desired format of the pixel data, or 0 to use the format
+ *                of the rendering target
+ *  \param pixels A pointer to be filled in with the pixel data
+ *  \param pitch  The pitch of the pixels parameter.
+ *  
+ *  \return 0 if \c pixels was filled in, 1 if no previous read of the same
+ *          size and format was pending, or -1 if pixel reading is not
+ *          supported.
+ *  
+ *  \note Renderers without asynchronous readback read the pixels immediately.
+ *  
+ *  \sa SDL_RenderReadPixels()
+ */
+extern DECLSPEC int SDLCALL SDL_RenderReadPixelsAsync(const SDL_Rect * rect,
+                                                      Uint32 format,
+                                                      void *pixels,
+                                                      int pitch);
+
 /**
  *  \brief Write pixels to the current rendering target.
  *  
@@ -29,6 +29,7 @@
 
 #if !SDL_VIDEO_DISABLED
 #include "video/SDL_leaks.h"
+#include "video/SDL_surfacepool_c.h"
 #endif
 
 /* Initialization/Cleanup routines */
@@ -245,6 +246,19 @@ SDL_Quit(void)
         fprintf(stderr, "SDL Warning: %d SDL surfaces extant\n",
                 surfaces_allocated);
     }
+#if !SDL_VIDEO_DISABLED
+    {
+        SDL_SurfacePoolStats stats;
+        SDL_GetSurfacePoolStats(&stats);
+        fprintf(stderr, "SDL Info: %u of %u surface allocations reused\n",
+                stats.reuses, stats.allocs);
+    }
+#endif
+#endif
+
+#if !SDL_VIDEO_DISABLED
+    /* Release the surface memory kept for reuse */
+    SDL_FlushSurfacePool();
 #endif
 #ifdef DEBUG_BUILD
     printf("[SDL_Quit] : SDL_UninstallParachute()\n");
@@ -28,6 +28,7 @@
 
 #include "video/SDL_sysvideo.h"
 #include "video/SDL_pixels_c.h"
+#include "video/SDL_surfacepool_c.h"
 #include "video/SDL_yuv_sw_c.h"
 
 static SDL_Window *SDL_VideoWindow = NULL;
@@ -468,14 +469,19 @@ SDL_ResizeVideoMode(int width, int height, int bpp, Uint32 flags)
 
     SDL_VideoSurface->w = width;
     SDL_VideoSurface->h = height;
+    if (!(SDL_VideoSurface->flags & SDL_PREALLOC)) {
+        SDL_FreeSurfaceMemory(SDL_VideoSurface->pixels);
+    }
     if (SDL_QueryTexturePixels(SDL_VideoTexture, &pixels, &pitch) == 0) {
+        SDL_VideoSurface->flags |= SDL_PREALLOC;
         SDL_VideoSurface->pixels = pixels;
         SDL_VideoSurface->pitch = pitch;
     } else {
-        SDL_CalculatePitch(SDL_VideoSurface);
+        SDL_VideoSurface->flags &= ~SDL_PREALLOC;
+        SDL_VideoSurface->pitch = SDL_CalculatePitch(SDL_VideoSurface);
         SDL_VideoSurface->pixels =
-            SDL_realloc(SDL_VideoSurface->pixels,
-                        SDL_VideoSurface->h * SDL_VideoSurface->pitch);
+            SDL_AllocSurfaceMemory(SDL_VideoSurface->h *
+                                   SDL_VideoSurface->pitch);
     }
     SDL_SetClipRect(SDL_VideoSurface, NULL);
     SDL_InvalidateMap(SDL_VideoSurface->map);
@@ -484,9 +490,10 @@ SDL_ResizeVideoMode(int width, int height, int bpp, Uint32 flags)
         SDL_ShadowSurface->w = width;
         SDL_ShadowSurface->h = height;
         SDL_ShadowSurface->pitch = SDL_CalculatePitch(SDL_ShadowSurface);
+        SDL_FreeSurfaceMemory(SDL_ShadowSurface->pixels);
         SDL_ShadowSurface->pixels =
-            SDL_realloc(SDL_ShadowSurface->pixels,
-                        SDL_ShadowSurface->h * SDL_ShadowSurface->pitch);
+            SDL_AllocSurfaceMemory(SDL_ShadowSurface->h *
+                                   SDL_ShadowSurface->pitch);
         SDL_SetClipRect(SDL_ShadowSurface, NULL);
         SDL_InvalidateMap(SDL_ShadowSurface->map);
     }
@@ -851,50 +858,107 @@ SDL_UpdateRect(SDL_Surface * screen, Sint32 x, Sint32 y, Uint32 w, Uint32 h)
     }
 }
 
+static int
+BlitShadowToTexture(SDL_Rect * rect)
+{
+    void *pixels;
+    int pitch;
+    void *surface_pixels;
+    int surface_pitch;
+    SDL_Rect dstrect;
+    int retval;
+
+    if (SDL_LockTexture(SDL_VideoTexture, rect, 1, &pixels, &pitch) < 0) {
+        return -1;
+    }
+
+    /* Point the video surface at the locked texture memory, so the
+       cached shadow blit converts the rectangle straight into it.
+     */
+    surface_pixels = SDL_VideoSurface->pixels;
+    surface_pitch = SDL_VideoSurface->pitch;
+    SDL_VideoSurface->pixels = pixels;
+    SDL_VideoSurface->pitch = pitch;
+
+    dstrect.x = 0;
+    dstrect.y = 0;
+    dstrect.w = rect->w;
+    dstrect.h = rect->h;
+    retval = SDL_LowerBlit(SDL_ShadowSurface, rect, SDL_VideoSurface,
+                           &dstrect);
+
+    SDL_VideoSurface->pixels = surface_pixels;
+    SDL_VideoSurface->pitch = surface_pitch;
+
+    SDL_UnlockTexture(SDL_VideoTexture);
+    return retval;
+}
+
+static void
+UpdateVideoTexture(const SDL_Rect * rect)
+{
+    int pitch = SDL_VideoSurface->pitch;
+    int psize = SDL_VideoSurface->format->BytesPerPixel;
+    void *pixels =
+        (Uint8 *) SDL_VideoSurface->pixels + rect->y * pitch +
+        rect->x * psize;
+
+    SDL_UpdateTexture(SDL_VideoTexture, rect, pixels, pitch);
+}
+
 void
 SDL_UpdateRects(SDL_Surface * screen, int numrects, SDL_Rect * rects)
 {
     int i;
 
     if (screen == SDL_ShadowSurface) {
-        for (i = 0; i < numrects; ++i) {
-            SDL_LowerBlit(SDL_ShadowSurface, &rects[i], SDL_VideoSurface,
-                          &rects[i]);
+        if (SDL_VideoSurface->flags & SDL_PREALLOC) {
+            /* The video surface is the texture memory, convert into it */
+            for (i = 0; i < numrects; ++i) {
+                SDL_LowerBlit(SDL_ShadowSurface, &rects[i],
+                              SDL_VideoSurface, &rects[i]);
+            }
+            SDL_DirtyTexture(SDL_VideoTexture, numrects, rects);
+        } else {
+            /* Convert the dirty rectangles directly into the texture,
+               going through the video surface only if it can't be locked.
+             */
+            for (i = 0; i < numrects; ++i) {
+                if (BlitShadowToTexture(&rects[i]) < 0) {
+                    SDL_LowerBlit(SDL_ShadowSurface, &rects[i],
+                                  SDL_VideoSurface, &rects[i]);
+                    UpdateVideoTexture(&rects[i]);
+                }
+            }
         }
-
-        /* Fall through to video surface update */
         screen = SDL_VideoSurface;
-    }
-    if (screen == SDL_VideoSurface) {
+    } else if (screen == SDL_VideoSurface) {
         if (screen->flags & SDL_PREALLOC) {
             /* The surface memory is maintained by the renderer */
             SDL_DirtyTexture(SDL_VideoTexture, numrects, rects);
         } else {
             /* The surface memory needs to be copied to texture */
-            int pitch = screen->pitch;
-            int psize = screen->format->BytesPerPixel;
             for (i = 0; i < numrects; ++i) {
-                const SDL_Rect *rect = &rects[i];
-                void *pixels =
-                    (Uint8 *) screen->pixels + rect->y * pitch +
-                    rect->x * psize;
-                SDL_UpdateTexture(SDL_VideoTexture, rect, pixels, pitch);
+                UpdateVideoTexture(&rects[i]);
             }
         }
-        if (SDL_VideoRendererInfo.flags & SDL_RENDERER_PRESENTCOPY) {
-            for (i = 0; i < numrects; ++i) {
-                SDL_RenderCopy(SDL_VideoTexture, &rects[i], &rects[i]);
-            }
-        } else {
-            SDL_Rect rect;
-            rect.x = 0;
-            rect.y = 0;
-            rect.w = screen->w;
-            rect.h = screen->h;
-            SDL_RenderCopy(SDL_VideoTexture, &rect, &rect);
+    } else {
+        return;
+    }
+
+    if (SDL_VideoRendererInfo.flags & SDL_RENDERER_PRESENTCOPY) {
+        for (i = 0; i < numrects; ++i) {
+            SDL_RenderCopy(SDL_VideoTexture, &rects[i], &rects[i]);
         }
-        SDL_RenderPresent();
+    } else {
+        SDL_Rect rect;
+        rect.x = 0;
+        rect.y = 0;
+        rect.w = screen->w;
+        rect.h = screen->h;
+        SDL_RenderCopy(SDL_VideoTexture, &rect, &rect);
     }
+    SDL_RenderPresent();
 }
 
 void
@@ -191,6 +191,13 @@ SDL_AudioCloseDevice_Default(_THIS)
 {                               /* no-op. */
 }
 
+static int
+SDL_AudioGetDeviceClock_Default(_THIS, SDL_AudioClock * clock)
+{
+    SDL_Unsupported();
+    return -1;
+}
+
 static void
 SDL_AudioDeinitialize_Default(void)
 {                               /* no-op. */
@@ -251,6 +258,7 @@ finalize_audio_entry_points(void)
     FILL_STUB(CloseDevice);
     FILL_STUB(LockDevice);
     FILL_STUB(UnlockDevice);
+    FILL_STUB(GetDeviceClock);
     FILL_STUB(Deinitialize);
 #undef FILL_STUB
 }
@@ -316,6 +324,127 @@ SDL_StreamDeinit(SDL_AudioStreamer * stream)
 }
 
 
+/* Add the time since 'start' to the device's callback time */
+static void
+count_callback_ticks(SDL_AudioDevice * device, Uint32 start)
+{
+    const Uint32 ticks = SDL_GetTicks() - start;
+
+    device->callback_ticks += ticks;
+    if (ticks > device->callback_max_ticks) {
+        device->callback_max_ticks = ticks;
+    }
+}
+
+void
+SDL_FillAudioDevice(SDL_AudioDevice * device, Uint8 * stream)
+{
+    SDL_AudioBus *bus;
+    Uint32 start;
+
+    SDL_mutexP(device->mixer_lock);
+    start = SDL_GetTicks();
+    /* Read once, so the conversion below uses the bus that was mixed */
+    bus = device->bus;
+    if (bus) {
+        /* Mix on the float bus, then convert into the device buffer */
+        SDL_MixAudioBus(bus);
+        if (device->voices) {
+            SDL_MixAudioVoices(device->voices, bus);
+        }
+    } else if (device->convert.needed) {
+        (*device->spec.callback) (device->spec.userdata, device->convert.buf,
+                                  device->spec.size);
+    } else {
+        (*device->spec.callback) (device->spec.userdata, stream,
+                                  device->spec.size);
+    }
+    count_callback_ticks(device, start);
+    SDL_mutexV(device->mixer_lock);
+
+    if (bus) {
+        SDL_ConvertAudioBus(bus, stream);
+    } else if (device->convert.needed) {
+        SDL_ConvertAudio(&device->convert);
+        SDL_memcpy(stream, device->convert.buf, device->convert.len_cvt);
+    }
+}
+
+void
+SDL_CaptureAudioDevice(SDL_AudioDevice * device, const Uint8 * data, int len)
+{
+    const int framesize = device->spec.size / device->spec.samples;
+    Uint8 *stream;
+    Uint32 start;
+
+    if (device->paused) {
+        return;
+    }
+    if (SDL_WriteAudioCapture(device->capture, data, len) < 0) {
+        ++device->underruns;
+    }
+    device->frames_submitted += len / framesize;
+
+    /* Without a callback, the application dequeues the audio itself */
+    if (device->callbackspec.callback) {
+        SDL_mutexP(device->mixer_lock);
+        while ((stream = SDL_GetAudioCaptureBuffer(device->capture)) != NULL) {
+            start = SDL_GetTicks();
+            (*device->callbackspec.callback) (device->callbackspec.userdata,
+                                              stream,
+                                              device->callbackspec.size);
+            count_callback_ticks(device, start);
+        }
+        SDL_mutexV(device->mixer_lock);
+    }
+}
+
+void
+SDL_StartAudioVirtualClock(SDL_AudioVirtualClock * clock, int freq,
+                           double speed)
+{
+    clock->speed = (speed > 0.0) ? speed : 0.0;
+    clock->freq = freq;
+    clock->start = SDL_GetTicks();
+    clock->frames = 0;
+}
+
+void
+SDL_WaitAudioVirtualClock(SDL_AudioVirtualClock * clock, int frames)
+{
+    const double scale = 1000.0 / (clock->freq * clock->speed);
+    Uint32 due, now;
+
+    clock->frames += frames;
+    if (clock->speed == 0.0) {
+        return;
+    }
+
+    /* Count from the start, so rounding doesn't add up over time */
+    due = (Uint32) (clock->frames * scale);
+    now = SDL_GetTicks() - clock->start;
+    if (now < due) {
+        SDL_Delay(due - now);
+    } else if (now - due > (Uint32) (frames * scale)) {
+        /* Fell behind, say while paused, so don't rush to catch up */
+        clock->start += now - due;
+    }
+}
+
+Uint64
+SDL_GetAudioVirtualClockFrames(SDL_AudioVirtualClock * clock)
+{
+    Uint64 frames;
+
+    if (clock->speed == 0.0) {
+        return clock->frames;
+    }
+    /* In double, since the ticks times the rate overflows 32 bits */
+    frames = (Uint64) ((double) (SDL_GetTicks() - clock->start) *
+                       clock->freq * clock->speed / 1000.0);
+    return SDL_min(frames, clock->frames);
+}
+
 /* The general mixing thread function */
 int SDLCALL
 SDL_RunAudio(void *devicep)
@@ -383,8 +512,24 @@ SDL_RunAudio(void *devicep)
     /* Calculate the delay while paused */
     delay = ((device->spec.samples * 1000) / device->spec.freq);
 
-    /* Determine if the streamer is necessary here */
-    if (device->use_streamer == 1) {
+    if (device->capture) {
+        /* Record a buffer at a time, and pass it on to the application */
+        while (device->enabled) {
+
+            if (device->paused) {
+                SDL_Delay(delay);
+                continue;
+            }
+
+            stream = device->fake_stream;
+            stream_len = device->spec.size;
+            stream_len = current_audio.impl.CaptureFromDevice(device, stream,
+                                                              stream_len);
+            if (stream_len > 0) {
+                SDL_CaptureAudioDevice(device, stream, stream_len);
+            }
+        }
+    } else if (device->use_streamer == 1) {
         /* This code is almost the same as the old code. The difference is, instead of reading
            directly from the callback into "stream", then converting and sending the audio off,
            we go: callback -> "istream" -> (conversion) -> streamer -> stream -> device.
@@ -484,33 +629,12 @@ SDL_RunAudio(void *devicep)
             }
 
             /* Fill the current buffer with sound */
-            if (device->convert.needed) {
-                if (device->convert.buf) {
-                    stream = device->convert.buf;
-                } else {
-                    continue;
-                }
-            } else {
-                stream = current_audio.impl.GetDeviceBuf(device);
-                if (stream == NULL) {
-                    stream = device->fake_stream;
-                }
-            }
-
-            SDL_mutexP(device->mixer_lock);
-            (*fill) (udata, stream, stream_len);
-            SDL_mutexV(device->mixer_lock);
-
-            /* Convert the audio if necessary */
-            if (device->convert.needed) {
-                SDL_ConvertAudio(&device->convert);
-                stream = current_audio.impl.GetDeviceBuf(device);
-                if (stream == NULL) {
-                    stream = device->fake_stream;
-                }
-                SDL_memcpy(stream, device->convert.buf,
-                           device->convert.len_cvt);
+            stream = current_audio.impl.GetDeviceBuf(device);
+            if (stream == NULL) {
+                stream = device->fake_stream;
             }
+            SDL_FillAudioDevice(device, stream);
+            device->frames_submitted += device->spec.samples;
 
             /* Ready current buffer for play and change current buffer */
             if (stream != device->fake_stream) {
@@ -697,6 +821,11 @@ close_audio_device(SDL_AudioDevice * device)
     if (device->thread != NULL) {
         SDL_WaitThread(device->thread, NULL);
     }
+    /* Drivers with their own thread may use the lock until they close */
+    if (device->opened) {
+        current_audio.impl.CloseDevice(device);
+        device->opened = 0;
+    }
     if (device->mixer_lock != NULL) {
         SDL_DestroyMutex(device->mixer_lock);
     }
@@ -706,25 +835,43 @@ close_audio_device(SDL_AudioDevice * device)
     if (device->convert.needed) {
         SDL_FreeAudioMem(device->convert.buf);
     }
-    if (device->opened) {
-        current_audio.impl.CloseDevice(device);
-        device->opened = 0;
+    if (device->bus != NULL) {
+        SDL_FreeAudioBus(device->bus);
+    }
+    if (device->voices != NULL) {
+        SDL_FreeAudioVoiceMixer(device->voices);
+    }
+    if (device->capture != NULL) {
+        SDL_FreeAudioCapture(device->capture);
     }
     SDL_FreeAudioMem(device);
 }
 
 
+/* Does the driver record through SDL_CaptureAudioDevice()? */
+static SDL_bool
+core_captures_audio(void)
+{
+    if (current_audio.impl.ProvidesOwnCallbackThread) {
+        return current_audio.impl.UsesFillAudioDevice ? SDL_TRUE : SDL_FALSE;
+    }
+    return current_audio.impl.CaptureFromDevice ? SDL_TRUE : SDL_FALSE;
+}
+
+
 /*
  * Sanity check desired AudioSpec for SDL_OpenAudio() in (orig).
  *  Fills in a sanitized copy in (prepared).
  *  Returns non-zero if okay, zero on fatal parameters in (orig).
  */
 static int
-prepare_audiospec(const SDL_AudioSpec * orig, SDL_AudioSpec * prepared)
+prepare_audiospec(const SDL_AudioSpec * orig, SDL_AudioSpec * prepared,
+                  int iscapture)
 {
     SDL_memcpy(prepared, orig, sizeof(SDL_AudioSpec));
 
-    if (orig->callback == NULL) {
+    /* Recorded audio can be dequeued instead */
+    if (orig->callback == NULL && !(iscapture && core_captures_audio())) {
         SDL_SetError("SDL_OpenAudio() passed a NULL callback");
         return 0;
     }
@@ -782,6 +929,38 @@ prepare_audiospec(const SDL_AudioSpec * orig, SDL_AudioSpec * prepared)
 }
 
 
+/* Does the device play through SDL_FillAudioDevice()? */
+static SDL_bool
+core_fills_audio_device(SDL_AudioDevice * device)
+{
+    if (device->iscapture) {
+        return SDL_FALSE;
+    }
+    if (current_audio.impl.ProvidesOwnCallbackThread &&
+        !current_audio.impl.UsesFillAudioDevice) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+/* Should conversion go through the float mixing bus? */
+static SDL_bool
+use_audio_bus(SDL_AudioDevice * device, const SDL_AudioSpec * obtained)
+{
+    const char *env = SDL_getenv("SDL_AUDIO_FLOAT_BUS");
+
+    /* Only SDL_FillAudioDevice() knows how to run the bus */
+    if (!core_fills_audio_device(device)) {
+        return SDL_FALSE;
+    }
+    if (env) {
+        return SDL_atoi(env) ? SDL_TRUE : SDL_FALSE;
+    }
+
+    /* The conversion filters can't resample with fixed size buffers */
+    return (obtained->freq != device->spec.freq) ? SDL_TRUE : SDL_FALSE;
+}
+
 static SDL_AudioDeviceID
 open_audio_device(const char *devname, int iscapture,
                   const SDL_AudioSpec * desired, SDL_AudioSpec * obtained,
@@ -806,7 +985,7 @@ open_audio_device(const char *devname, int iscapture,
     if (!obtained) {
         obtained = &_obtained;
     }
-    if (!prepare_audiospec(desired, obtained)) {
+    if (!prepare_audiospec(desired, obtained, iscapture)) {
         return 0;
     }
 
@@ -919,7 +1098,21 @@ open_audio_device(const char *devname, int iscapture,
             build_cvt = SDL_TRUE;
         }
     }
-    if (build_cvt) {
+    device->callbackspec = *obtained;
+    if (iscapture && core_captures_audio()) {
+        /* Converted on the way out of the capture ring, not with cvt */
+        device->capture = SDL_CreateAudioCapture(&device->spec, obtained);
+        if (device->capture == NULL) {
+            close_audio_device(device);
+            return 0;
+        }
+    } else if (build_cvt && use_audio_bus(device, obtained)) {
+        device->bus = SDL_CreateAudioBus(obtained, &device->spec);
+        if (device->bus == NULL) {
+            close_audio_device(device);
+            return 0;
+        }
+    } else if (build_cvt) {
         /* Build an audio conversion block */
         if (SDL_BuildAudioCVT(&device->convert,
                               obtained->format, obtained->channels,
@@ -1043,6 +1236,58 @@ SDL_GetAudioStatus(void)
     return SDL_GetAudioDeviceStatus(1);
 }
 
+int
+SDL_GetAudioDeviceClock(SDL_AudioDeviceID devid, SDL_AudioClock * clock)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+
+    if (!device) {
+        return -1;
+    }
+    if (clock == NULL) {
+        SDL_SetError("Parameter '%s' is invalid", "clock");
+        return -1;
+    }
+    SDL_memset(clock, 0, sizeof(*clock));
+    clock->frames_submitted = device->frames_submitted;
+    clock->callback_ticks = device->callback_ticks;
+    clock->callback_max_ticks = device->callback_max_ticks;
+    clock->underruns = device->underruns;
+    return current_audio.impl.GetDeviceClock(device, clock);
+}
+
+Uint32
+SDL_GetAudioDeviceUnderruns(SDL_AudioDeviceID devid)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+    if (device) {
+        return device->underruns;
+    }
+    return 0;
+}
+
+Uint32
+SDL_DequeueAudio(SDL_AudioDeviceID devid, void *data, Uint32 len)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+    Uint32 amount;
+
+    if (!device) {
+        return 0;
+    }
+    if (device->capture == NULL || device->callbackspec.callback != NULL) {
+        SDL_SetError("Audio can only be dequeued from a capture device "
+                     "opened without a callback");
+        return 0;
+    }
+
+    /* Other readers wait, but the device thread never does */
+    SDL_mutexP(device->mixer_lock);
+    amount = SDL_ReadAudioCapture(device->capture, (Uint8 *) data, len);
+    SDL_mutexV(device->mixer_lock);
+    return amount;
+}
+
 void
 SDL_PauseAudioDevice(SDL_AudioDeviceID devid, int pause_on)
 {
@@ -1059,6 +1304,186 @@ SDL_PauseAudio(int pause_on)
 }
 
 
+/* Get the device's float bus, creating it if needed.  The device is locked */
+static SDL_AudioBus *
+start_audio_bus(SDL_AudioDevice * device)
+{
+    if (device->bus == NULL) {
+        device->bus = SDL_CreateAudioBus(&device->callbackspec, &device->spec);
+    }
+    return device->bus;
+}
+
+/* Get a device that can mix on the float bus */
+static SDL_AudioDevice *
+get_bus_audio_device(SDL_AudioDeviceID devid)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+
+    if (!device) {
+        return NULL;
+    }
+    if (!core_fills_audio_device(device)) {
+        SDL_SetError("Mixing isn't supported on this audio device");
+        return NULL;
+    }
+    return device;
+}
+
+int
+SDL_SetAudioDeviceVolume(SDL_AudioDeviceID devid, int volume)
+{
+    SDL_AudioDevice *device = get_bus_audio_device(devid);
+    int retval = 0;
+
+    if (!device) {
+        return -1;
+    }
+    if (volume < 0) {
+        volume = 0;
+    } else if (volume > SDL_MIX_MAXVOLUME) {
+        volume = SDL_MIX_MAXVOLUME;
+    }
+
+    current_audio.impl.LockDevice(device);
+    /* Volume is applied on the float bus, so start using it */
+    if (start_audio_bus(device) != NULL) {
+        SDL_SetAudioBusVolume(device->bus,
+                              (float) volume / SDL_MIX_MAXVOLUME);
+    } else {
+        retval = -1;
+    }
+    current_audio.impl.UnlockDevice(device);
+    return retval;
+}
+
+struct SDL_AudioClip *
+SDL_CreateAudioClip(SDL_AudioDeviceID devid, const SDL_AudioSpec * spec,
+                    const Uint8 * buf, Uint32 len)
+{
+    SDL_AudioDevice *device = get_bus_audio_device(devid);
+
+    if (!device) {
+        return NULL;
+    }
+    if (spec == NULL || buf == NULL) {
+        SDL_SetError("Parameter '%s' is invalid", spec ? "buf" : "spec");
+        return NULL;
+    }
+
+    return SDL_ConvertAudioClip(devid, spec, buf, len, device->spec.freq);
+}
+
+void
+SDL_FreeAudioClip(SDL_AudioClip * clip)
+{
+    SDL_AudioDeviceID devid;
+    SDL_AudioDevice *device = NULL;
+
+    if (clip == NULL) {
+        return;
+    }
+
+    /* The device may already be closed, which stopped the voices */
+    devid = SDL_GetAudioClipDevice(clip);
+    if (devid > 0 && devid <= SDL_arraysize(open_devices)) {
+        device = open_devices[devid - 1];
+    }
+    if (device && device->voices) {
+        current_audio.impl.LockDevice(device);
+        SDL_RemoveAudioClipVoices(device->voices, clip);
+        current_audio.impl.UnlockDevice(device);
+    }
+    SDL_FreeAudioClipData(clip);
+}
+
+SDL_AudioVoiceID
+SDL_PlayAudioClip(SDL_AudioClip * clip, int loops, int volume, int pan)
+{
+    SDL_AudioDevice *device;
+    SDL_AudioVoiceID voice = 0;
+
+    if (clip == NULL) {
+        SDL_SetError("Parameter '%s' is invalid", "clip");
+        return 0;
+    }
+    device = get_bus_audio_device(SDL_GetAudioClipDevice(clip));
+    if (!device) {
+        return 0;
+    }
+
+    current_audio.impl.LockDevice(device);
+    if (device->voices == NULL && start_audio_bus(device) != NULL) {
+        device->voices = SDL_CreateAudioVoiceMixer(&device->spec);
+    }
+    if (device->voices != NULL) {
+        voice = SDL_AddAudioVoice(device->voices, clip, loops, volume, pan);
+    }
+    current_audio.impl.UnlockDevice(device);
+    return voice;
+}
+
+int
+SDL_SetAudioVoiceVolume(SDL_AudioDeviceID devid, SDL_AudioVoiceID voice,
+                        int volume, int pan)
+{
+    SDL_AudioDevice *device = get_bus_audio_device(devid);
+    int retval;
+
+    if (!device) {
+        return -1;
+    }
+
+    current_audio.impl.LockDevice(device);
+    if (device->voices) {
+        retval = SDL_SetAudioVoice(device->voices, voice, volume, pan);
+    } else {
+        SDL_SetError("Audio voice isn't playing");
+        retval = -1;
+    }
+    current_audio.impl.UnlockDevice(device);
+    return retval;
+}
+
+int
+SDL_StopAudioVoice(SDL_AudioDeviceID devid, SDL_AudioVoiceID voice)
+{
+    SDL_AudioDevice *device = get_bus_audio_device(devid);
+    int retval;
+
+    if (!device) {
+        return -1;
+    }
+
+    current_audio.impl.LockDevice(device);
+    if (device->voices) {
+        retval = SDL_RemoveAudioVoice(device->voices, voice);
+    } else {
+        SDL_SetError("Audio voice isn't playing");
+        retval = -1;
+    }
+    current_audio.impl.UnlockDevice(device);
+    return retval;
+}
+
+SDL_bool
+SDL_AudioVoicePlaying(SDL_AudioDeviceID devid, SDL_AudioVoiceID voice)
+{
+    SDL_AudioDevice *device = get_bus_audio_device(devid);
+    SDL_bool retval = SDL_FALSE;
+
+    if (!device) {
+        return SDL_FALSE;
+    }
+
+    current_audio.impl.LockDevice(device);
+    if (device->voices) {
+        retval = SDL_HasAudioVoice(device->voices, voice);
+    }
+    current_audio.impl.UnlockDevice(device);
+    return retval;
+}
+
 void
 SDL_LockAudioDevice(SDL_AudioDeviceID devid)
 {
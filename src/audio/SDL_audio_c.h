@@ -33,6 +33,57 @@ extern void SDL_CalculateAudioSpec(SDL_AudioSpec * spec);
 /* The actual mixing thread function */
 extern int SDLCALL SDL_RunAudio(void *audiop);
 
+/* The float32 mixing bus, in SDL_audiobus.c */
+#define SDL_AUDIO_BUS_MAX_CHANNELS  8
+typedef struct SDL_AudioBus SDL_AudioBus;
+extern SDL_AudioBus *SDL_CreateAudioBus(const SDL_AudioSpec * src,
+                                        const SDL_AudioSpec * dst);
+extern void SDL_SetAudioBusVolume(SDL_AudioBus * bus, float volume);
+extern float SDL_GetAudioBusVolume(SDL_AudioBus * bus);
+extern float *SDL_GetAudioBusPlane(SDL_AudioBus * bus, int channel);
+extern void SDL_ScaleAudioBusSamples(SDL_AudioBus * bus, float *out,
+                                     const float *src, float gain, int count,
+                                     SDL_bool add);
+extern void SDL_MixAudioBus(SDL_AudioBus * bus);
+extern void SDL_ConvertAudioBus(SDL_AudioBus * bus, Uint8 * stream);
+extern void SDL_FreeAudioBus(SDL_AudioBus * bus);
+
+/* The voice mixer, in SDL_audiovoice.c */
+typedef struct SDL_AudioVoiceMixer SDL_AudioVoiceMixer;
+extern SDL_AudioClip *SDL_ConvertAudioClip(SDL_AudioDeviceID dev,
+                                           const SDL_AudioSpec * spec,
+                                           const Uint8 * buf, Uint32 len,
+                                           int freq);
+extern SDL_AudioDeviceID SDL_GetAudioClipDevice(SDL_AudioClip * clip);
+extern void SDL_FreeAudioClipData(SDL_AudioClip * clip);
+extern SDL_AudioVoiceMixer *SDL_CreateAudioVoiceMixer(const SDL_AudioSpec *
+                                                      spec);
+extern SDL_AudioVoiceID SDL_AddAudioVoice(SDL_AudioVoiceMixer * mixer,
+                                          SDL_AudioClip * clip, int loops,
+                                          int volume, int pan);
+extern int SDL_SetAudioVoice(SDL_AudioVoiceMixer * mixer,
+                             SDL_AudioVoiceID voice, int volume, int pan);
+extern int SDL_RemoveAudioVoice(SDL_AudioVoiceMixer * mixer,
+                                SDL_AudioVoiceID voice);
+extern SDL_bool SDL_HasAudioVoice(SDL_AudioVoiceMixer * mixer,
+                                  SDL_AudioVoiceID voice);
+extern void SDL_RemoveAudioClipVoices(SDL_AudioVoiceMixer * mixer,
+                                      SDL_AudioClip * clip);
+extern void SDL_MixAudioVoices(SDL_AudioVoiceMixer * mixer,
+                               SDL_AudioBus * bus);
+extern void SDL_FreeAudioVoiceMixer(SDL_AudioVoiceMixer * mixer);
+
+/* The capture pipeline, in SDL_audiocapture.c */
+typedef struct SDL_AudioCapture SDL_AudioCapture;
+extern SDL_AudioCapture *SDL_CreateAudioCapture(const SDL_AudioSpec * src,
+                                                const SDL_AudioSpec * dst);
+extern int SDL_WriteAudioCapture(SDL_AudioCapture * cap, const Uint8 * data,
+                                 Uint32 len);
+extern Uint32 SDL_ReadAudioCapture(SDL_AudioCapture * cap, Uint8 * data,
+                                   Uint32 len);
+extern Uint8 *SDL_GetAudioCaptureBuffer(SDL_AudioCapture * cap);
+extern void SDL_FreeAudioCapture(SDL_AudioCapture * cap);
+
 /* this is used internally to access some autogenerated code. */
 typedef struct
 {
@@ -41,6 +92,7 @@ typedef struct
     SDL_AudioFilter filter;
 } SDL_AudioTypeFilters;
 extern const SDL_AudioTypeFilters sdl_audio_type_filters[];
+extern const SDL_AudioTypeFilters sdl_audio_type_filters_sse2[];
 
 /* this is used internally to access some autogenerated code. */
 typedef struct
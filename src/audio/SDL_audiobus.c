@@ -0,0 +1,660 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2010 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* The float32 mixing bus between the application callback and the device.
+
+   Instead of a chain of SDL_AudioCVT filters that each make a full pass
+   over the buffer, the callback's samples are decoded a small chunk at a
+   time, and channel mapping, volume and resampling are done in a single
+   pass into planar float buffers, one per device channel.  Those are
+   converted to the device format once, at the end.
+ */
+
+#include "SDL_audio.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_audio_c.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/* Callback frames decoded at a time, small enough to stay in the cache */
+#define BUS_CHUNK_FRAMES    256
+
+#define DIVBY127 0.0078740157480315f
+#define DIVBY32767 3.05185094759972e-05f
+#define DIVBY2147483647 4.6566128752458e-10f
+
+struct SDL_AudioBus
+{
+    /* The application side */
+    SDL_AudioFormat src_format;
+    int src_channels;
+    int src_freq;
+    void (SDLCALL * callback) (void *userdata, Uint8 * stream, int len);
+    void *userdata;
+    Uint8 *src_buf;
+    int src_len;
+    int src_pos;
+
+    /* The device side */
+    SDL_AudioFormat dst_format;
+    int dst_channels;
+    int dst_freq;
+    int samples;
+    float *planes;
+
+    /* Whether to use the SSE2 paths */
+    SDL_bool sse2;
+
+    /* Gain of each application channel in each device channel */
+    float map[SDL_AUDIO_BUS_MAX_CHANNELS][SDL_AUDIO_BUS_MAX_CHANNELS];
+    float volume;
+
+    /* Decoded application frames, one row per channel.  Frame 0 is the
+       last frame of the previous chunk, so resampling can interpolate
+       across chunks. */
+    float frames[SDL_AUDIO_BUS_MAX_CHANNELS][BUS_CHUNK_FRAMES + 1];
+    int frame;
+    int num_frames;
+
+    /* Position between frame and frame + 1, in units of 1/dst_freq */
+    int phase;
+
+    /* Resampled frames for the part of the output one chunk covers */
+    int run_index[BUS_CHUNK_FRAMES];
+    float run_weight[BUS_CHUNK_FRAMES];
+    float run[SDL_AUDIO_BUS_MAX_CHANNELS][BUS_CHUNK_FRAMES];
+};
+
+
+/* Replace map with the result of mixing its channels down or up to
+   'channels' with the matrix 'step' */
+static void
+SDL_ApplyBusMapStep(float map[][SDL_AUDIO_BUS_MAX_CHANNELS], int src_channels,
+                    float step[][SDL_AUDIO_BUS_MAX_CHANNELS], int channels,
+                    int prev_channels)
+{
+    float result[SDL_AUDIO_BUS_MAX_CHANNELS][SDL_AUDIO_BUS_MAX_CHANNELS];
+    int i, j, k;
+
+    for (i = 0; i < channels; ++i) {
+        for (j = 0; j < src_channels; ++j) {
+            float sum = 0.0f;
+            for (k = 0; k < prev_channels; ++k) {
+                sum += step[i][k] * map[k][j];
+            }
+            result[i][j] = sum;
+        }
+    }
+    SDL_memcpy(map, result, sizeof(result));
+}
+
+/* Build the same channel mapping as the SDL_AudioCVT filter chain */
+static void
+SDL_BuildBusMap(SDL_AudioBus * bus)
+{
+    float step[SDL_AUDIO_BUS_MAX_CHANNELS][SDL_AUDIO_BUS_MAX_CHANNELS];
+    int channels = bus->src_channels;
+    int i;
+
+    SDL_memset(bus->map, 0, sizeof(bus->map));
+    for (i = 0; i < channels; ++i) {
+        bus->map[i][i] = 1.0f;
+    }
+
+#define BUS_MAP_STEP(new_channels) \
+    { \
+        SDL_ApplyBusMapStep(bus->map, bus->src_channels, step, \
+                            new_channels, channels); \
+        channels = new_channels; \
+    }
+
+    if (channels == bus->dst_channels) {
+        return;
+    }
+    if ((channels == 1) && (bus->dst_channels > 1)) {
+        SDL_memset(step, 0, sizeof(step));
+        step[0][0] = step[1][0] = 1.0f;
+        BUS_MAP_STEP(2);
+    }
+    if ((channels == 2) && (bus->dst_channels == 6 || bus->dst_channels == 4)) {
+        /* Front pair, then the difference from the center on the back */
+        SDL_memset(step, 0, sizeof(step));
+        step[0][0] = 1.0f;
+        step[1][1] = 1.0f;
+        step[2][0] = 0.5f;
+        step[2][1] = -0.5f;
+        step[3][0] = -0.5f;
+        step[3][1] = 0.5f;
+        if (bus->dst_channels == 6) {
+            step[4][0] = step[4][1] = 0.5f;
+            step[5][0] = step[5][1] = 0.5f;
+        }
+        BUS_MAP_STEP(bus->dst_channels);
+    }
+    while ((channels * 2) <= bus->dst_channels) {
+        SDL_memset(step, 0, sizeof(step));
+        for (i = 0; i < channels * 2; ++i) {
+            step[i][i / 2] = 1.0f;
+        }
+        BUS_MAP_STEP(channels * 2);
+    }
+    if ((channels == 6) && (bus->dst_channels <= 4)) {
+        SDL_memset(step, 0, sizeof(step));
+        for (i = 0; i < 4; ++i) {
+            step[i][i] = 1.0f;
+        }
+        BUS_MAP_STEP((bus->dst_channels <= 2) ? 2 : 4);
+    }
+    while (((channels % 2) == 0) && ((channels / 2) >= bus->dst_channels)) {
+        SDL_memset(step, 0, sizeof(step));
+        for (i = 0; i < channels / 2; ++i) {
+            step[i][i * 2] = step[i][i * 2 + 1] = 0.5f;
+        }
+        BUS_MAP_STEP(channels / 2);
+    }
+    /* Any device channels still unaccounted for are left silent */
+#undef BUS_MAP_STEP
+}
+
+SDL_AudioBus *
+SDL_CreateAudioBus(const SDL_AudioSpec * src, const SDL_AudioSpec * dst)
+{
+    SDL_AudioBus *bus;
+
+    if (src->channels > SDL_AUDIO_BUS_MAX_CHANNELS ||
+        dst->channels > SDL_AUDIO_BUS_MAX_CHANNELS) {
+        SDL_SetError("Too many channels for the mixing bus");
+        return NULL;
+    }
+    if (src->callback == NULL) {
+        SDL_SetError("SDL_AudioSpec.callback is NULL");
+        return NULL;
+    }
+
+    bus = (SDL_AudioBus *) SDL_calloc(1, sizeof(*bus));
+    if (bus == NULL) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    bus->src_format = src->format;
+    bus->src_channels = src->channels;
+    bus->src_freq = src->freq;
+    bus->callback = src->callback;
+    bus->userdata = src->userdata;
+    bus->src_len = src->size;
+    bus->src_pos = src->size;
+    bus->dst_format = dst->format;
+    bus->dst_channels = dst->channels;
+    bus->dst_freq = dst->freq;
+    bus->samples = dst->samples;
+    bus->volume = 1.0f;
+    bus->num_frames = 0;
+    bus->sse2 = SDL_HasSSE2();
+
+    bus->src_buf = (Uint8 *) SDL_malloc(bus->src_len);
+    bus->planes =
+        (float *) SDL_malloc(bus->samples * bus->dst_channels *
+                             sizeof(float));
+    if (bus->src_buf == NULL || bus->planes == NULL) {
+        SDL_FreeAudioBus(bus);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    SDL_BuildBusMap(bus);
+    return bus;
+}
+
+void
+SDL_SetAudioBusVolume(SDL_AudioBus * bus, float volume)
+{
+    bus->volume = volume;
+}
+
+float
+SDL_GetAudioBusVolume(SDL_AudioBus * bus)
+{
+    return bus->volume;
+}
+
+float *
+SDL_GetAudioBusPlane(SDL_AudioBus * bus, int channel)
+{
+    return bus->planes + channel * bus->samples;
+}
+
+#ifdef __SSE2__
+/* Decode the mono and stereo S16 and F32 frames four at a time, returning
+   how many were done */
+static int
+SDL_DecodeBusFrames_SSE2(SDL_AudioBus * bus, const Uint8 * buf, int pos,
+                         int count)
+{
+    const int channels = bus->src_channels;
+    const __m128 divby = _mm_set1_ps(DIVBY32767);
+    float *left = &bus->frames[0][pos];
+    float *right = &bus->frames[1][pos];
+    int i = 0;
+
+    if (channels == 1 && bus->src_format == AUDIO_S16LSB) {
+        for (; i + 8 <= count; i += 8) {
+            const __m128i in =
+                _mm_loadu_si128((const __m128i *) (buf + i * 2));
+            _mm_storeu_ps(left + i, _mm_mul_ps(_mm_cvtepi32_ps(
+                _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16)), divby));
+            _mm_storeu_ps(left + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(
+                _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16)), divby));
+        }
+    } else if (channels == 2 && bus->src_format == AUDIO_S16LSB) {
+        for (; i + 4 <= count; i += 4) {
+            const __m128i in =
+                _mm_loadu_si128((const __m128i *) (buf + i * 4));
+            const __m128 lo = _mm_mul_ps(_mm_cvtepi32_ps(
+                _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16)), divby);
+            const __m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(
+                _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16)), divby);
+            _mm_storeu_ps(left + i, _mm_shuffle_ps(lo, hi, 0x88));
+            _mm_storeu_ps(right + i, _mm_shuffle_ps(lo, hi, 0xDD));
+        }
+    } else if (channels == 1 && bus->src_format == AUDIO_F32LSB) {
+        SDL_memcpy(left, buf, count * sizeof(float));
+        i = count;
+    } else if (channels == 2 && bus->src_format == AUDIO_F32LSB) {
+        for (; i + 4 <= count; i += 4) {
+            const __m128 lo = _mm_loadu_ps((const float *) (buf + i * 8));
+            const __m128 hi = _mm_loadu_ps((const float *) (buf + i * 8 + 16));
+            _mm_storeu_ps(left + i, _mm_shuffle_ps(lo, hi, 0x88));
+            _mm_storeu_ps(right + i, _mm_shuffle_ps(lo, hi, 0xDD));
+        }
+    }
+    return i;
+}
+#endif /* __SSE2__ */
+
+/* Decode 'count' callback frames into the channel rows at frame 'pos',
+   calling the callback for more as needed */
+static void
+SDL_DecodeBusFrames(SDL_AudioBus * bus, int pos, int count)
+{
+    const int channels = bus->src_channels;
+    const int framesize = (SDL_AUDIO_BITSIZE(bus->src_format) / 8) * channels;
+    int c;
+
+    while (count > 0) {
+        int n, done = 0;
+
+        if (bus->src_pos >= bus->src_len) {
+            (*bus->callback) (bus->userdata, bus->src_buf, bus->src_len);
+            bus->src_pos = 0;
+        }
+        n = SDL_min(count, (bus->src_len - bus->src_pos) / framesize);
+
+#ifdef __SSE2__
+        if (bus->sse2) {
+            done = SDL_DecodeBusFrames_SSE2(bus, bus->src_buf + bus->src_pos,
+                                            pos, n);
+        }
+#endif
+
+#define DECODE_SAMPLES(type, expr) \
+        { \
+            const type *src = (const type *) (bus->src_buf + bus->src_pos); \
+            int i; \
+            src += done * channels; \
+            for (i = pos + done; i < pos + n; ++i) { \
+                for (c = 0; c < channels; ++c, ++src) { \
+                    bus->frames[c][i] = expr; \
+                } \
+            } \
+        }
+        switch (bus->src_format) {
+        case AUDIO_U8:
+            DECODE_SAMPLES(Uint8, ((int) *src - 128) * DIVBY127);
+            break;
+        case AUDIO_S8:
+            DECODE_SAMPLES(Sint8, *src * DIVBY127);
+            break;
+        case AUDIO_U16LSB:
+            DECODE_SAMPLES(Uint16,
+                           ((int) SDL_SwapLE16(*src) - 32768) * DIVBY32767);
+            break;
+        case AUDIO_U16MSB:
+            DECODE_SAMPLES(Uint16,
+                           ((int) SDL_SwapBE16(*src) - 32768) * DIVBY32767);
+            break;
+        case AUDIO_S16LSB:
+            DECODE_SAMPLES(Uint16, ((Sint16) SDL_SwapLE16(*src)) * DIVBY32767);
+            break;
+        case AUDIO_S16MSB:
+            DECODE_SAMPLES(Uint16, ((Sint16) SDL_SwapBE16(*src)) * DIVBY32767);
+            break;
+        case AUDIO_S32LSB:
+            DECODE_SAMPLES(Uint32,
+                           ((Sint32) SDL_SwapLE32(*src)) * DIVBY2147483647);
+            break;
+        case AUDIO_S32MSB:
+            DECODE_SAMPLES(Uint32,
+                           ((Sint32) SDL_SwapBE32(*src)) * DIVBY2147483647);
+            break;
+        case AUDIO_F32LSB:
+            DECODE_SAMPLES(float, SDL_SwapFloatLE(*src));
+            break;
+        case AUDIO_F32MSB:
+            DECODE_SAMPLES(float, SDL_SwapFloatBE(*src));
+            break;
+        default:
+            for (c = 0; c < channels; ++c) {
+                SDL_memset(&bus->frames[c][pos + done], 0,
+                           (n - done) * sizeof(float));
+            }
+            break;
+        }
+#undef DECODE_SAMPLES
+
+        bus->src_pos += n * framesize;
+        pos += n;
+        count -= n;
+    }
+}
+
+/* Keep the current frame and decode the next chunk after it */
+static void
+SDL_RefillBus(SDL_AudioBus * bus)
+{
+    int skip = bus->frame - (bus->num_frames - 1);
+    int c;
+
+    if (bus->num_frames == 0) {
+        /* Nothing decoded yet, so start right at the first frame */
+        SDL_DecodeBusFrames(bus, 0, 1);
+    } else if (skip == 0) {
+        for (c = 0; c < bus->src_channels; ++c) {
+            bus->frames[c][0] = bus->frames[c][bus->frame];
+        }
+    } else {
+        /* Downsampling stepped past the end of the chunk */
+        while (skip-- > 0) {
+            SDL_DecodeBusFrames(bus, 0, 1);
+        }
+    }
+    SDL_DecodeBusFrames(bus, 1, BUS_CHUNK_FRAMES);
+    bus->frame = 0;
+    bus->num_frames = BUS_CHUNK_FRAMES + 1;
+}
+
+/* Linearly interpolate as much of the output as the current chunk covers,
+   returning the number of frames, at most 'max' */
+static int
+SDL_ResampleBusRun(SDL_AudioBus * bus, int max)
+{
+    const float scale = 1.0f / bus->dst_freq;
+    int m = 0;
+    int c, k;
+
+    if (max > BUS_CHUNK_FRAMES) {
+        max = BUS_CHUNK_FRAMES;
+    }
+    while (m < max && bus->frame + 1 < bus->num_frames) {
+        bus->run_index[m] = bus->frame;
+        bus->run_weight[m] = bus->phase * scale;
+        ++m;
+
+        bus->phase += bus->src_freq;
+        while (bus->phase >= bus->dst_freq) {
+            bus->phase -= bus->dst_freq;
+            ++bus->frame;
+        }
+    }
+
+    for (c = 0; c < bus->src_channels; ++c) {
+        const float *x = bus->frames[c];
+        float *out = bus->run[c];
+        for (k = 0; k < m; ++k) {
+            const int j = bus->run_index[k];
+            out[k] = x[j] + (x[j + 1] - x[j]) * bus->run_weight[k];
+        }
+    }
+    return m;
+}
+
+/* Set or add 'gain' times 'src' to 'out' */
+void
+SDL_ScaleAudioBusSamples(SDL_AudioBus * bus, float *out, const float *src,
+                         float gain, int count, SDL_bool add)
+{
+    int k = 0;
+
+#ifdef __SSE2__
+    if (bus->sse2) {
+        const __m128 g = _mm_set1_ps(gain);
+        if (add) {
+            for (; k + 4 <= count; k += 4) {
+                _mm_storeu_ps(out + k, _mm_add_ps(_mm_loadu_ps(out + k),
+                              _mm_mul_ps(g, _mm_loadu_ps(src + k))));
+            }
+        } else {
+            for (; k + 4 <= count; k += 4) {
+                _mm_storeu_ps(out + k, _mm_mul_ps(g, _mm_loadu_ps(src + k)));
+            }
+        }
+    }
+#endif
+    if (add) {
+        for (; k < count; ++k) {
+            out[k] += gain * src[k];
+        }
+    } else {
+        for (; k < count; ++k) {
+            out[k] = gain * src[k];
+        }
+    }
+}
+
+void
+SDL_MixAudioBus(SDL_AudioBus * bus)
+{
+    const int src_channels = bus->src_channels;
+    const int dst_channels = bus->dst_channels;
+    const int samples = bus->samples;
+    const float *in[SDL_AUDIO_BUS_MAX_CHANNELS];
+    int i, m, c, d;
+
+    for (i = 0; i < samples; i += m) {
+        while (bus->frame + 1 >= bus->num_frames) {
+            SDL_RefillBus(bus);
+        }
+
+        if (bus->src_freq == bus->dst_freq) {
+            /* No resampling, so map straight from the decoded frames */
+            m = SDL_min(samples - i, bus->num_frames - 1 - bus->frame);
+            for (c = 0; c < src_channels; ++c) {
+                in[c] = &bus->frames[c][bus->frame];
+            }
+            bus->frame += m;
+        } else {
+            m = SDL_ResampleBusRun(bus, samples - i);
+            for (c = 0; c < src_channels; ++c) {
+                in[c] = bus->run[c];
+            }
+        }
+
+        /* Each device channel is a weighted sum of the callback channels */
+        for (d = 0; d < dst_channels; ++d) {
+            float *out = bus->planes + d * samples + i;
+            SDL_bool first = SDL_TRUE;
+
+            for (c = 0; c < src_channels; ++c) {
+                if (bus->map[d][c] != 0.0f) {
+                    SDL_ScaleAudioBusSamples(bus, out, in[c],
+                                             bus->map[d][c] * bus->volume, m,
+                                             first ? SDL_FALSE : SDL_TRUE);
+                    first = SDL_FALSE;
+                }
+            }
+            if (first) {
+                SDL_memset(out, 0, m * sizeof(float));
+            }
+        }
+    }
+}
+
+#ifdef __SSE2__
+/* Encode mono and stereo S16 and F32 four frames at a time, returning how
+   many were done */
+static int
+SDL_ConvertAudioBus_SSE2(SDL_AudioBus * bus, Uint8 * stream)
+{
+    const int channels = bus->dst_channels;
+    const int samples = bus->samples;
+    const float *left = bus->planes;
+    const float *right = bus->planes + samples;
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 minus_one = _mm_set1_ps(-1.0f);
+    const __m128 mult = _mm_set1_ps(32767.0f);
+    int i = 0;
+
+#define CLAMP_SSE2(x) _mm_min_ps(_mm_max_ps((x), minus_one), one)
+    if (channels == 1 && bus->dst_format == AUDIO_S16LSB) {
+        for (; i + 8 <= samples; i += 8) {
+            const __m128 lo = CLAMP_SSE2(_mm_loadu_ps(left + i));
+            const __m128 hi = CLAMP_SSE2(_mm_loadu_ps(left + i + 4));
+            _mm_storeu_si128((__m128i *) (stream + i * 2),
+                _mm_packs_epi32(_mm_cvttps_epi32(_mm_mul_ps(lo, mult)),
+                                _mm_cvttps_epi32(_mm_mul_ps(hi, mult))));
+        }
+    } else if (channels == 2 && bus->dst_format == AUDIO_S16LSB) {
+        for (; i + 4 <= samples; i += 4) {
+            const __m128 l = CLAMP_SSE2(_mm_loadu_ps(left + i));
+            const __m128 r = CLAMP_SSE2(_mm_loadu_ps(right + i));
+            const __m128 lo = _mm_unpacklo_ps(l, r);
+            const __m128 hi = _mm_unpackhi_ps(l, r);
+            _mm_storeu_si128((__m128i *) (stream + i * 4),
+                _mm_packs_epi32(_mm_cvttps_epi32(_mm_mul_ps(lo, mult)),
+                                _mm_cvttps_epi32(_mm_mul_ps(hi, mult))));
+        }
+    } else if (channels == 1 && bus->dst_format == AUDIO_F32LSB) {
+        for (; i + 4 <= samples; i += 4) {
+            _mm_storeu_ps((float *) (stream + i * 4),
+                          CLAMP_SSE2(_mm_loadu_ps(left + i)));
+        }
+    } else if (channels == 2 && bus->dst_format == AUDIO_F32LSB) {
+        for (; i + 4 <= samples; i += 4) {
+            const __m128 l = CLAMP_SSE2(_mm_loadu_ps(left + i));
+            const __m128 r = CLAMP_SSE2(_mm_loadu_ps(right + i));
+            _mm_storeu_ps((float *) (stream + i * 8), _mm_unpacklo_ps(l, r));
+            _mm_storeu_ps((float *) (stream + i * 8 + 16),
+                          _mm_unpackhi_ps(l, r));
+        }
+    }
+#undef CLAMP_SSE2
+    return i;
+}
+#endif /* __SSE2__ */
+
+void
+SDL_ConvertAudioBus(SDL_AudioBus * bus, Uint8 * stream)
+{
+    const int channels = bus->dst_channels;
+    const int samples = bus->samples;
+    int i, d, done = 0;
+
+#ifdef __SSE2__
+    if (bus->sse2) {
+        done = SDL_ConvertAudioBus_SSE2(bus, stream);
+    }
+#endif
+
+#define ENCODE_SAMPLES(type, expr) \
+    { \
+        type *dst = (type *) stream + done * channels; \
+        for (i = done; i < samples; ++i) { \
+            for (d = 0; d < channels; ++d) { \
+                float val = bus->planes[d * samples + i]; \
+                if (val > 1.0f) { \
+                    val = 1.0f; \
+                } else if (val < -1.0f) { \
+                    val = -1.0f; \
+                } \
+                *(dst++) = expr; \
+            } \
+        } \
+    }
+    switch (bus->dst_format) {
+    case AUDIO_U8:
+        ENCODE_SAMPLES(Uint8, (Uint8) ((Sint32) (val * 127.0f) + 128));
+        break;
+    case AUDIO_S8:
+        ENCODE_SAMPLES(Sint8, (Sint8) (val * 127.0f));
+        break;
+    case AUDIO_U16LSB:
+        ENCODE_SAMPLES(Uint16,
+                       SDL_SwapLE16((Uint16) ((Sint32) (val * 32767.0f) +
+                                              32768)));
+        break;
+    case AUDIO_U16MSB:
+        ENCODE_SAMPLES(Uint16,
+                       SDL_SwapBE16((Uint16) ((Sint32) (val * 32767.0f) +
+                                              32768)));
+        break;
+    case AUDIO_S16LSB:
+        ENCODE_SAMPLES(Uint16, SDL_SwapLE16((Uint16) (Sint16) (val * 32767.0f)));
+        break;
+    case AUDIO_S16MSB:
+        ENCODE_SAMPLES(Uint16, SDL_SwapBE16((Uint16) (Sint16) (val * 32767.0f)));
+        break;
+    case AUDIO_S32LSB:
+        ENCODE_SAMPLES(Uint32,
+                       SDL_SwapLE32((Uint32) (Sint32) (val * 2147483647.0)));
+        break;
+    case AUDIO_S32MSB:
+        ENCODE_SAMPLES(Uint32,
+                       SDL_SwapBE32((Uint32) (Sint32) (val * 2147483647.0)));
+        break;
+    case AUDIO_F32LSB:
+        ENCODE_SAMPLES(float, SDL_SwapFloatLE(val));
+        break;
+    case AUDIO_F32MSB:
+        ENCODE_SAMPLES(float, SDL_SwapFloatBE(val));
+        break;
+    default:
+        break;
+    }
+#undef ENCODE_SAMPLES
+}
+
+void
+SDL_FreeAudioBus(SDL_AudioBus * bus)
+{
+    if (bus) {
+        if (bus->src_buf) {
+            SDL_free(bus->src_buf);
+        }
+        if (bus->planes) {
+            SDL_free(bus->planes);
+        }
+        SDL_free(bus);
+    }
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
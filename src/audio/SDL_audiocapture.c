@@ -0,0 +1,252 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2010 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* The capture pipeline, between a recording device and the application.
+
+   The thread reading from the device only copies raw frames into a ring
+   buffer, so it never blocks on the application or waits for a lock.
+   Conversion to the application's format, including resampling, is done
+   on the reading side, through the same float bus used for playback.
+ */
+
+#include "SDL_audio.h"
+#include "SDL_atomic.h"
+#include "SDL_audio_c.h"
+
+/* Device frames handed to the bus at a time */
+#define CAPTURE_CHUNK_FRAMES    256
+
+struct SDL_AudioCapture
+{
+    /* Raw device frames.  'head' and 'tail' count the bytes written and
+       read so far, and are only ever advanced by the writer and the reader
+       respectively.  The size is a power of two, so they can wrap. */
+    Uint8 *ring;
+    Uint32 ring_size;
+    volatile Uint32 head;
+    volatile Uint32 tail;
+    int framesize;
+    Uint8 silence;
+
+    /* Converts device frames to the application's format, if needed */
+    SDL_AudioBus *bus;
+    Uint32 src_needed;
+
+    /* Converted audio not read yet */
+    Uint8 *out;
+    Uint32 out_size;
+    Uint32 out_len;
+    Uint32 out_pos;
+    int out_framesize;
+};
+
+
+/* Read a counter the other side advances, with a full barrier */
+static Uint32
+SDL_LoadCaptureCounter(volatile Uint32 * counter)
+{
+    return SDL_AtomicFetchThenAdd32(counter, 0);
+}
+
+static Uint32
+SDL_CaptureAvailable(SDL_AudioCapture * cap)
+{
+    return SDL_LoadCaptureCounter(&cap->head) - cap->tail;
+}
+
+/* Take up to 'len' bytes out of the ring, returning how many */
+static Uint32
+SDL_TakeCaptureFrames(SDL_AudioCapture * cap, Uint8 * data, Uint32 len)
+{
+    const Uint32 pos = cap->tail & (cap->ring_size - 1);
+    Uint32 amount = SDL_min(len, SDL_CaptureAvailable(cap));
+    Uint32 first;
+
+    amount -= amount % cap->framesize;
+    first = SDL_min(amount, cap->ring_size - pos);
+    SDL_memcpy(data, cap->ring + pos, first);
+    SDL_memcpy(data + first, cap->ring, amount - first);
+    SDL_AtomicAddThenFetch32(&cap->tail, amount);
+    return amount;
+}
+
+/* Feeds the bus from the ring.  The reader only runs the bus once the ring
+   holds all it can ask for, so the silence is only a safety net. */
+static void SDLCALL
+SDL_ReadCaptureSource(void *userdata, Uint8 * stream, int len)
+{
+    SDL_AudioCapture *cap = (SDL_AudioCapture *) userdata;
+    const Uint32 amount = SDL_TakeCaptureFrames(cap, stream, (Uint32) len);
+
+    SDL_memset(stream + amount, cap->silence, len - amount);
+}
+
+SDL_AudioCapture *
+SDL_CreateAudioCapture(const SDL_AudioSpec * src, const SDL_AudioSpec * dst)
+{
+    SDL_AudioCapture *cap;
+    SDL_AudioSpec chunk;
+    Uint32 size;
+
+    cap = (SDL_AudioCapture *) SDL_calloc(1, sizeof(*cap));
+    if (cap == NULL) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    cap->framesize = (SDL_AUDIO_BITSIZE(src->format) / 8) * src->channels;
+    cap->silence = src->silence;
+    cap->out_size = dst->size;
+    cap->out_framesize = (SDL_AUDIO_BITSIZE(dst->format) / 8) * dst->channels;
+
+    if (src->format != dst->format || src->channels != dst->channels ||
+        src->freq != dst->freq) {
+        chunk = *src;
+        chunk.samples = CAPTURE_CHUNK_FRAMES;
+        chunk.callback = SDL_ReadCaptureSource;
+        chunk.userdata = cap;
+        SDL_CalculateAudioSpec(&chunk);
+        cap->bus = SDL_CreateAudioBus(&chunk, dst);
+        if (cap->bus == NULL) {
+            SDL_FreeAudioCapture(cap);
+            return NULL;
+        }
+
+        /* One converted buffer uses up to its length in device frames, plus
+           one to interpolate from.  The bus decodes a chunk ahead of that,
+           and reads the ring a chunk at a time. */
+        cap->src_needed = (Uint32) (((double) dst->samples * src->freq +
+                                     dst->freq - 1) / dst->freq);
+        cap->src_needed += 2 + 2 * CAPTURE_CHUNK_FRAMES + 1;
+        cap->src_needed *= cap->framesize;
+    } else {
+        cap->src_needed = dst->size;
+    }
+
+    /* Leave room for the reader to fall a few buffers behind */
+    size = SDL_max(src->size * 8, cap->src_needed * 4);
+    cap->ring_size = 1;
+    while (cap->ring_size < size) {
+        cap->ring_size *= 2;
+    }
+    cap->ring = (Uint8 *) SDL_malloc(cap->ring_size);
+    cap->out = (Uint8 *) SDL_malloc(cap->out_size);
+    if (cap->ring == NULL || cap->out == NULL) {
+        SDL_FreeAudioCapture(cap);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    return cap;
+}
+
+int
+SDL_WriteAudioCapture(SDL_AudioCapture * cap, const Uint8 * data, Uint32 len)
+{
+    const Uint32 pos = cap->head & (cap->ring_size - 1);
+    const Uint32 used = cap->head - SDL_LoadCaptureCounter(&cap->tail);
+    Uint32 first;
+
+    if (len > cap->ring_size - used) {
+        /* The reader fell behind.  Drop all of it, to stay frame aligned. */
+        return -1;
+    }
+    first = SDL_min(len, cap->ring_size - pos);
+    SDL_memcpy(cap->ring + pos, data, first);
+    SDL_memcpy(cap->ring, data + first, len - first);
+    SDL_AtomicAddThenFetch32(&cap->head, len);
+    return 0;
+}
+
+/* Convert the next buffer into 'out', if enough has been recorded */
+static SDL_bool
+SDL_RefillAudioCapture(SDL_AudioCapture * cap)
+{
+    if (SDL_CaptureAvailable(cap) < cap->src_needed) {
+        return SDL_FALSE;
+    }
+    if (cap->bus) {
+        SDL_MixAudioBus(cap->bus);
+        SDL_ConvertAudioBus(cap->bus, cap->out);
+    } else {
+        SDL_TakeCaptureFrames(cap, cap->out, cap->out_size);
+    }
+    cap->out_len = cap->out_size;
+    cap->out_pos = 0;
+    return SDL_TRUE;
+}
+
+Uint32
+SDL_ReadAudioCapture(SDL_AudioCapture * cap, Uint8 * data, Uint32 len)
+{
+    Uint32 done = 0;
+    Uint32 amount;
+
+    len -= len % cap->out_framesize;
+    while (done < len) {
+        if (cap->out_pos < cap->out_len) {
+            amount = SDL_min(len - done, cap->out_len - cap->out_pos);
+            SDL_memcpy(data + done, cap->out + cap->out_pos, amount);
+            cap->out_pos += amount;
+        } else if (cap->bus == NULL) {
+            /* Nothing to convert, so there's no need to wait for a buffer */
+            amount = SDL_TakeCaptureFrames(cap, data + done, len - done);
+            if (amount == 0) {
+                break;
+            }
+        } else if (!SDL_RefillAudioCapture(cap)) {
+            break;
+        } else {
+            continue;
+        }
+        done += amount;
+    }
+    return done;
+}
+
+Uint8 *
+SDL_GetAudioCaptureBuffer(SDL_AudioCapture * cap)
+{
+    if (cap->out_pos < cap->out_len || !SDL_RefillAudioCapture(cap)) {
+        return NULL;
+    }
+    cap->out_pos = cap->out_len;
+    return cap->out;
+}
+
+void
+SDL_FreeAudioCapture(SDL_AudioCapture * cap)
+{
+    if (cap) {
+        if (cap->bus) {
+            SDL_FreeAudioBus(cap->bus);
+        }
+        if (cap->ring) {
+            SDL_free(cap->ring);
+        }
+        if (cap->out) {
+            SDL_free(cap->out);
+        }
+        SDL_free(cap);
+    }
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
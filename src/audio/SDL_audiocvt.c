@@ -25,6 +25,7 @@
 
 #include "SDL_audio.h"
 #include "SDL_audio_c.h"
+#include "SDL_cpuinfo.h"
 
 /* #define DEBUG_CONVERT */
 
@@ -806,6 +807,17 @@ SDL_HandTunedTypeCVT(SDL_AudioFormat src_fmt, SDL_AudioFormat dst_fmt)
      *  processor, platform, compiler, or library here.
      */
 
+    /* The autogenerated SSE2 converters, for the most common formats. */
+    if (SDL_HasSSE2()) {
+        int i;
+        for (i = 0; sdl_audio_type_filters_sse2[i].filter != NULL; i++) {
+            const SDL_AudioTypeFilters *filt = &sdl_audio_type_filters_sse2[i];
+            if ((filt->src_fmt == src_fmt) && (filt->dst_fmt == dst_fmt)) {
+                return filt->filter;
+            }
+        }
+    }
+
     return NULL;                /* no specialized converter code available. */
 }
 
@@ -47,6 +47,15 @@
 #define NO_CONVERTERS 0
 #endif
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+/* Byte swap every 16 or 32-bit sample in a vector. */
+#define SSE2_SWAP16(v) _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8))
+#define SSE2_SWAP32(v) \
+    SSE2_SWAP16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xB1), 0xB1))
+#endif
+
 
 /* *INDENT-OFF* */
 
@@ -2190,6 +2199,677 @@ SDL_Convert_F32MSB_to_F32LSB(SDL_AudioCVT * cvt, SDL_AudioFormat format)
     }
 }
 
+#ifdef __SSE2__
+static void SDLCALL
+SDL_Convert_S16LSB_to_S16MSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (Uint16);
+    const int vectors = count - (count % 8);
+    const Uint16 *src = (const Uint16 *) cvt->buf;
+    Sint16 *dst = (Sint16 *) cvt->buf;
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_S16LSB to AUDIO_S16MSB (using SSE2).\n");
+#endif
+
+    for (i = 0; i < vectors; i += 8) {
+        _mm_storeu_si128((__m128i *) (dst + i + 0), SSE2_SWAP16(_mm_loadu_si128((const __m128i *) (src + i + 0))));
+    }
+    for (; i < count; ++i) {
+        const Sint16 val = ((Sint16) SDL_SwapLE16(src[i]));
+        dst[i] = ((Sint16) SDL_SwapBE16(val));
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_S16MSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_S16LSB_to_F32LSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (Uint16);
+    const int vectors = count - (count % 8);
+    const Uint16 *src = (const Uint16 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m128 divby = _mm_set1_ps(DIVBY32767);
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_S16LSB to AUDIO_F32LSB (using SSE2).\n");
+#endif
+
+    for (i = count - 1; i >= vectors; --i) {
+        const float val = (((float) ((Sint16) SDL_SwapLE16(src[i]))) * DIVBY32767);
+        dst[i] = SDL_SwapFloatLE(val);
+    }
+    for (i = vectors - 8; i >= 0; i -= 8) {
+        const __m128i in = _mm_loadu_si128((const __m128i *) (src + i + 0));
+        const __m128 lo = _mm_mul_ps(_mm_cvtepi32_ps(
+            _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16)), divby);
+        const __m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(
+            _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16)), divby);
+        _mm_storeu_si128((__m128i *) (dst + i + 0), _mm_castps_si128(lo));
+        _mm_storeu_si128((__m128i *) (dst + i + 4), _mm_castps_si128(hi));
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_F32LSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_S16LSB_to_F32MSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (Uint16);
+    const int vectors = count - (count % 8);
+    const Uint16 *src = (const Uint16 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m128 divby = _mm_set1_ps(DIVBY32767);
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_S16LSB to AUDIO_F32MSB (using SSE2).\n");
+#endif
+
+    for (i = count - 1; i >= vectors; --i) {
+        const float val = (((float) ((Sint16) SDL_SwapLE16(src[i]))) * DIVBY32767);
+        dst[i] = SDL_SwapFloatBE(val);
+    }
+    for (i = vectors - 8; i >= 0; i -= 8) {
+        const __m128i in = _mm_loadu_si128((const __m128i *) (src + i + 0));
+        const __m128 lo = _mm_mul_ps(_mm_cvtepi32_ps(
+            _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16)), divby);
+        const __m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(
+            _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16)), divby);
+        _mm_storeu_si128((__m128i *) (dst + i + 0), SSE2_SWAP32(_mm_castps_si128(lo)));
+        _mm_storeu_si128((__m128i *) (dst + i + 4), SSE2_SWAP32(_mm_castps_si128(hi)));
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_F32MSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_S16MSB_to_S16LSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (Uint16);
+    const int vectors = count - (count % 8);
+    const Uint16 *src = (const Uint16 *) cvt->buf;
+    Sint16 *dst = (Sint16 *) cvt->buf;
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_S16MSB to AUDIO_S16LSB (using SSE2).\n");
+#endif
+
+    for (i = 0; i < vectors; i += 8) {
+        _mm_storeu_si128((__m128i *) (dst + i + 0), SSE2_SWAP16(_mm_loadu_si128((const __m128i *) (src + i + 0))));
+    }
+    for (; i < count; ++i) {
+        const Sint16 val = ((Sint16) SDL_SwapBE16(src[i]));
+        dst[i] = ((Sint16) SDL_SwapLE16(val));
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_S16LSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_S16MSB_to_F32LSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (Uint16);
+    const int vectors = count - (count % 8);
+    const Uint16 *src = (const Uint16 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m128 divby = _mm_set1_ps(DIVBY32767);
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_S16MSB to AUDIO_F32LSB (using SSE2).\n");
+#endif
+
+    for (i = count - 1; i >= vectors; --i) {
+        const float val = (((float) ((Sint16) SDL_SwapBE16(src[i]))) * DIVBY32767);
+        dst[i] = SDL_SwapFloatLE(val);
+    }
+    for (i = vectors - 8; i >= 0; i -= 8) {
+        const __m128i in = SSE2_SWAP16(_mm_loadu_si128((const __m128i *) (src + i + 0)));
+        const __m128 lo = _mm_mul_ps(_mm_cvtepi32_ps(
+            _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16)), divby);
+        const __m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(
+            _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16)), divby);
+        _mm_storeu_si128((__m128i *) (dst + i + 0), _mm_castps_si128(lo));
+        _mm_storeu_si128((__m128i *) (dst + i + 4), _mm_castps_si128(hi));
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_F32LSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_S16MSB_to_F32MSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (Uint16);
+    const int vectors = count - (count % 8);
+    const Uint16 *src = (const Uint16 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m128 divby = _mm_set1_ps(DIVBY32767);
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_S16MSB to AUDIO_F32MSB (using SSE2).\n");
+#endif
+
+    for (i = count - 1; i >= vectors; --i) {
+        const float val = (((float) ((Sint16) SDL_SwapBE16(src[i]))) * DIVBY32767);
+        dst[i] = SDL_SwapFloatBE(val);
+    }
+    for (i = vectors - 8; i >= 0; i -= 8) {
+        const __m128i in = SSE2_SWAP16(_mm_loadu_si128((const __m128i *) (src + i + 0)));
+        const __m128 lo = _mm_mul_ps(_mm_cvtepi32_ps(
+            _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16)), divby);
+        const __m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(
+            _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16)), divby);
+        _mm_storeu_si128((__m128i *) (dst + i + 0), SSE2_SWAP32(_mm_castps_si128(lo)));
+        _mm_storeu_si128((__m128i *) (dst + i + 4), SSE2_SWAP32(_mm_castps_si128(hi)));
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_F32MSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_S32LSB_to_S32MSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (Uint32);
+    const int vectors = count - (count % 4);
+    const Uint32 *src = (const Uint32 *) cvt->buf;
+    Sint32 *dst = (Sint32 *) cvt->buf;
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_S32LSB to AUDIO_S32MSB (using SSE2).\n");
+#endif
+
+    for (i = 0; i < vectors; i += 4) {
+        _mm_storeu_si128((__m128i *) (dst + i + 0), SSE2_SWAP32(_mm_loadu_si128((const __m128i *) (src + i + 0))));
+    }
+    for (; i < count; ++i) {
+        const Sint32 val = ((Sint32) SDL_SwapLE32(src[i]));
+        dst[i] = ((Sint32) SDL_SwapBE32(val));
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_S32MSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_S32LSB_to_F32LSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (Uint32);
+    const int vectors = count - (count % 4);
+    const Uint32 *src = (const Uint32 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m128 divby = _mm_set1_ps(DIVBY2147483647);
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_S32LSB to AUDIO_F32LSB (using SSE2).\n");
+#endif
+
+    for (i = 0; i < vectors; i += 4) {
+        const __m128 out = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *) (src + i + 0))), divby);
+        _mm_storeu_si128((__m128i *) (dst + i + 0), _mm_castps_si128(out));
+    }
+    for (; i < count; ++i) {
+        const float val = (((float) ((Sint32) SDL_SwapLE32(src[i]))) * DIVBY2147483647);
+        dst[i] = SDL_SwapFloatLE(val);
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_F32LSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_S32LSB_to_F32MSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (Uint32);
+    const int vectors = count - (count % 4);
+    const Uint32 *src = (const Uint32 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m128 divby = _mm_set1_ps(DIVBY2147483647);
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_S32LSB to AUDIO_F32MSB (using SSE2).\n");
+#endif
+
+    for (i = 0; i < vectors; i += 4) {
+        const __m128 out = _mm_mul_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i *) (src + i + 0))), divby);
+        _mm_storeu_si128((__m128i *) (dst + i + 0), SSE2_SWAP32(_mm_castps_si128(out)));
+    }
+    for (; i < count; ++i) {
+        const float val = (((float) ((Sint32) SDL_SwapLE32(src[i]))) * DIVBY2147483647);
+        dst[i] = SDL_SwapFloatBE(val);
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_F32MSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_S32MSB_to_S32LSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (Uint32);
+    const int vectors = count - (count % 4);
+    const Uint32 *src = (const Uint32 *) cvt->buf;
+    Sint32 *dst = (Sint32 *) cvt->buf;
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_S32MSB to AUDIO_S32LSB (using SSE2).\n");
+#endif
+
+    for (i = 0; i < vectors; i += 4) {
+        _mm_storeu_si128((__m128i *) (dst + i + 0), SSE2_SWAP32(_mm_loadu_si128((const __m128i *) (src + i + 0))));
+    }
+    for (; i < count; ++i) {
+        const Sint32 val = ((Sint32) SDL_SwapBE32(src[i]));
+        dst[i] = ((Sint32) SDL_SwapLE32(val));
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_S32LSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_S32MSB_to_F32LSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (Uint32);
+    const int vectors = count - (count % 4);
+    const Uint32 *src = (const Uint32 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m128 divby = _mm_set1_ps(DIVBY2147483647);
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_S32MSB to AUDIO_F32LSB (using SSE2).\n");
+#endif
+
+    for (i = 0; i < vectors; i += 4) {
+        const __m128 out = _mm_mul_ps(_mm_cvtepi32_ps(SSE2_SWAP32(_mm_loadu_si128((const __m128i *) (src + i + 0)))), divby);
+        _mm_storeu_si128((__m128i *) (dst + i + 0), _mm_castps_si128(out));
+    }
+    for (; i < count; ++i) {
+        const float val = (((float) ((Sint32) SDL_SwapBE32(src[i]))) * DIVBY2147483647);
+        dst[i] = SDL_SwapFloatLE(val);
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_F32LSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_S32MSB_to_F32MSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (Uint32);
+    const int vectors = count - (count % 4);
+    const Uint32 *src = (const Uint32 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m128 divby = _mm_set1_ps(DIVBY2147483647);
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_S32MSB to AUDIO_F32MSB (using SSE2).\n");
+#endif
+
+    for (i = 0; i < vectors; i += 4) {
+        const __m128 out = _mm_mul_ps(_mm_cvtepi32_ps(SSE2_SWAP32(_mm_loadu_si128((const __m128i *) (src + i + 0)))), divby);
+        _mm_storeu_si128((__m128i *) (dst + i + 0), SSE2_SWAP32(_mm_castps_si128(out)));
+    }
+    for (; i < count; ++i) {
+        const float val = (((float) ((Sint32) SDL_SwapBE32(src[i]))) * DIVBY2147483647);
+        dst[i] = SDL_SwapFloatBE(val);
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_F32MSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32LSB_to_S16LSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (float);
+    const int vectors = count - (count % 8);
+    const float *src = (const float *) cvt->buf;
+    Sint16 *dst = (Sint16 *) cvt->buf;
+    const __m128 mult = _mm_set1_ps(32767.0f);
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_F32LSB to AUDIO_S16LSB (using SSE2).\n");
+#endif
+
+    for (i = 0; i < vectors; i += 8) {
+        const __m128 lo = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) (src + i + 0)));
+        const __m128 hi = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) (src + i + 4)));
+        const __m128i out =
+            _mm_packs_epi32(_mm_cvttps_epi32(_mm_mul_ps(lo, mult)),
+                            _mm_cvttps_epi32(_mm_mul_ps(hi, mult)));
+        _mm_storeu_si128((__m128i *) (dst + i + 0), out);
+    }
+    for (; i < count; ++i) {
+        const Sint16 val = ((Sint16) (SDL_SwapFloatLE(src[i]) * 32767.0f));
+        dst[i] = ((Sint16) SDL_SwapLE16(val));
+    }
+
+    cvt->len_cvt /= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_S16LSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32LSB_to_S16MSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (float);
+    const int vectors = count - (count % 8);
+    const float *src = (const float *) cvt->buf;
+    Sint16 *dst = (Sint16 *) cvt->buf;
+    const __m128 mult = _mm_set1_ps(32767.0f);
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_F32LSB to AUDIO_S16MSB (using SSE2).\n");
+#endif
+
+    for (i = 0; i < vectors; i += 8) {
+        const __m128 lo = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) (src + i + 0)));
+        const __m128 hi = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) (src + i + 4)));
+        const __m128i out =
+            _mm_packs_epi32(_mm_cvttps_epi32(_mm_mul_ps(lo, mult)),
+                            _mm_cvttps_epi32(_mm_mul_ps(hi, mult)));
+        _mm_storeu_si128((__m128i *) (dst + i + 0), SSE2_SWAP16(out));
+    }
+    for (; i < count; ++i) {
+        const Sint16 val = ((Sint16) (SDL_SwapFloatLE(src[i]) * 32767.0f));
+        dst[i] = ((Sint16) SDL_SwapBE16(val));
+    }
+
+    cvt->len_cvt /= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_S16MSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32LSB_to_S32LSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (float);
+    const int vectors = count - (count % 4);
+    const float *src = (const float *) cvt->buf;
+    Sint32 *dst = (Sint32 *) cvt->buf;
+    const __m128d mult = _mm_set1_pd(2147483647.0);
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_F32LSB to AUDIO_S32LSB (using SSE2).\n");
+#endif
+
+    for (i = 0; i < vectors; i += 4) {
+        const __m128 in = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) (src + i + 0)));
+        const __m128i lo =
+            _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtps_pd(in), mult));
+        const __m128i hi = _mm_cvttpd_epi32(
+            _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(in, in)), mult));
+        const __m128i out = _mm_unpacklo_epi64(lo, hi);
+        _mm_storeu_si128((__m128i *) (dst + i + 0), out);
+    }
+    for (; i < count; ++i) {
+        const Sint32 val = ((Sint32) (SDL_SwapFloatLE(src[i]) * 2147483647.0));
+        dst[i] = ((Sint32) SDL_SwapLE32(val));
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_S32LSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32LSB_to_S32MSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (float);
+    const int vectors = count - (count % 4);
+    const float *src = (const float *) cvt->buf;
+    Sint32 *dst = (Sint32 *) cvt->buf;
+    const __m128d mult = _mm_set1_pd(2147483647.0);
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_F32LSB to AUDIO_S32MSB (using SSE2).\n");
+#endif
+
+    for (i = 0; i < vectors; i += 4) {
+        const __m128 in = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *) (src + i + 0)));
+        const __m128i lo =
+            _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtps_pd(in), mult));
+        const __m128i hi = _mm_cvttpd_epi32(
+            _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(in, in)), mult));
+        const __m128i out = _mm_unpacklo_epi64(lo, hi);
+        _mm_storeu_si128((__m128i *) (dst + i + 0), SSE2_SWAP32(out));
+    }
+    for (; i < count; ++i) {
+        const Sint32 val = ((Sint32) (SDL_SwapFloatLE(src[i]) * 2147483647.0));
+        dst[i] = ((Sint32) SDL_SwapBE32(val));
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_S32MSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32LSB_to_F32MSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (float);
+    const int vectors = count - (count % 4);
+    const float *src = (const float *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_F32LSB to AUDIO_F32MSB (using SSE2).\n");
+#endif
+
+    for (i = 0; i < vectors; i += 4) {
+        _mm_storeu_si128((__m128i *) (dst + i + 0), SSE2_SWAP32(_mm_castps_si128(_mm_castsi128_ps(_mm_loadu_si128((const __m128i *) (src + i + 0))))));
+    }
+    for (; i < count; ++i) {
+        const float val = SDL_SwapFloatLE(src[i]);
+        dst[i] = SDL_SwapFloatBE(val);
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_F32MSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32MSB_to_S16LSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (float);
+    const int vectors = count - (count % 8);
+    const float *src = (const float *) cvt->buf;
+    Sint16 *dst = (Sint16 *) cvt->buf;
+    const __m128 mult = _mm_set1_ps(32767.0f);
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_F32MSB to AUDIO_S16LSB (using SSE2).\n");
+#endif
+
+    for (i = 0; i < vectors; i += 8) {
+        const __m128 lo = _mm_castsi128_ps(SSE2_SWAP32(_mm_loadu_si128((const __m128i *) (src + i + 0))));
+        const __m128 hi = _mm_castsi128_ps(SSE2_SWAP32(_mm_loadu_si128((const __m128i *) (src + i + 4))));
+        const __m128i out =
+            _mm_packs_epi32(_mm_cvttps_epi32(_mm_mul_ps(lo, mult)),
+                            _mm_cvttps_epi32(_mm_mul_ps(hi, mult)));
+        _mm_storeu_si128((__m128i *) (dst + i + 0), out);
+    }
+    for (; i < count; ++i) {
+        const Sint16 val = ((Sint16) (SDL_SwapFloatBE(src[i]) * 32767.0f));
+        dst[i] = ((Sint16) SDL_SwapLE16(val));
+    }
+
+    cvt->len_cvt /= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_S16LSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32MSB_to_S16MSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (float);
+    const int vectors = count - (count % 8);
+    const float *src = (const float *) cvt->buf;
+    Sint16 *dst = (Sint16 *) cvt->buf;
+    const __m128 mult = _mm_set1_ps(32767.0f);
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_F32MSB to AUDIO_S16MSB (using SSE2).\n");
+#endif
+
+    for (i = 0; i < vectors; i += 8) {
+        const __m128 lo = _mm_castsi128_ps(SSE2_SWAP32(_mm_loadu_si128((const __m128i *) (src + i + 0))));
+        const __m128 hi = _mm_castsi128_ps(SSE2_SWAP32(_mm_loadu_si128((const __m128i *) (src + i + 4))));
+        const __m128i out =
+            _mm_packs_epi32(_mm_cvttps_epi32(_mm_mul_ps(lo, mult)),
+                            _mm_cvttps_epi32(_mm_mul_ps(hi, mult)));
+        _mm_storeu_si128((__m128i *) (dst + i + 0), SSE2_SWAP16(out));
+    }
+    for (; i < count; ++i) {
+        const Sint16 val = ((Sint16) (SDL_SwapFloatBE(src[i]) * 32767.0f));
+        dst[i] = ((Sint16) SDL_SwapBE16(val));
+    }
+
+    cvt->len_cvt /= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_S16MSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32MSB_to_S32LSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (float);
+    const int vectors = count - (count % 4);
+    const float *src = (const float *) cvt->buf;
+    Sint32 *dst = (Sint32 *) cvt->buf;
+    const __m128d mult = _mm_set1_pd(2147483647.0);
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_F32MSB to AUDIO_S32LSB (using SSE2).\n");
+#endif
+
+    for (i = 0; i < vectors; i += 4) {
+        const __m128 in = _mm_castsi128_ps(SSE2_SWAP32(_mm_loadu_si128((const __m128i *) (src + i + 0))));
+        const __m128i lo =
+            _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtps_pd(in), mult));
+        const __m128i hi = _mm_cvttpd_epi32(
+            _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(in, in)), mult));
+        const __m128i out = _mm_unpacklo_epi64(lo, hi);
+        _mm_storeu_si128((__m128i *) (dst + i + 0), out);
+    }
+    for (; i < count; ++i) {
+        const Sint32 val = ((Sint32) (SDL_SwapFloatBE(src[i]) * 2147483647.0));
+        dst[i] = ((Sint32) SDL_SwapLE32(val));
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_S32LSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32MSB_to_S32MSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (float);
+    const int vectors = count - (count % 4);
+    const float *src = (const float *) cvt->buf;
+    Sint32 *dst = (Sint32 *) cvt->buf;
+    const __m128d mult = _mm_set1_pd(2147483647.0);
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_F32MSB to AUDIO_S32MSB (using SSE2).\n");
+#endif
+
+    for (i = 0; i < vectors; i += 4) {
+        const __m128 in = _mm_castsi128_ps(SSE2_SWAP32(_mm_loadu_si128((const __m128i *) (src + i + 0))));
+        const __m128i lo =
+            _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtps_pd(in), mult));
+        const __m128i hi = _mm_cvttpd_epi32(
+            _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(in, in)), mult));
+        const __m128i out = _mm_unpacklo_epi64(lo, hi);
+        _mm_storeu_si128((__m128i *) (dst + i + 0), SSE2_SWAP32(out));
+    }
+    for (; i < count; ++i) {
+        const Sint32 val = ((Sint32) (SDL_SwapFloatBE(src[i]) * 2147483647.0));
+        dst[i] = ((Sint32) SDL_SwapBE32(val));
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_S32MSB);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32MSB_to_F32LSB_SSE2(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof (float);
+    const int vectors = count - (count % 4);
+    const float *src = (const float *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_F32MSB to AUDIO_F32LSB (using SSE2).\n");
+#endif
+
+    for (i = 0; i < vectors; i += 4) {
+        _mm_storeu_si128((__m128i *) (dst + i + 0), _mm_castps_si128(_mm_castsi128_ps(SSE2_SWAP32(_mm_loadu_si128((const __m128i *) (src + i + 0))))));
+    }
+    for (; i < count; ++i) {
+        const float val = SDL_SwapFloatBE(src[i]);
+        dst[i] = SDL_SwapFloatLE(val);
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_F32LSB);
+    }
+}
+
+#endif  /* __SSE2__ */
+
 #endif  /* !NO_CONVERTERS */
 
 
@@ -2290,6 +2970,35 @@ const SDL_AudioTypeFilters sdl_audio_type_filters[] =
     { 0, 0, NULL }
 };
 
+const SDL_AudioTypeFilters sdl_audio_type_filters_sse2[] =
+{
+#if !NO_CONVERTERS && defined(__SSE2__)
+    { AUDIO_S16LSB, AUDIO_S16MSB, SDL_Convert_S16LSB_to_S16MSB_SSE2 },
+    { AUDIO_S16LSB, AUDIO_F32LSB, SDL_Convert_S16LSB_to_F32LSB_SSE2 },
+    { AUDIO_S16LSB, AUDIO_F32MSB, SDL_Convert_S16LSB_to_F32MSB_SSE2 },
+    { AUDIO_S16MSB, AUDIO_S16LSB, SDL_Convert_S16MSB_to_S16LSB_SSE2 },
+    { AUDIO_S16MSB, AUDIO_F32LSB, SDL_Convert_S16MSB_to_F32LSB_SSE2 },
+    { AUDIO_S16MSB, AUDIO_F32MSB, SDL_Convert_S16MSB_to_F32MSB_SSE2 },
+    { AUDIO_S32LSB, AUDIO_S32MSB, SDL_Convert_S32LSB_to_S32MSB_SSE2 },
+    { AUDIO_S32LSB, AUDIO_F32LSB, SDL_Convert_S32LSB_to_F32LSB_SSE2 },
+    { AUDIO_S32LSB, AUDIO_F32MSB, SDL_Convert_S32LSB_to_F32MSB_SSE2 },
+    { AUDIO_S32MSB, AUDIO_S32LSB, SDL_Convert_S32MSB_to_S32LSB_SSE2 },
+    { AUDIO_S32MSB, AUDIO_F32LSB, SDL_Convert_S32MSB_to_F32LSB_SSE2 },
+    { AUDIO_S32MSB, AUDIO_F32MSB, SDL_Convert_S32MSB_to_F32MSB_SSE2 },
+    { AUDIO_F32LSB, AUDIO_S16LSB, SDL_Convert_F32LSB_to_S16LSB_SSE2 },
+    { AUDIO_F32LSB, AUDIO_S16MSB, SDL_Convert_F32LSB_to_S16MSB_SSE2 },
+    { AUDIO_F32LSB, AUDIO_S32LSB, SDL_Convert_F32LSB_to_S32LSB_SSE2 },
+    { AUDIO_F32LSB, AUDIO_S32MSB, SDL_Convert_F32LSB_to_S32MSB_SSE2 },
+    { AUDIO_F32LSB, AUDIO_F32MSB, SDL_Convert_F32LSB_to_F32MSB_SSE2 },
+    { AUDIO_F32MSB, AUDIO_S16LSB, SDL_Convert_F32MSB_to_S16LSB_SSE2 },
+    { AUDIO_F32MSB, AUDIO_S16MSB, SDL_Convert_F32MSB_to_S16MSB_SSE2 },
+    { AUDIO_F32MSB, AUDIO_S32LSB, SDL_Convert_F32MSB_to_S32LSB_SSE2 },
+    { AUDIO_F32MSB, AUDIO_S32MSB, SDL_Convert_F32MSB_to_S32MSB_SSE2 },
+    { AUDIO_F32MSB, AUDIO_F32LSB, SDL_Convert_F32MSB_to_F32LSB_SSE2 },
+#endif  /* !NO_CONVERTERS && __SSE2__ */
+    { 0, 0, NULL }
+};
+
 
 #if !NO_RESAMPLERS
 
@@ -16209,7 +16918,7 @@ const SDL_AudioRateFilters sdl_audio_rate_filters[] =
     { 0, 0, 0, 0, NULL }
 };
 
-/* 390 converters generated. */
+/* 412 converters generated. */
 
 /* *INDENT-ON* */
 
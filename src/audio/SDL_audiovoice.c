@@ -0,0 +1,409 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2010 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* The voice mixer, which plays clips on top of the callback's audio.
+
+   Clips are converted once to float at the device rate, so a voice is just
+   a position in a clip and a gain for each device channel.  The voices are
+   added straight into the float bus a block at a time, so the block being
+   mixed stays in the cache however many voices are playing.
+ */
+
+#include "SDL_audio.h"
+#include "SDL_audio_c.h"
+
+/* Output frames mixed for all voices at a time */
+#define VOICE_BLOCK_FRAMES  256
+
+/* Frames converted at a time when creating a clip */
+#define CLIP_CONVERT_FRAMES 1024
+
+struct SDL_AudioClip
+{
+    SDL_AudioDeviceID dev;
+    int freq;
+    int channels;
+    Uint32 frames;
+    float *data;                /* One row of 'frames' samples per channel */
+};
+
+typedef struct
+{
+    SDL_AudioVoiceID id;
+    SDL_AudioClip *clip;
+    Uint32 pos;
+    int loops;
+
+    /* Gain of each clip channel in each of the first two device channels */
+    float gain[2][2];
+} SDL_AudioVoice;
+
+struct SDL_AudioVoiceMixer
+{
+    int channels;
+    int samples;
+    SDL_AudioVoiceID next_id;
+    SDL_AudioVoice *voices;
+    int num_voices;
+    int max_voices;
+};
+
+
+/* Reads a clip's source data for the bus, with silence after the end */
+typedef struct
+{
+    const Uint8 *buf;
+    Uint32 len;
+    Uint32 pos;
+    Uint8 silence;
+} SDL_ClipSource;
+
+static void SDLCALL
+SDL_ReadClipSource(void *userdata, Uint8 * stream, int len)
+{
+    SDL_ClipSource *source = (SDL_ClipSource *) userdata;
+    Uint32 amount = SDL_min((Uint32) len, source->len - source->pos);
+
+    SDL_memcpy(stream, source->buf + source->pos, amount);
+    SDL_memset(stream + amount, source->silence, len - amount);
+    source->pos += amount;
+}
+
+SDL_AudioClip *
+SDL_ConvertAudioClip(SDL_AudioDeviceID dev, const SDL_AudioSpec * spec,
+                     const Uint8 * buf, Uint32 len, int freq)
+{
+    SDL_AudioSpec src, dst;
+    SDL_ClipSource source;
+    SDL_AudioClip *clip;
+    SDL_AudioBus *bus;
+    Uint32 framesize, frames, i;
+    int c;
+
+    if (spec->channels == 0 || spec->freq <= 0) {
+        SDL_SetError("Invalid clip format");
+        return NULL;
+    }
+    switch (spec->format) {
+    case AUDIO_U8:
+    case AUDIO_S8:
+    case AUDIO_U16LSB:
+    case AUDIO_U16MSB:
+    case AUDIO_S16LSB:
+    case AUDIO_S16MSB:
+    case AUDIO_S32LSB:
+    case AUDIO_S32MSB:
+    case AUDIO_F32LSB:
+    case AUDIO_F32MSB:
+        break;
+    default:
+        SDL_SetError("Unsupported clip format");
+        return NULL;
+    }
+    framesize = (SDL_AUDIO_BITSIZE(spec->format) / 8) * spec->channels;
+    frames = len / framesize;
+    if (frames == 0) {
+        SDL_SetError("Audio clip is empty");
+        return NULL;
+    }
+
+    clip = (SDL_AudioClip *) SDL_calloc(1, sizeof(*clip));
+    if (clip == NULL) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    clip->dev = dev;
+    clip->freq = freq;
+    clip->channels = (spec->channels == 1) ? 1 : 2;
+    clip->frames = (Uint32) (((double) frames * freq) / spec->freq);
+    if (clip->frames == 0) {
+        clip->frames = 1;
+    }
+    clip->data =
+        (float *) SDL_malloc(clip->frames * clip->channels * sizeof(float));
+    if (clip->data == NULL) {
+        SDL_free(clip);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    /* Run the data through a bus to convert and resample it */
+    source.buf = buf;
+    source.len = frames * framesize;
+    source.pos = 0;
+    source.silence = (spec->format == AUDIO_U8) ? 0x80 : 0;
+
+    src = *spec;
+    src.samples = CLIP_CONVERT_FRAMES;
+    src.callback = SDL_ReadClipSource;
+    src.userdata = &source;
+    SDL_CalculateAudioSpec(&src);
+    dst = src;
+    dst.format = AUDIO_F32SYS;
+    dst.channels = clip->channels;
+    dst.freq = freq;
+    SDL_CalculateAudioSpec(&dst);
+
+    bus = SDL_CreateAudioBus(&src, &dst);
+    if (bus == NULL) {
+        SDL_FreeAudioClipData(clip);
+        return NULL;
+    }
+    for (i = 0; i < clip->frames; i += CLIP_CONVERT_FRAMES) {
+        const Uint32 count = SDL_min(CLIP_CONVERT_FRAMES, clip->frames - i);
+        SDL_MixAudioBus(bus);
+        for (c = 0; c < clip->channels; ++c) {
+            SDL_memcpy(clip->data + c * clip->frames + i,
+                       SDL_GetAudioBusPlane(bus, c), count * sizeof(float));
+        }
+    }
+    SDL_FreeAudioBus(bus);
+    return clip;
+}
+
+SDL_AudioDeviceID
+SDL_GetAudioClipDevice(SDL_AudioClip * clip)
+{
+    return clip->dev;
+}
+
+void
+SDL_FreeAudioClipData(SDL_AudioClip * clip)
+{
+    if (clip->data) {
+        SDL_free(clip->data);
+    }
+    SDL_free(clip);
+}
+
+SDL_AudioVoiceMixer *
+SDL_CreateAudioVoiceMixer(const SDL_AudioSpec * spec)
+{
+    SDL_AudioVoiceMixer *mixer;
+
+    mixer = (SDL_AudioVoiceMixer *) SDL_calloc(1, sizeof(*mixer));
+    if (mixer == NULL) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    mixer->channels = spec->channels;
+    mixer->samples = spec->samples;
+    mixer->next_id = 1;
+    return mixer;
+}
+
+static SDL_AudioVoice *
+SDL_FindAudioVoice(SDL_AudioVoiceMixer * mixer, SDL_AudioVoiceID id)
+{
+    int i;
+
+    for (i = 0; i < mixer->num_voices; ++i) {
+        if (mixer->voices[i].id == id) {
+            return &mixer->voices[i];
+        }
+    }
+    return NULL;
+}
+
+/* Balance between the left and right channels, full volume in the center */
+static void
+SDL_SetAudioVoiceGain(SDL_AudioVoiceMixer * mixer, SDL_AudioVoice * voice,
+                      int volume, int pan)
+{
+    const float gain = (float) SDL_max(0, SDL_min(volume, SDL_MIX_MAXVOLUME))
+        / SDL_MIX_MAXVOLUME;
+    const float balance = (float) SDL_max(-SDL_MIX_MAXVOLUME,
+                                          SDL_min(pan, SDL_MIX_MAXVOLUME))
+        / SDL_MIX_MAXVOLUME;
+    const float left = gain * SDL_min(1.0f, 1.0f - balance);
+    const float right = gain * SDL_min(1.0f, 1.0f + balance);
+
+    SDL_memset(voice->gain, 0, sizeof(voice->gain));
+    if (mixer->channels == 1) {
+        /* Pan doesn't mean anything in mono */
+        if (voice->clip->channels == 1) {
+            voice->gain[0][0] = gain;
+        } else {
+            voice->gain[0][0] = voice->gain[0][1] = gain * 0.5f;
+        }
+    } else if (voice->clip->channels == 1) {
+        voice->gain[0][0] = left;
+        voice->gain[1][0] = right;
+    } else {
+        voice->gain[0][0] = left;
+        voice->gain[1][1] = right;
+    }
+}
+
+SDL_AudioVoiceID
+SDL_AddAudioVoice(SDL_AudioVoiceMixer * mixer, SDL_AudioClip * clip,
+                  int loops, int volume, int pan)
+{
+    SDL_AudioVoice *voice;
+
+    if (mixer->num_voices == mixer->max_voices) {
+        const int max = mixer->max_voices ? mixer->max_voices * 2 : 32;
+        SDL_AudioVoice *voices = (SDL_AudioVoice *)
+            SDL_realloc(mixer->voices, max * sizeof(*voices));
+        if (voices == NULL) {
+            SDL_OutOfMemory();
+            return 0;
+        }
+        mixer->voices = voices;
+        mixer->max_voices = max;
+    }
+
+    voice = &mixer->voices[mixer->num_voices++];
+    voice->id = mixer->next_id++;
+    if (mixer->next_id == 0) {
+        mixer->next_id = 1;
+    }
+    voice->clip = clip;
+    voice->pos = 0;
+    voice->loops = loops;
+    SDL_SetAudioVoiceGain(mixer, voice, volume, pan);
+    return voice->id;
+}
+
+int
+SDL_SetAudioVoice(SDL_AudioVoiceMixer * mixer, SDL_AudioVoiceID id,
+                  int volume, int pan)
+{
+    SDL_AudioVoice *voice = SDL_FindAudioVoice(mixer, id);
+
+    if (voice == NULL) {
+        SDL_SetError("Audio voice isn't playing");
+        return -1;
+    }
+    SDL_SetAudioVoiceGain(mixer, voice, volume, pan);
+    return 0;
+}
+
+static void
+SDL_DeleteAudioVoice(SDL_AudioVoiceMixer * mixer, int index)
+{
+    mixer->voices[index] = mixer->voices[--mixer->num_voices];
+}
+
+int
+SDL_RemoveAudioVoice(SDL_AudioVoiceMixer * mixer, SDL_AudioVoiceID id)
+{
+    SDL_AudioVoice *voice = SDL_FindAudioVoice(mixer, id);
+
+    if (voice == NULL) {
+        SDL_SetError("Audio voice isn't playing");
+        return -1;
+    }
+    SDL_DeleteAudioVoice(mixer, (int) (voice - mixer->voices));
+    return 0;
+}
+
+SDL_bool
+SDL_HasAudioVoice(SDL_AudioVoiceMixer * mixer, SDL_AudioVoiceID id)
+{
+    return SDL_FindAudioVoice(mixer, id) ? SDL_TRUE : SDL_FALSE;
+}
+
+void
+SDL_RemoveAudioClipVoices(SDL_AudioVoiceMixer * mixer, SDL_AudioClip * clip)
+{
+    int i;
+
+    for (i = 0; i < mixer->num_voices; ++i) {
+        if (mixer->voices[i].clip == clip) {
+            SDL_DeleteAudioVoice(mixer, i--);
+        }
+    }
+}
+
+/* Add up to 'count' frames of a voice to the bus, returning SDL_FALSE once
+   it has finished */
+static SDL_bool
+SDL_MixAudioVoice(SDL_AudioVoiceMixer * mixer, SDL_AudioBus * bus,
+                  SDL_AudioVoice * voice, int offset, int count, float volume)
+{
+    const SDL_AudioClip *clip = voice->clip;
+    const int channels = SDL_min(mixer->channels, 2);
+    int d, c;
+
+    while (count > 0) {
+        const int n = (int) SDL_min((Uint32) count, clip->frames - voice->pos);
+
+        for (d = 0; d < channels; ++d) {
+            float *out = SDL_GetAudioBusPlane(bus, d) + offset;
+            for (c = 0; c < clip->channels; ++c) {
+                if (voice->gain[d][c] != 0.0f) {
+                    SDL_ScaleAudioBusSamples(bus, out,
+                                             clip->data + c * clip->frames +
+                                             voice->pos,
+                                             voice->gain[d][c] * volume, n,
+                                             SDL_TRUE);
+                }
+            }
+        }
+
+        voice->pos += n;
+        offset += n;
+        count -= n;
+        if (voice->pos == clip->frames) {
+            if (voice->loops == 0) {
+                return SDL_FALSE;
+            }
+            if (voice->loops > 0) {
+                --voice->loops;
+            }
+            voice->pos = 0;
+        }
+    }
+    return SDL_TRUE;
+}
+
+void
+SDL_MixAudioVoices(SDL_AudioVoiceMixer * mixer, SDL_AudioBus * bus)
+{
+    const float volume = SDL_GetAudioBusVolume(bus);
+    int i, v;
+
+    for (i = 0; i < mixer->samples; i += VOICE_BLOCK_FRAMES) {
+        const int count = SDL_min(VOICE_BLOCK_FRAMES, mixer->samples - i);
+        for (v = 0; v < mixer->num_voices; ++v) {
+            if (!SDL_MixAudioVoice(mixer, bus, &mixer->voices[v], i, count,
+                                   volume)) {
+                SDL_DeleteAudioVoice(mixer, v--);
+            }
+        }
+    }
+}
+
+void
+SDL_FreeAudioVoiceMixer(SDL_AudioVoiceMixer * mixer)
+{
+    if (mixer) {
+        if (mixer->voices) {
+            SDL_free(mixer->voices);
+        }
+        SDL_free(mixer);
+    }
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -44,10 +44,18 @@ typedef struct SDL_AudioDriverImpl
     void (*CloseDevice) (_THIS);
     void (*LockDevice) (_THIS);
     void (*UnlockDevice) (_THIS);
+    /* The core fills in its own counters, and the driver where playback
+       is.  Drivers that count the frames better can replace them. */
+    int (*GetDeviceClock) (_THIS, SDL_AudioClock * clock);
+    /* Read recorded audio into buffer, returning the bytes read.  Drivers
+       without it have no capture pipeline in the core audio thread. */
+    int (*CaptureFromDevice) (_THIS, Uint8 * buffer, int buflen);
     void (*Deinitialize) (void);
 
     /* Some flags to push duplicate code into the core and reduce #ifdefs. */
     int ProvidesOwnCallbackThread:1;
+    int UsesFillAudioDevice:1;  /* own thread calls SDL_FillAudioDevice()
+                                   and SDL_CaptureAudioDevice() */
     int SkipMixerLock:1;
     int HasCaptureSupport:1;
     int OnlyHasDefaultOutputDevice:1;
@@ -87,9 +95,21 @@ struct SDL_AudioDevice
     /* The current audio specification (shared with audio thread) */
     SDL_AudioSpec spec;
 
+    /* The format the application's callback works in */
+    SDL_AudioSpec callbackspec;
+
     /* An audio conversion block for audio format emulation */
     SDL_AudioCVT convert;
 
+    /* The float mixing bus, used instead of convert when set */
+    struct SDL_AudioBus *bus;
+
+    /* Clips playing on top of the callback, mixed on the bus */
+    struct SDL_AudioVoiceMixer *voices;
+
+    /* Recorded audio waiting to be converted for the application */
+    struct SDL_AudioCapture *capture;
+
     /* The streamer, if sample rate conversion necessitates it */
     int use_streamer;
     SDL_AudioStreamer streamer;
@@ -100,6 +120,17 @@ struct SDL_AudioDevice
     int paused;
     int opened;
 
+    /* Times the hardware ran out of audio to play, or recorded audio was
+       dropped because the application didn't read it in time */
+    Uint32 underruns;
+
+    /* Frames given to or recorded by the device */
+    Uint64 frames_submitted;
+
+    /* Milliseconds spent in the application's callback */
+    Uint32 callback_ticks;
+    Uint32 callback_max_ticks;
+
     /* Fake audio buffer for when the audio hardware is busy */
     Uint8 *fake_stream;
 
@@ -116,6 +147,34 @@ struct SDL_AudioDevice
 };
 #undef _THIS
 
+/* Fill a device buffer from the application's callback, converting and
+   mixing as needed.  The core audio thread uses this, and so can drivers
+   that provide their own callback thread. */
+extern void SDL_FillAudioDevice(SDL_AudioDevice * device, Uint8 * stream);
+
+/* Pass audio recorded by the device on to the application.  The core audio
+   thread uses this, and so can drivers that provide their own thread. */
+extern void SDL_CaptureAudioDevice(SDL_AudioDevice * device,
+                                   const Uint8 * data, int len);
+
+/* Keeps time for drivers with no hardware to do it, at any multiple of real
+   time.  A speed of 0 runs as fast as the application can keep up. */
+typedef struct SDL_AudioVirtualClock
+{
+    double speed;
+    int freq;
+    Uint32 start;               /* SDL_GetTicks() when frame 0 was due */
+    Uint64 frames;              /* Frames handed over so far */
+} SDL_AudioVirtualClock;
+
+extern void SDL_StartAudioVirtualClock(SDL_AudioVirtualClock * clock,
+                                       int freq, double speed);
+/* Hand over 'frames' more frames, and wait until they're due */
+extern void SDL_WaitAudioVirtualClock(SDL_AudioVirtualClock * clock,
+                                      int frames);
+/* The frames that have had time to play */
+extern Uint64 SDL_GetAudioVirtualClockFrames(SDL_AudioVirtualClock * clock);
+
 typedef struct AudioBootStrap
 {
     const char *name;
@@ -24,9 +24,17 @@
 /* Microsoft WAVE file loading routines */
 
 #include "SDL_audio.h"
+#include "SDL_thread.h"
+#include "SDL_cpuinfo.h"
 #include "SDL_wave.h"
 
+/* Files are decoded on several threads, each getting at least this many
+   ADPCM blocks */
+#define WAVE_THREAD_BLOCKS  64
+#define WAVE_MAX_THREADS    16
 
+
+static int ReadChunkHeader(SDL_RWops * src, Chunk * chunk);
 static int ReadChunk(SDL_RWops * src, Chunk * chunk);
 
 struct MS_ADPCM_decodestate
@@ -36,63 +44,58 @@ struct MS_ADPCM_decodestate
     Sint16 iSamp1;
     Sint16 iSamp2;
 };
-static struct MS_ADPCM_decoder
+struct MS_ADPCM_decoder
 {
-    WaveFMT wavefmt;
     Uint16 wSamplesPerBlock;
     Uint16 wNumCoef;
     Sint16 aCoeff[7][2];
     /* * * */
     struct MS_ADPCM_decodestate state[2];
-} MS_ADPCM_state;
+};
 
 static int
-InitMS_ADPCM(WaveFMT * format)
+InitMS_ADPCM(struct MS_ADPCM_decoder *decoder, WaveFMT * format,
+             Uint32 fmtlen)
 {
     Uint8 *rogue_feel;
-    Uint16 extra_info;
     int i;
 
-    /* Set the rogue pointer to the MS_ADPCM specific data */
-    MS_ADPCM_state.wavefmt.encoding = SDL_SwapLE16(format->encoding);
-    MS_ADPCM_state.wavefmt.channels = SDL_SwapLE16(format->channels);
-    MS_ADPCM_state.wavefmt.frequency = SDL_SwapLE32(format->frequency);
-    MS_ADPCM_state.wavefmt.byterate = SDL_SwapLE32(format->byterate);
-    MS_ADPCM_state.wavefmt.blockalign = SDL_SwapLE16(format->blockalign);
-    MS_ADPCM_state.wavefmt.bitspersample =
-        SDL_SwapLE16(format->bitspersample);
-    rogue_feel = (Uint8 *) format + sizeof(*format);
-    if (sizeof(*format) == 16) {
-        extra_info = ((rogue_feel[1] << 8) | rogue_feel[0]);
-        rogue_feel += sizeof(Uint16);
+    if (fmtlen < sizeof(*format) + 3 * sizeof(Uint16) + 7 * 2 * sizeof(Uint16)) {
+        SDL_SetError("MS ADPCM format chunk too small");
+        return (-1);
     }
-    MS_ADPCM_state.wSamplesPerBlock = ((rogue_feel[1] << 8) | rogue_feel[0]);
+
+    /* Set the rogue pointer to the MS_ADPCM specific data,
+       after the size of the extra information */
+    rogue_feel = (Uint8 *) format + sizeof(*format) + sizeof(Uint16);
+    decoder->wSamplesPerBlock = ((rogue_feel[1] << 8) | rogue_feel[0]);
     rogue_feel += sizeof(Uint16);
-    MS_ADPCM_state.wNumCoef = ((rogue_feel[1] << 8) | rogue_feel[0]);
+    decoder->wNumCoef = ((rogue_feel[1] << 8) | rogue_feel[0]);
     rogue_feel += sizeof(Uint16);
-    if (MS_ADPCM_state.wNumCoef != 7) {
+    if (decoder->wNumCoef != 7) {
         SDL_SetError("Unknown set of MS_ADPCM coefficients");
         return (-1);
     }
-    for (i = 0; i < MS_ADPCM_state.wNumCoef; ++i) {
-        MS_ADPCM_state.aCoeff[i][0] = ((rogue_feel[1] << 8) | rogue_feel[0]);
+    for (i = 0; i < decoder->wNumCoef; ++i) {
+        decoder->aCoeff[i][0] = ((rogue_feel[1] << 8) | rogue_feel[0]);
         rogue_feel += sizeof(Uint16);
-        MS_ADPCM_state.aCoeff[i][1] = ((rogue_feel[1] << 8) | rogue_feel[0]);
+        decoder->aCoeff[i][1] = ((rogue_feel[1] << 8) | rogue_feel[0]);
         rogue_feel += sizeof(Uint16);
     }
     return (0);
 }
 
+static const Sint32 MS_ADPCM_adaptive[16] = {
+    230, 230, 230, 230, 307, 409, 512, 614,
+    768, 614, 512, 409, 307, 230, 230, 230
+};
+
 static Sint32
 MS_ADPCM_nibble(struct MS_ADPCM_decodestate *state,
                 Uint8 nybble, Sint16 * coeff)
 {
     const Sint32 max_audioval = ((1 << (16 - 1)) - 1);
     const Sint32 min_audioval = -(1 << (16 - 1));
-    const Sint32 adaptive[] = {
-        230, 230, 230, 230, 307, 409, 512, 614,
-        768, 614, 512, 409, 307, 230, 230, 230
-    };
     Sint32 new_sample, delta;
 
     new_sample = ((state->iSamp1 * coeff[0]) +
@@ -107,7 +110,7 @@ MS_ADPCM_nibble(struct MS_ADPCM_decodestate *state,
     } else if (new_sample > max_audioval) {
         new_sample = max_audioval;
     }
-    delta = ((Sint32) state->iDelta * adaptive[nybble]) / 256;
+    delta = ((Sint32) state->iDelta * MS_ADPCM_adaptive[nybble]) / 256;
     if (delta < 16) {
         delta = 16;
     }
@@ -117,103 +120,55 @@ MS_ADPCM_nibble(struct MS_ADPCM_decodestate *state,
     return (new_sample);
 }
 
+/* Decode a block of wSamplesPerBlock frames */
 static int
-MS_ADPCM_decode(Uint8 ** audio_buf, Uint32 * audio_len)
+MS_ADPCM_decode(struct MS_ADPCM_decoder *decoder, int channels,
+                const Uint8 * encoded, Sint16 * decoded)
 {
-    struct MS_ADPCM_decodestate *state[2];
-    Uint8 *freeable, *encoded, *decoded;
-    Sint32 encoded_len, samplesleft;
-    Sint8 nybble, stereo;
+    struct MS_ADPCM_decodestate *state = decoder->state;
     Sint16 *coeff[2];
-    Sint32 new_sample;
-
-    /* Allocate the proper sized output buffer */
-    encoded_len = *audio_len;
-    encoded = *audio_buf;
-    freeable = *audio_buf;
-    *audio_len = (encoded_len / MS_ADPCM_state.wavefmt.blockalign) *
-        MS_ADPCM_state.wSamplesPerBlock *
-        MS_ADPCM_state.wavefmt.channels * sizeof(Sint16);
-    *audio_buf = (Uint8 *) SDL_malloc(*audio_len);
-    if (*audio_buf == NULL) {
-        SDL_Error(SDL_ENOMEM);
-        return (-1);
-    }
-    decoded = *audio_buf;
-
-    /* Get ready... Go! */
-    stereo = (MS_ADPCM_state.wavefmt.channels == 2);
-    state[0] = &MS_ADPCM_state.state[0];
-    state[1] = &MS_ADPCM_state.state[stereo];
-    while (encoded_len >= MS_ADPCM_state.wavefmt.blockalign) {
-        /* Grab the initial information for this block */
-        state[0]->hPredictor = *encoded++;
-        if (stereo) {
-            state[1]->hPredictor = *encoded++;
+    int c, i, samples;
+
+    /* Grab the initial information for this block */
+    for (c = 0; c < channels; ++c) {
+        state[c].hPredictor = *encoded++;
+        if (state[c].hPredictor >= decoder->wNumCoef) {
+            SDL_SetError("Invalid MS ADPCM predictor");
+            return (-1);
         }
-        state[0]->iDelta = ((encoded[1] << 8) | encoded[0]);
+        coeff[c] = decoder->aCoeff[state[c].hPredictor];
+    }
+    for (c = 0; c < channels; ++c) {
+        state[c].iDelta = ((encoded[1] << 8) | encoded[0]);
         encoded += sizeof(Sint16);
-        if (stereo) {
-            state[1]->iDelta = ((encoded[1] << 8) | encoded[0]);
-            encoded += sizeof(Sint16);
-        }
-        state[0]->iSamp1 = ((encoded[1] << 8) | encoded[0]);
+    }
+    for (c = 0; c < channels; ++c) {
+        state[c].iSamp1 = ((encoded[1] << 8) | encoded[0]);
         encoded += sizeof(Sint16);
-        if (stereo) {
-            state[1]->iSamp1 = ((encoded[1] << 8) | encoded[0]);
-            encoded += sizeof(Sint16);
-        }
-        state[0]->iSamp2 = ((encoded[1] << 8) | encoded[0]);
+    }
+    for (c = 0; c < channels; ++c) {
+        state[c].iSamp2 = ((encoded[1] << 8) | encoded[0]);
         encoded += sizeof(Sint16);
-        if (stereo) {
-            state[1]->iSamp2 = ((encoded[1] << 8) | encoded[0]);
-            encoded += sizeof(Sint16);
-        }
-        coeff[0] = MS_ADPCM_state.aCoeff[state[0]->hPredictor];
-        coeff[1] = MS_ADPCM_state.aCoeff[state[1]->hPredictor];
-
-        /* Store the two initial samples we start with */
-        decoded[0] = state[0]->iSamp2 & 0xFF;
-        decoded[1] = state[0]->iSamp2 >> 8;
-        decoded += 2;
-        if (stereo) {
-            decoded[0] = state[1]->iSamp2 & 0xFF;
-            decoded[1] = state[1]->iSamp2 >> 8;
-            decoded += 2;
-        }
-        decoded[0] = state[0]->iSamp1 & 0xFF;
-        decoded[1] = state[0]->iSamp1 >> 8;
-        decoded += 2;
-        if (stereo) {
-            decoded[0] = state[1]->iSamp1 & 0xFF;
-            decoded[1] = state[1]->iSamp1 >> 8;
-            decoded += 2;
-        }
+    }
 
-        /* Decode and store the other samples in this block */
-        samplesleft = (MS_ADPCM_state.wSamplesPerBlock - 2) *
-            MS_ADPCM_state.wavefmt.channels;
-        while (samplesleft > 0) {
-            nybble = (*encoded) >> 4;
-            new_sample = MS_ADPCM_nibble(state[0], nybble, coeff[0]);
-            decoded[0] = new_sample & 0xFF;
-            new_sample >>= 8;
-            decoded[1] = new_sample & 0xFF;
-            decoded += 2;
-
-            nybble = (*encoded) & 0x0F;
-            new_sample = MS_ADPCM_nibble(state[1], nybble, coeff[1]);
-            decoded[0] = new_sample & 0xFF;
-            new_sample >>= 8;
-            decoded[1] = new_sample & 0xFF;
-            decoded += 2;
-
-            ++encoded;
-            samplesleft -= 2;
-        }
-        encoded_len -= MS_ADPCM_state.wavefmt.blockalign;
+    /* Store the two initial samples we start with */
+    for (c = 0; c < channels; ++c) {
+        decoded[c] = SDL_SwapLE16(state[c].iSamp2);
+        decoded[channels + c] = SDL_SwapLE16(state[c].iSamp1);
+    }
+    decoded += 2 * channels;
+
+    /* Decode and store the other samples in this block,
+       stereo nybbles alternate between the channels */
+    samples = (decoder->wSamplesPerBlock - 2) * channels;
+    for (i = 0; i < samples; ++i) {
+        Uint8 nybble = (i & 1) ? (encoded[i >> 1] & 0x0F) :
+            (encoded[i >> 1] >> 4);
+        c = (channels == 2) ? (i & 1) : 0;
+        decoded[i] = SDL_SwapLE16((Sint16)
+                                  MS_ADPCM_nibble(&state[c], nybble,
+                                                  coeff[c]));
     }
-    SDL_free(freeable);
     return (0);
 }
 
@@ -222,62 +177,58 @@ struct IMA_ADPCM_decodestate
     Sint32 sample;
     Sint8 index;
 };
-static struct IMA_ADPCM_decoder
+struct IMA_ADPCM_decoder
 {
-    WaveFMT wavefmt;
     Uint16 wSamplesPerBlock;
     /* * * */
     struct IMA_ADPCM_decodestate state[2];
-} IMA_ADPCM_state;
+};
 
 static int
-InitIMA_ADPCM(WaveFMT * format)
+InitIMA_ADPCM(struct IMA_ADPCM_decoder *decoder, WaveFMT * format,
+              Uint32 fmtlen)
 {
     Uint8 *rogue_feel;
-    Uint16 extra_info;
-
-    /* Set the rogue pointer to the IMA_ADPCM specific data */
-    IMA_ADPCM_state.wavefmt.encoding = SDL_SwapLE16(format->encoding);
-    IMA_ADPCM_state.wavefmt.channels = SDL_SwapLE16(format->channels);
-    IMA_ADPCM_state.wavefmt.frequency = SDL_SwapLE32(format->frequency);
-    IMA_ADPCM_state.wavefmt.byterate = SDL_SwapLE32(format->byterate);
-    IMA_ADPCM_state.wavefmt.blockalign = SDL_SwapLE16(format->blockalign);
-    IMA_ADPCM_state.wavefmt.bitspersample =
-        SDL_SwapLE16(format->bitspersample);
-    rogue_feel = (Uint8 *) format + sizeof(*format);
-    if (sizeof(*format) == 16) {
-        extra_info = ((rogue_feel[1] << 8) | rogue_feel[0]);
-        rogue_feel += sizeof(Uint16);
+
+    if (fmtlen < sizeof(*format) + 2 * sizeof(Uint16)) {
+        SDL_SetError("IMA ADPCM format chunk too small");
+        return (-1);
     }
-    IMA_ADPCM_state.wSamplesPerBlock = ((rogue_feel[1] << 8) | rogue_feel[0]);
+
+    /* Set the rogue pointer to the IMA_ADPCM specific data,
+       after the size of the extra information */
+    rogue_feel = (Uint8 *) format + sizeof(*format) + sizeof(Uint16);
+    decoder->wSamplesPerBlock = ((rogue_feel[1] << 8) | rogue_feel[0]);
     return (0);
 }
 
+static const int IMA_ADPCM_index_table[16] = {
+    -1, -1, -1, -1,
+    2, 4, 6, 8,
+    -1, -1, -1, -1,
+    2, 4, 6, 8
+};
+
+static const Sint32 IMA_ADPCM_step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
+    34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130,
+    143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408,
+    449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282,
+    1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+    3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
+    9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+    22385, 24623, 27086, 29794, 32767
+};
+
 static Sint32
 IMA_ADPCM_nibble(struct IMA_ADPCM_decodestate *state, Uint8 nybble)
 {
     const Sint32 max_audioval = ((1 << (16 - 1)) - 1);
     const Sint32 min_audioval = -(1 << (16 - 1));
-    const int index_table[16] = {
-        -1, -1, -1, -1,
-        2, 4, 6, 8,
-        -1, -1, -1, -1,
-        2, 4, 6, 8
-    };
-    const Sint32 step_table[89] = {
-        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
-        34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130,
-        143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408,
-        449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282,
-        1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
-        3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
-        9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
-        22385, 24623, 27086, 29794, 32767
-    };
     Sint32 delta, step;
 
     /* Compute difference and new sample value */
-    step = step_table[state->index];
+    step = IMA_ADPCM_step_table[state->index];
     delta = step >> 3;
     if (nybble & 0x04)
         delta += step;
@@ -290,7 +241,7 @@ IMA_ADPCM_nibble(struct IMA_ADPCM_decodestate *state, Uint8 nybble)
     state->sample += delta;
 
     /* Update index value */
-    state->index += index_table[nybble];
+    state->index += IMA_ADPCM_index_table[nybble];
     if (state->index > 88) {
         state->index = 88;
     } else if (state->index < 0) {
@@ -306,131 +257,185 @@ IMA_ADPCM_nibble(struct IMA_ADPCM_decodestate *state, Uint8 nybble)
     return (state->sample);
 }
 
-/* Fill the decode buffer with a channel block of data (8 samples) */
+/* Decode all the samples of a channel in a block.  The channels take turns
+   storing 8 samples in 4 bytes, so every 4 * numchannels bytes of the block
+   hold samples 8 * numchannels apart in the decode buffer. */
 static void
-Fill_IMA_ADPCM_block(Uint8 * decoded, Uint8 * encoded,
-                     int channel, int numchannels,
-                     struct IMA_ADPCM_decodestate *state)
+Fill_IMA_ADPCM_channel(Sint16 * decoded, const Uint8 * encoded,
+                       int channel, int numchannels, int groups,
+                       struct IMA_ADPCM_decodestate *state)
 {
+    struct IMA_ADPCM_decodestate local = *state;
     int i;
-    Sint8 nybble;
-    Sint32 new_sample;
-
-    decoded += (channel * 2);
-    for (i = 0; i < 4; ++i) {
-        nybble = (*encoded) & 0x0F;
-        new_sample = IMA_ADPCM_nibble(state, nybble);
-        decoded[0] = new_sample & 0xFF;
-        new_sample >>= 8;
-        decoded[1] = new_sample & 0xFF;
-        decoded += 2 * numchannels;
-
-        nybble = (*encoded) >> 4;
-        new_sample = IMA_ADPCM_nibble(state, nybble);
-        decoded[0] = new_sample & 0xFF;
-        new_sample >>= 8;
-        decoded[1] = new_sample & 0xFF;
-        decoded += 2 * numchannels;
-
-        ++encoded;
+
+    decoded += channel;
+    encoded += channel * 4;
+    while (groups--) {
+        for (i = 0; i < 4; ++i) {
+            decoded[0] = SDL_SwapLE16((Sint16)
+                                      IMA_ADPCM_nibble(&local,
+                                                       encoded[i] & 0x0F));
+            decoded[numchannels] = SDL_SwapLE16((Sint16)
+                                                IMA_ADPCM_nibble(&local,
+                                                                 encoded[i]
+                                                                 >> 4));
+            decoded += 2 * numchannels;
+        }
+        encoded += 4 * numchannels;
     }
+    *state = local;
 }
 
+/* Decode a block of wSamplesPerBlock frames */
 static int
-IMA_ADPCM_decode(Uint8 ** audio_buf, Uint32 * audio_len)
+IMA_ADPCM_decode(struct IMA_ADPCM_decoder *decoder, int channels,
+                 const Uint8 * encoded, Sint16 * decoded)
 {
-    struct IMA_ADPCM_decodestate *state;
-    Uint8 *freeable, *encoded, *decoded;
-    Sint32 encoded_len, samplesleft;
-    unsigned int c, channels;
-
-    /* Check to make sure we have enough variables in the state array */
-    channels = IMA_ADPCM_state.wavefmt.channels;
-    if (channels > SDL_arraysize(IMA_ADPCM_state.state)) {
-        SDL_SetError("IMA ADPCM decoder can only handle %d channels",
-                     SDL_arraysize(IMA_ADPCM_state.state));
-        return (-1);
+    struct IMA_ADPCM_decodestate *state = decoder->state;
+    int c, groups;
+
+    /* Grab the initial information for this block */
+    for (c = 0; c < channels; ++c) {
+        /* Fill the state information for this block */
+        state[c].sample = ((encoded[1] << 8) | encoded[0]);
+        encoded += 2;
+        if (state[c].sample & 0x8000) {
+            state[c].sample -= 0x10000;
+        }
+        state[c].index = *encoded++;
+        if (state[c].index < 0 || state[c].index > 88) {
+            SDL_SetError("Invalid IMA ADPCM step index");
+            return (-1);
+        }
+        /* Reserved byte in buffer header, should be 0 */
+        if (*encoded++ != 0) {
+            /* Uh oh, corrupt data?  Buggy code? */ ;
+        }
+
+        /* Store the initial sample we start with */
+        decoded[c] = SDL_SwapLE16((Sint16) state[c].sample);
     }
-    state = IMA_ADPCM_state.state;
+    decoded += channels;
 
-    /* Allocate the proper sized output buffer */
-    encoded_len = *audio_len;
-    encoded = *audio_buf;
-    freeable = *audio_buf;
-    *audio_len = (encoded_len / IMA_ADPCM_state.wavefmt.blockalign) *
-        IMA_ADPCM_state.wSamplesPerBlock *
-        IMA_ADPCM_state.wavefmt.channels * sizeof(Sint16);
-    *audio_buf = (Uint8 *) SDL_malloc(*audio_len);
-    if (*audio_buf == NULL) {
-        SDL_Error(SDL_ENOMEM);
-        return (-1);
+    /* Decode and store the other samples in this block */
+    groups = (decoder->wSamplesPerBlock - 1) / 8;
+    for (c = 0; c < channels; ++c) {
+        Fill_IMA_ADPCM_channel(decoded, encoded, c, channels, groups,
+                               &state[c]);
     }
-    decoded = *audio_buf;
-
-    /* Get ready... Go! */
-    while (encoded_len >= IMA_ADPCM_state.wavefmt.blockalign) {
-        /* Grab the initial information for this block */
-        for (c = 0; c < channels; ++c) {
-            /* Fill the state information for this block */
-            state[c].sample = ((encoded[1] << 8) | encoded[0]);
-            encoded += 2;
-            if (state[c].sample & 0x8000) {
-                state[c].sample -= 0x10000;
-            }
-            state[c].index = *encoded++;
-            /* Reserved byte in buffer header, should be 0 */
-            if (*encoded++ != 0) {
-                /* Uh oh, corrupt data?  Buggy code? */ ;
-            }
+    return (0);
+}
 
-            /* Store the initial sample we start with */
-            decoded[0] = (Uint8) (state[c].sample & 0xFF);
-            decoded[1] = (Uint8) (state[c].sample >> 8);
-            decoded += 2;
-        }
+typedef union
+{
+    struct MS_ADPCM_decoder ms;
+    struct IMA_ADPCM_decoder ima;
+} ADPCM_decoder;
 
-        /* Decode and store the other samples in this block */
-        samplesleft = (IMA_ADPCM_state.wSamplesPerBlock - 1) * channels;
-        while (samplesleft > 0) {
-            for (c = 0; c < channels; ++c) {
-                Fill_IMA_ADPCM_block(decoded, encoded,
-                                     c, channels, &state[c]);
-                encoded += 4;
-                samplesleft -= 8;
-            }
-            decoded += (channels * 8 * 2);
+struct SDL_WAVStream
+{
+    SDL_RWops *src;
+    int freesrc;
+    long fp_offset;             /* where the file starts */
+    long end;                   /* where the RIFF chunk ends */
+    long data_start;            /* where the audio data starts */
+
+    Uint16 encoding;
+    int channels;
+    int bitspersample;          /* in the file */
+    int framesize;              /* bytes per frame, once decoded */
+    Uint32 frames;              /* length of the audio data */
+    Uint32 frame;               /* the next frame read */
+
+    /* ADPCM decoding */
+    int blockalign;
+    int samplesperblock;
+    Uint8 *block;               /* the last block read from the file */
+    Sint16 *decoded;            /* and the frames it decoded to */
+    int decoded_frames;
+    int decoded_pos;
+    ADPCM_decoder adpcm;
+};
+
+/* Check the ADPCM block layout, so decoding stays within the blocks */
+static int
+SDL_InitWAVStreamADPCM(SDL_WAVStream * stream, WaveFMT * format,
+                       Uint32 fmtlen)
+{
+    int channels = stream->channels;
+    int spb, size;
+
+    if (stream->encoding == MS_ADPCM_CODE) {
+        if (InitMS_ADPCM(&stream->adpcm.ms, format, fmtlen) < 0) {
+            return (-1);
+        }
+        spb = stream->adpcm.ms.wSamplesPerBlock;
+        size = 7 * channels + ((spb - 2) * channels + 1) / 2;
+        if (spb < 2) {
+            size = stream->blockalign + 1;
+        }
+    } else {
+        if (InitIMA_ADPCM(&stream->adpcm.ima, format, fmtlen) < 0) {
+            return (-1);
+        }
+        spb = stream->adpcm.ima.wSamplesPerBlock;
+        size = 4 * channels + ((spb - 1) * channels) / 2;
+        if (spb < 1 || ((spb - 1) % 8) != 0) {
+            size = stream->blockalign + 1;
         }
-        encoded_len -= IMA_ADPCM_state.wavefmt.blockalign;
     }
-    SDL_free(freeable);
+    if (channels > 2) {
+        SDL_SetError("ADPCM decoder can only handle %d channels", 2);
+        return (-1);
+    }
+    if (size > stream->blockalign) {
+        SDL_SetError("Invalid ADPCM block size");
+        return (-1);
+    }
+    stream->samplesperblock = spb;
+
+    stream->block = (Uint8 *) SDL_malloc(stream->blockalign);
+    stream->decoded =
+        (Sint16 *) SDL_malloc(spb * channels * sizeof(Sint16));
+    if (stream->block == NULL || stream->decoded == NULL) {
+        SDL_Error(SDL_ENOMEM);
+        return (-1);
+    }
     return (0);
 }
 
-SDL_AudioSpec *
-SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
-               SDL_AudioSpec * spec, Uint8 ** audio_buf, Uint32 * audio_len)
+SDL_WAVStream *
+SDL_OpenWAVStream_RW(SDL_RWops * src, int freesrc, SDL_AudioSpec * spec)
 {
-    int was_error;
+    SDL_WAVStream *stream;
     Chunk chunk;
-    int lenread;
-    int IEEE_float_encoded, MS_ADPCM_encoded, IMA_ADPCM_encoded;
-    int samplesize;
+    Uint32 fmtlen;
+    Uint32 data_len;
 
     /* WAV magic header */
     Uint32 RIFFchunk;
     Uint32 wavelen = 0;
     Uint32 WAVEmagic;
-    Uint32 headerDiff = 0;
 
     /* FMT chunk */
     WaveFMT *format = NULL;
 
     /* Make sure we are passed a valid data source */
-    was_error = 0;
     if (src == NULL) {
-        was_error = 1;
-        goto done;
+        return (NULL);
+    }
+    stream = (SDL_WAVStream *) SDL_calloc(1, sizeof(*stream));
+    if (stream == NULL) {
+        SDL_Error(SDL_ENOMEM);
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+        return (NULL);
     }
+    stream->src = src;
+    stream->freesrc = freesrc;
+    stream->fp_offset = SDL_RWtell(src);
+    stream->end = -1;
 
     /* Check the magic header */
     RIFFchunk = SDL_ReadLE32(src);
@@ -444,163 +449,481 @@ SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
     }
     if ((RIFFchunk != RIFF) || (WAVEmagic != WAVE)) {
         SDL_SetError("Unrecognized file type (not WAVE)");
-        was_error = 1;
-        goto done;
+        goto error;
     }
-    headerDiff += sizeof(Uint32);       /* for WAVE */
+    /* wavelen includes the WAVE magic */
+    stream->end = SDL_RWtell(src) + wavelen - sizeof(Uint32);
 
     /* Read the audio data format chunk */
-    chunk.data = NULL;
     do {
-        if (chunk.data != NULL) {
-            SDL_free(chunk.data);
-            chunk.data = NULL;
+        if (ReadChunkHeader(src, &chunk) < 0) {
+            goto error;
         }
-        lenread = ReadChunk(src, &chunk);
-        if (lenread < 0) {
-            was_error = 1;
-            goto done;
+        if ((chunk.magic == FACT) || (chunk.magic == LIST)) {
+            SDL_RWseek(src, chunk.length, RW_SEEK_CUR);
         }
-        /* 2 Uint32's for chunk header+len, plus the lenread */
-        headerDiff += lenread + 2 * sizeof(Uint32);
     } while ((chunk.magic == FACT) || (chunk.magic == LIST));
-
-    /* Decode the audio data format */
-    format = (WaveFMT *) chunk.data;
     if (chunk.magic != FMT) {
         SDL_SetError("Complex WAVE files not supported");
-        was_error = 1;
-        goto done;
+        goto error;
+    }
+    if (chunk.length < sizeof(*format)) {
+        SDL_SetError("WAVE format chunk too small");
+        goto error;
+    }
+    if (ReadChunk(src, &chunk) < 0) {
+        goto error;
+    }
+    format = (WaveFMT *) chunk.data;
+    fmtlen = chunk.length;
+
+    /* Decode the audio data format */
+    stream->encoding = SDL_SwapLE16(format->encoding);
+    stream->channels = SDL_SwapLE16(format->channels);
+    stream->blockalign = SDL_SwapLE16(format->blockalign);
+    stream->bitspersample = SDL_SwapLE16(format->bitspersample);
+    if (stream->encoding == EXTENSIBLE_CODE) {
+        /* The real encoding starts the sub-format GUID, after the size of
+           the extra information, the valid bits and the channel mask */
+        Uint8 *subformat = (Uint8 *) format + sizeof(*format) + 8;
+        if (fmtlen < sizeof(*format) + 8 + 16) {
+            SDL_SetError("WAVE format chunk too small");
+            goto error;
+        }
+        stream->encoding = ((subformat[1] << 8) | subformat[0]);
     }
-    IEEE_float_encoded = MS_ADPCM_encoded = IMA_ADPCM_encoded = 0;
-    switch (SDL_SwapLE16(format->encoding)) {
+    if (stream->channels == 0) {
+        SDL_SetError("WAVE file has no channels");
+        goto error;
+    }
+
+    SDL_memset(spec, 0, (sizeof *spec));
+    switch (stream->encoding) {
     case PCM_CODE:
         /* We can understand this */
+        switch (stream->bitspersample) {
+        case 8:
+            spec->format = AUDIO_U8;
+            break;
+        case 16:
+            spec->format = AUDIO_S16;
+            break;
+        case 24:
+            /* Expanded to 32-bit samples */
+        case 32:
+            spec->format = AUDIO_S32;
+            break;
+        }
         break;
     case IEEE_FLOAT_CODE:
-        IEEE_float_encoded = 1;
         /* We can understand this */
-        break;
-    case MS_ADPCM_CODE:
-        /* Try to understand this */
-        if (InitMS_ADPCM(format) < 0) {
-            was_error = 1;
-            goto done;
+        if (stream->bitspersample == 32) {
+            spec->format = AUDIO_F32;
         }
-        MS_ADPCM_encoded = 1;
         break;
+    case MS_ADPCM_CODE:
     case IMA_ADPCM_CODE:
         /* Try to understand this */
-        if (InitIMA_ADPCM(format) < 0) {
-            was_error = 1;
-            goto done;
+        if (SDL_InitWAVStreamADPCM(stream, format, fmtlen) < 0) {
+            goto error;
+        }
+        if (stream->bitspersample == 4) {
+            spec->format = AUDIO_S16;
         }
-        IMA_ADPCM_encoded = 1;
         break;
     case MP3_CODE:
-        SDL_SetError("MPEG Layer 3 data not supported",
-                     SDL_SwapLE16(format->encoding));
-        was_error = 1;
-        goto done;
+        SDL_SetError("MPEG Layer 3 data not supported");
+        goto error;
     default:
-        SDL_SetError("Unknown WAVE data format: 0x%.4x",
-                     SDL_SwapLE16(format->encoding));
-        was_error = 1;
-        goto done;
+        SDL_SetError("Unknown WAVE data format: 0x%.4x", stream->encoding);
+        goto error;
+    }
+    if (spec->format == 0) {
+        SDL_SetError("Unknown %d-bit PCM data format",
+                     stream->bitspersample);
+        goto error;
     }
-    SDL_memset(spec, 0, (sizeof *spec));
     spec->freq = SDL_SwapLE32(format->frequency);
+    spec->channels = (Uint8) stream->channels;
+    spec->samples = 4096;       /* Good default buffer size */
+    stream->framesize =
+        (SDL_AUDIO_BITSIZE(spec->format) / 8) * stream->channels;
 
-    if (IEEE_float_encoded) {
-        if ((SDL_SwapLE16(format->bitspersample)) != 32) {
-            was_error = 1;
-        } else {
-            spec->format = AUDIO_F32;
+    /* Find the audio data chunk, it is read as needed */
+    do {
+        if (ReadChunkHeader(src, &chunk) < 0) {
+            goto error;
+        }
+        if (chunk.magic != DATA) {
+            SDL_RWseek(src, chunk.length, RW_SEEK_CUR);
         }
+    } while (chunk.magic != DATA);
+    stream->data_start = SDL_RWtell(src);
+    data_len = chunk.length;
+
+    /* Only whole frames and ADPCM blocks are decoded */
+    if (stream->samplesperblock) {
+        stream->frames =
+            (data_len / stream->blockalign) * stream->samplesperblock;
+    } else {
+        stream->frames =
+            data_len / (stream->channels * (stream->bitspersample / 8));
+    }
+
+    SDL_free(format);
+    return (stream);
+
+  error:
+    if (format != NULL) {
+        SDL_free(format);
+    }
+    SDL_RWseek(src, stream->fp_offset, RW_SEEK_SET);
+    stream->end = -1;
+    SDL_CloseWAVStream(stream);
+    return (NULL);
+}
+
+Uint32
+SDL_GetWAVStreamLength(SDL_WAVStream * stream)
+{
+    if (!stream) {
+        SDL_SetError("Invalid WAV stream");
+        return 0;
+    }
+    return stream->frames;
+}
+
+static int
+SDL_DecodeWAVBlock(SDL_WAVStream * stream, ADPCM_decoder * decoder,
+                   const Uint8 * encoded, Sint16 * decoded)
+{
+    if (stream->encoding == MS_ADPCM_CODE) {
+        return MS_ADPCM_decode(&decoder->ms, stream->channels, encoded,
+                               decoded);
     } else {
-        switch (SDL_SwapLE16(format->bitspersample)) {
-        case 4:
-            if (MS_ADPCM_encoded || IMA_ADPCM_encoded) {
-                spec->format = AUDIO_S16;
-            } else {
-                was_error = 1;
+        return IMA_ADPCM_decode(&decoder->ima, stream->channels, encoded,
+                                decoded);
+    }
+}
+
+/* Read and decode the next ADPCM block */
+static int
+SDL_ReadWAVStreamBlock(SDL_WAVStream * stream)
+{
+    if (SDL_RWread(stream->src, stream->block, stream->blockalign, 1) != 1) {
+        SDL_Error(SDL_EFREAD);
+        return (-1);
+    }
+    if (SDL_DecodeWAVBlock(stream, &stream->adpcm, stream->block,
+                           stream->decoded) < 0) {
+        return (-1);
+    }
+    stream->decoded_frames = stream->samplesperblock;
+    return (0);
+}
+
+static int
+SDL_ReadWAVStreamADPCM(SDL_WAVStream * stream, Uint8 * buf, int frames)
+{
+    int count, left = frames;
+
+    while (left > 0) {
+        if (stream->decoded_pos == stream->decoded_frames) {
+            if (SDL_ReadWAVStreamBlock(stream) < 0) {
+                break;
             }
-            break;
-        case 8:
-            spec->format = AUDIO_U8;
-            break;
-        case 16:
-            spec->format = AUDIO_S16;
-            break;
-        case 32:
-            spec->format = AUDIO_S32;
-            break;
-        default:
-            was_error = 1;
-            break;
+            stream->decoded_pos = 0;
         }
+        count = SDL_min(left, stream->decoded_frames - stream->decoded_pos);
+        SDL_memcpy(buf,
+                   (Uint8 *) stream->decoded +
+                   stream->decoded_pos * stream->framesize,
+                   count * stream->framesize);
+        stream->decoded_pos += count;
+        buf += count * stream->framesize;
+        left -= count;
     }
+    return (frames - left);
+}
 
-    if (was_error) {
-        SDL_SetError("Unknown %d-bit PCM data format",
-                     SDL_SwapLE16(format->bitspersample));
-        goto done;
+static int
+SDL_ReadWAVStreamPCM(SDL_WAVStream * stream, Uint8 * buf, int frames)
+{
+    int filesize = stream->channels * (stream->bitspersample / 8);
+    Uint8 *src;
+    int i, samples;
+
+    if (stream->bitspersample != 24) {
+        return SDL_RWread(stream->src, buf, filesize, frames);
     }
-    spec->channels = (Uint8) SDL_SwapLE16(format->channels);
-    spec->samples = 4096;       /* Good default buffer size */
 
-    /* Read the audio data chunk */
-    *audio_buf = NULL;
-    do {
-        if (*audio_buf != NULL) {
-            SDL_free(*audio_buf);
-            *audio_buf = NULL;
-        }
-        lenread = ReadChunk(src, &chunk);
-        if (lenread < 0) {
-            was_error = 1;
-            goto done;
+    /* Read the 24-bit samples into the end of the buffer and
+       expand them forward into 32-bit samples */
+    src = buf + frames * stream->channels;
+    frames = SDL_RWread(stream->src, src, filesize, frames);
+    samples = frames * stream->channels;
+    for (i = 0; i < samples; ++i) {
+        Uint8 b0 = src[0];
+        Uint8 b1 = src[1];
+        Uint8 b2 = src[2];
+        buf[0] = 0;
+        buf[1] = b0;
+        buf[2] = b1;
+        buf[3] = b2;
+        buf += 4;
+        src += 3;
+    }
+    return (frames);
+}
+
+int
+SDL_ReadWAVStream(SDL_WAVStream * stream, void *buf, int frames)
+{
+    int count;
+
+    if (!stream) {
+        SDL_SetError("Invalid WAV stream");
+        return (-1);
+    }
+    if (frames < 0) {
+        SDL_SetError("Invalid number of frames");
+        return (-1);
+    }
+    if ((Uint32) frames > stream->frames - stream->frame) {
+        frames = (int) (stream->frames - stream->frame);
+    }
+    if (frames == 0) {
+        return (0);
+    }
+
+    SDL_ClearError();
+    if (stream->samplesperblock) {
+        count = SDL_ReadWAVStreamADPCM(stream, (Uint8 *) buf, frames);
+    } else {
+        count = SDL_ReadWAVStreamPCM(stream, (Uint8 *) buf, frames);
+    }
+    if (count < frames) {
+        /* Broken block, or the data chunk is longer than the file */
+        if (count == 0 && SDL_strcmp(SDL_GetError(), "") != 0) {
+            return (-1);
         }
-        *audio_len = lenread;
-        *audio_buf = chunk.data;
-        if (chunk.magic != DATA)
-            headerDiff += lenread + 2 * sizeof(Uint32);
-    } while (chunk.magic != DATA);
-    headerDiff += 2 * sizeof(Uint32);   /* for the data chunk and len */
+        stream->frames = stream->frame + count;
+    }
+    stream->frame += count;
+    return (count);
+}
+
+int
+SDL_SeekWAVStream(SDL_WAVStream * stream, Uint32 frame)
+{
+    long offset;
 
-    if (MS_ADPCM_encoded) {
-        if (MS_ADPCM_decode(audio_buf, audio_len) < 0) {
-            was_error = 1;
-            goto done;
+    if (!stream) {
+        SDL_SetError("Invalid WAV stream");
+        return (-1);
+    }
+    if (frame > stream->frames) {
+        SDL_SetError("Seek past the end of the WAV stream");
+        return (-1);
+    }
+
+    if (stream->samplesperblock) {
+        /* Decode the block the frame is in */
+        offset = (long) (frame / stream->samplesperblock) *
+            stream->blockalign;
+        stream->decoded_pos = stream->decoded_frames = 0;
+    } else {
+        offset = (long) frame *
+            (stream->channels * (stream->bitspersample / 8));
+    }
+    if (SDL_RWseek(stream->src, stream->data_start + offset, RW_SEEK_SET) <
+        0) {
+        SDL_Error(SDL_EFSEEK);
+        return (-1);
+    }
+    if (stream->samplesperblock && frame < stream->frames) {
+        if (SDL_ReadWAVStreamBlock(stream) < 0) {
+            return (-1);
         }
+        stream->decoded_pos = frame % stream->samplesperblock;
+    }
+    stream->frame = frame;
+    return (0);
+}
+
+void
+SDL_CloseWAVStream(SDL_WAVStream * stream)
+{
+    if (!stream) {
+        return;
+    }
+    if (stream->freesrc) {
+        SDL_RWclose(stream->src);
+    } else if (stream->end >= 0) {
+        /* seek to the end of the file (given by the RIFF chunk) */
+        SDL_RWseek(stream->src, stream->end, RW_SEEK_SET);
     }
-    if (IMA_ADPCM_encoded) {
-        if (IMA_ADPCM_decode(audio_buf, audio_len) < 0) {
-            was_error = 1;
-            goto done;
+    if (stream->block) {
+        SDL_free(stream->block);
+    }
+    if (stream->decoded) {
+        SDL_free(stream->decoded);
+    }
+    SDL_free(stream);
+}
+
+/* A range of ADPCM blocks decoded by one thread */
+typedef struct
+{
+    SDL_WAVStream *stream;
+    ADPCM_decoder decoder;
+    const Uint8 *encoded;
+    Sint16 *decoded;
+    int blocks;
+    int retval;
+} WAVDecodeJob;
+
+static int SDLCALL
+SDL_RunWAVDecodeJob(void *data)
+{
+    WAVDecodeJob *job = (WAVDecodeJob *) data;
+    SDL_WAVStream *stream = job->stream;
+    int i;
+
+    for (i = 0; i < job->blocks; ++i) {
+        job->retval = SDL_DecodeWAVBlock(stream, &job->decoder,
+                                         job->encoded +
+                                         i * stream->blockalign,
+                                         job->decoded +
+                                         i * stream->samplesperblock *
+                                         stream->channels);
+        if (job->retval < 0) {
+            break;
         }
     }
+    return (job->retval);
+}
+
+/* Decode all the ADPCM blocks of a stream, splitting them between threads */
+static int
+SDL_DecodeWAVBlocks(SDL_WAVStream * stream, Uint8 * audio_buf)
+{
+    WAVDecodeJob jobs[WAVE_MAX_THREADS];
+    SDL_Thread *threads[WAVE_MAX_THREADS];
+    Uint8 *encoded;
+    int blocks, numjobs, first, i;
+    int retval = 0;
+
+    blocks = stream->frames / stream->samplesperblock;
+    encoded = (Uint8 *) SDL_malloc(blocks * stream->blockalign);
+    if (encoded == NULL) {
+        SDL_Error(SDL_ENOMEM);
+        return (-1);
+    }
+    if (SDL_RWread(stream->src, encoded, stream->blockalign, blocks) !=
+        blocks) {
+        SDL_Error(SDL_EFREAD);
+        SDL_free(encoded);
+        return (-1);
+    }
 
-    /* Don't return a buffer that isn't a multiple of samplesize */
-    samplesize = ((SDL_AUDIO_BITSIZE(spec->format)) / 8) * spec->channels;
-    *audio_len &= ~(samplesize - 1);
+    numjobs = SDL_min(SDL_GetCPUCount(), blocks / WAVE_THREAD_BLOCKS);
+    numjobs = SDL_max(SDL_min(numjobs, WAVE_MAX_THREADS), 1);
+    first = 0;
+    for (i = 0; i < numjobs; ++i) {
+        jobs[i].stream = stream;
+        jobs[i].decoder = stream->adpcm;
+        jobs[i].encoded = encoded + first * stream->blockalign;
+        jobs[i].decoded = (Sint16 *) audio_buf +
+            first * stream->samplesperblock * stream->channels;
+        jobs[i].blocks = (blocks * (i + 1)) / numjobs - first;
+        jobs[i].retval = 0;
+        first += jobs[i].blocks;
+    }
 
-  done:
-    if (format != NULL) {
-        SDL_free(format);
+    /* This thread decodes the first range, and any the others couldn't */
+    for (i = 1; i < numjobs; ++i) {
+/* !!! FIXME: this is nasty. */
+#if (defined(__WIN32__) && !defined(_WIN32_WCE)) && !defined(HAVE_LIBC)
+#undef SDL_CreateThread
+        threads[i] = SDL_CreateThread(SDL_RunWAVDecodeJob, &jobs[i], NULL,
+                                      NULL);
+#else
+        threads[i] = SDL_CreateThread(SDL_RunWAVDecodeJob, &jobs[i]);
+#endif
     }
-    if (src) {
-        if (freesrc) {
-            SDL_RWclose(src);
+    SDL_RunWAVDecodeJob(&jobs[0]);
+    for (i = 1; i < numjobs; ++i) {
+        if (threads[i]) {
+            SDL_WaitThread(threads[i], NULL);
         } else {
-            /* seek to the end of the file (given by the RIFF chunk) */
-            SDL_RWseek(src, wavelen - chunk.length - headerDiff, RW_SEEK_CUR);
+            SDL_RunWAVDecodeJob(&jobs[i]);
         }
     }
-    if (was_error) {
-        spec = NULL;
+    for (i = 0; i < numjobs; ++i) {
+        if (jobs[i].retval < 0) {
+            /* The message was set on the thread that failed */
+            SDL_SetError("Invalid ADPCM block");
+            retval = -1;
+        }
+    }
+
+    SDL_free(encoded);
+    return (retval);
+}
+
+SDL_AudioSpec *
+SDL_LoadWAV_RW(SDL_RWops * src, int freesrc,
+               SDL_AudioSpec * spec, Uint8 ** audio_buf, Uint32 * audio_len)
+{
+    SDL_WAVStream *stream;
+    Uint32 frames, len;
+    int count;
+
+    stream = SDL_OpenWAVStream_RW(src, freesrc, spec);
+    if (stream == NULL) {
+        return (NULL);
+    }
+
+    /* Decode the whole file into one buffer */
+    frames = stream->frames;
+    if (frames > 0xFFFFFFFF / stream->framesize) {
+        SDL_SetError("WAVE file too large");
+        goto error;
+    }
+    *audio_len = frames * stream->framesize;
+    *audio_buf = (Uint8 *) SDL_malloc(*audio_len ? *audio_len : 1);
+    if (*audio_buf == NULL) {
+        SDL_Error(SDL_ENOMEM);
+        goto error;
+    }
+    if (stream->samplesperblock) {
+        if (SDL_DecodeWAVBlocks(stream, *audio_buf) < 0) {
+            goto error_buf;
+        }
+    } else {
+        for (len = 0; len < *audio_len; len += count * stream->framesize) {
+            count = SDL_ReadWAVStream(stream, *audio_buf + len,
+                                      SDL_min(frames, 0x100000));
+            if (count <= 0) {
+                if (count == 0) {
+                    SDL_Error(SDL_EFREAD);
+                }
+                goto error_buf;
+            }
+            frames -= count;
+        }
     }
+
+    SDL_CloseWAVStream(stream);
     return (spec);
+
+  error_buf:
+    SDL_free(*audio_buf);
+    *audio_buf = NULL;
+  error:
+    SDL_CloseWAVStream(stream);
+    return (NULL);
 }
 
 /* Since the WAV memory is allocated in the shared library, it must also
@@ -614,11 +937,24 @@ SDL_FreeWAV(Uint8 * audio_buf)
     }
 }
 
+static int
+ReadChunkHeader(SDL_RWops * src, Chunk * chunk)
+{
+    Uint32 header[2];
+
+    if (SDL_RWread(src, header, sizeof(header), 1) != 1) {
+        SDL_Error(SDL_EFREAD);
+        return (-1);
+    }
+    chunk->magic = SDL_SwapLE32(header[0]);
+    chunk->length = SDL_SwapLE32(header[1]);
+    chunk->data = NULL;
+    return (0);
+}
+
 static int
 ReadChunk(SDL_RWops * src, Chunk * chunk)
 {
-    chunk->magic = SDL_ReadLE32(src);
-    chunk->length = SDL_ReadLE32(src);
     chunk->data = (Uint8 *) SDL_malloc(chunk->length);
     if (chunk->data == NULL) {
         SDL_Error(SDL_ENOMEM);
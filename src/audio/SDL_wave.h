@@ -37,6 +37,7 @@
 #define IEEE_FLOAT_CODE	0x0003
 #define IMA_ADPCM_CODE	0x0011
 #define MP3_CODE	0x0055
+#define EXTENSIBLE_CODE	0xFFFE
 #define WAVE_MONO	1
 #define WAVE_STEREO	2
 
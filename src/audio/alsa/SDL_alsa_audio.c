@@ -85,6 +85,19 @@ static int (*ALSA_snd_pcm_sw_params_set_start_threshold)
 static int (*ALSA_snd_pcm_sw_params) (snd_pcm_t *, snd_pcm_sw_params_t *);
 static int (*ALSA_snd_pcm_nonblock) (snd_pcm_t *, int);
 static int (*ALSA_snd_pcm_wait)(snd_pcm_t *, int);
+static int (*ALSA_snd_pcm_sw_params_set_avail_min)
+  (snd_pcm_t *, snd_pcm_sw_params_t *, snd_pcm_uframes_t);
+static snd_pcm_sframes_t(*ALSA_snd_pcm_avail_update) (snd_pcm_t *);
+static int (*ALSA_snd_pcm_mmap_begin)
+  (snd_pcm_t *, const snd_pcm_channel_area_t **, snd_pcm_uframes_t *,
+   snd_pcm_uframes_t *);
+static snd_pcm_sframes_t(*ALSA_snd_pcm_mmap_commit)
+  (snd_pcm_t *, snd_pcm_uframes_t, snd_pcm_uframes_t);
+static snd_pcm_sframes_t(*ALSA_snd_pcm_mmap_writei)
+  (snd_pcm_t *, const void *, snd_pcm_uframes_t);
+static snd_pcm_state_t(*ALSA_snd_pcm_state) (snd_pcm_t *);
+static int (*ALSA_snd_pcm_start) (snd_pcm_t *);
+static int (*ALSA_snd_pcm_delay) (snd_pcm_t *, snd_pcm_sframes_t *);
 #define snd_pcm_hw_params_sizeof ALSA_snd_pcm_hw_params_sizeof
 #define snd_pcm_sw_params_sizeof ALSA_snd_pcm_sw_params_sizeof
 
@@ -144,6 +157,14 @@ load_alsa_syms(void)
     SDL_ALSA_SYM(snd_pcm_sw_params);
     SDL_ALSA_SYM(snd_pcm_nonblock);
     SDL_ALSA_SYM(snd_pcm_wait);
+    SDL_ALSA_SYM(snd_pcm_sw_params_set_avail_min);
+    SDL_ALSA_SYM(snd_pcm_avail_update);
+    SDL_ALSA_SYM(snd_pcm_mmap_begin);
+    SDL_ALSA_SYM(snd_pcm_mmap_commit);
+    SDL_ALSA_SYM(snd_pcm_mmap_writei);
+    SDL_ALSA_SYM(snd_pcm_state);
+    SDL_ALSA_SYM(snd_pcm_start);
+    SDL_ALSA_SYM(snd_pcm_delay);
     return 0;
 }
 
@@ -218,11 +239,58 @@ get_audio_device(int channels)
 }
 
 
+/* Recover from an xrun or suspend, returning -1 if that's impossible */
+static int
+ALSA_recover(_THIS, int status)
+{
+    if (status == -EPIPE) {
+        ++this->underruns;
+    }
+    status = ALSA_snd_pcm_recover(this->hidden->pcm_handle, status, 0);
+    if (status < 0) {
+        /* Hmm, not much we can do - abort */
+        fprintf(stderr, "ALSA write failed (unrecoverable): %s\n",
+                ALSA_snd_strerror(status));
+        this->enabled = 0;
+        return -1;
+    }
+    return 0;
+}
+
 /* This function waits until it is possible to write a full sound buffer */
 static void
 ALSA_WaitDevice(_THIS)
 {
-    /* We're in blocking mode, so there's nothing to do here */
+    snd_pcm_t *pcm_handle = this->hidden->pcm_handle;
+    snd_pcm_sframes_t avail;
+    int status;
+
+    if (!this->hidden->mmap) {
+        /* We're in blocking mode, so there's nothing to do here */
+        return;
+    }
+
+    /* Sleep in poll() until a period of the ring buffer is free */
+    while (this->enabled) {
+        avail = ALSA_snd_pcm_avail_update(pcm_handle);
+        if (avail < 0) {
+            if (ALSA_recover(this, (int) avail) < 0) {
+                return;
+            }
+            continue;
+        }
+        if (avail >= (snd_pcm_sframes_t) this->spec.samples) {
+            return;
+        }
+        if (ALSA_snd_pcm_state(pcm_handle) != SND_PCM_STATE_RUNNING) {
+            /* Nothing is draining the buffer, so don't wait for it */
+            return;
+        }
+        status = ALSA_snd_pcm_wait(pcm_handle, 1000);
+        if (status < 0 && ALSA_recover(this, status) < 0) {
+            return;
+        }
+    }
 }
 
 
@@ -233,7 +301,7 @@ ALSA_WaitDevice(_THIS)
  *  and for Windows DirectX [and CoreAudio], this is FL-FR-C-LFE-RL-RR"
  */
 #define SWIZ6(T) \
-    T *ptr = (T *) this->hidden->mixbuf; \
+    T *ptr = (T *) buf; \
     Uint32 i; \
     for (i = 0; i < this->spec.samples; i++, ptr += 6) { \
         T tmp; \
@@ -242,25 +310,25 @@ ALSA_WaitDevice(_THIS)
     }
 
 static __inline__ void
-swizzle_alsa_channels_6_64bit(_THIS)
+swizzle_alsa_channels_6_64bit(_THIS, Uint8 * buf)
 {
     SWIZ6(Uint64);
 }
 
 static __inline__ void
-swizzle_alsa_channels_6_32bit(_THIS)
+swizzle_alsa_channels_6_32bit(_THIS, Uint8 * buf)
 {
     SWIZ6(Uint32);
 }
 
 static __inline__ void
-swizzle_alsa_channels_6_16bit(_THIS)
+swizzle_alsa_channels_6_16bit(_THIS, Uint8 * buf)
 {
     SWIZ6(Uint16);
 }
 
 static __inline__ void
-swizzle_alsa_channels_6_8bit(_THIS)
+swizzle_alsa_channels_6_8bit(_THIS, Uint8 * buf)
 {
     SWIZ6(Uint8);
 }
@@ -269,28 +337,76 @@ swizzle_alsa_channels_6_8bit(_THIS)
 
 
 /*
- * Called right before feeding this->hidden->mixbuf to the hardware. Swizzle
- *  channels from Windows/Mac order to the format alsalib will want.
+ * Called right before feeding a buffer to the hardware. Swizzle channels
+ *  from Windows/Mac order to the format alsalib will want.
  */
 static __inline__ void
-swizzle_alsa_channels(_THIS)
+swizzle_alsa_channels(_THIS, Uint8 * buf)
 {
     if (this->spec.channels == 6) {
         const Uint16 fmtsize = (this->spec.format & 0xFF);      /* bits/channel. */
         if (fmtsize == 16)
-            swizzle_alsa_channels_6_16bit(this);
+            swizzle_alsa_channels_6_16bit(this, buf);
         else if (fmtsize == 8)
-            swizzle_alsa_channels_6_8bit(this);
+            swizzle_alsa_channels_6_8bit(this, buf);
         else if (fmtsize == 32)
-            swizzle_alsa_channels_6_32bit(this);
+            swizzle_alsa_channels_6_32bit(this, buf);
         else if (fmtsize == 64)
-            swizzle_alsa_channels_6_64bit(this);
+            swizzle_alsa_channels_6_64bit(this, buf);
     }
 
     /* !!! FIXME: update this for 7.1 if needed, later. */
 }
 
 
+/* Commit the period the callback wrote straight into the ring buffer */
+static void
+ALSA_PlayDeviceMMap(_THIS)
+{
+    snd_pcm_t *pcm_handle = this->hidden->pcm_handle;
+    snd_pcm_sframes_t status;
+
+    if (this->hidden->mmap_buf != NULL) {
+        swizzle_alsa_channels(this, this->hidden->mmap_buf);
+        status = ALSA_snd_pcm_mmap_commit(pcm_handle,
+                                          this->hidden->mmap_offset,
+                                          this->spec.samples);
+        this->hidden->mmap_buf = NULL;
+        if (status != (snd_pcm_sframes_t) this->spec.samples) {
+            /* The period is lost, but the next one can start over */
+            ALSA_recover(this, (status < 0) ? (int) status : -EPIPE);
+            return;
+        }
+    } else {
+        /* The period wraps around the end of the ring buffer */
+        const Uint8 *sample_buf = (const Uint8 *) this->hidden->mixbuf;
+        const int frame_size = (((int) (this->spec.format & 0xFF)) / 8) *
+                                    this->spec.channels;
+        snd_pcm_uframes_t frames_left = this->spec.samples;
+
+        swizzle_alsa_channels(this, this->hidden->mixbuf);
+        while (frames_left > 0 && this->enabled) {
+            status = ALSA_snd_pcm_mmap_writei(pcm_handle, sample_buf,
+                                              frames_left);
+            if (status < 0) {
+                if (status == -EAGAIN) {
+                    ALSA_snd_pcm_wait(pcm_handle, 1000);
+                } else if (ALSA_recover(this, (int) status) < 0) {
+                    return;
+                }
+                continue;
+            }
+            sample_buf += status * frame_size;
+            frames_left -= status;
+        }
+    }
+
+    /* Committing doesn't start the stream the way writing does */
+    if (ALSA_snd_pcm_state(pcm_handle) == SND_PCM_STATE_PREPARED) {
+        ALSA_snd_pcm_start(pcm_handle);
+    }
+}
+
 static void
 ALSA_PlayDevice(_THIS)
 {
@@ -300,7 +416,12 @@ ALSA_PlayDevice(_THIS)
                                 this->spec.channels;
     snd_pcm_uframes_t frames_left = ((snd_pcm_uframes_t) this->spec.samples);
 
-    swizzle_alsa_channels(this);
+    if (this->hidden->mmap) {
+        ALSA_PlayDeviceMMap(this);
+        return;
+    }
+
+    swizzle_alsa_channels(this, this->hidden->mixbuf);
 
     while ( frames_left > 0 && this->enabled ) {
         /* !!! FIXME: This works, but needs more testing before going live */
@@ -315,12 +436,7 @@ ALSA_PlayDevice(_THIS)
                 SDL_Delay(1);
                 continue;
             }
-            status = ALSA_snd_pcm_recover(this->hidden->pcm_handle, status, 0);
-            if (status < 0) {
-                /* Hmm, not much we can do - abort */
-                fprintf(stderr, "ALSA write failed (unrecoverable): %s\n",
-                        ALSA_snd_strerror(status));
-                this->enabled = 0;
+            if (ALSA_recover(this, status) < 0) {
                 return;
             }
             continue;
@@ -333,9 +449,49 @@ ALSA_PlayDevice(_THIS)
 static Uint8 *
 ALSA_GetDeviceBuf(_THIS)
 {
+    if (this->hidden->mmap) {
+        const snd_pcm_channel_area_t *areas;
+        snd_pcm_uframes_t offset;
+        snd_pcm_uframes_t frames = this->spec.samples;
+
+        /* Let the callback write straight into the ring buffer, as long
+           as the whole period is contiguous there */
+        if (ALSA_snd_pcm_mmap_begin(this->hidden->pcm_handle,
+                                    &areas, &offset, &frames) >= 0 &&
+            frames == this->spec.samples) {
+            this->hidden->mmap_offset = offset;
+            this->hidden->mmap_buf = (Uint8 *) areas[0].addr +
+                (areas[0].first + offset * areas[0].step) / 8;
+            return (this->hidden->mmap_buf);
+        }
+        this->hidden->mmap_buf = NULL;
+    }
     return (this->hidden->mixbuf);
 }
 
+/* The delay is how long until a frame written now is played */
+static int
+ALSA_GetDeviceClock(_THIS, SDL_AudioClock * clock)
+{
+    snd_pcm_sframes_t delay = 0;
+    Uint64 queued;
+    int status;
+
+    status = ALSA_snd_pcm_delay(this->hidden->pcm_handle, &delay);
+    if (status < 0) {
+        SDL_SetError("ALSA: Couldn't get the delay: %s",
+                     ALSA_snd_strerror(status));
+        return -1;
+    }
+    if (delay < 0) {
+        delay = 0;
+    }
+    queued = SDL_min((Uint64) delay, clock->frames_submitted);
+    clock->frames_played = clock->frames_submitted - queued;
+    clock->latency = (Uint32) ((queued * 1000000) / this->spec.freq);
+    return 0;
+}
+
 static void
 ALSA_CloseDevice(_THIS)
 {
@@ -345,6 +501,9 @@ ALSA_CloseDevice(_THIS)
             this->hidden->mixbuf = NULL;
         }
         if (this->hidden->pcm_handle) {
+            if (SDL_getenv("SDL_AUDIO_ALSA_DEBUG")) {
+                fprintf(stderr, "ALSA: %u underruns\n", this->underruns);
+            }
             ALSA_snd_pcm_drain(this->hidden->pcm_handle);
             ALSA_snd_pcm_close(this->hidden->pcm_handle);
             this->hidden->pcm_handle = NULL;
@@ -376,7 +535,14 @@ ALSA_finalize_hardware(_THIS, snd_pcm_hw_params_t *hwparams, int override)
     }
 
     /* !!! FIXME: Is this safe to do? */
-    this->spec.samples = bufsize / 2;
+    if (this->hidden->latency) {
+        /* Each callback fills one period, whatever the latency */
+        snd_pcm_uframes_t persize = 0;
+        ALSA_snd_pcm_hw_params_get_period_size(hwparams, &persize, NULL);
+        this->spec.samples = persize;
+    } else {
+        this->spec.samples = bufsize / 2;
+    }
 
     /* This is useful for debugging */
     if ( SDL_getenv("SDL_AUDIO_ALSA_DEBUG") ) {
@@ -466,6 +632,44 @@ ALSA_set_buffer_size(_THIS, snd_pcm_hw_params_t *params, int override)
     return ALSA_finalize_hardware(this, hwparams, override);
 }
 
+/* Size the buffer to hold SDL_AUDIO_ALSA_LATENCY milliseconds of audio */
+static int
+ALSA_set_latency(_THIS, snd_pcm_hw_params_t *params)
+{
+    int status;
+    snd_pcm_hw_params_t *hwparams;
+    snd_pcm_uframes_t frames;
+    unsigned int periods;
+
+    if (this->hidden->latency <= 0) {
+        return(-1);
+    }
+
+    /* Copy the hardware parameters for this setup */
+    snd_pcm_hw_params_alloca(&hwparams);
+    ALSA_snd_pcm_hw_params_copy(hwparams, params);
+
+    /* Refill the buffer a period at a time, with two periods in it */
+    frames = (this->spec.freq * this->hidden->latency) / 1000 / 2;
+    if (frames < 16) {
+        frames = 16;
+    }
+    status = ALSA_snd_pcm_hw_params_set_period_size_near(
+                this->hidden->pcm_handle, hwparams, &frames, NULL);
+    if ( status < 0 ) {
+        return(-1);
+    }
+
+    periods = 2;
+    status = ALSA_snd_pcm_hw_params_set_periods_near(
+                this->hidden->pcm_handle, hwparams, &periods, NULL);
+    if ( status < 0 ) {
+        return(-1);
+    }
+
+    return ALSA_finalize_hardware(this, hwparams, 1);
+}
+
 static int
 ALSA_OpenDevice(_THIS, const char *devname, int iscapture)
 {
@@ -477,6 +681,7 @@ ALSA_OpenDevice(_THIS, const char *devname, int iscapture)
     SDL_AudioFormat test_format = 0;
     unsigned int rate = 0;
     unsigned int channels = 0;
+    const char *env;
 
     /* Initialize all variables that we clean on shutdown */
     this->hidden = (struct SDL_PrivateAudioData *)
@@ -512,9 +717,17 @@ ALSA_OpenDevice(_THIS, const char *devname, int iscapture)
         return 0;
     }
 
-    /* SDL only uses interleaved sample output */
-    status = ALSA_snd_pcm_hw_params_set_access(pcm_handle, hwparams,
-                                               SND_PCM_ACCESS_RW_INTERLEAVED);
+    /* SDL only uses interleaved sample output, through mmap if asked to */
+    env = SDL_getenv("SDL_AUDIO_ALSA_MMAP");
+    if (env && SDL_atoi(env)) {
+        status = ALSA_snd_pcm_hw_params_set_access(pcm_handle, hwparams,
+                                                 SND_PCM_ACCESS_MMAP_INTERLEAVED);
+        this->hidden->mmap = (status >= 0);
+    }
+    if (!this->hidden->mmap) {
+        status = ALSA_snd_pcm_hw_params_set_access(pcm_handle, hwparams,
+                                                 SND_PCM_ACCESS_RW_INTERLEAVED);
+    }
     if (status < 0) {
         ALSA_CloseDevice(this);
         SDL_SetError("ALSA: Couldn't set interleaved access: %s",
@@ -604,7 +817,12 @@ ALSA_OpenDevice(_THIS, const char *devname, int iscapture)
     this->spec.freq = rate;
 
     /* Set the buffer size, in samples */
-    if ( ALSA_set_period_size(this, hwparams, 0) < 0 &&
+    env = SDL_getenv("SDL_AUDIO_ALSA_LATENCY");
+    if (env) {
+        this->hidden->latency = SDL_atoi(env);
+    }
+    if ( ALSA_set_latency(this, hwparams) < 0 &&
+         ALSA_set_period_size(this, hwparams, 0) < 0 &&
          ALSA_set_buffer_size(this, hwparams, 0) < 0 ) {
         /* Failed to set desired buffer size, do the best you can... */
         if ( ALSA_set_period_size(this, hwparams, 1) < 0 ) {
@@ -630,6 +848,15 @@ ALSA_OpenDevice(_THIS, const char *devname, int iscapture)
                      ALSA_snd_strerror(status));
         return 0;
     }
+    /* Wake up from poll() once a whole period can be written */
+    status = ALSA_snd_pcm_sw_params_set_avail_min(pcm_handle, swparams,
+                                                  this->spec.samples);
+    if (status < 0) {
+        ALSA_CloseDevice(this);
+        SDL_SetError("ALSA: Couldn't set wakeup threshold: %s",
+                     ALSA_snd_strerror(status));
+        return 0;
+    }
     status = ALSA_snd_pcm_sw_params(pcm_handle, swparams);
     if (status < 0) {
         ALSA_CloseDevice(this);
@@ -676,6 +903,7 @@ ALSA_Init(SDL_AudioDriverImpl * impl)
     impl->WaitDevice = ALSA_WaitDevice;
     impl->GetDeviceBuf = ALSA_GetDeviceBuf;
     impl->PlayDevice = ALSA_PlayDevice;
+    impl->GetDeviceClock = ALSA_GetDeviceClock;
     impl->CloseDevice = ALSA_CloseDevice;
     impl->Deinitialize = ALSA_Deinitialize;
     impl->OnlyHasDefaultOutputDevice = 1;       /* !!! FIXME: Add device enum! */
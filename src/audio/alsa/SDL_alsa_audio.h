@@ -39,6 +39,14 @@ struct SDL_PrivateAudioData
     /* Raw mixing buffer */
     Uint8 *mixbuf;
     int mixlen;
+
+    /* Whether the callback writes straight into the mmap'ed ring buffer */
+    int mmap;
+    Uint8 *mmap_buf;
+    snd_pcm_uframes_t mmap_offset;
+
+    /* The requested buffer latency in milliseconds, or 0 */
+    int latency;
 };
 
 #endif /* _ALSA_PCM_audio_h */
@@ -23,7 +23,7 @@
 */
 #include "SDL_config.h"
 
-/* Output raw audio data to a file. */
+/* Output raw audio data to a file, or record from a WAVE file. */
 
 #if HAVE_STDIO_H
 #include <stdio.h>
@@ -42,26 +42,53 @@
 /* environment variables and defaults. */
 #define DISKENVR_OUTFILE         "SDL_DISKAUDIOFILE"
 #define DISKDEFAULT_OUTFILE      "sdlaudio.raw"
+#define DISKENVR_INFILE          "SDL_DISKAUDIOFILEIN"
+#define DISKDEFAULT_INFILE       "sdlaudio-in.wav"
 #define DISKENVR_WRITEDELAY      "SDL_DISKAUDIODELAY"
 #define DISKDEFAULT_WRITEDELAY   150
+#define DISKENVR_SPEED           "SDL_DISKAUDIOSPEED"
+#define DISKENVR_FREQUENCY       "SDL_DISKAUDIOFREQUENCY"
+#define DISKENVR_CHANNELS        "SDL_DISKAUDIOCHANNELS"
 
 static const char *
-DISKAUD_GetOutputFilename(const char *devname)
+DISKAUD_GetFilename(const char *devname, int iscapture)
 {
     if (devname == NULL) {
-        devname = SDL_getenv(DISKENVR_OUTFILE);
+        devname = SDL_getenv(iscapture ? DISKENVR_INFILE : DISKENVR_OUTFILE);
         if (devname == NULL) {
-            devname = DISKDEFAULT_OUTFILE;
+            devname = iscapture ? DISKDEFAULT_INFILE : DISKDEFAULT_OUTFILE;
         }
     }
     return devname;
 }
 
+/* Keep time at a multiple of real time if asked to, or else just wait a
+   fixed delay between buffers.  Call this once the spec is final. */
+static void
+DISKAUD_StartTiming(_THIS)
+{
+    const char *envr = SDL_getenv(DISKENVR_SPEED);
+
+    if (envr) {
+        this->hidden->paced = 1;
+        SDL_StartAudioVirtualClock(&this->hidden->vclock, this->spec.freq,
+                                   SDL_atof(envr));
+    } else {
+        envr = SDL_getenv(DISKENVR_WRITEDELAY);
+        this->hidden->write_delay =
+            (envr) ? SDL_atoi(envr) : DISKDEFAULT_WRITEDELAY;
+    }
+}
+
 /* This function waits until it is possible to write a full sound buffer */
 static void
 DISKAUD_WaitDevice(_THIS)
 {
-    SDL_Delay(this->hidden->write_delay);
+    if (this->hidden->paced) {
+        SDL_WaitAudioVirtualClock(&this->hidden->vclock, this->spec.samples);
+    } else {
+        SDL_Delay(this->hidden->write_delay);
+    }
 }
 
 static void
@@ -88,6 +115,52 @@ DISKAUD_GetDeviceBuf(_THIS)
     return (this->hidden->mixbuf);
 }
 
+/* Read the next buffer from the file, as if it were being recorded */
+static int
+DISKAUD_CaptureFromDevice(_THIS, Uint8 * buffer, int buflen)
+{
+    const int framesize = this->spec.size / this->spec.samples;
+    const int frames = buflen / framesize;
+    int done = 0;
+    int ret;
+
+    /* Wait as long as it would take to record it */
+    DISKAUD_WaitDevice(this);
+    while (done < frames) {
+        ret = SDL_ReadWAVStream(this->hidden->input,
+                                buffer + done * framesize, frames - done);
+        if (ret < 0) {
+            this->enabled = 0;
+            return 0;
+        } else if (ret == 0) {
+            break;
+        }
+        done += ret;
+    }
+
+    /* After the end of the file, keep recording silence */
+    SDL_memset(buffer + done * framesize, this->spec.silence,
+               buflen - done * framesize);
+    return buflen;
+}
+
+/* Each buffer goes straight to the file, or came straight from it, and
+   is played on the virtual clock if there is one */
+static int
+DISKAUD_GetDeviceClock(_THIS, SDL_AudioClock * clock)
+{
+    Uint64 played = clock->frames_submitted;
+
+    if (this->hidden->paced) {
+        played = SDL_GetAudioVirtualClockFrames(&this->hidden->vclock);
+        played = SDL_min(played, clock->frames_submitted);
+    }
+    clock->frames_played = played;
+    clock->latency = (Uint32)
+        (((clock->frames_submitted - played) * 1000000) / this->spec.freq);
+    return 0;
+}
+
 static void
 DISKAUD_CloseDevice(_THIS)
 {
@@ -100,6 +173,10 @@ DISKAUD_CloseDevice(_THIS)
             SDL_RWclose(this->hidden->output);
             this->hidden->output = NULL;
         }
+        if (this->hidden->input != NULL) {
+            SDL_CloseWAVStream(this->hidden->input);
+            this->hidden->input = NULL;
+        }
         SDL_free(this->hidden);
         this->hidden = NULL;
     }
@@ -108,8 +185,9 @@ DISKAUD_CloseDevice(_THIS)
 static int
 DISKAUD_OpenDevice(_THIS, const char *devname, int iscapture)
 {
-    const char *envr = SDL_getenv(DISKENVR_WRITEDELAY);
-    const char *fname = DISKAUD_GetOutputFilename(devname);
+    const char *fname = DISKAUD_GetFilename(devname, iscapture);
+    const char *envr;
+    SDL_AudioSpec wavspec;
 
     this->hidden = (struct SDL_PrivateAudioData *)
         SDL_malloc(sizeof(*this->hidden));
@@ -119,6 +197,40 @@ DISKAUD_OpenDevice(_THIS, const char *devname, int iscapture)
     }
     SDL_memset(this->hidden, 0, sizeof(*this->hidden));
 
+    if (iscapture) {
+        /* Record in whatever format the file is in, and let the core
+           convert it */
+        this->hidden->input = SDL_OpenWAVStream(fname, &wavspec);
+        if (this->hidden->input == NULL) {
+            DISKAUD_CloseDevice(this);
+            return 0;
+        }
+        this->spec.format = wavspec.format;
+        this->spec.channels = wavspec.channels;
+        this->spec.freq = wavspec.freq;
+        SDL_CalculateAudioSpec(&this->spec);
+        DISKAUD_StartTiming(this);
+
+#if HAVE_STDIO_H
+        fprintf(stderr,
+                "WARNING: You are using the SDL disk writer audio driver!\n"
+                " Reading from file [%s].\n", fname);
+#endif
+        return 1;
+    }
+
+    /* Write at a fixed rate or channel count if asked to, like hardware
+       that only takes one, and let the core convert to it */
+    envr = SDL_getenv(DISKENVR_FREQUENCY);
+    if (envr && SDL_atoi(envr) > 0) {
+        this->spec.freq = SDL_atoi(envr);
+    }
+    envr = SDL_getenv(DISKENVR_CHANNELS);
+    if (envr && SDL_atoi(envr) > 0) {
+        this->spec.channels = (Uint8) SDL_atoi(envr);
+    }
+    SDL_CalculateAudioSpec(&this->spec);
+
     /* Open the audio device */
     this->hidden->output = SDL_RWFromFile(fname, "wb");
     if (this->hidden->output == NULL) {
@@ -127,16 +239,14 @@ DISKAUD_OpenDevice(_THIS, const char *devname, int iscapture)
     }
 
     /* Allocate mixing buffer */
+    this->hidden->mixlen = this->spec.size;
     this->hidden->mixbuf = (Uint8 *) SDL_AllocAudioMem(this->hidden->mixlen);
     if (this->hidden->mixbuf == NULL) {
         DISKAUD_CloseDevice(this);
         return 0;
     }
     SDL_memset(this->hidden->mixbuf, this->spec.silence, this->spec.size);
-
-    this->hidden->mixlen = this->spec.size;
-    this->hidden->write_delay =
-        (envr) ? SDL_atoi(envr) : DISKDEFAULT_WRITEDELAY;
+    DISKAUD_StartTiming(this);
 
 #if HAVE_STDIO_H
     fprintf(stderr,
@@ -157,6 +267,9 @@ DISKAUD_Init(SDL_AudioDriverImpl * impl)
     impl->PlayDevice = DISKAUD_PlayDevice;
     impl->GetDeviceBuf = DISKAUD_GetDeviceBuf;
     impl->CloseDevice = DISKAUD_CloseDevice;
+    impl->CaptureFromDevice = DISKAUD_CaptureFromDevice;
+    impl->GetDeviceClock = DISKAUD_GetDeviceClock;
+    impl->HasCaptureSupport = 1;
 
     return 1;   /* this audio target is available. */
 }
@@ -34,9 +34,14 @@ struct SDL_PrivateAudioData
 {
     /* The file descriptor for the audio device */
     SDL_RWops *output;
+    SDL_WAVStream *input;
     Uint8 *mixbuf;
     Uint32 mixlen;
     Uint32 write_delay;
+
+    /* Keeps time instead of write_delay, if a speed was asked for */
+    int paced;
+    SDL_AudioVirtualClock vclock;
 };
 
 #endif /* _SDL_diskaudio_h */
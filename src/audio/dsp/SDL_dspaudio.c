@@ -368,6 +368,42 @@ DSP_GetDeviceBuf(_THIS)
     return (this->hidden->mixbuf);
 }
 
+/* Whatever is still queued in the driver hasn't been played yet */
+static int
+DSP_GetDeviceClock(_THIS, SDL_AudioClock * clock)
+{
+    const int framesize = this->spec.size / this->spec.samples;
+    Uint64 queued;
+    int bytes;
+#ifndef SNDCTL_DSP_GETODELAY
+    audio_buf_info info;
+#endif
+
+    if (this->iscapture) {
+        SDL_Unsupported();
+        return -1;
+    }
+#ifdef SNDCTL_DSP_GETODELAY
+    if (ioctl(this->hidden->audio_fd, SNDCTL_DSP_GETODELAY, &bytes) < 0) {
+        SDL_SetError("Couldn't get audio delay: %s", strerror(errno));
+        return -1;
+    }
+#else
+    if (ioctl(this->hidden->audio_fd, SNDCTL_DSP_GETOSPACE, &info) < 0) {
+        SDL_SetError("Couldn't get audio space: %s", strerror(errno));
+        return -1;
+    }
+    bytes = info.fragstotal * info.fragsize - info.bytes;
+#endif
+    if (bytes < 0) {
+        bytes = 0;
+    }
+    queued = SDL_min((Uint64) (bytes / framesize), clock->frames_submitted);
+    clock->frames_played = clock->frames_submitted - queued;
+    clock->latency = (Uint32) ((queued * 1000000) / this->spec.freq);
+    return 0;
+}
+
 static int
 DSP_Init(SDL_AudioDriverImpl * impl)
 {
@@ -377,6 +413,7 @@ DSP_Init(SDL_AudioDriverImpl * impl)
     impl->OpenDevice = DSP_OpenDevice;
     impl->PlayDevice = DSP_PlayDevice;
     impl->GetDeviceBuf = DSP_GetDeviceBuf;
+    impl->GetDeviceClock = DSP_GetDeviceClock;
     impl->CloseDevice = DSP_CloseDevice;
     impl->Deinitialize = DSP_Deinitialize;
 
@@ -26,12 +26,79 @@
 /* Output audio to nowhere... */
 
 #include "SDL_audio.h"
+#include "../SDL_audiomem.h"
 #include "../SDL_audio_c.h"
 #include "SDL_dummyaudio.h"
 
+/* environment variables and defaults. */
+#define DUMMYENVR_SPEED         "SDL_DUMMYAUDIOSPEED"
+#define DUMMYDEFAULT_SPEED      1.0
+
+/* Play at the requested speed, which may be faster than real time */
+static void
+DUMMYAUD_WaitDevice(_THIS)
+{
+    SDL_WaitAudioVirtualClock(&this->hidden->vclock, this->spec.samples);
+}
+
+/* The audio is rendered into memory, and that's as far as it goes */
+static Uint8 *
+DUMMYAUD_GetDeviceBuf(_THIS)
+{
+    return (this->hidden->mixbuf);
+}
+
+/* Frames are played on the virtual clock, with nothing else queued */
+static int
+DUMMYAUD_GetDeviceClock(_THIS, SDL_AudioClock * clock)
+{
+    Uint64 played = SDL_GetAudioVirtualClockFrames(&this->hidden->vclock);
+
+    clock->frames_played = SDL_min(played, clock->frames_submitted);
+    clock->latency = (Uint32)
+        (((clock->frames_submitted - clock->frames_played) * 1000000) /
+         this->spec.freq);
+    return 0;
+}
+
+static void
+DUMMYAUD_CloseDevice(_THIS)
+{
+    if (this->hidden != NULL) {
+        if (this->hidden->mixbuf != NULL) {
+            SDL_FreeAudioMem(this->hidden->mixbuf);
+            this->hidden->mixbuf = NULL;
+        }
+        SDL_free(this->hidden);
+        this->hidden = NULL;
+    }
+}
+
 static int
 DUMMYAUD_OpenDevice(_THIS, const char *devname, int iscapture)
 {
+    const char *envr = SDL_getenv(DUMMYENVR_SPEED);
+
+    this->hidden = (struct SDL_PrivateAudioData *)
+        SDL_malloc(sizeof(*this->hidden));
+    if (this->hidden == NULL) {
+        SDL_OutOfMemory();
+        return 0;
+    }
+    SDL_memset(this->hidden, 0, sizeof(*this->hidden));
+
+    /* Allocate mixing buffer */
+    this->hidden->mixlen = this->spec.size;
+    this->hidden->mixbuf = (Uint8 *) SDL_AllocAudioMem(this->hidden->mixlen);
+    if (this->hidden->mixbuf == NULL) {
+        DUMMYAUD_CloseDevice(this);
+        SDL_OutOfMemory();
+        return 0;
+    }
+    SDL_memset(this->hidden->mixbuf, this->spec.silence, this->spec.size);
+
+    SDL_StartAudioVirtualClock(&this->hidden->vclock, this->spec.freq,
+                               (envr) ? SDL_atof(envr) : DUMMYDEFAULT_SPEED);
     return 1;                   /* always succeeds. */
 }
 
@@ -40,6 +107,10 @@ DUMMYAUD_Init(SDL_AudioDriverImpl * impl)
 {
     /* Set the function pointers */
     impl->OpenDevice = DUMMYAUD_OpenDevice;
+    impl->WaitDevice = DUMMYAUD_WaitDevice;
+    impl->GetDeviceBuf = DUMMYAUD_GetDeviceBuf;
+    impl->GetDeviceClock = DUMMYAUD_GetDeviceClock;
+    impl->CloseDevice = DUMMYAUD_CloseDevice;
     impl->OnlyHasDefaultOutputDevice = 1;
     return 1;   /* this audio target is available. */
 }
@@ -31,11 +31,12 @@
 
 struct SDL_PrivateAudioData
 {
-    /* The file descriptor for the audio device */
+    /* The memory the audio is rendered into */
     Uint8 *mixbuf;
     Uint32 mixlen;
-    Uint32 write_delay;
-    Uint32 initial_calls;
+
+    /* Keeps time in place of the hardware */
+    SDL_AudioVirtualClock vclock;
 };
 
 #endif /* _SDL_dummyaudio_h */
@@ -75,10 +75,18 @@ static void (*PULSEAUDIO_pa_simple_free) (pa_simple *);
 static pa_channel_map *(*PULSEAUDIO_pa_channel_map_init_auto) (
     pa_channel_map *, unsigned, pa_channel_map_def_t);
 static const char * (*PULSEAUDIO_pa_strerror) (int);
-static pa_mainloop * (*PULSEAUDIO_pa_mainloop_new) (void);
-static pa_mainloop_api * (*PULSEAUDIO_pa_mainloop_get_api) (pa_mainloop *);
-static int (*PULSEAUDIO_pa_mainloop_iterate) (pa_mainloop *, int, int *);
-static void (*PULSEAUDIO_pa_mainloop_free) (pa_mainloop *);
+static pa_threaded_mainloop * (*PULSEAUDIO_pa_threaded_mainloop_new) (void);
+static pa_mainloop_api * (*PULSEAUDIO_pa_threaded_mainloop_get_api) (
+    pa_threaded_mainloop *);
+static int (*PULSEAUDIO_pa_threaded_mainloop_start) (pa_threaded_mainloop *);
+static void (*PULSEAUDIO_pa_threaded_mainloop_stop) (pa_threaded_mainloop *);
+static void (*PULSEAUDIO_pa_threaded_mainloop_lock) (pa_threaded_mainloop *);
+static void (*PULSEAUDIO_pa_threaded_mainloop_unlock) (
+    pa_threaded_mainloop *);
+static void (*PULSEAUDIO_pa_threaded_mainloop_wait) (pa_threaded_mainloop *);
+static void (*PULSEAUDIO_pa_threaded_mainloop_signal) (
+    pa_threaded_mainloop *, int);
+static void (*PULSEAUDIO_pa_threaded_mainloop_free) (pa_threaded_mainloop *);
 
 static pa_operation_state_t (*PULSEAUDIO_pa_operation_get_state) (
     pa_operation *);
@@ -87,6 +95,8 @@ static void (*PULSEAUDIO_pa_operation_unref) (pa_operation *);
 
 static pa_context * (*PULSEAUDIO_pa_context_new) (pa_mainloop_api *,
     const char *);
+static void (*PULSEAUDIO_pa_context_set_state_callback) (pa_context *,
+    pa_context_notify_cb_t, void *);
 static int (*PULSEAUDIO_pa_context_connect) (pa_context *, const char *,
     pa_context_flags_t, const pa_spawn_api *);
 static pa_context_state_t (*PULSEAUDIO_pa_context_get_state) (pa_context *);
@@ -95,12 +105,26 @@ static void (*PULSEAUDIO_pa_context_unref) (pa_context *);
 
 static pa_stream * (*PULSEAUDIO_pa_stream_new) (pa_context *, const char *,
     const pa_sample_spec *, const pa_channel_map *);
+static void (*PULSEAUDIO_pa_stream_set_state_callback) (pa_stream *,
+    pa_stream_notify_cb_t, void *);
+static void (*PULSEAUDIO_pa_stream_set_write_callback) (pa_stream *,
+    pa_stream_request_cb_t, void *);
+static void (*PULSEAUDIO_pa_stream_set_read_callback) (pa_stream *,
+    pa_stream_request_cb_t, void *);
 static int (*PULSEAUDIO_pa_stream_connect_playback) (pa_stream *, const char *,
     const pa_buffer_attr *, pa_stream_flags_t, pa_cvolume *, pa_stream *);
+static int (*PULSEAUDIO_pa_stream_connect_record) (pa_stream *, const char *,
+    const pa_buffer_attr *, pa_stream_flags_t);
 static pa_stream_state_t (*PULSEAUDIO_pa_stream_get_state) (pa_stream *);
 static size_t (*PULSEAUDIO_pa_stream_writable_size) (pa_stream *);
 static int (*PULSEAUDIO_pa_stream_write) (pa_stream *, const void *, size_t,
     pa_free_cb_t, int64_t, pa_seek_mode_t);
+static int (*PULSEAUDIO_pa_stream_peek) (pa_stream *, const void **,
+    size_t *);
+static int (*PULSEAUDIO_pa_stream_drop) (pa_stream *);
+static int (*PULSEAUDIO_pa_stream_get_time) (pa_stream *, pa_usec_t *);
+static int (*PULSEAUDIO_pa_stream_get_latency) (pa_stream *, pa_usec_t *,
+    int *);
 static pa_operation * (*PULSEAUDIO_pa_stream_drain) (pa_stream *,
     pa_stream_success_cb_t, void *);
 static int (*PULSEAUDIO_pa_stream_disconnect) (pa_stream *);
@@ -182,23 +206,37 @@ load_pulseaudio_syms(void)
 {
     SDL_PULSEAUDIO_SYM(pa_simple_new);
     SDL_PULSEAUDIO_SYM(pa_simple_free);
-    SDL_PULSEAUDIO_SYM(pa_mainloop_new);
-    SDL_PULSEAUDIO_SYM(pa_mainloop_get_api);
-    SDL_PULSEAUDIO_SYM(pa_mainloop_iterate);
-    SDL_PULSEAUDIO_SYM(pa_mainloop_free);
+    SDL_PULSEAUDIO_SYM(pa_threaded_mainloop_new);
+    SDL_PULSEAUDIO_SYM(pa_threaded_mainloop_get_api);
+    SDL_PULSEAUDIO_SYM(pa_threaded_mainloop_start);
+    SDL_PULSEAUDIO_SYM(pa_threaded_mainloop_stop);
+    SDL_PULSEAUDIO_SYM(pa_threaded_mainloop_lock);
+    SDL_PULSEAUDIO_SYM(pa_threaded_mainloop_unlock);
+    SDL_PULSEAUDIO_SYM(pa_threaded_mainloop_wait);
+    SDL_PULSEAUDIO_SYM(pa_threaded_mainloop_signal);
+    SDL_PULSEAUDIO_SYM(pa_threaded_mainloop_free);
     SDL_PULSEAUDIO_SYM(pa_operation_get_state);
     SDL_PULSEAUDIO_SYM(pa_operation_cancel);
     SDL_PULSEAUDIO_SYM(pa_operation_unref);
     SDL_PULSEAUDIO_SYM(pa_context_new);
+    SDL_PULSEAUDIO_SYM(pa_context_set_state_callback);
     SDL_PULSEAUDIO_SYM(pa_context_connect);
     SDL_PULSEAUDIO_SYM(pa_context_get_state);
     SDL_PULSEAUDIO_SYM(pa_context_disconnect);
     SDL_PULSEAUDIO_SYM(pa_context_unref);
     SDL_PULSEAUDIO_SYM(pa_stream_new);
+    SDL_PULSEAUDIO_SYM(pa_stream_set_state_callback);
+    SDL_PULSEAUDIO_SYM(pa_stream_set_write_callback);
+    SDL_PULSEAUDIO_SYM(pa_stream_set_read_callback);
     SDL_PULSEAUDIO_SYM(pa_stream_connect_playback);
+    SDL_PULSEAUDIO_SYM(pa_stream_connect_record);
     SDL_PULSEAUDIO_SYM(pa_stream_get_state);
     SDL_PULSEAUDIO_SYM(pa_stream_writable_size);
     SDL_PULSEAUDIO_SYM(pa_stream_write);
+    SDL_PULSEAUDIO_SYM(pa_stream_peek);
+    SDL_PULSEAUDIO_SYM(pa_stream_drop);
+    SDL_PULSEAUDIO_SYM(pa_stream_get_time);
+    SDL_PULSEAUDIO_SYM(pa_stream_get_latency);
     SDL_PULSEAUDIO_SYM(pa_stream_drain);
     SDL_PULSEAUDIO_SYM(pa_stream_disconnect);
     SDL_PULSEAUDIO_SYM(pa_stream_unref);
@@ -208,97 +246,218 @@ load_pulseaudio_syms(void)
 }
 
 
-/* This function waits until it is possible to write a full sound buffer */
+/*
+ * Everything below runs on PulseAudio's own thread, which calls back into
+ *  the application as soon as the server asks for audio.  There is no SDL
+ *  audio thread in between.
+ */
+
 static void
-PULSEAUDIO_WaitDevice(_THIS)
+context_state_callback(pa_context *c, void *userdata)
 {
-    struct SDL_PrivateAudioData *h = this->hidden;
-
-    while(1) {
-        if (PULSEAUDIO_pa_context_get_state(h->context) != PA_CONTEXT_READY ||
-            PULSEAUDIO_pa_stream_get_state(h->stream) != PA_STREAM_READY ||
-            PULSEAUDIO_pa_mainloop_iterate(h->mainloop, 1, NULL) < 0) {
-            this->enabled = 0;
-            return;
-        }
-        if (PULSEAUDIO_pa_stream_writable_size(h->stream) >= h->mixlen) {
-            return;
-        }
-    }
+    SDL_AudioDevice *this = (SDL_AudioDevice *) userdata;
+    PULSEAUDIO_pa_threaded_mainloop_signal(this->hidden->mainloop, 0);
 }
 
 static void
-PULSEAUDIO_PlayDevice(_THIS)
+stream_state_callback(pa_stream *s, void *userdata)
 {
-    /* Write the audio data */
-    struct SDL_PrivateAudioData *h = this->hidden;
-    if (PULSEAUDIO_pa_stream_write(h->stream, h->mixbuf, h->mixlen, NULL, 0LL,
-                                   PA_SEEK_RELATIVE) < 0) {
+    SDL_AudioDevice *this = (SDL_AudioDevice *) userdata;
+    if (!PA_STREAM_IS_GOOD(PULSEAUDIO_pa_stream_get_state(s))) {
         this->enabled = 0;
     }
+    PULSEAUDIO_pa_threaded_mainloop_signal(this->hidden->mainloop, 0);
 }
 
+/* Record the stream timing for PULSEAUDIO_GetDeviceClock().  Called from
+   the stream callbacks, with the mainloop locked.  The application may hold
+   the device's mixer lock while asking for the clock, so the clock can't
+   take the mainloop lock itself. */
 static void
-stream_drain_complete(pa_stream *s, int success, void *userdata)
+stream_update_clock(_THIS)
 {
-    /* no-op for pa_stream_drain() to use for callback. */
+    struct SDL_PrivateAudioData *h = this->hidden;
+    pa_usec_t usec = 0;
+    int negative = 0;
+    Uint64 played = 0;
+    Uint32 latency = 0;
+    int valid = 0;
+
+    if (PULSEAUDIO_pa_stream_get_time(h->stream, &usec) >= 0) {
+        played = (usec * this->spec.freq) / 1000000;
+        if (PULSEAUDIO_pa_stream_get_latency(h->stream, &usec,
+                                             &negative) >= 0 && !negative) {
+            latency = (Uint32) usec;
+        }
+        valid = 1;
+    }
+
+    SDL_mutexP(h->clock_lock);
+    h->clock_valid = valid;
+    h->clock_submitted = h->frames;
+    h->clock_played = played;
+    h->clock_latency = latency;
+    h->clock_ticks = SDL_GetTicks();
+    SDL_mutexV(h->clock_lock);
 }
 
+/* The server wants more audio, so fill whole buffers while there's room */
 static void
-PULSEAUDIO_WaitDone(_THIS)
+stream_write_callback(pa_stream *s, size_t nbytes, void *userdata)
 {
+    SDL_AudioDevice *this = (SDL_AudioDevice *) userdata;
     struct SDL_PrivateAudioData *h = this->hidden;
-    pa_operation *o;
 
-    o = PULSEAUDIO_pa_stream_drain(h->stream, stream_drain_complete, NULL);
-    if (!o) {
-        return;
+    while (this->enabled &&
+           PULSEAUDIO_pa_stream_writable_size(s) >= (size_t) h->mixlen) {
+        if (this->paused) {
+            SDL_memset(h->mixbuf, this->spec.silence, h->mixlen);
+        } else {
+            SDL_FillAudioDevice(this, h->mixbuf);
+        }
+        if (PULSEAUDIO_pa_stream_write(s, h->mixbuf, h->mixlen, NULL, 0LL,
+                                       PA_SEEK_RELATIVE) < 0) {
+            this->enabled = 0;
+            break;
+        }
+        h->frames += this->spec.samples;
     }
+    stream_update_clock(this);
+}
 
-    while (PULSEAUDIO_pa_operation_get_state(o) != PA_OPERATION_DONE) {
-        if (PULSEAUDIO_pa_context_get_state(h->context) != PA_CONTEXT_READY ||
-            PULSEAUDIO_pa_stream_get_state(h->stream) != PA_STREAM_READY ||
-            PULSEAUDIO_pa_mainloop_iterate(h->mainloop, 1, NULL) < 0) {
-            PULSEAUDIO_pa_operation_cancel(o);
+/* Recorded audio arrived, so hand it to the core's capture pipeline */
+static void
+stream_read_callback(pa_stream *s, size_t nbytes, void *userdata)
+{
+    SDL_AudioDevice *this = (SDL_AudioDevice *) userdata;
+    struct SDL_PrivateAudioData *h = this->hidden;
+    const int framesize = this->spec.size / this->spec.samples;
+    const Uint8 *data;
+    size_t len, amount;
+
+    while (this->enabled) {
+        if (PULSEAUDIO_pa_stream_peek(s, (const void **) &data, &len) < 0 ||
+            len == 0) {
             break;
         }
+        h->frames += len / framesize;
+        if (data != NULL) {
+            SDL_CaptureAudioDevice(this, data, (int) len);
+        } else {
+            /* A hole in the recording */
+            while (len > 0) {
+                amount = SDL_min(len, (size_t) h->mixlen);
+                SDL_memset(h->mixbuf, this->spec.silence, amount);
+                SDL_CaptureAudioDevice(this, h->mixbuf, (int) amount);
+                len -= amount;
+            }
+        }
+        PULSEAUDIO_pa_stream_drop(s);
     }
+    stream_update_clock(this);
+}
 
-    PULSEAUDIO_pa_operation_unref(o);
+static void
+stream_drain_complete(pa_stream *s, int success, void *userdata)
+{
+    SDL_AudioDevice *this = (SDL_AudioDevice *) userdata;
+    PULSEAUDIO_pa_threaded_mainloop_signal(this->hidden->mainloop, 0);
 }
 
+/* Are the context and stream still usable?  Needs the mainloop lock. */
+static int
+stream_is_ready(struct SDL_PrivateAudioData *h)
+{
+    return (PULSEAUDIO_pa_context_get_state(h->context) == PA_CONTEXT_READY &&
+            PULSEAUDIO_pa_stream_get_state(h->stream) == PA_STREAM_READY);
+}
 
 
-static Uint8 *
-PULSEAUDIO_GetDeviceBuf(_THIS)
+static int
+PULSEAUDIO_GetDeviceClock(_THIS, SDL_AudioClock * clock)
 {
-    return (this->hidden->mixbuf);
+    struct SDL_PrivateAudioData *h = this->hidden;
+    Uint32 elapsed;
+    Uint64 frames;
+
+    SDL_mutexP(h->clock_lock);
+    if (!h->clock_valid) {
+        SDL_mutexV(h->clock_lock);
+        SDL_SetError("PulseAudio has no timing information yet");
+        return -1;
+    }
+    clock->frames_submitted = h->clock_submitted;
+    clock->frames_played = h->clock_played;
+    clock->latency = h->clock_latency;
+    elapsed = SDL_GetTicks() - h->clock_ticks;
+    SDL_mutexV(h->clock_lock);
+
+    /* Playback has moved on since the last callback */
+    if (!this->iscapture && !this->paused) {
+        frames = ((Uint64) elapsed * this->spec.freq) / 1000;
+        clock->frames_played =
+            SDL_min(clock->frames_played + frames, clock->frames_submitted);
+        if (clock->latency > elapsed * 1000) {
+            clock->latency -= elapsed * 1000;
+        } else {
+            clock->latency = 0;
+        }
+    }
+    return 0;
 }
 
 
 static void
 PULSEAUDIO_CloseDevice(_THIS)
 {
-    if (this->hidden != NULL) {
-        if (this->hidden->mixbuf != NULL) {
-            SDL_FreeAudioMem(this->hidden->mixbuf);
-            this->hidden->mixbuf = NULL;
+    struct SDL_PrivateAudioData *h = this->hidden;
+    pa_operation *o;
+
+    if (h != NULL) {
+        if (h->mainloop != NULL) {
+            PULSEAUDIO_pa_threaded_mainloop_lock(h->mainloop);
+        }
+        if (h->stream) {
+            /* Let the queued audio finish playing */
+            if (!this->iscapture && stream_is_ready(h)) {
+                o = PULSEAUDIO_pa_stream_drain(h->stream,
+                                               stream_drain_complete, this);
+                if (o) {
+                    while (PULSEAUDIO_pa_operation_get_state(o) ==
+                           PA_OPERATION_RUNNING && stream_is_ready(h)) {
+                        PULSEAUDIO_pa_threaded_mainloop_wait(h->mainloop);
+                    }
+                    if (PULSEAUDIO_pa_operation_get_state(o) ==
+                        PA_OPERATION_RUNNING) {
+                        PULSEAUDIO_pa_operation_cancel(o);
+                    }
+                    PULSEAUDIO_pa_operation_unref(o);
+                }
+            }
+            PULSEAUDIO_pa_stream_disconnect(h->stream);
+            PULSEAUDIO_pa_stream_unref(h->stream);
+            h->stream = NULL;
         }
-        if (this->hidden->stream) {
-            PULSEAUDIO_pa_stream_disconnect(this->hidden->stream);
-            PULSEAUDIO_pa_stream_unref(this->hidden->stream);
-            this->hidden->stream = NULL;
+        if (h->context != NULL) {
+            PULSEAUDIO_pa_context_disconnect(h->context);
+            PULSEAUDIO_pa_context_unref(h->context);
+            h->context = NULL;
         }
-        if (this->hidden->context != NULL) {
-            PULSEAUDIO_pa_context_disconnect(this->hidden->context);
-            PULSEAUDIO_pa_context_unref(this->hidden->context);
-            this->hidden->context = NULL;
+        if (h->mainloop != NULL) {
+            PULSEAUDIO_pa_threaded_mainloop_unlock(h->mainloop);
+            PULSEAUDIO_pa_threaded_mainloop_stop(h->mainloop);
+            PULSEAUDIO_pa_threaded_mainloop_free(h->mainloop);
+            h->mainloop = NULL;
         }
-        if (this->hidden->mainloop != NULL) {
-            PULSEAUDIO_pa_mainloop_free(this->hidden->mainloop);
-            this->hidden->mainloop = NULL;
+        if (h->mixbuf != NULL) {
+            SDL_FreeAudioMem(h->mixbuf);
+            h->mixbuf = NULL;
         }
-        SDL_free(this->hidden);
+        if (h->clock_lock != NULL) {
+            SDL_DestroyMutex(h->clock_lock);
+            h->clock_lock = NULL;
+        }
+        SDL_free(h);
         this->hidden = NULL;
     }
 }
@@ -336,6 +495,82 @@ get_progname(void)
 }
 
 
+/* Connect to the server and start the stream, with the mainloop locked.
+   Returns an error message on failure. */
+static const char *
+connect_stream(_THIS, const pa_sample_spec *paspec, const pa_buffer_attr *paattr,
+               pa_stream_flags_t flags)
+{
+    struct SDL_PrivateAudioData *h = this->hidden;
+    pa_channel_map pacmap;
+    int state = 0;
+
+    h->context = PULSEAUDIO_pa_context_new(
+        PULSEAUDIO_pa_threaded_mainloop_get_api(h->mainloop), get_progname());
+    if (!h->context) {
+        return "pa_context_new() failed";
+    }
+    PULSEAUDIO_pa_context_set_state_callback(h->context,
+                                             context_state_callback, this);
+
+    /* Connect to the PulseAudio server */
+    if (PULSEAUDIO_pa_context_connect(h->context, NULL, 0, NULL) < 0) {
+        return "Could not setup connection to PulseAudio";
+    }
+
+    while ((state = PULSEAUDIO_pa_context_get_state(h->context)) !=
+           PA_CONTEXT_READY) {
+        if (!PA_CONTEXT_IS_GOOD(state)) {
+            return "Could not connect to PulseAudio";
+        }
+        PULSEAUDIO_pa_threaded_mainloop_wait(h->mainloop);
+    }
+
+    /* The SDL ALSA output hints us that we use Windows' channel mapping */
+    /* http://bugzilla.libsdl.org/show_bug.cgi?id=110 */
+    PULSEAUDIO_pa_channel_map_init_auto(&pacmap, this->spec.channels,
+                                        PA_CHANNEL_MAP_WAVEEX);
+
+    h->stream = PULSEAUDIO_pa_stream_new(
+        h->context,
+        "Simple DirectMedia Layer", /* stream description */
+        paspec,     /* sample format spec */
+        &pacmap     /* channel map */
+        );
+
+    if (h->stream == NULL) {
+        return "Could not set up PulseAudio stream";
+    }
+    PULSEAUDIO_pa_stream_set_state_callback(h->stream, stream_state_callback,
+                                            this);
+
+    if (this->iscapture) {
+        PULSEAUDIO_pa_stream_set_read_callback(h->stream,
+                                               stream_read_callback, this);
+        state = PULSEAUDIO_pa_stream_connect_record(h->stream, NULL, paattr,
+                                                    flags);
+    } else {
+        PULSEAUDIO_pa_stream_set_write_callback(h->stream,
+                                                stream_write_callback, this);
+        state = PULSEAUDIO_pa_stream_connect_playback(h->stream, NULL, paattr,
+                                                      flags, NULL, NULL);
+    }
+    if (state < 0) {
+        return "Could not connect PulseAudio stream";
+    }
+
+    while ((state = PULSEAUDIO_pa_stream_get_state(h->stream)) !=
+           PA_STREAM_READY) {
+        if (!PA_STREAM_IS_GOOD(state)) {
+            return "Could not create to PulseAudio stream";
+        }
+        PULSEAUDIO_pa_threaded_mainloop_wait(h->mainloop);
+    }
+
+    return NULL;
+}
+
+
 static int
 PULSEAUDIO_OpenDevice(_THIS, const char *devname, int iscapture)
 {
@@ -343,9 +578,8 @@ PULSEAUDIO_OpenDevice(_THIS, const char *devname, int iscapture)
     Uint16 test_format = 0;
     pa_sample_spec paspec;
     pa_buffer_attr paattr;
-    pa_channel_map pacmap;
     pa_stream_flags_t flags = 0;
-    int state = 0;
+    const char *error;
 
     /* Initialize all variables that we clean on shutdown */
     this->hidden = (struct SDL_PrivateAudioData *)
@@ -356,6 +590,11 @@ PULSEAUDIO_OpenDevice(_THIS, const char *devname, int iscapture)
     }
     SDL_memset(this->hidden, 0, (sizeof *this->hidden));
     h = this->hidden;
+    h->clock_lock = SDL_CreateMutex();
+    if (h->clock_lock == NULL) {
+        PULSEAUDIO_CloseDevice(this);
+        return 0;
+    }
 
     paspec.format = PA_SAMPLE_INVALID;
 
@@ -375,6 +614,18 @@ PULSEAUDIO_OpenDevice(_THIS, const char *devname, int iscapture)
         case AUDIO_S16MSB:
             paspec.format = PA_SAMPLE_S16BE;
             break;
+        case AUDIO_S32LSB:
+            paspec.format = PA_SAMPLE_S32LE;
+            break;
+        case AUDIO_S32MSB:
+            paspec.format = PA_SAMPLE_S32BE;
+            break;
+        case AUDIO_F32LSB:
+            paspec.format = PA_SAMPLE_FLOAT32LE;
+            break;
+        case AUDIO_F32MSB:
+            paspec.format = PA_SAMPLE_FLOAT32BE;
+            break;
         default:
             paspec.format = PA_SAMPLE_INVALID;
             break;
@@ -391,9 +642,6 @@ PULSEAUDIO_OpenDevice(_THIS, const char *devname, int iscapture)
     this->spec.format = test_format;
 
     /* Calculate the final parameters for this audio specification */
-#ifdef PA_STREAM_ADJUST_LATENCY
-    this->spec.samples /= 2; /* Mix in smaller chunck to avoid underruns */
-#endif
     SDL_CalculateAudioSpec(&this->spec);
 
     /* Allocate mixing buffer */
@@ -409,97 +657,41 @@ PULSEAUDIO_OpenDevice(_THIS, const char *devname, int iscapture)
     paspec.channels = this->spec.channels;
     paspec.rate = this->spec.freq;
 
-    /* Reduced prebuffering compared to the defaults. */
-#ifdef PA_STREAM_ADJUST_LATENCY
-    /* 2x original requested bufsize */
-    paattr.tlength = h->mixlen * 4;
-    paattr.prebuf = -1;
+    /* Ask for the latency of the requested buffer size: the server asks
+       for a buffer at a time, and keeps two queued. */
     paattr.maxlength = -1;
-    /* -1 can lead to pa_stream_writable_size() >= mixlen never being true */
+    paattr.prebuf = -1;
     paattr.minreq = h->mixlen;
+    paattr.tlength = h->mixlen * 2;
+    paattr.fragsize = h->mixlen;
+#ifdef PA_STREAM_ADJUST_LATENCY
     flags = PA_STREAM_ADJUST_LATENCY;
-#else
-    paattr.tlength = h->mixlen*2;
-    paattr.prebuf = h->mixlen*2;
-    paattr.maxlength = h->mixlen*2;
-    paattr.minreq = h->mixlen;
 #endif
+    flags |= PA_STREAM_INTERPOLATE_TIMING | PA_STREAM_AUTO_TIMING_UPDATE;
 
-    /* The SDL ALSA output hints us that we use Windows' channel mapping */
-    /* http://bugzilla.libsdl.org/show_bug.cgi?id=110 */
-    PULSEAUDIO_pa_channel_map_init_auto(&pacmap, this->spec.channels,
-                                        PA_CHANNEL_MAP_WAVEEX);
-
-    /* Set up a new main loop */
-    if (!(h->mainloop = PULSEAUDIO_pa_mainloop_new())) {
-        PULSEAUDIO_CloseDevice(this);
-        SDL_SetError("pa_mainloop_new() failed");
-        return 0;
-    }
-
-    h->mainloop_api = PULSEAUDIO_pa_mainloop_get_api(h->mainloop);
-    h->context = PULSEAUDIO_pa_context_new(h->mainloop_api, get_progname());
-    if (!h->context) {
-        PULSEAUDIO_CloseDevice(this);
-        SDL_SetError("pa_context_new() failed");
-        return 0;
-    }
-
-    /* Connect to the PulseAudio server */
-    if (PULSEAUDIO_pa_context_connect(h->context, NULL, 0, NULL) < 0) {
+    /* Set up a new main loop, with its own thread */
+    if (!(h->mainloop = PULSEAUDIO_pa_threaded_mainloop_new())) {
         PULSEAUDIO_CloseDevice(this);
-        SDL_SetError("Could not setup connection to PulseAudio");
+        SDL_SetError("pa_threaded_mainloop_new() failed");
         return 0;
     }
-
-    do {
-        if (PULSEAUDIO_pa_mainloop_iterate(h->mainloop, 1, NULL) < 0) {
-            PULSEAUDIO_CloseDevice(this);
-            SDL_SetError("pa_mainloop_iterate() failed");
-            return 0;
-        }
-        state = PULSEAUDIO_pa_context_get_state(h->context);
-        if (!PA_CONTEXT_IS_GOOD(state)) {
-            PULSEAUDIO_CloseDevice(this);
-            SDL_SetError("Could not connect to PulseAudio");
-            return 0;
-        }
-    } while (state != PA_CONTEXT_READY);
-
-    h->stream = PULSEAUDIO_pa_stream_new(
-        h->context,
-        "Simple DirectMedia Layer", /* stream description */
-        &paspec,    /* sample format spec */
-        &pacmap     /* channel map */
-        );
-
-    if (h->stream == NULL) {
+    if (PULSEAUDIO_pa_threaded_mainloop_start(h->mainloop) < 0) {
+        PULSEAUDIO_pa_threaded_mainloop_free(h->mainloop);
+        h->mainloop = NULL;
         PULSEAUDIO_CloseDevice(this);
-        SDL_SetError("Could not set up PulseAudio stream");
+        SDL_SetError("pa_threaded_mainloop_start() failed");
         return 0;
     }
 
-    if (PULSEAUDIO_pa_stream_connect_playback(h->stream, NULL, &paattr, flags,
-            NULL, NULL) < 0) {
+    PULSEAUDIO_pa_threaded_mainloop_lock(h->mainloop);
+    error = connect_stream(this, &paspec, &paattr, flags);
+    PULSEAUDIO_pa_threaded_mainloop_unlock(h->mainloop);
+    if (error) {
         PULSEAUDIO_CloseDevice(this);
-        SDL_SetError("Could not connect PulseAudio stream");
+        SDL_SetError("%s", error);
         return 0;
     }
 
-    do {
-        if (PULSEAUDIO_pa_mainloop_iterate(h->mainloop, 1, NULL) < 0) {
-            PULSEAUDIO_CloseDevice(this);
-            SDL_SetError("pa_mainloop_iterate() failed");
-            return 0;
-        }
-        state = PULSEAUDIO_pa_stream_get_state(h->stream);
-        if (!PA_STREAM_IS_GOOD(state)) {
-            PULSEAUDIO_CloseDevice(this);
-            SDL_SetError("Could not create to PulseAudio stream");
-            return 0;
-        }
-    } while (state != PA_STREAM_READY);
-
     /* We're ready to rock and roll. :-) */
     return 1;
 }
@@ -521,13 +713,14 @@ PULSEAUDIO_Init(SDL_AudioDriverImpl * impl)
 
     /* Set the function pointers */
     impl->OpenDevice = PULSEAUDIO_OpenDevice;
-    impl->PlayDevice = PULSEAUDIO_PlayDevice;
-    impl->WaitDevice = PULSEAUDIO_WaitDevice;
-    impl->GetDeviceBuf = PULSEAUDIO_GetDeviceBuf;
     impl->CloseDevice = PULSEAUDIO_CloseDevice;
-    impl->WaitDone = PULSEAUDIO_WaitDone;
+    impl->GetDeviceClock = PULSEAUDIO_GetDeviceClock;
     impl->Deinitialize = PULSEAUDIO_Deinitialize;
+    impl->ProvidesOwnCallbackThread = 1;
+    impl->UsesFillAudioDevice = 1;
+    impl->HasCaptureSupport = 1;
     impl->OnlyHasDefaultOutputDevice = 1;
+    impl->OnlyHasDefaultInputDevice = 1;
 
     return 1;   /* this audio target is available. */
 }
@@ -24,6 +24,7 @@
 #ifndef _SDL_pulseaudio_h
 #define _SDL_pulseaudio_h
 
+#include <pulse/pulseaudio.h>
 #include <pulse/simple.h>
 
 #include "../SDL_sysaudio.h"
@@ -34,14 +35,24 @@
 struct SDL_PrivateAudioData
 {
     /* pulseaudio structures */
-    pa_mainloop *mainloop;
-    pa_mainloop_api *mainloop_api;
+    pa_threaded_mainloop *mainloop;
     pa_context *context;
     pa_stream *stream;
 
     /* Raw mixing buffer */
     Uint8 *mixbuf;
     int mixlen;
+
+    /* Frames written to or read from the stream */
+    Uint64 frames;
+
+    /* Stream timing as of the last callback, under clock_lock */
+    SDL_mutex *clock_lock;
+    int clock_valid;
+    Uint64 clock_submitted;
+    Uint64 clock_played;
+    Uint32 clock_latency;
+    Uint32 clock_ticks;
 };
 
 #endif /* _SDL_pulseaudio_h */
@@ -17,6 +17,17 @@ my @audiotypes = qw(
 );
 
 my @channels = ( 1, 2, 4, 6, 8 );
+
+# Conversions that get SSE2 versions: between 16 or 32-bit integers and
+#  floats, and byte swaps, in every byte order.
+my @sse2types = qw(
+    S16LSB
+    S16MSB
+    S32LSB
+    S32MSB
+    F32LSB
+    F32MSB
+);
 my %funcs;
 my $custom_converters = 0;
 
@@ -38,7 +49,7 @@ sub outputHeader {
 /* DO NOT EDIT!  This file is generated by sdlgenaudiocvt.pl */
 /*
     SDL - Simple DirectMedia Layer
-    Copyright (C) 1997-2009 Sam Lantinga
+    Copyright (C) 1997-2010 Sam Lantinga
 
     This library is free software; you can redistribute it and/or
     modify it under the terms of the GNU Lesser General Public
@@ -84,6 +95,15 @@ sub outputHeader {
 #define NO_CONVERTERS 0
 #endif
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+/* Byte swap every 16 or 32-bit sample in a vector. */
+#define SSE2_SWAP16(v) _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8))
+#define SSE2_SWAP32(v) \\
+    SSE2_SWAP16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(v, 0xB1), 0xB1))
+#endif
+
 
 /* *INDENT-OFF* */
 
@@ -187,6 +207,52 @@ sub getSignFlipVal {
     die("bug in script.\n");
 }
 
+# The C expressions converting one sample in '*src' to 'val', and 'val' to
+#  what is stored in the destination.
+sub getCvtCode {
+    my ($from, $to) = @_;
+    my ($fsigned, $ffloat, $fsize, $fendian, $fctype) = splittype($from);
+    my ($tsigned, $tfloat, $tsize, $tendian, $tctype) = splittype($to);
+
+    # Have to convert to/from float/int.
+    # !!! FIXME: cast through double for int32<->float?
+    my $code = getSwapFunc($fsize, $fsigned, $ffloat, $fendian, '*src');
+    if ($ffloat != $tfloat) {
+        if ($ffloat) {
+            my $mult = getFloatToIntMult($tsize);
+            if (!$tsigned) {   # bump from -1.0f/1.0f to 0.0f/2.0f
+                $code = "($code + 1.0f)";
+            }
+            $code = "(($tctype) ($code * $mult))";
+        } else {
+            # $divby will be the reciprocal, to avoid pipeline stalls
+            #  from floating point division...so multiply it.
+            my $divby = getIntToFloatDivBy($fsize);
+            $code = "(((float) $code) * $divby)";
+            if (!$fsigned) {   # bump from 0.0f/2.0f to -1.0f/1.0f.
+                $code = "($code - 1.0f)";
+            }
+        }
+    } else {
+        # All integer conversions here.
+        if ($fsigned != $tsigned) {
+            my $signflipval = getSignFlipVal($fsize);
+            $code = "(($code) ^ $signflipval)";
+        }
+
+        my $shiftval = abs($fsize - $tsize);
+        if ($fsize < $tsize) {
+            $code = "((($tctype) $code) << $shiftval)";
+        } elsif ($fsize > $tsize) {
+            $code = "(($tctype) ($code >> $shiftval))";
+        }
+    }
+
+    my $swap = getSwapFunc($tsize, $tsigned, $tfloat, $tendian, 'val');
+
+    return ($code, $swap);
+}
+
 sub buildCvtFunc {
     my ($from, $to) = @_;
     my ($fsigned, $ffloat, $fsize, $fendian, $fctype) = splittype($from);
@@ -237,41 +303,7 @@ EOF
 EOF
         }
 
-        # Have to convert to/from float/int.
-        # !!! FIXME: cast through double for int32<->float?
-        my $code = getSwapFunc($fsize, $fsigned, $ffloat, $fendian, '*src');
-        if ($ffloat != $tfloat) {
-            if ($ffloat) {
-                my $mult = getFloatToIntMult($tsize);
-                if (!$tsigned) {   # bump from -1.0f/1.0f to 0.0f/2.0f
-                    $code = "($code + 1.0f)";
-                }
-                $code = "(($tctype) ($code * $mult))";
-            } else {
-                # $divby will be the reciprocal, to avoid pipeline stalls
-                #  from floating point division...so multiply it.
-                my $divby = getIntToFloatDivBy($fsize);
-                $code = "(((float) $code) * $divby)";
-                if (!$fsigned) {   # bump from 0.0f/2.0f to -1.0f/1.0f.
-                    $code = "($code - 1.0f)";
-                }
-            }
-        } else {
-            # All integer conversions here.
-            if ($fsigned != $tsigned) {
-                my $signflipval = getSignFlipVal($fsize);
-                $code = "(($code) ^ $signflipval)";
-            }
-
-            my $shiftval = abs($fsize - $tsize);
-            if ($fsize < $tsize) {
-                $code = "((($tctype) $code) << $shiftval)";
-            } elsif ($fsize > $tsize) {
-                $code = "(($tctype) ($code >> $shiftval))";
-            }
-        }
-
-        my $swap = getSwapFunc($tsize, $tsigned, $tfloat, $tendian, 'val');
+        my ($code, $swap) = getCvtCode($from, $to);
 
         print <<EOF;
         const $tctype val = $code;
@@ -311,6 +343,174 @@ EOF
     }
 }
 
+# SSE2 loads and stores of a vector of samples at 'src + i' or 'dst + i'.
+sub getSSE2Load {
+    my ($type, $offset) = @_;
+    my ($signed, $float, $size, $endian, $ctype) = splittype($type);
+    my $code = "_mm_loadu_si128((const __m128i *) (src + i + $offset))";
+    $code = "SSE2_SWAP${size}($code)" if ($endian eq 'MSB');
+    $code = "_mm_castsi128_ps($code)" if ($float);
+    return $code;
+}
+
+sub getSSE2Store {
+    my ($type, $offset, $val) = @_;
+    my ($signed, $float, $size, $endian, $ctype) = splittype($type);
+    my $code = $val;
+    $code = "_mm_castps_si128($code)" if ($float);
+    $code = "SSE2_SWAP${size}($code)" if ($endian eq 'MSB');
+    return "_mm_storeu_si128((__m128i *) (dst + i + $offset), $code);";
+}
+
+sub isSSE2Cvt {
+    my ($from, $to) = @_;
+    my ($fsigned, $ffloat, $fsize, $fendian, $fctype) = splittype($from);
+    my ($tsigned, $tfloat, $tsize, $tendian, $tctype) = splittype($to);
+
+    return 0 if ($from eq $to);
+    return 0 if (!grep { $_ eq $from } @sse2types);
+    return 0 if (!grep { $_ eq $to } @sse2types);
+
+    # Integer size changes aren't hot enough to bother with.
+    return 0 if ((!$ffloat) and (!$tfloat) and ($fsize != $tsize));
+    return 1;
+}
+
+sub buildSSE2CvtFunc {
+    my ($from, $to) = @_;
+    my ($fsigned, $ffloat, $fsize, $fendian, $fctype) = splittype($from);
+    my ($tsigned, $tfloat, $tsize, $tendian, $tctype) = splittype($to);
+
+    return if (!isSSE2Cvt($from, $to));
+
+    my $hashid = getTypeConvertHashId($from, $to) . '/SSE2';
+    my $sym = "SDL_Convert_${from}_to_${to}_SSE2";
+    $funcs{$hashid} = $sym;
+    $custom_converters++;
+
+    # Always unsigned for ints, for possible byteswaps.
+    my $srctype = (($ffloat) ? 'float' : "Uint${fsize}");
+
+    # Samples per loop, a vector of the smaller type.
+    my $per = 16 / (($fsize < $tsize ? $fsize : $tsize) / 8);
+
+    my $consts = '';
+    my $body = '';
+    my $load0 = getSSE2Load($from, 0);
+    if ($ffloat == $tfloat) {
+        # Byte swaps.
+        $body = "        " . getSSE2Store($to, 0, $load0) . "\n";
+    } elsif ((!$ffloat) and ($fsize == 16)) {
+        my $divby = getIntToFloatDivBy($fsize);
+        $consts = "    const __m128 divby = _mm_set1_ps($divby);\n";
+        my $storelo = getSSE2Store($to, 0, 'lo');
+        my $storehi = getSSE2Store($to, 4, 'hi');
+        $body = <<EOF;
+        const __m128i in = $load0;
+        const __m128 lo = _mm_mul_ps(_mm_cvtepi32_ps(
+            _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16)), divby);
+        const __m128 hi = _mm_mul_ps(_mm_cvtepi32_ps(
+            _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16)), divby);
+        $storelo
+        $storehi
+EOF
+    } elsif (!$ffloat) {
+        my $divby = getIntToFloatDivBy($fsize);
+        $consts = "    const __m128 divby = _mm_set1_ps($divby);\n";
+        my $store = getSSE2Store($to, 0, 'out');
+        $body = <<EOF;
+        const __m128 out = _mm_mul_ps(_mm_cvtepi32_ps($load0), divby);
+        $store
+EOF
+    } elsif ($tsize == 16) {
+        my $mult = getFloatToIntMult($tsize);
+        my $load4 = getSSE2Load($from, 4);
+        $consts = "    const __m128 mult = _mm_set1_ps($mult);\n";
+        my $store = getSSE2Store($to, 0, 'out');
+        $body = <<EOF;
+        const __m128 lo = $load0;
+        const __m128 hi = $load4;
+        const __m128i out =
+            _mm_packs_epi32(_mm_cvttps_epi32(_mm_mul_ps(lo, mult)),
+                            _mm_cvttps_epi32(_mm_mul_ps(hi, mult)));
+        $store
+EOF
+    } else {
+        # Like the scalar code, multiply in double precision.
+        my $mult = getFloatToIntMult($tsize);
+        $consts = "    const __m128d mult = _mm_set1_pd($mult);\n";
+        my $store = getSSE2Store($to, 0, 'out');
+        $body = <<EOF;
+        const __m128 in = $load0;
+        const __m128i lo =
+            _mm_cvttpd_epi32(_mm_mul_pd(_mm_cvtps_pd(in), mult));
+        const __m128i hi = _mm_cvttpd_epi32(
+            _mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(in, in)), mult));
+        const __m128i out = _mm_unpacklo_epi64(lo, hi);
+        $store
+EOF
+    }
+
+    my ($code, $swap) = getCvtCode($from, $to);
+    $code =~ s/\*src/src[i]/;
+
+    print <<EOF;
+static void SDLCALL
+${sym}(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const int count = cvt->len_cvt / sizeof ($srctype);
+    const int vectors = count - (count % $per);
+    const $srctype *src = (const $srctype *) cvt->buf;
+    $tctype *dst = ($tctype *) cvt->buf;
+$consts    int i;
+
+#if DEBUG_CONVERT
+    fprintf(stderr, "Converting AUDIO_${from} to AUDIO_${to} (using SSE2).\\n");
+#endif
+
+EOF
+
+    if ($fsize < $tsize) {
+        # The buffer grows, so work backwards from the samples that
+        #  don't fill a vector.
+        print <<EOF;
+    for (i = count - 1; i >= vectors; --i) {
+        const $tctype val = $code;
+        dst[i] = ${swap};
+    }
+    for (i = vectors - $per; i >= 0; i -= $per) {
+$body    }
+
+EOF
+    } else {
+        print <<EOF;
+    for (i = 0; i < vectors; i += $per) {
+$body    }
+    for (; i < count; ++i) {
+        const $tctype val = $code;
+        dst[i] = ${swap};
+    }
+
+EOF
+    }
+
+    if ($fsize > $tsize) {
+        my $divby = $fsize / $tsize;
+        print("    cvt->len_cvt /= $divby;\n");
+    } elsif ($fsize < $tsize) {
+        my $mult = $tsize / $fsize;
+        print("    cvt->len_cvt *= $mult;\n");
+    }
+
+    print <<EOF;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, AUDIO_$to);
+    }
+}
+
+EOF
+}
+
 
 sub buildTypeConverters {
     print "#if !NO_CONVERTERS\n\n";
@@ -321,6 +521,15 @@ sub buildTypeConverters {
             buildCvtFunc($from, $to);
         }
     }
+    print "#ifdef __SSE2__\n";
+    foreach (@audiotypes) {
+        my $from = $_;
+        foreach (@audiotypes) {
+            my $to = $_;
+            buildSSE2CvtFunc($from, $to);
+        }
+    }
+    print "#endif  /* __SSE2__ */\n\n";
     print "#endif  /* !NO_CONVERTERS */\n\n\n";
 
     print "const SDL_AudioTypeFilters sdl_audio_type_filters[] =\n{\n";
@@ -338,6 +547,24 @@ sub buildTypeConverters {
     }
     print "#endif  /* !NO_CONVERTERS */\n";
 
+    print("    { 0, 0, NULL }\n");
+    print "};\n\n";
+
+    print "const SDL_AudioTypeFilters sdl_audio_type_filters_sse2[] =\n{\n";
+    print "#if !NO_CONVERTERS && defined(__SSE2__)\n";
+    foreach (@audiotypes) {
+        my $from = $_;
+        foreach (@audiotypes) {
+            my $to = $_;
+            if (isSSE2Cvt($from, $to)) {
+                my $hashid = getTypeConvertHashId($from, $to) . '/SSE2';
+                my $sym = $funcs{$hashid};
+                print("    { AUDIO_$from, AUDIO_$to, $sym },\n");
+            }
+        }
+    }
+    print "#endif  /* !NO_CONVERTERS && __SSE2__ */\n";
+
     print("    { 0, 0, NULL }\n");
     print "};\n\n\n";
 }
@@ -84,12 +84,17 @@
  *
  *   The end of the sequence is marked by a zero <skip>,<run> pair at the
  *   beginning of an opaque line.
+ *
+ * Both encodings are preceded by a table with the offset of each scan line
+ * from the start of the encoding, so that blits clipped at the top can start
+ * right at their first line. Trailing blank lines point at the end marker.
  */
 
 #include "SDL_video.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
+#include "SDL_surfacepool_c.h"
 
 #ifndef MAX
 #define MAX(a, b) ((a) > (b) ? (a) : (b))
@@ -98,6 +103,12 @@
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #endif
 
+/* size of the line offset table in front of the encoding */
+#define RLE_INDEX_SIZE(h)   ((h) * sizeof(Uint32))
+
+/* start of scan line y in the encoding */
+#define RLE_LINE(data, y)   ((Uint8 *)(data) + ((Uint32 *)(data))[y])
+
 #define PIXEL_COPY(to, from, len, bpp)			\
 do {							\
     if(bpp == 4) {					\
@@ -462,51 +473,7 @@ SDL_RLEBlit(SDL_Surface * src, SDL_Rect * srcrect,
     y = dstrect->y;
     dstbuf = (Uint8 *) dst->pixels
         + y * dst->pitch + x * src->format->BytesPerPixel;
-    srcbuf = (Uint8 *) src->map->data;
-
-    {
-        /* skip lines at the top if neccessary */
-        int vskip = srcrect->y;
-        int ofs = 0;
-        if (vskip) {
-
-#define RLESKIP(bpp, Type)			\
-		for(;;) {			\
-		    int run;			\
-		    ofs += *(Type *)srcbuf;	\
-		    run = ((Type *)srcbuf)[1];	\
-		    srcbuf += sizeof(Type) * 2;	\
-		    if(run) {			\
-			srcbuf += run * bpp;	\
-			ofs += run;		\
-		    } else if(!ofs)		\
-			goto done;		\
-		    if(ofs == w) {		\
-			ofs = 0;		\
-			if(!--vskip)		\
-			    break;		\
-		    }				\
-		}
-
-            switch (src->format->BytesPerPixel) {
-            case 1:
-                RLESKIP(1, Uint8);
-                break;
-            case 2:
-                RLESKIP(2, Uint8);
-                break;
-            case 3:
-                RLESKIP(3, Uint8);
-                break;
-            case 4:
-                RLESKIP(4, Uint16);
-                break;
-            }
-
-#undef RLESKIP
-
-        }
-    }
+    srcbuf = RLE_LINE(src->map->data, srcrect->y);
 
     alpha = src->map->info.a;
     /* if left or right edge clipping needed, call clip blit */
@@ -544,7 +511,6 @@ SDL_RLEBlit(SDL_Surface * src, SDL_Rect * srcrect,
 #undef RLEBLIT
     }
 
-  done:
     /* Unlock the destination if necessary */
     if (SDL_MUSTLOCK(dst)) {
         SDL_UnlockSurface(dst);
@@ -605,6 +571,69 @@ SDL_RLEBlit(SDL_Surface * src, SDL_Rect * srcrect,
 	dst = (Uint16)(d | d >> 16);			\
     } while(0)
 
+#ifdef __SSE2__
+/* blend a run of translucent pixels onto 32bpp, 4 pixels at a time.
+   d + ((s - d) * alpha >> 8) is computed as (d * (256 - alpha) + s * alpha)
+   >> 8, which fits in 16 bits and gives the same result as the macro. */
+static void
+BlitTranslRun888SSE2(Uint32 * dst, const Uint32 * src, int n)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i v256 = _mm_set1_epi16(256);
+    const __m128i opaque = _mm_set1_epi32(0xff000000);
+
+    while (n >= 4) {
+        __m128i s = _mm_loadu_si128((const __m128i *) src);
+        __m128i d = _mm_loadu_si128((__m128i *) dst);
+        __m128i s_lo = _mm_unpacklo_epi8(s, zero);
+        __m128i s_hi = _mm_unpackhi_epi8(s, zero);
+        __m128i d_lo = _mm_unpacklo_epi8(d, zero);
+        __m128i d_hi = _mm_unpackhi_epi8(d, zero);
+        __m128i a_lo, a_hi;
+
+        /* spread the alpha of each pixel over its four channels */
+        a_lo = _mm_shufflelo_epi16(s_lo, 0xff);
+        a_lo = _mm_shufflehi_epi16(a_lo, 0xff);
+        a_hi = _mm_shufflelo_epi16(s_hi, 0xff);
+        a_hi = _mm_shufflehi_epi16(a_hi, 0xff);
+
+        d_lo = _mm_add_epi16(_mm_mullo_epi16(s_lo, a_lo),
+                             _mm_mullo_epi16(d_lo,
+                                             _mm_sub_epi16(v256, a_lo)));
+        d_hi = _mm_add_epi16(_mm_mullo_epi16(s_hi, a_hi),
+                             _mm_mullo_epi16(d_hi,
+                                             _mm_sub_epi16(v256, a_hi)));
+        d = _mm_packus_epi16(_mm_srli_epi16(d_lo, 8),
+                             _mm_srli_epi16(d_hi, 8));
+        _mm_storeu_si128((__m128i *) dst, _mm_or_si128(d, opaque));
+        src += 4;
+        dst += 4;
+        n -= 4;
+    }
+    while (n--) {
+        BLIT_TRANSL_888(*src, *dst);
+        src++;
+        dst++;
+    }
+}
+#endif /* __SSE2__ */
+
+static void
+BlitTranslRun888(Uint32 * dst, const Uint32 * src, int n)
+{
+#ifdef __SSE2__
+    if (SDL_HasSSE2()) {
+        BlitTranslRun888SSE2(dst, src, n);
+        return;
+    }
+#endif
+    while (n--) {
+        BLIT_TRANSL_888(*src, *dst);
+        src++;
+        dst++;
+    }
+}
+
 /* used to save the destination format in the encoding. Designed to be
    macro-compatible with SDL_PixelFormat but without the unneeded fields */
 typedef struct
@@ -691,8 +720,11 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * dst,
 			Ptype *dst = (Ptype *)dstbuf + cofs;		  \
 			Uint32 *src = (Uint32 *)srcbuf + (cofs - ofs);	  \
 			int i;						  \
-			for(i = 0; i < crun; i++)			  \
-			    do_blend(src[i], dst[i]);			  \
+			if(sizeof(Ptype) == 4)				  \
+			    BlitTranslRun888((Uint32 *)dst, src, crun);	  \
+			else						  \
+			    for(i = 0; i < crun; i++)			  \
+				do_blend(src[i], dst[i]);		  \
 		    }							  \
 		    srcbuf += run * 4;					  \
 		    ofs += run;						  \
@@ -735,63 +767,7 @@ SDL_RLEAlphaBlit(SDL_Surface * src, SDL_Rect * srcrect,
     x = dstrect->x;
     y = dstrect->y;
     dstbuf = (Uint8 *) dst->pixels + y * dst->pitch + x * df->BytesPerPixel;
-    srcbuf = (Uint8 *) src->map->data + sizeof(RLEDestFormat);
-
-    {
-        /* skip lines at the top if necessary */
-        int vskip = srcrect->y;
-        if (vskip) {
-            int ofs;
-            if (df->BytesPerPixel == 2) {
-                /* the 16/32 interleaved format */
-                do {
-                    /* skip opaque line */
-                    ofs = 0;
-                    do {
-                        int run;
-                        ofs += srcbuf[0];
-                        run = srcbuf[1];
-                        srcbuf += 2;
-                        if (run) {
-                            srcbuf += 2 * run;
-                            ofs += run;
-                        } else if (!ofs)
-                            goto done;
-                    } while (ofs < w);
-
-                    /* skip padding */
-                    srcbuf += (uintptr_t) srcbuf & 2;
-
-                    /* skip translucent line */
-                    ofs = 0;
-                    do {
-                        int run;
-                        ofs += ((Uint16 *) srcbuf)[0];
-                        run = ((Uint16 *) srcbuf)[1];
-                        srcbuf += 4 * (run + 1);
-                        ofs += run;
-                    } while (ofs < w);
-                } while (--vskip);
-            } else {
-                /* the 32/32 interleaved format */
-                vskip <<= 1;    /* opaque and translucent have same format */
-                do {
-                    ofs = 0;
-                    do {
-                        int run;
-                        ofs += ((Uint16 *) srcbuf)[0];
-                        run = ((Uint16 *) srcbuf)[1];
-                        srcbuf += 4;
-                        if (run) {
-                            srcbuf += 4 * run;
-                            ofs += run;
-                        } else if (!ofs)
-                            goto done;
-                    } while (ofs < w);
-                } while (--vskip);
-            }
-        }
-    }
+    srcbuf = RLE_LINE(src->map->data, srcrect->y);
 
     /* if left or right edge clipping needed, call clip blit */
     if (srcrect->x || srcrect->w != src->w) {
@@ -835,12 +811,17 @@ SDL_RLEAlphaBlit(SDL_Surface * src, SDL_Rect * srcrect,
 		    if(run) {						 \
 			Ptype *dst = (Ptype *)dstbuf + ofs;		 \
 			unsigned i;					 \
-			for(i = 0; i < run; i++) {			 \
-			    Uint32 src = *(Uint32 *)srcbuf;		 \
-			    do_blend(src, *dst);			 \
-			    srcbuf += 4;				 \
-			    dst++;					 \
-			}						 \
+			if(sizeof(Ptype) == 4) {			 \
+			    BlitTranslRun888((Uint32 *)dst,		 \
+					     (Uint32 *)srcbuf, run);	 \
+			    srcbuf += run * 4;				 \
+			} else						 \
+			    for(i = 0; i < run; i++) {			 \
+				Uint32 src = *(Uint32 *)srcbuf;		 \
+				do_blend(src, *dst);			 \
+				srcbuf += 4;				 \
+				dst++;					 \
+			    }						 \
 			ofs += run;					 \
 		    }							 \
 		} while(ofs < w);					 \
@@ -1084,7 +1065,7 @@ RLEAlphaSurface(SDL_Surface * surface)
         return -1;              /* anything else unsupported right now */
     }
 
-    maxsize += sizeof(RLEDestFormat);
+    maxsize += RLE_INDEX_SIZE(surface->h) + sizeof(RLEDestFormat);
     rlebuf = (Uint8 *) SDL_malloc(maxsize);
     if (!rlebuf) {
         SDL_OutOfMemory();
@@ -1092,7 +1073,8 @@ RLEAlphaSurface(SDL_Surface * surface)
     }
     {
         /* save the destination format so we can undo the encoding later */
-        RLEDestFormat *r = (RLEDestFormat *) rlebuf;
+        RLEDestFormat *r =
+            (RLEDestFormat *) (rlebuf + RLE_INDEX_SIZE(surface->h));
         r->BytesPerPixel = df->BytesPerPixel;
         r->Rloss = df->Rloss;
         r->Gloss = df->Gloss;
@@ -1106,7 +1088,7 @@ RLEAlphaSurface(SDL_Surface * surface)
         r->Bmask = df->Bmask;
         r->Amask = df->Amask;
     }
-    dst = rlebuf + sizeof(RLEDestFormat);
+    dst = rlebuf + RLE_INDEX_SIZE(surface->h) + sizeof(RLEDestFormat);
 
     /* Do the actual encoding */
     {
@@ -1114,6 +1096,7 @@ RLEAlphaSurface(SDL_Surface * surface)
         int h = surface->h, w = surface->w;
         SDL_PixelFormat *sf = surface->format;
         Uint32 *src = (Uint32 *) surface->pixels;
+        Uint32 *index = (Uint32 *) rlebuf;
         Uint8 *lastline = dst;  /* end of last non-blank line */
 
         /* opaque counts are 8 or 16 bits, depending on target depth */
@@ -1135,6 +1118,7 @@ RLEAlphaSurface(SDL_Surface * surface)
         for (y = 0; y < h; y++) {
             int runstart, skipstart;
             int blankline = 0;
+            index[y] = (Uint32) (dst - rlebuf);
             /* First encode all opaque pixels of a scan line */
             x = 0;
             do {
@@ -1206,6 +1190,8 @@ RLEAlphaSurface(SDL_Surface * surface)
             src += surface->pitch >> 2;
         }
         dst = lastline;         /* back up past trailing blank lines */
+        for (y = h - 1; y >= 0 && index[y] > (Uint32) (dst - rlebuf); y--)
+            index[y] = (Uint32) (dst - rlebuf);
         ADD_OPAQUE_COUNTS(0, 0);
     }
 
@@ -1214,7 +1200,7 @@ RLEAlphaSurface(SDL_Surface * surface)
 
     /* Now that we have it encoded, release the original pixels */
     if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_free(surface->pixels);
+        SDL_FreeSurfaceMemory(surface->pixels);
         surface->pixels = NULL;
     }
 
@@ -1275,6 +1261,7 @@ RLEColorkeySurface(SDL_Surface * surface)
     int bpp = surface->format->BytesPerPixel;
     getpix_func getpix;
     Uint32 ckey, rgbmask;
+    Uint32 *index;
     int w, h;
 
     /* calculate the worst case size for the compressed surface */
@@ -1297,6 +1284,7 @@ RLEColorkeySurface(SDL_Surface * surface)
         break;
     }
 
+    maxsize += RLE_INDEX_SIZE(surface->h);
     rlebuf = (Uint8 *) SDL_malloc(maxsize);
     if (rlebuf == NULL) {
         SDL_OutOfMemory();
@@ -1308,7 +1296,8 @@ RLEColorkeySurface(SDL_Surface * surface)
     curbuf = srcbuf;
     maxn = bpp == 4 ? 65535 : 255;
     skip = run = 0;
-    dst = rlebuf;
+    index = (Uint32 *) rlebuf;
+    dst = rlebuf + RLE_INDEX_SIZE(surface->h);
     rgbmask = ~surface->format->Amask;
     ckey = surface->map->info.colorkey & rgbmask;
     lastline = dst;
@@ -1330,6 +1319,7 @@ RLEColorkeySurface(SDL_Surface * surface)
     for (y = 0; y < h; y++) {
         int x = 0;
         int blankline = 0;
+        index[y] = (Uint32) (dst - rlebuf);
         do {
             int run, skip, len;
             int runstart;
@@ -1372,13 +1362,15 @@ RLEColorkeySurface(SDL_Surface * surface)
         srcbuf += surface->pitch;
     }
     dst = lastline;             /* back up bast trailing blank lines */
+    for (y = h - 1; y >= 0 && index[y] > (Uint32) (dst - rlebuf); y--)
+        index[y] = (Uint32) (dst - rlebuf);
     ADD_COUNTS(0, 0);
 
 #undef ADD_COUNTS
 
     /* Now that we have it encoded, release the original pixels */
     if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_free(surface->pixels);
+        SDL_FreeSurfaceMemory(surface->pixels);
         surface->pixels = NULL;
     }
 
@@ -1464,7 +1456,8 @@ UnRLEAlpha(SDL_Surface * surface)
     Uint8 *srcbuf;
     Uint32 *dst;
     SDL_PixelFormat *sf = surface->format;
-    RLEDestFormat *df = surface->map->data;
+    RLEDestFormat *df = (RLEDestFormat *)
+        ((Uint8 *) surface->map->data + RLE_INDEX_SIZE(surface->h));
     int (*uncopy_opaque) (Uint32 *, void *, int,
                           RLEDestFormat *, SDL_PixelFormat *);
     int (*uncopy_transl) (Uint32 *, void *, int,
@@ -1479,7 +1472,7 @@ UnRLEAlpha(SDL_Surface * surface)
         uncopy_opaque = uncopy_transl = uncopy_32;
     }
 
-    surface->pixels = SDL_malloc(surface->h * surface->pitch);
+    surface->pixels = SDL_AllocSurfaceMemory(surface->h * surface->pitch);
     if (!surface->pixels) {
         return (SDL_FALSE);
     }
@@ -1542,7 +1535,8 @@ SDL_UnRLESurface(SDL_Surface * surface, int recode)
                 SDL_Rect full;
 
                 /* re-create the original surface */
-                surface->pixels = SDL_malloc(surface->h * surface->pitch);
+                surface->pixels =
+                    SDL_AllocSurfaceMemory(surface->h * surface->pitch);
                 if (!surface->pixels) {
                     /* Oh crap... */
                     surface->flags |= SDL_RLEACCEL;
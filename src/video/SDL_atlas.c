@@ -0,0 +1,319 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2010 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Packing of small images into shared textures, using a skyline packer */
+
+#include "SDL_video.h"
+#include "SDL_pixels_c.h"
+
+/* Space left around each image so filtering doesn't pick up neighbours */
+#define ATLAS_PADDING   1
+
+typedef struct
+{
+    int x, y, w;
+} SDL_AtlasSegment;
+
+typedef struct SDL_AtlasPage
+{
+    SDL_Texture *texture;
+
+    /* The top edge of the packed area, from left to right */
+    SDL_AtlasSegment *skyline;
+    int num_segments;
+
+    struct SDL_AtlasPage *next;
+} SDL_AtlasPage;
+
+struct SDL_TextureAtlas
+{
+    Uint32 format;
+    int w, h;
+    SDL_AtlasPage *pages;
+};
+
+SDL_TextureAtlas *
+SDL_CreateTextureAtlas(Uint32 format, int w, int h)
+{
+    SDL_TextureAtlas *atlas;
+
+    if (SDL_ISPIXELFORMAT_INDEXED(format) ||
+        SDL_ISPIXELFORMAT_FOURCC(format)) {
+        SDL_SetError("Atlas textures can't be indexed or YUV");
+        return NULL;
+    }
+    if (w <= 0 || h <= 0) {
+        SDL_SetError("Invalid atlas size");
+        return NULL;
+    }
+
+    atlas = (SDL_TextureAtlas *) SDL_calloc(1, sizeof(*atlas));
+    if (!atlas) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    atlas->format = format;
+    atlas->w = w;
+    atlas->h = h;
+    return atlas;
+}
+
+static SDL_AtlasPage *
+SDL_CreateAtlasPage(SDL_TextureAtlas * atlas)
+{
+    SDL_AtlasPage *page;
+    void *pixels;
+    int pitch;
+
+    page = (SDL_AtlasPage *) SDL_calloc(1, sizeof(*page));
+    if (!page) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    /* There are never more segments than columns, plus one being added */
+    page->skyline =
+        (SDL_AtlasSegment *) SDL_malloc((atlas->w + 1) *
+                                        sizeof(*page->skyline));
+    if (!page->skyline) {
+        SDL_OutOfMemory();
+        SDL_free(page);
+        return NULL;
+    }
+    page->skyline[0].x = 0;
+    page->skyline[0].y = 0;
+    page->skyline[0].w = atlas->w;
+    page->num_segments = 1;
+
+    page->texture =
+        SDL_CreateTexture(atlas->format, SDL_TEXTUREACCESS_STATIC, atlas->w,
+                          atlas->h);
+    if (!page->texture) {
+        SDL_free(page->skyline);
+        SDL_free(page);
+        return NULL;
+    }
+    if (SDL_ISPIXELFORMAT_ALPHA(atlas->format)) {
+        SDL_SetTextureBlendMode(page->texture, SDL_BLENDMODE_BLEND);
+    }
+
+    /* Start out transparent, so the padding is clean */
+    pitch = atlas->w * SDL_BYTESPERPIXEL(atlas->format);
+    pixels = SDL_calloc(atlas->h, pitch);
+    if (pixels) {
+        SDL_UpdateTexture(page->texture, NULL, pixels, pitch);
+        SDL_free(pixels);
+    }
+
+    page->next = atlas->pages;
+    atlas->pages = page;
+    return page;
+}
+
+/* Find the lowest position of a w x h area resting on the skyline,
+   starting at segment 'index', or return -1 if it doesn't fit there */
+static int
+SDL_FitSkyline(SDL_TextureAtlas * atlas, SDL_AtlasPage * page, int index,
+               int w, int h)
+{
+    SDL_AtlasSegment *segment = &page->skyline[index];
+    int x = segment->x;
+    int y = 0;
+    int left = w;
+
+    if (x + w > atlas->w) {
+        return -1;
+    }
+    while (left > 0) {
+        if (index == page->num_segments) {
+            return -1;
+        }
+        y = SDL_max(y, page->skyline[index].y);
+        if (y + h > atlas->h) {
+            return -1;
+        }
+        left -= page->skyline[index].w;
+        ++index;
+    }
+    return y;
+}
+
+/* Raise the skyline over the area placed at segment 'index' */
+static void
+SDL_AddSkylineLevel(SDL_AtlasPage * page, int index, int x, int y, int w)
+{
+    SDL_AtlasSegment *skyline = page->skyline;
+    int i;
+
+    SDL_memmove(&skyline[index + 1], &skyline[index],
+                (page->num_segments - index) * sizeof(*skyline));
+    skyline[index].x = x;
+    skyline[index].y = y;
+    skyline[index].w = w;
+    ++page->num_segments;
+
+    /* Trim the segments that are now covered */
+    for (i = index + 1; i < page->num_segments; ++i) {
+        int shrink = skyline[i - 1].x + skyline[i - 1].w - skyline[i].x;
+        if (shrink <= 0) {
+            break;
+        }
+        skyline[i].x += shrink;
+        skyline[i].w -= shrink;
+        if (skyline[i].w > 0) {
+            break;
+        }
+        SDL_memmove(&skyline[i], &skyline[i + 1],
+                    (page->num_segments - i - 1) * sizeof(*skyline));
+        --page->num_segments;
+        --i;
+    }
+
+    /* Merge neighbours at the same height */
+    for (i = 0; i < page->num_segments - 1; ++i) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].w += skyline[i + 1].w;
+            SDL_memmove(&skyline[i + 1], &skyline[i + 2],
+                        (page->num_segments - i - 2) * sizeof(*skyline));
+            --page->num_segments;
+            --i;
+        }
+    }
+}
+
+/* Place a w x h area on a page using the bottom-left rule */
+static SDL_bool
+SDL_PackAtlasPage(SDL_TextureAtlas * atlas, SDL_AtlasPage * page, int w,
+                  int h, SDL_Rect * rect)
+{
+    int i, y;
+    int best_index = -1;
+    int best_bottom = 0;
+    int best_width = 0;
+
+    for (i = 0; i < page->num_segments; ++i) {
+        y = SDL_FitSkyline(atlas, page, i, w, h);
+        if (y < 0) {
+            continue;
+        }
+        if (best_index < 0 || y + h < best_bottom ||
+            (y + h == best_bottom && page->skyline[i].w < best_width)) {
+            best_index = i;
+            best_bottom = y + h;
+            best_width = page->skyline[i].w;
+        }
+    }
+    if (best_index < 0) {
+        return SDL_FALSE;
+    }
+
+    rect->x = page->skyline[best_index].x;
+    rect->y = best_bottom - h;
+    rect->w = w;
+    rect->h = h;
+    SDL_AddSkylineLevel(page, best_index, rect->x, best_bottom, w);
+    return SDL_TRUE;
+}
+
+int
+SDL_AddSurfaceToAtlas(SDL_TextureAtlas * atlas, SDL_Surface * surface,
+                      SDL_Texture ** texture, SDL_Rect * rect)
+{
+    SDL_AtlasPage *page;
+    SDL_PixelFormat dst_fmt;
+    SDL_Surface *dst;
+    int bpp;
+    Uint32 Rmask, Gmask, Bmask, Amask;
+    int w, h;
+
+    if (!atlas) {
+        SDL_SetError("Invalid atlas");
+        return -1;
+    }
+    if (!surface) {
+        SDL_SetError("SDL_AddSurfaceToAtlas() passed NULL surface");
+        return -1;
+    }
+
+    w = SDL_min(surface->w + ATLAS_PADDING, atlas->w);
+    h = SDL_min(surface->h + ATLAS_PADDING, atlas->h);
+    if (surface->w > w || surface->h > h) {
+        SDL_SetError("Surface is larger than the atlas textures");
+        return -1;
+    }
+
+    for (page = atlas->pages; page; page = page->next) {
+        if (SDL_PackAtlasPage(atlas, page, w, h, rect)) {
+            break;
+        }
+    }
+    if (!page) {
+        page = SDL_CreateAtlasPage(atlas);
+        if (!page) {
+            return -1;
+        }
+        if (!SDL_PackAtlasPage(atlas, page, w, h, rect)) {
+            SDL_SetError("Surface is larger than the atlas textures");
+            return -1;
+        }
+    }
+    rect->w = surface->w;
+    rect->h = surface->h;
+
+    /* Convert the pixels to the atlas format and upload them */
+    SDL_PixelFormatEnumToMasks(atlas->format, &bpp, &Rmask, &Gmask, &Bmask,
+                               &Amask);
+    SDL_InitFormat(&dst_fmt, bpp, Rmask, Gmask, Bmask, Amask);
+    dst = SDL_ConvertSurface(surface, &dst_fmt, 0);
+    if (!dst) {
+        return -1;
+    }
+    if (SDL_UpdateTexture(page->texture, rect, dst->pixels, dst->pitch) < 0) {
+        SDL_FreeSurface(dst);
+        return -1;
+    }
+    SDL_FreeSurface(dst);
+
+    *texture = page->texture;
+    return 0;
+}
+
+void
+SDL_DestroyTextureAtlas(SDL_TextureAtlas * atlas)
+{
+    SDL_AtlasPage *page;
+
+    if (!atlas) {
+        return;
+    }
+    while (atlas->pages) {
+        page = atlas->pages;
+        atlas->pages = page->next;
+        SDL_DestroyTexture(page->texture);
+        SDL_free(page->skyline);
+        SDL_free(page);
+    }
+    SDL_free(atlas);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -23,6 +23,192 @@
 
 #include "SDL_video.h"
 #include "SDL_draw.h"
+#include "SDL_rect_c.h"
+
+#ifdef __SSE2__
+/* *INDENT-OFF* */
+
+/* Run 'op' on 'pix', a vector of whole pixels, across the rectangle.
+   The end of each row goes through a small buffer so no scalar version
+   of 'op' is needed. */
+#define FILLRECT_SSE2(type, op) \
+do { \
+    DECLARE_ALIGNED(type, tail[16 / sizeof(type)], 16); \
+    const int per_vector = 16 / sizeof(type); \
+    int width = rect->w; \
+    int height = rect->h; \
+    int pitch = (dst->pitch / dst->format->BytesPerPixel); \
+    type *row = (type *)dst->pixels + rect->y * pitch + rect->x; \
+    while (height--) { \
+        type *pixel = row; \
+        int n = width; \
+        __m128i pix; \
+        while (n >= per_vector) { \
+            pix = _mm_loadu_si128((__m128i *)pixel); \
+            op; \
+            _mm_storeu_si128((__m128i *)pixel, pix); \
+            pixel += per_vector; \
+            n -= per_vector; \
+        } \
+        if (n > 0) { \
+            SDL_memcpy(tail, pixel, n * sizeof(type)); \
+            pix = _mm_loadu_si128((__m128i *)tail); \
+            op; \
+            _mm_storeu_si128((__m128i *)tail, pix); \
+            SDL_memcpy(pixel, tail, n * sizeof(type)); \
+        } \
+        row += pitch; \
+    } \
+} while (0)
+
+/*
+ * 32-bit xRGB, the color channels are processed as 16-bit lanes
+ */
+
+#define SSE2_BLEND_8888(lanes) \
+    lanes = _mm_add_epi16(SSE2_DIV255(_mm_mullo_epi16(lanes, inva16)), color16)
+
+#define SSE2_MOD_8888(lanes) \
+    lanes = SSE2_DIV255(_mm_mullo_epi16(lanes, color16))
+
+#define SSE2_OP_8888(lanes_op) \
+do { \
+    __m128i lo = _mm_unpacklo_epi8(pix, zero); \
+    __m128i hi = _mm_unpackhi_epi8(pix, zero); \
+    lanes_op(lo); \
+    lanes_op(hi); \
+    pix = _mm_or_si128(_mm_and_si128(_mm_packus_epi16(lo, hi), rgbmask), \
+                       _mm_and_si128(pix, keepmask)); \
+} while (0)
+
+#define SSE2_ADD_8888 \
+    pix = _mm_or_si128(_mm_and_si128(_mm_adds_epu8(pix, color8), rgbmask), \
+                       _mm_and_si128(pix, keepmask))
+
+#define DEFINE_SSE2_BLENDFILLRECT_8888(fmt, keep) \
+static int \
+SDL_BlendFillRect_##fmt##SSE2(SDL_Surface * dst, const SDL_Rect * rect, \
+                              int blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a) \
+{ \
+    unsigned inva = 0xff - a; \
+    const __m128i zero = _mm_setzero_si128(); \
+    const __m128i div255 = _mm_set1_epi16((short) 0x8081); \
+    const __m128i inva16 = _mm_set1_epi16((short) inva); \
+    const __m128i color16 = _mm_set_epi16(0, r, g, b, 0, r, g, b); \
+    const __m128i color8 = _mm_set1_epi32((r << 16) | (g << 8) | b); \
+    const __m128i rgbmask = _mm_set1_epi32(0x00FFFFFF); \
+    const __m128i keepmask = _mm_set1_epi32((int) keep); \
+ \
+    switch (blendMode) { \
+    case SDL_BLENDMODE_BLEND: \
+        FILLRECT_SSE2(Uint32, SSE2_OP_8888(SSE2_BLEND_8888)); \
+        break; \
+    case SDL_BLENDMODE_ADD: \
+        FILLRECT_SSE2(Uint32, SSE2_ADD_8888); \
+        break; \
+    case SDL_BLENDMODE_MOD: \
+        FILLRECT_SSE2(Uint32, SSE2_OP_8888(SSE2_MOD_8888)); \
+        break; \
+    default: \
+        FILLRECT(Uint32, DRAW_SETPIXEL_##fmt); \
+        break; \
+    } \
+    return 0; \
+}
+
+/* RGB888 clears the unused byte like DRAW_SETPIXEL_RGB888 does */
+DEFINE_SSE2_BLENDFILLRECT_8888(RGB888, 0x00000000)
+DEFINE_SSE2_BLENDFILLRECT_8888(ARGB8888, 0xFF000000)
+
+/*
+ * 16-bit RGB, each channel is expanded to 8 bits in its own vector
+ */
+
+/* The channel masks each format needs */
+#define SSE2_MASKS_RGB555 \
+    const __m128i mask5 = _mm_set1_epi16(0xF8)
+
+#define SSE2_MASKS_RGB565 \
+    const __m128i mask5 = _mm_set1_epi16(0xF8); \
+    const __m128i mask6 = _mm_set1_epi16(0xFC)
+
+#define SSE2_UNPACK_RGB555 \
+    R = _mm_and_si128(_mm_srli_epi16(pix, 7), mask5); \
+    G = _mm_and_si128(_mm_srli_epi16(pix, 2), mask5); \
+    B = _mm_and_si128(_mm_slli_epi16(pix, 3), mask5)
+
+#define SSE2_PACK_RGB555 \
+    pix = _mm_or_si128(_mm_or_si128( \
+              _mm_slli_epi16(_mm_and_si128(R, mask5), 7), \
+              _mm_slli_epi16(_mm_and_si128(G, mask5), 2)), \
+              _mm_srli_epi16(B, 3))
+
+#define SSE2_UNPACK_RGB565 \
+    R = _mm_and_si128(_mm_srli_epi16(pix, 8), mask5); \
+    G = _mm_and_si128(_mm_srli_epi16(pix, 3), mask6); \
+    B = _mm_and_si128(_mm_slli_epi16(pix, 3), mask5)
+
+#define SSE2_PACK_RGB565 \
+    pix = _mm_or_si128(_mm_or_si128( \
+              _mm_slli_epi16(_mm_and_si128(R, mask5), 8), \
+              _mm_slli_epi16(_mm_and_si128(G, mask6), 3)), \
+              _mm_srli_epi16(B, 3))
+
+#define SSE2_BLEND_16(C, c) \
+    C = _mm_add_epi16(SSE2_DIV255(_mm_mullo_epi16(C, inva16)), c)
+
+#define SSE2_ADD_16(C, c) \
+    C = _mm_min_epi16(_mm_add_epi16(C, c), max16)
+
+#define SSE2_MOD_16(C, c) \
+    C = SSE2_DIV255(_mm_mullo_epi16(C, c))
+
+#define SSE2_OP_16(fmt, channel_op) \
+do { \
+    __m128i R, G, B; \
+    SSE2_UNPACK_##fmt; \
+    channel_op(R, r16); \
+    channel_op(G, g16); \
+    channel_op(B, b16); \
+    SSE2_PACK_##fmt; \
+} while (0)
+
+#define DEFINE_SSE2_BLENDFILLRECT_16(fmt) \
+static int \
+SDL_BlendFillRect_##fmt##SSE2(SDL_Surface * dst, const SDL_Rect * rect, \
+                              int blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a) \
+{ \
+    unsigned inva = 0xff - a; \
+    const __m128i div255 = _mm_set1_epi16((short) 0x8081); \
+    const __m128i inva16 = _mm_set1_epi16((short) inva); \
+    const __m128i r16 = _mm_set1_epi16(r); \
+    const __m128i g16 = _mm_set1_epi16(g); \
+    const __m128i b16 = _mm_set1_epi16(b); \
+    const __m128i max16 = _mm_set1_epi16(0xFF); \
+    SSE2_MASKS_##fmt; \
+ \
+    switch (blendMode) { \
+    case SDL_BLENDMODE_BLEND: \
+        FILLRECT_SSE2(Uint16, SSE2_OP_16(fmt, SSE2_BLEND_16)); \
+        break; \
+    case SDL_BLENDMODE_ADD: \
+        FILLRECT_SSE2(Uint16, SSE2_OP_16(fmt, SSE2_ADD_16)); \
+        break; \
+    case SDL_BLENDMODE_MOD: \
+        FILLRECT_SSE2(Uint16, SSE2_OP_16(fmt, SSE2_MOD_16)); \
+        break; \
+    default: \
+        FILLRECT(Uint16, DRAW_SETPIXEL_##fmt); \
+        break; \
+    } \
+    return 0; \
+}
+
+DEFINE_SSE2_BLENDFILLRECT_16(RGB555)
+DEFINE_SSE2_BLENDFILLRECT_16(RGB565)
+
+/* *INDENT-ON* */
+#endif /* __SSE2__ */
 
 static int
 SDL_BlendFillRect_RGB555(SDL_Surface * dst, const SDL_Rect * rect,
@@ -30,6 +216,12 @@ SDL_BlendFillRect_RGB555(SDL_Surface * dst, const SDL_Rect * rect,
 {
     unsigned inva = 0xff - a;
 
+#ifdef __SSE2__
+    if (SDL_HasSSE2()) {
+        return SDL_BlendFillRect_RGB555SSE2(dst, rect, blendMode, r, g, b, a);
+    }
+#endif
+
     switch (blendMode) {
     case SDL_BLENDMODE_BLEND:
         FILLRECT(Uint16, DRAW_SETPIXEL_BLEND_RGB555);
@@ -53,6 +245,12 @@ SDL_BlendFillRect_RGB565(SDL_Surface * dst, const SDL_Rect * rect,
 {
     unsigned inva = 0xff - a;
 
+#ifdef __SSE2__
+    if (SDL_HasSSE2()) {
+        return SDL_BlendFillRect_RGB565SSE2(dst, rect, blendMode, r, g, b, a);
+    }
+#endif
+
     switch (blendMode) {
     case SDL_BLENDMODE_BLEND:
         FILLRECT(Uint16, DRAW_SETPIXEL_BLEND_RGB565);
@@ -76,6 +274,12 @@ SDL_BlendFillRect_RGB888(SDL_Surface * dst, const SDL_Rect * rect,
 {
     unsigned inva = 0xff - a;
 
+#ifdef __SSE2__
+    if (SDL_HasSSE2()) {
+        return SDL_BlendFillRect_RGB888SSE2(dst, rect, blendMode, r, g, b, a);
+    }
+#endif
+
     switch (blendMode) {
     case SDL_BLENDMODE_BLEND:
         FILLRECT(Uint32, DRAW_SETPIXEL_BLEND_RGB888);
@@ -99,6 +303,12 @@ SDL_BlendFillRect_ARGB8888(SDL_Surface * dst, const SDL_Rect * rect,
 {
     unsigned inva = 0xff - a;
 
+#ifdef __SSE2__
+    if (SDL_HasSSE2()) {
+        return SDL_BlendFillRect_ARGB8888SSE2(dst, rect, blendMode, r, g, b, a);
+    }
+#endif
+
     switch (blendMode) {
     case SDL_BLENDMODE_BLEND:
         FILLRECT(Uint32, DRAW_SETPIXEL_BLEND_ARGB8888);
@@ -265,7 +475,8 @@ int
 SDL_BlendFillRects(SDL_Surface * dst, const SDL_Rect ** rects, int count,
                    int blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
-    SDL_Rect clipped;
+    SDL_Rect stack_rects[64];
+    SDL_Rect *merged;
     int i;
     int (*func)(SDL_Surface * dst, const SDL_Rect * rect,
                 int blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a) = NULL;
@@ -325,21 +536,27 @@ SDL_BlendFillRects(SDL_Surface * dst, const SDL_Rect ** rects, int count,
         }
     }
 
-    for (i = 0; i < count; ++i) {
-        const SDL_Rect * rect = rects[i];
-
-        /* If 'rect' == NULL, then fill the whole surface */
-        if (rect) {
-            /* Perform clipping */
-            if (!SDL_IntersectRect(rect, &dst->clip_rect, &clipped)) {
-                continue;
-            }
-            rect = &clipped;
-        } else {
-            rect = &dst->clip_rect;
+    if (count <= (int) SDL_arraysize(stack_rects)) {
+        merged = stack_rects;
+    } else {
+        merged = (SDL_Rect *) SDL_malloc(count * sizeof(*merged));
+        if (!merged) {
+            SDL_OutOfMemory();
+            return -1;
         }
+    }
+
+    /* Blending the same pixel twice isn't the same as blending it once,
+       so overlapping rects can only be combined for plain fills. */
+    count = SDL_MergeRects(rects, count, &dst->clip_rect,
+                           (blendMode == SDL_BLENDMODE_NONE ||
+                            blendMode == SDL_BLENDMODE_MASK), merged);
+    for (i = 0; i < count; ++i) {
+        status = func(dst, &merged[i], blendMode, r, g, b, a);
+    }
 
-        status = func(dst, rect, blendMode, r, g, b, a);
+    if (merged != stack_rects) {
+        SDL_free(merged);
     }
     return status;
 }
@@ -22,6 +22,7 @@
 #include "SDL_config.h"
 
 #include "SDL_draw.h"
+#include "SDL_rect_c.h"
 
 
 static void
@@ -740,6 +741,7 @@ SDL_BlendLines(SDL_Surface * dst, const SDL_Point * points, int count,
     int x1, y1;
     int x2, y2;
     SDL_bool draw_end;
+    SDL_bool inside;
     BlendLineFunc func;
 
     if (!dst) {
@@ -753,20 +755,28 @@ SDL_BlendLines(SDL_Surface * dst, const SDL_Point * points, int count,
         return -1;
     }
 
+    /* Only clip the segments if the polyline isn't entirely visible */
+    inside = SDL_PointsInRect(points, count, &dst->clip_rect);
+
     for (i = 1; i < count; ++i) {
         x1 = points[i-1].x;
         y1 = points[i-1].y;
         x2 = points[i].x;
         y2 = points[i].y;
 
-        /* Perform clipping */
-        /* FIXME: We don't actually want to clip, as it may change line slope */
-        if (!SDL_IntersectRectAndLine(&dst->clip_rect, &x1, &y1, &x2, &y2)) {
-            continue;
-        }
+        if (inside) {
+            draw_end = SDL_FALSE;
+        } else {
+            /* Perform clipping */
+            /* FIXME: We don't actually want to clip, as it may change line slope */
+            if (!SDL_IntersectRectAndLine(&dst->clip_rect,
+                                          &x1, &y1, &x2, &y2)) {
+                continue;
+            }
 
-        /* Draw the end if it was clipped */
-        draw_end = (x2 != points[i].x || y2 != points[i].y);
+            /* Draw the end if it was clipped */
+            draw_end = (x2 != points[i].x || y2 != points[i].y);
+        }
 
         func(dst, x1, y1, x2, y2, blendMode, r, g, b, a, draw_end);
     }
@@ -777,4 +787,628 @@ SDL_BlendLines(SDL_Surface * dst, const SDL_Point * points, int count,
     return 0;
 }
 
+/*
+ * Wide and anti-aliased polylines
+ *
+ * A stroke covers everything within width/2 of the polyline, so each
+ * segment is a capsule with round ends, which also rounds the joins.
+ * The coverage of a band of rows is collected in an 8-bit mask, keeping
+ * the largest value where segments overlap so the joins are only blended
+ * once, and then each row of the mask is blended as a single span.
+ */
+
+/* The number of rows rasterized at a time */
+#define STROKE_BAND_ROWS    32
+
+typedef struct
+{
+    float x, y;                 /* The start point */
+    float dx, dy;               /* The end point, relative to the start */
+    float len, len2;            /* The length, and the length squared */
+    int miny, maxy;             /* The rows the stroke can touch */
+} SDL_StrokeSegment;
+
+typedef struct
+{
+    Uint8 *coverage;            /* STROKE_BAND_ROWS rows of w bytes */
+    int x, y, w, h;             /* The area of the band on the surface */
+    int minx[STROKE_BAND_ROWS]; /* The covered part of each row, from x */
+    int maxx[STROKE_BAND_ROWS];
+} SDL_StrokeBand;
+
+static void
+SDL_BlendCoverage_RGB2(SDL_Surface * dst, int x, int y,
+                       const Uint8 * coverage, int width, int blendMode,
+                       Uint8 _r, Uint8 _g, Uint8 _b, Uint8 _a)
+{
+    const SDL_PixelFormat *fmt = dst->format;
+
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        COVERAGESPAN(Uint16, COVERAGE_BLEND, DRAW_SETPIXEL_BLEND_RGB);
+        break;
+    case SDL_BLENDMODE_ADD:
+        COVERAGESPAN(Uint16, COVERAGE_BLEND, DRAW_SETPIXEL_ADD_RGB);
+        break;
+    case SDL_BLENDMODE_MOD:
+        COVERAGESPAN(Uint16, COVERAGE_MOD, DRAW_SETPIXEL_MOD_RGB);
+        break;
+    default:
+        COVERAGESPAN_OPAQUE(Uint16, DRAW_SETPIXEL_RGB,
+                            DRAW_SETPIXEL_BLEND_RGB);
+        break;
+    }
+}
+
+static void
+SDL_BlendCoverage_RGB555(SDL_Surface * dst, int x, int y,
+                         const Uint8 * coverage, int width, int blendMode,
+                         Uint8 _r, Uint8 _g, Uint8 _b, Uint8 _a)
+{
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        COVERAGESPAN(Uint16, COVERAGE_BLEND, DRAW_SETPIXEL_BLEND_RGB555);
+        break;
+    case SDL_BLENDMODE_ADD:
+        COVERAGESPAN(Uint16, COVERAGE_BLEND, DRAW_SETPIXEL_ADD_RGB555);
+        break;
+    case SDL_BLENDMODE_MOD:
+        COVERAGESPAN(Uint16, COVERAGE_MOD, DRAW_SETPIXEL_MOD_RGB555);
+        break;
+    default:
+        COVERAGESPAN_OPAQUE(Uint16, DRAW_SETPIXEL_RGB555,
+                            DRAW_SETPIXEL_BLEND_RGB555);
+        break;
+    }
+}
+
+static void
+SDL_BlendCoverage_RGB565(SDL_Surface * dst, int x, int y,
+                         const Uint8 * coverage, int width, int blendMode,
+                         Uint8 _r, Uint8 _g, Uint8 _b, Uint8 _a)
+{
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        COVERAGESPAN(Uint16, COVERAGE_BLEND, DRAW_SETPIXEL_BLEND_RGB565);
+        break;
+    case SDL_BLENDMODE_ADD:
+        COVERAGESPAN(Uint16, COVERAGE_BLEND, DRAW_SETPIXEL_ADD_RGB565);
+        break;
+    case SDL_BLENDMODE_MOD:
+        COVERAGESPAN(Uint16, COVERAGE_MOD, DRAW_SETPIXEL_MOD_RGB565);
+        break;
+    default:
+        COVERAGESPAN_OPAQUE(Uint16, DRAW_SETPIXEL_RGB565,
+                            DRAW_SETPIXEL_BLEND_RGB565);
+        break;
+    }
+}
+
+static void
+SDL_BlendCoverage_RGB4(SDL_Surface * dst, int x, int y,
+                       const Uint8 * coverage, int width, int blendMode,
+                       Uint8 _r, Uint8 _g, Uint8 _b, Uint8 _a)
+{
+    const SDL_PixelFormat *fmt = dst->format;
+
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        COVERAGESPAN(Uint32, COVERAGE_BLEND, DRAW_SETPIXEL_BLEND_RGB);
+        break;
+    case SDL_BLENDMODE_ADD:
+        COVERAGESPAN(Uint32, COVERAGE_BLEND, DRAW_SETPIXEL_ADD_RGB);
+        break;
+    case SDL_BLENDMODE_MOD:
+        COVERAGESPAN(Uint32, COVERAGE_MOD, DRAW_SETPIXEL_MOD_RGB);
+        break;
+    default:
+        COVERAGESPAN_OPAQUE(Uint32, DRAW_SETPIXEL_RGB,
+                            DRAW_SETPIXEL_BLEND_RGB);
+        break;
+    }
+}
+
+static void
+SDL_BlendCoverage_RGBA4(SDL_Surface * dst, int x, int y,
+                        const Uint8 * coverage, int width, int blendMode,
+                        Uint8 _r, Uint8 _g, Uint8 _b, Uint8 _a)
+{
+    const SDL_PixelFormat *fmt = dst->format;
+
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        COVERAGESPAN(Uint32, COVERAGE_BLEND, DRAW_SETPIXEL_BLEND_RGBA);
+        break;
+    case SDL_BLENDMODE_ADD:
+        COVERAGESPAN(Uint32, COVERAGE_BLEND, DRAW_SETPIXEL_ADD_RGBA);
+        break;
+    case SDL_BLENDMODE_MOD:
+        COVERAGESPAN(Uint32, COVERAGE_MOD, DRAW_SETPIXEL_MOD_RGBA);
+        break;
+    default:
+        COVERAGESPAN_OPAQUE(Uint32, DRAW_SETPIXEL_RGBA,
+                            DRAW_SETPIXEL_BLEND_RGBA);
+        break;
+    }
+}
+
+#ifdef __SSE2__
+/* Blend a coverage span into 32-bit xRGB pixels, four at a time, giving
+   the same results as the scalar code.  'opaque' is the pixel written
+   where a span is fully covered in the opaque modes, and 'keep' masks
+   the bits of the destination preserved by blending. */
+static void
+SDL_BlendCoverage_8888SSE2(Uint32 * pixel, const Uint8 * coverage,
+                           int width, int blendMode,
+                           Uint8 _r, Uint8 _g, Uint8 _b, Uint8 _a,
+                           Uint32 opaque, Uint32 keep)
+{
+    DECLARE_ALIGNED(Uint32, tail[4], 16);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i div255 = _mm_set1_epi16((short) 0x8081);
+    const __m128i max16 = _mm_set1_epi16(0xff);
+    const __m128i alpha16 = _mm_set1_epi16(_a);
+    const __m128i color16 = _mm_set_epi16(0, _r, _g, _b, 0, _r, _g, _b);
+    const __m128i invcolor16 = _mm_sub_epi16(max16, color16);
+    const __m128i full32 = _mm_set1_epi32(0xff);
+    const __m128i opaque32 = _mm_set1_epi32((int) opaque);
+    const __m128i rgbmask = _mm_set1_epi32(0x00FFFFFF);
+    const __m128i keepmask = _mm_set1_epi32((int) keep);
+    __m128i pix, lo, hi, wlo, whi, w32, mask;
+    Uint32 weights;
+    int n;
+
+    while (width > 0) {
+        n = SDL_min(width, 4);
+        weights = 0;
+        SDL_memcpy(&weights, coverage, n);
+        if (!weights) {
+            pixel += n;
+            coverage += n;
+            width -= n;
+            continue;
+        }
+        if (n == 4) {
+            pix = _mm_loadu_si128((__m128i *) pixel);
+        } else {
+            SDL_memcpy(tail, pixel, n * sizeof(*pixel));
+            pix = _mm_load_si128((__m128i *) tail);
+        }
+
+        /* Spread each pixel's weight over its channels */
+        w32 = _mm_unpacklo_epi8(_mm_cvtsi32_si128((int) weights), zero);
+        wlo = _mm_unpacklo_epi16(w32, w32);
+        whi = _mm_unpackhi_epi32(wlo, wlo);
+        wlo = _mm_unpacklo_epi32(wlo, wlo);
+        w32 = _mm_unpacklo_epi16(w32, zero);
+
+        lo = _mm_unpacklo_epi8(pix, zero);
+        hi = _mm_unpackhi_epi8(pix, zero);
+        switch (blendMode) {
+        case SDL_BLENDMODE_MOD:
+            wlo = _mm_sub_epi16(max16,
+                                SSE2_DIV255(_mm_mullo_epi16(wlo, invcolor16)));
+            whi = _mm_sub_epi16(max16,
+                                SSE2_DIV255(_mm_mullo_epi16(whi, invcolor16)));
+            lo = SSE2_DIV255(_mm_mullo_epi16(lo, wlo));
+            hi = SSE2_DIV255(_mm_mullo_epi16(hi, whi));
+            break;
+        case SDL_BLENDMODE_BLEND:
+        case SDL_BLENDMODE_ADD:
+            wlo = SSE2_DIV255(_mm_mullo_epi16(wlo, alpha16));
+            whi = SSE2_DIV255(_mm_mullo_epi16(whi, alpha16));
+            /* Fall through */
+        default:
+            if (blendMode != SDL_BLENDMODE_ADD) {
+                lo = SSE2_DIV255(_mm_mullo_epi16(lo,
+                                                 _mm_sub_epi16(max16, wlo)));
+                hi = SSE2_DIV255(_mm_mullo_epi16(hi,
+                                                 _mm_sub_epi16(max16, whi)));
+            }
+            lo = _mm_add_epi16(lo, SSE2_DIV255(_mm_mullo_epi16(color16, wlo)));
+            hi = _mm_add_epi16(hi, SSE2_DIV255(_mm_mullo_epi16(color16, whi)));
+            break;
+        }
+        lo = _mm_or_si128(_mm_and_si128(_mm_packus_epi16(lo, hi), rgbmask),
+                          _mm_and_si128(pix, keepmask));
+
+        /* Fully covered pixels are set in the opaque modes */
+        if (blendMode != SDL_BLENDMODE_BLEND &&
+            blendMode != SDL_BLENDMODE_ADD &&
+            blendMode != SDL_BLENDMODE_MOD) {
+            mask = _mm_cmpeq_epi32(w32, full32);
+            lo = _mm_or_si128(_mm_and_si128(mask, opaque32),
+                              _mm_andnot_si128(mask, lo));
+        }
+
+        /* Pixels that aren't covered at all are left alone */
+        mask = _mm_cmpeq_epi32(w32, zero);
+        lo = _mm_or_si128(_mm_and_si128(mask, pix),
+                          _mm_andnot_si128(mask, lo));
+
+        if (n == 4) {
+            _mm_storeu_si128((__m128i *) pixel, lo);
+        } else {
+            _mm_store_si128((__m128i *) tail, lo);
+            SDL_memcpy(pixel, tail, n * sizeof(*pixel));
+        }
+        pixel += n;
+        coverage += n;
+        width -= n;
+    }
+}
+#endif /* __SSE2__ */
+
+static void
+SDL_BlendCoverage_RGB888(SDL_Surface * dst, int x, int y,
+                         const Uint8 * coverage, int width, int blendMode,
+                         Uint8 _r, Uint8 _g, Uint8 _b, Uint8 _a)
+{
+#ifdef __SSE2__
+    if (SDL_HasSSE2()) {
+        Uint32 *pixel = (Uint32 *)((Uint8 *)dst->pixels + y * dst->pitch) + x;
+
+        /* RGB888 clears the unused byte like DRAW_SETPIXEL_RGB888 does */
+        SDL_BlendCoverage_8888SSE2(pixel, coverage, width, blendMode,
+                                   _r, _g, _b, _a,
+                                   ((Uint32) _r << 16) | (_g << 8) | _b,
+                                   0x00000000);
+        return;
+    }
+#endif
+
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        COVERAGESPAN(Uint32, COVERAGE_BLEND, DRAW_SETPIXEL_BLEND_RGB888);
+        break;
+    case SDL_BLENDMODE_ADD:
+        COVERAGESPAN(Uint32, COVERAGE_BLEND, DRAW_SETPIXEL_ADD_RGB888);
+        break;
+    case SDL_BLENDMODE_MOD:
+        COVERAGESPAN(Uint32, COVERAGE_MOD, DRAW_SETPIXEL_MOD_RGB888);
+        break;
+    default:
+        COVERAGESPAN_OPAQUE(Uint32, DRAW_SETPIXEL_RGB888,
+                            DRAW_SETPIXEL_BLEND_RGB888);
+        break;
+    }
+}
+
+static void
+SDL_BlendCoverage_ARGB8888(SDL_Surface * dst, int x, int y,
+                           const Uint8 * coverage, int width, int blendMode,
+                           Uint8 _r, Uint8 _g, Uint8 _b, Uint8 _a)
+{
+#ifdef __SSE2__
+    if (SDL_HasSSE2()) {
+        Uint32 *pixel = (Uint32 *)((Uint8 *)dst->pixels + y * dst->pitch) + x;
+
+        SDL_BlendCoverage_8888SSE2(pixel, coverage, width, blendMode,
+                                   _r, _g, _b, _a,
+                                   ((Uint32) _a << 24) | (_r << 16) |
+                                   (_g << 8) | _b,
+                                   0xFF000000);
+        return;
+    }
+#endif
+
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        COVERAGESPAN(Uint32, COVERAGE_BLEND, DRAW_SETPIXEL_BLEND_ARGB8888);
+        break;
+    case SDL_BLENDMODE_ADD:
+        COVERAGESPAN(Uint32, COVERAGE_BLEND, DRAW_SETPIXEL_ADD_ARGB8888);
+        break;
+    case SDL_BLENDMODE_MOD:
+        COVERAGESPAN(Uint32, COVERAGE_MOD, DRAW_SETPIXEL_MOD_ARGB8888);
+        break;
+    default:
+        COVERAGESPAN_OPAQUE(Uint32, DRAW_SETPIXEL_ARGB8888,
+                            DRAW_SETPIXEL_BLEND_ARGB8888);
+        break;
+    }
+}
+
+typedef void (*BlendCoverageFunc) (SDL_Surface * dst, int x, int y,
+                                   const Uint8 * coverage, int width,
+                                   int blendMode,
+                                   Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+static BlendCoverageFunc
+SDL_CalculateBlendCoverageFunc(const SDL_PixelFormat * fmt)
+{
+    switch (fmt->BytesPerPixel) {
+    case 2:
+        if (fmt->Rmask == 0x7C00) {
+            return SDL_BlendCoverage_RGB555;
+        } else if (fmt->Rmask == 0xF800) {
+            return SDL_BlendCoverage_RGB565;
+        } else {
+            return SDL_BlendCoverage_RGB2;
+        }
+        break;
+    case 4:
+        if (fmt->Rmask == 0x00FF0000) {
+            if (fmt->Amask) {
+                return SDL_BlendCoverage_ARGB8888;
+            } else {
+                return SDL_BlendCoverage_RGB888;
+            }
+        } else {
+            if (fmt->Amask) {
+                return SDL_BlendCoverage_RGBA4;
+            } else {
+                return SDL_BlendCoverage_RGB4;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* Extend the span [*left, *right] to cover [l, r], unless that's empty */
+static void
+SDL_AddStrokeSpan(float *left, float *right, float l, float r)
+{
+    if (l > r) {
+        return;
+    }
+    if (*left > *right) {
+        *left = l;
+        *right = r;
+    } else {
+        *left = SDL_min(*left, l);
+        *right = SDL_max(*right, r);
+    }
+}
+
+/* Find the part of row y that is within 'radius' of the segment */
+static SDL_bool
+SDL_GetStrokeSpan(const SDL_StrokeSegment * seg, float y, float radius,
+                  float *left, float *right)
+{
+    float ey = y - seg->y;
+    float h, l, r, t0, t1;
+
+    *left = 1.0f;
+    *right = 0.0f;
+
+    /* The round ends */
+    h = radius * radius - ey * ey;
+    if (h >= 0.0f) {
+        h = (float) SDL_sqrt(h);
+        SDL_AddStrokeSpan(left, right, seg->x - h, seg->x + h);
+    }
+    h = radius * radius - (ey - seg->dy) * (ey - seg->dy);
+    if (h >= 0.0f) {
+        h = (float) SDL_sqrt(h);
+        SDL_AddStrokeSpan(left, right,
+                          seg->x + seg->dx - h, seg->x + seg->dx + h);
+    }
+
+    /* The body, where the row is close enough to the line and the
+       nearest point on the line is between the ends */
+    if (seg->dy == 0.0f) {
+        if (ey * ey <= radius * radius) {
+            SDL_AddStrokeSpan(left, right,
+                              seg->x + SDL_min(seg->dx, 0.0f),
+                              seg->x + SDL_max(seg->dx, 0.0f));
+        }
+    } else {
+        h = radius * seg->len / ABS(seg->dy);
+        l = seg->x + seg->dx * ey / seg->dy - h;
+        r = seg->x + seg->dx * ey / seg->dy + h;
+        if (seg->dx != 0.0f) {
+            t0 = seg->x - ey * seg->dy / seg->dx;
+            t1 = seg->x + (seg->len2 - ey * seg->dy) / seg->dx;
+            l = SDL_max(l, SDL_min(t0, t1));
+            r = SDL_min(r, SDL_max(t0, t1));
+        } else if (ey * seg->dy < 0.0f || ey * seg->dy > seg->len2) {
+            r = l - 1.0f;
+        }
+        SDL_AddStrokeSpan(left, right, l, r);
+    }
+    return (*left <= *right);
+}
+
+static float
+SDL_GetStrokeDistance(const SDL_StrokeSegment * seg, float x, float y)
+{
+    float ex = x - seg->x;
+    float ey = y - seg->y;
+    float t = 0.0f;
+
+    if (seg->len2 > 0.0f) {
+        t = (ex * seg->dx + ey * seg->dy) / seg->len2;
+        if (t < 0.0f) {
+            t = 0.0f;
+        } else if (t > 1.0f) {
+            t = 1.0f;
+        }
+    }
+    ex -= t * seg->dx;
+    ey -= t * seg->dy;
+    return (float) SDL_sqrt(ex * ex + ey * ey);
+}
+
+/* Add the coverage of one segment to the band.  Pixels are covered if
+   their center is within 'radius' - 0.5 of the segment, and when
+   anti-aliasing, partially covered out to 'radius' + 0.5. */
+static void
+SDL_RasterizeStroke(SDL_StrokeBand * band, const SDL_StrokeSegment * seg,
+                    float radius, SDL_bool antialias)
+{
+    float inner = radius - 0.5f;
+    float outer = antialias ? radius + 0.5f : inner;
+    float left, right;
+    int miny = SDL_max(seg->miny, band->y);
+    int maxy = SDL_min(seg->maxy, band->y + band->h - 1);
+    int minx = band->x;
+    int maxx = band->x + band->w - 1;
+    int x, y, x1, x2, ix1, ix2, row;
+    float cover;
+    Uint8 *coverage;
+
+    for (y = miny; y <= maxy; ++y) {
+        if (!SDL_GetStrokeSpan(seg, (float) y, outer, &left, &right)) {
+            continue;
+        }
+        x1 = SDL_max(minx, -(int) SDL_floor(-left));
+        x2 = SDL_min(maxx, (int) SDL_floor(right));
+        if (x1 > x2) {
+            continue;
+        }
+
+        /* The fully covered part of the row */
+        ix1 = x2 + 1;
+        ix2 = x2;
+        if (!antialias) {
+            ix1 = x1;
+        } else if (inner > 0.0f &&
+                   SDL_GetStrokeSpan(seg, (float) y, inner, &left, &right)) {
+            ix1 = SDL_max(x1, -(int) SDL_floor(-left));
+            ix2 = SDL_min(x2, (int) SDL_floor(right));
+        }
+
+        row = y - band->y;
+        coverage = band->coverage + row * band->w;
+        for (x = x1; x <= x2; ++x) {
+            if (x >= ix1 && x <= ix2) {
+                SDL_memset(&coverage[x - minx], 0xff, ix2 - x + 1);
+                x = ix2;
+                continue;
+            }
+            cover = outer - SDL_GetStrokeDistance(seg, (float) x, (float) y);
+            if (cover <= 0.0f) {
+                continue;
+            }
+            if (cover >= 1.0f) {
+                coverage[x - minx] = 0xff;
+            } else if (cover * 255.0f + 0.5f > coverage[x - minx]) {
+                coverage[x - minx] = (Uint8) (cover * 255.0f + 0.5f);
+            }
+        }
+        band->minx[row] = SDL_min(band->minx[row], x1 - minx);
+        band->maxx[row] = SDL_max(band->maxx[row], x2 - minx);
+    }
+}
+
+int
+SDL_StrokeLines(SDL_Surface * dst, const SDL_Point * points, int count,
+                int width, Uint32 flags,
+                int blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    SDL_bool antialias = (flags & SDL_LINE_ANTIALIAS) ? SDL_TRUE : SDL_FALSE;
+    BlendCoverageFunc func;
+    SDL_StrokeSegment *segments, *seg;
+    SDL_StrokeBand band;
+    SDL_Rect bounds;
+    float radius, outer, offset;
+    int i, y, pad, num_segments;
+    Uint8 *coverage;
+
+    if (!dst) {
+        SDL_SetError("SDL_StrokeLines(): Passed NULL destination surface");
+        return -1;
+    }
+    if (width < 1) {
+        SDL_SetError("SDL_StrokeLines(): Invalid line width");
+        return -1;
+    }
+    if (count < 1) {
+        return 0;
+    }
+
+    /* Thin aliased lines are what the Bresenham code already draws */
+    if (width == 1 && !antialias) {
+        if (blendMode == SDL_BLENDMODE_NONE ||
+            blendMode == SDL_BLENDMODE_MASK) {
+            return SDL_DrawLines(dst, points, count,
+                                 SDL_MapRGBA(dst->format, r, g, b, a));
+        }
+        return SDL_BlendLines(dst, points, count, blendMode, r, g, b, a);
+    }
+
+    func = SDL_CalculateBlendCoverageFunc(dst->format);
+    if (!func) {
+        SDL_SetError("SDL_StrokeLines(): Unsupported surface format");
+        return -1;
+    }
+
+    radius = 0.5f * width;
+    outer = antialias ? radius + 0.5f : radius - 0.5f;
+
+    /* Lines with an even width are centered between pixels */
+    offset = (width & 1) ? 0.0f : 0.5f;
+
+    /* Find the area the stroke can touch */
+    pad = width / 2 + 2;
+    SDL_EnclosePoints(points, count, NULL, &bounds);
+    bounds.x -= pad;
+    bounds.y -= pad;
+    bounds.w += 2 * pad;
+    bounds.h += 2 * pad;
+    if (!SDL_IntersectRect(&bounds, &dst->clip_rect, &bounds)) {
+        return 0;
+    }
+
+    /* A single point is drawn as a segment of no length */
+    num_segments = SDL_max(count - 1, 1);
+    segments = (SDL_StrokeSegment *)
+        SDL_malloc(num_segments * sizeof(*segments) +
+                   STROKE_BAND_ROWS * bounds.w);
+    if (!segments) {
+        SDL_OutOfMemory();
+        return -1;
+    }
+    for (i = 0; i < num_segments; ++i) {
+        const SDL_Point *p1 = &points[i];
+        const SDL_Point *p2 = &points[SDL_min(i + 1, count - 1)];
+
+        seg = &segments[i];
+        seg->x = p1->x + offset;
+        seg->y = p1->y + offset;
+        seg->dx = (float) (p2->x - p1->x);
+        seg->dy = (float) (p2->y - p1->y);
+        seg->len2 = seg->dx * seg->dx + seg->dy * seg->dy;
+        seg->len = (float) SDL_sqrt(seg->len2);
+        seg->miny = -(int) SDL_floor(outer - offset - SDL_min(p1->y, p2->y));
+        seg->maxy = (int) SDL_floor(SDL_max(p1->y, p2->y) + offset + outer);
+    }
+
+    band.coverage = (Uint8 *) &segments[num_segments];
+    band.x = bounds.x;
+    band.w = bounds.w;
+    SDL_memset(band.coverage, 0, STROKE_BAND_ROWS * band.w);
+
+    for (band.y = bounds.y; band.y < bounds.y + bounds.h;
+         band.y += STROKE_BAND_ROWS) {
+        band.h = SDL_min(STROKE_BAND_ROWS, bounds.y + bounds.h - band.y);
+        for (y = 0; y < band.h; ++y) {
+            band.minx[y] = band.w;
+            band.maxx[y] = -1;
+        }
+
+        for (i = 0; i < num_segments; ++i) {
+            seg = &segments[i];
+            if (seg->maxy >= band.y && seg->miny < band.y + band.h) {
+                SDL_RasterizeStroke(&band, seg, radius, antialias);
+            }
+        }
+
+        /* Blend each row, clearing the mask for the next band */
+        for (y = 0; y < band.h; ++y) {
+            if (band.minx[y] > band.maxx[y]) {
+                continue;
+            }
+            coverage = band.coverage + y * band.w + band.minx[y];
+            func(dst, band.x + band.minx[y], band.y + y, coverage,
+                 band.maxx[y] - band.minx[y] + 1, blendMode, r, g, b, a);
+            SDL_memset(coverage, 0, band.maxx[y] - band.minx[y] + 1);
+        }
+    }
+
+    SDL_free(segments);
+    return 0;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
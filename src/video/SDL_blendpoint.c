@@ -24,100 +24,101 @@
 #include "SDL_draw.h"
 
 static int
-SDL_BlendPoint_RGB555(SDL_Surface * dst, int x, int y, int blendMode, Uint8 r,
-                      Uint8 g, Uint8 b, Uint8 a)
+SDL_BlendPoints_RGB555(SDL_Surface * dst, const SDL_Point * points, int count,
+                       int blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
     unsigned inva = 0xff - a;
 
     switch (blendMode) {
     case SDL_BLENDMODE_BLEND:
-        DRAW_SETPIXELXY_BLEND_RGB555(x, y);
+        DRAWPOINTS(DRAW_SETPIXELXY_BLEND_RGB555);
         break;
     case SDL_BLENDMODE_ADD:
-        DRAW_SETPIXELXY_ADD_RGB555(x, y);
+        DRAWPOINTS(DRAW_SETPIXELXY_ADD_RGB555);
         break;
     case SDL_BLENDMODE_MOD:
-        DRAW_SETPIXELXY_MOD_RGB555(x, y);
+        DRAWPOINTS(DRAW_SETPIXELXY_MOD_RGB555);
         break;
     default:
-        DRAW_SETPIXELXY_RGB555(x, y);
+        DRAWPOINTS(DRAW_SETPIXELXY_RGB555);
         break;
     }
     return 0;
 }
 
 static int
-SDL_BlendPoint_RGB565(SDL_Surface * dst, int x, int y, int blendMode, Uint8 r,
-                      Uint8 g, Uint8 b, Uint8 a)
+SDL_BlendPoints_RGB565(SDL_Surface * dst, const SDL_Point * points, int count,
+                       int blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
     unsigned inva = 0xff - a;
 
     switch (blendMode) {
     case SDL_BLENDMODE_BLEND:
-        DRAW_SETPIXELXY_BLEND_RGB565(x, y);
+        DRAWPOINTS(DRAW_SETPIXELXY_BLEND_RGB565);
         break;
     case SDL_BLENDMODE_ADD:
-        DRAW_SETPIXELXY_ADD_RGB565(x, y);
+        DRAWPOINTS(DRAW_SETPIXELXY_ADD_RGB565);
         break;
     case SDL_BLENDMODE_MOD:
-        DRAW_SETPIXELXY_MOD_RGB565(x, y);
+        DRAWPOINTS(DRAW_SETPIXELXY_MOD_RGB565);
         break;
     default:
-        DRAW_SETPIXELXY_RGB565(x, y);
+        DRAWPOINTS(DRAW_SETPIXELXY_RGB565);
         break;
     }
     return 0;
 }
 
 static int
-SDL_BlendPoint_RGB888(SDL_Surface * dst, int x, int y, int blendMode, Uint8 r,
-                      Uint8 g, Uint8 b, Uint8 a)
+SDL_BlendPoints_RGB888(SDL_Surface * dst, const SDL_Point * points, int count,
+                       int blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
     unsigned inva = 0xff - a;
 
     switch (blendMode) {
     case SDL_BLENDMODE_BLEND:
-        DRAW_SETPIXELXY_BLEND_RGB888(x, y);
+        DRAWPOINTS(DRAW_SETPIXELXY_BLEND_RGB888);
         break;
     case SDL_BLENDMODE_ADD:
-        DRAW_SETPIXELXY_ADD_RGB888(x, y);
+        DRAWPOINTS(DRAW_SETPIXELXY_ADD_RGB888);
         break;
     case SDL_BLENDMODE_MOD:
-        DRAW_SETPIXELXY_MOD_RGB888(x, y);
+        DRAWPOINTS(DRAW_SETPIXELXY_MOD_RGB888);
         break;
     default:
-        DRAW_SETPIXELXY_RGB888(x, y);
+        DRAWPOINTS(DRAW_SETPIXELXY_RGB888);
         break;
     }
     return 0;
 }
 
 static int
-SDL_BlendPoint_ARGB8888(SDL_Surface * dst, int x, int y, int blendMode,
-                        Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+SDL_BlendPoints_ARGB8888(SDL_Surface * dst, const SDL_Point * points,
+                         int count, int blendMode, Uint8 r, Uint8 g, Uint8 b,
+                         Uint8 a)
 {
     unsigned inva = 0xff - a;
 
     switch (blendMode) {
     case SDL_BLENDMODE_BLEND:
-        DRAW_SETPIXELXY_BLEND_ARGB8888(x, y);
+        DRAWPOINTS(DRAW_SETPIXELXY_BLEND_ARGB8888);
         break;
     case SDL_BLENDMODE_ADD:
-        DRAW_SETPIXELXY_ADD_ARGB8888(x, y);
+        DRAWPOINTS(DRAW_SETPIXELXY_ADD_ARGB8888);
         break;
     case SDL_BLENDMODE_MOD:
-        DRAW_SETPIXELXY_MOD_ARGB8888(x, y);
+        DRAWPOINTS(DRAW_SETPIXELXY_MOD_ARGB8888);
         break;
     default:
-        DRAW_SETPIXELXY_ARGB8888(x, y);
+        DRAWPOINTS(DRAW_SETPIXELXY_ARGB8888);
         break;
     }
     return 0;
 }
 
 static int
-SDL_BlendPoint_RGB(SDL_Surface * dst, int x, int y, int blendMode, Uint8 r,
-                   Uint8 g, Uint8 b, Uint8 a)
+SDL_BlendPoints_RGB(SDL_Surface * dst, const SDL_Point * points, int count,
+                    int blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
     SDL_PixelFormat *fmt = dst->format;
     unsigned inva = 0xff - a;
@@ -126,32 +127,32 @@ SDL_BlendPoint_RGB(SDL_Surface * dst, int x, int y, int blendMode, Uint8 r,
     case 2:
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
-            DRAW_SETPIXELXY2_BLEND_RGB(x, y);
+            DRAWPOINTS(DRAW_SETPIXELXY2_BLEND_RGB);
             break;
         case SDL_BLENDMODE_ADD:
-            DRAW_SETPIXELXY2_ADD_RGB(x, y);
+            DRAWPOINTS(DRAW_SETPIXELXY2_ADD_RGB);
             break;
         case SDL_BLENDMODE_MOD:
-            DRAW_SETPIXELXY2_MOD_RGB(x, y);
+            DRAWPOINTS(DRAW_SETPIXELXY2_MOD_RGB);
             break;
         default:
-            DRAW_SETPIXELXY2_RGB(x, y);
+            DRAWPOINTS(DRAW_SETPIXELXY2_RGB);
             break;
         }
         return 0;
     case 4:
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
-            DRAW_SETPIXELXY4_BLEND_RGB(x, y);
+            DRAWPOINTS(DRAW_SETPIXELXY4_BLEND_RGB);
             break;
         case SDL_BLENDMODE_ADD:
-            DRAW_SETPIXELXY4_ADD_RGB(x, y);
+            DRAWPOINTS(DRAW_SETPIXELXY4_ADD_RGB);
             break;
         case SDL_BLENDMODE_MOD:
-            DRAW_SETPIXELXY4_MOD_RGB(x, y);
+            DRAWPOINTS(DRAW_SETPIXELXY4_MOD_RGB);
             break;
         default:
-            DRAW_SETPIXELXY4_RGB(x, y);
+            DRAWPOINTS(DRAW_SETPIXELXY4_RGB);
             break;
         }
         return 0;
@@ -162,8 +163,8 @@ SDL_BlendPoint_RGB(SDL_Surface * dst, int x, int y, int blendMode, Uint8 r,
 }
 
 static int
-SDL_BlendPoint_RGBA(SDL_Surface * dst, int x, int y, int blendMode, Uint8 r,
-                    Uint8 g, Uint8 b, Uint8 a)
+SDL_BlendPoints_RGBA(SDL_Surface * dst, const SDL_Point * points, int count,
+                     int blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
     SDL_PixelFormat *fmt = dst->format;
     unsigned inva = 0xff - a;
@@ -172,16 +173,16 @@ SDL_BlendPoint_RGBA(SDL_Surface * dst, int x, int y, int blendMode, Uint8 r,
     case 4:
         switch (blendMode) {
         case SDL_BLENDMODE_BLEND:
-            DRAW_SETPIXELXY4_BLEND_RGBA(x, y);
+            DRAWPOINTS(DRAW_SETPIXELXY4_BLEND_RGBA);
             break;
         case SDL_BLENDMODE_ADD:
-            DRAW_SETPIXELXY4_ADD_RGBA(x, y);
+            DRAWPOINTS(DRAW_SETPIXELXY4_ADD_RGBA);
             break;
         case SDL_BLENDMODE_MOD:
-            DRAW_SETPIXELXY4_MOD_RGBA(x, y);
+            DRAWPOINTS(DRAW_SETPIXELXY4_MOD_RGBA);
             break;
         default:
-            DRAW_SETPIXELXY4_RGBA(x, y);
+            DRAWPOINTS(DRAW_SETPIXELXY4_RGBA);
             break;
         }
         return 0;
@@ -195,6 +196,8 @@ int
 SDL_BlendPoint(SDL_Surface * dst, int x, int y, int blendMode, Uint8 r,
                Uint8 g, Uint8 b, Uint8 a)
 {
+    SDL_Point point;
+
     if (!dst) {
         SDL_SetError("Passed NULL destination surface");
         return -1;
@@ -212,6 +215,8 @@ SDL_BlendPoint(SDL_Surface * dst, int x, int y, int blendMode, Uint8 r,
         y >= (dst->clip_rect.y + dst->clip_rect.h)) {
         return 0;
     }
+    point.x = x;
+    point.y = y;
 
     if (blendMode == SDL_BLENDMODE_BLEND || blendMode == SDL_BLENDMODE_ADD) {
         r = DRAW_MUL(r, a);
@@ -223,24 +228,22 @@ SDL_BlendPoint(SDL_Surface * dst, int x, int y, int blendMode, Uint8 r,
     case 15:
         switch (dst->format->Rmask) {
         case 0x7C00:
-            return SDL_BlendPoint_RGB555(dst, x, y, blendMode, r, g, b, a);
+            return SDL_BlendPoints_RGB555(dst, &point, 1, blendMode, r, g, b, a);
         }
         break;
     case 16:
         switch (dst->format->Rmask) {
         case 0xF800:
-            return SDL_BlendPoint_RGB565(dst, x, y, blendMode, r, g, b, a);
+            return SDL_BlendPoints_RGB565(dst, &point, 1, blendMode, r, g, b, a);
         }
         break;
     case 32:
         switch (dst->format->Rmask) {
         case 0x00FF0000:
             if (!dst->format->Amask) {
-                return SDL_BlendPoint_RGB888(dst, x, y, blendMode, r, g, b,
-                                             a);
+                return SDL_BlendPoints_RGB888(dst, &point, 1, blendMode, r, g, b, a);
             } else {
-                return SDL_BlendPoint_ARGB8888(dst, x, y, blendMode, r, g, b,
-                                               a);
+                return SDL_BlendPoints_ARGB8888(dst, &point, 1, blendMode, r, g, b, a);
             }
             break;
         }
@@ -250,9 +253,9 @@ SDL_BlendPoint(SDL_Surface * dst, int x, int y, int blendMode, Uint8 r,
     }
 
     if (!dst->format->Amask) {
-        return SDL_BlendPoint_RGB(dst, x, y, blendMode, r, g, b, a);
+        return SDL_BlendPoints_RGB(dst, &point, 1, blendMode, r, g, b, a);
     } else {
-        return SDL_BlendPoint_RGBA(dst, x, y, blendMode, r, g, b, a);
+        return SDL_BlendPoints_RGBA(dst, &point, 1, blendMode, r, g, b, a);
     }
 }
 
@@ -260,13 +263,8 @@ int
 SDL_BlendPoints(SDL_Surface * dst, const SDL_Point * points, int count,
                 int blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
-    int minx, miny;
-    int maxx, maxy;
-    int i;
-    int x, y;
-    int (*func)(SDL_Surface * dst, int x, int y,
+    int (*func)(SDL_Surface * dst, const SDL_Point * points, int count,
                 int blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a) = NULL;
-    int status = 0;
 
     if (!dst) {
         SDL_SetError("Passed NULL destination surface");
@@ -285,19 +283,18 @@ SDL_BlendPoints(SDL_Surface * dst, const SDL_Point * points, int count,
         b = DRAW_MUL(b, a);
     }
 
-    /* FIXME: Does this function pointer slow things down significantly? */
     switch (dst->format->BitsPerPixel) {
     case 15:
         switch (dst->format->Rmask) {
         case 0x7C00:
-            func = SDL_BlendPoint_RGB555;
+            func = SDL_BlendPoints_RGB555;
             break;
         }
         break;
     case 16:
         switch (dst->format->Rmask) {
         case 0xF800:
-            func = SDL_BlendPoint_RGB565;
+            func = SDL_BlendPoints_RGB565;
             break;
         }
         break;
@@ -305,9 +302,9 @@ SDL_BlendPoints(SDL_Surface * dst, const SDL_Point * points, int count,
         switch (dst->format->Rmask) {
         case 0x00FF0000:
             if (!dst->format->Amask) {
-                func = SDL_BlendPoint_RGB888;
+                func = SDL_BlendPoints_RGB888;
             } else {
-                func = SDL_BlendPoint_ARGB8888;
+                func = SDL_BlendPoints_ARGB8888;
             }
             break;
         }
@@ -318,27 +315,13 @@ SDL_BlendPoints(SDL_Surface * dst, const SDL_Point * points, int count,
 
     if (!func) {
         if (!dst->format->Amask) {
-            func = SDL_BlendPoint_RGB;
+            func = SDL_BlendPoints_RGB;
         } else {
-            func = SDL_BlendPoint_RGBA;
+            func = SDL_BlendPoints_RGBA;
         }
     }
 
-    minx = dst->clip_rect.x;
-    maxx = dst->clip_rect.x + dst->clip_rect.w - 1;
-    miny = dst->clip_rect.y;
-    maxy = dst->clip_rect.y + dst->clip_rect.h - 1;
-
-    for (i = 0; i < count; ++i) {
-        x = points[i].x;
-        y = points[i].y;
-
-        if (x < minx || x > maxx || y < miny || y > maxy) {
-            continue;
-        }
-        status = func(dst, x, y, blendMode, r, g, b, a);
-    }
-    return status;
+    return func(dst, points, count, blendMode, r, g, b, a);
 }
 
 /* vi: set ts=4 sw=4 expandtab: */
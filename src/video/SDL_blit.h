@@ -64,6 +64,16 @@
 #define SDL_CPU_ALTIVEC_PREFETCH    0x00000010
 #define SDL_CPU_ALTIVEC_NOPREFETCH  0x00000020
 
+/* How each channel moves when converting between two RGB formats:
+   dst |= ((src & srcmask) >> rshift << lshift) & dstmask */
+typedef struct
+{
+    Uint32 srcmask[4];
+    Uint32 dstmask[4];
+    Uint8 rshift[4];
+    Uint8 lshift[4];
+} SDL_BlitConvert;
+
 typedef struct
 {
     Uint8 *src;
@@ -80,6 +90,7 @@ typedef struct
     int flags;
     Uint32 colorkey;
     Uint8 r, g, b, a;
+    SDL_BlitConvert convert;    /* set up by SDL_CalculateBlitN() */
 } SDL_BlitInfo;
 
 typedef void (SDLCALL * SDL_BlitFunc) (SDL_BlitInfo * info);
@@ -105,6 +116,9 @@ typedef struct SDL_BlitMap
     /* the version count matches the destination; mismatch indicates
        an invalid mapping */
     unsigned int format_version;
+
+    /* the shared format of the destination, if it has one */
+    SDL_PixelFormat *dst_format;
 } SDL_BlitMap;
 
 /* Functions found in SDL_blit.c */
@@ -419,6 +419,330 @@ BlitRGBtoRGBPixelAlphaMMX(SDL_BlitInfo * info)
 
 #endif /* __MMX__ */
 
+#ifdef __SSE2__
+
+/* Run 'op' on 4 pixels at a time, with 's' and 'd' holding the source and
+   destination pixels, and 'd' stored back. The end of each row goes
+   through a small buffer so no scalar version of 'op' is needed. */
+#define BLIT32_SSE2(op) \
+do { \
+    DECLARE_ALIGNED(Uint32, srctail[4], 16); \
+    DECLARE_ALIGNED(Uint32, dsttail[4], 16); \
+    while (height--) { \
+        int n = width; \
+        __m128i s, d; \
+        while (n >= 4) { \
+            s = _mm_loadu_si128((__m128i *) srcp); \
+            d = _mm_loadu_si128((__m128i *) dstp); \
+            op; \
+            _mm_storeu_si128((__m128i *) dstp, d); \
+            srcp += 4; \
+            dstp += 4; \
+            n -= 4; \
+        } \
+        if (n > 0) { \
+            SDL_memcpy(srctail, srcp, n * 4); \
+            SDL_memcpy(dsttail, dstp, n * 4); \
+            s = _mm_load_si128((__m128i *) srctail); \
+            d = _mm_load_si128((__m128i *) dsttail); \
+            op; \
+            _mm_store_si128((__m128i *) dsttail, d); \
+            SDL_memcpy(dstp, dsttail, n * 4); \
+            srcp += n; \
+            dstp += n; \
+        } \
+        srcp += srcskip; \
+        dstp += dstskip; \
+    } \
+} while (0)
+
+/* The same for 32-bit sources and 16-bit destinations, 8 pixels at a time,
+   with the source in 's0' and 's1' */
+#define BLIT32TO16_SSE2(op) \
+do { \
+    DECLARE_ALIGNED(Uint32, srctail[8], 16); \
+    DECLARE_ALIGNED(Uint16, dsttail[8], 16); \
+    while (height--) { \
+        int n = width; \
+        __m128i s0, s1, d; \
+        while (n >= 8) { \
+            s0 = _mm_loadu_si128((__m128i *) srcp); \
+            s1 = _mm_loadu_si128((__m128i *) (srcp + 4)); \
+            d = _mm_loadu_si128((__m128i *) dstp); \
+            op; \
+            _mm_storeu_si128((__m128i *) dstp, d); \
+            srcp += 8; \
+            dstp += 8; \
+            n -= 8; \
+        } \
+        if (n > 0) { \
+            SDL_memcpy(srctail, srcp, n * 4); \
+            SDL_memcpy(dsttail, dstp, n * 2); \
+            s0 = _mm_load_si128((__m128i *) srctail); \
+            s1 = _mm_load_si128((__m128i *) (srctail + 4)); \
+            d = _mm_load_si128((__m128i *) dsttail); \
+            op; \
+            _mm_store_si128((__m128i *) dsttail, d); \
+            SDL_memcpy(dstp, dsttail, n * 2); \
+            srcp += n; \
+            dstp += n; \
+        } \
+        srcp += srcskip; \
+        dstp += dstskip; \
+    } \
+} while (0)
+
+/* d + ((s - d) * a >> 8) for 16-bit lanes of 8-bit values, computed as
+   (d * (256 - a) + s * a) >> 8 so it can't overflow */
+static __inline__ __m128i
+SDL_Blend8SSE2(__m128i s, __m128i d, __m128i a)
+{
+    __m128i inva = _mm_sub_epi16(_mm_set1_epi16(256), a);
+    return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(s, a),
+                                        _mm_mullo_epi16(d, inva)), 8);
+}
+
+/* fast ARGB888->(A)RGB888 blending with pixel alpha, like the MMX version */
+static void
+BlitRGBtoRGBPixelAlphaSSE2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    SDL_PixelFormat *sf = info->src_fmt;
+    Uint32 chanmask = sf->Rmask | sf->Gmask | sf->Bmask;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i vchanmask = _mm_set1_epi32(chanmask);
+    const __m128i vamask = _mm_set1_epi32(sf->Amask);
+    const __m128i ashift = _mm_cvtsi32_si128(sf->Ashift);
+    __m128i alpha, opaque, slo, shi, alo, ahi, blend;
+    int mask;
+
+    BLIT32_SSE2({
+        alpha = _mm_and_si128(s, vamask);
+        mask = _mm_movemask_epi8(_mm_cmpeq_epi32(alpha, zero));
+        if (mask != 0xffff) {
+            opaque = _mm_cmpeq_epi32(alpha, vamask);
+            mask = _mm_movemask_epi8(opaque);
+            blend = _mm_or_si128(_mm_and_si128(s, vchanmask),
+                                 _mm_andnot_si128(vchanmask, d));
+            if (mask != 0xffff) {
+                /* blend the color channels, keep the destination alpha */
+                /* spread the alpha over the color channels */
+                alpha = _mm_srl_epi32(alpha, ashift);
+                alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 8));
+                alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+                alpha = _mm_and_si128(alpha, vchanmask);
+                alo = _mm_unpacklo_epi8(alpha, zero);
+                ahi = _mm_unpackhi_epi8(alpha, zero);
+                slo = SDL_Blend8SSE2(_mm_unpacklo_epi8(s, zero),
+                                     _mm_unpacklo_epi8(d, zero), alo);
+                shi = SDL_Blend8SSE2(_mm_unpackhi_epi8(s, zero),
+                                     _mm_unpackhi_epi8(d, zero), ahi);
+                /* opaque pixels get the source color as is */
+                blend = _mm_or_si128(_mm_and_si128(opaque, blend),
+                                     _mm_andnot_si128(opaque,
+                                                      _mm_packus_epi16(slo,
+                                                                       shi)));
+            }
+            d = blend;
+        }
+    });
+}
+
+/* fast RGB888->(A)RGB888 blending with surface alpha, like the MMX version */
+static void
+BlitRGBtoRGBSurfaceAlphaSSE2(SDL_BlitInfo * info)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip >> 2;
+    SDL_PixelFormat *df = info->dst_fmt;
+    unsigned alpha = info->a;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i dsta = _mm_set1_epi32(df->Amask);
+
+    if (alpha == 128 && (df->Rmask | df->Gmask | df->Bmask) == 0x00FFFFFF) {
+        const __m128i hmask = _mm_set1_epi32(0x00fefefe);
+        const __m128i lmask = _mm_set1_epi32(0x00010101);
+
+        BLIT32_SSE2({
+            __m128i half = _mm_add_epi32(_mm_and_si128(s, hmask),
+                                         _mm_and_si128(d, hmask));
+            half = _mm_srli_epi32(half, 1);
+            d = _mm_and_si128(_mm_and_si128(s, d), lmask);
+            d = _mm_or_si128(_mm_add_epi32(d, half), dsta);
+        });
+    } else {
+        Uint32 chanmask =
+            (0xff << df->Rshift) | (0xff << df->Gshift) | (0xff << df->
+                                                            Bshift);
+        __m128i valpha = _mm_and_si128(_mm_set1_epi32(chanmask),
+                                       _mm_set1_epi8((char) alpha));
+
+        valpha = _mm_unpacklo_epi8(valpha, zero);
+        BLIT32_SSE2({
+            __m128i lo = SDL_Blend8SSE2(_mm_unpacklo_epi8(s, zero),
+                                        _mm_unpacklo_epi8(d, zero), valpha);
+            __m128i hi = SDL_Blend8SSE2(_mm_unpackhi_epi8(s, zero),
+                                        _mm_unpackhi_epi8(d, zero), valpha);
+            d = _mm_or_si128(_mm_packus_epi16(lo, hi), dsta);
+        });
+    }
+}
+
+/* Split 8 pixels from 's0' and 's1' into 16-bit lanes of the bits at 'shift' */
+#define SPLIT32_SSE2(shift, mask) \
+    _mm_packs_epi32( \
+        _mm_and_si128(_mm_srli_epi32(s0, shift), _mm_set1_epi32(mask)), \
+        _mm_and_si128(_mm_srli_epi32(s1, shift), _mm_set1_epi32(mask)))
+
+/* fast ARGB8888->RGB565/555 blending with pixel alpha. The channels are
+   blended at the destination depth with 5-bit alpha, the same as in
+   BlitARGBto565PixelAlpha and BlitARGBto555PixelAlpha. */
+static void
+BlitARGBto16PixelAlphaSSE2(SDL_BlitInfo * info, int gbits)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint16 *dstp = (Uint16 *) info->dst;
+    int dstskip = info->dst_skip >> 1;
+    const int gmask = (1 << gbits) - 1;
+    const int rshift = 5 + gbits;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i v32 = _mm_set1_epi16(32);
+    const __m128i v31 = _mm_set1_epi16(31);
+    __m128i a, inva, r, g, b, opaque, src;
+    int mask;
+
+    BLIT32TO16_SSE2({
+        a = SPLIT32_SSE2(27, 0x1f);
+        mask = _mm_movemask_epi8(_mm_cmpeq_epi16(a, zero));
+        if (mask != 0xffff) {
+            b = SPLIT32_SSE2(3, 0x1f);
+            g = SPLIT32_SSE2(16 - gbits, gmask);
+            r = SPLIT32_SSE2(19, 0x1f);
+            src = _mm_or_si128(_mm_or_si128(b, _mm_slli_epi16(g, 5)),
+                               _mm_slli_epi16(r, rshift));
+            opaque = _mm_cmpeq_epi16(a, v31);
+            mask = _mm_movemask_epi8(opaque);
+            if (mask != 0xffff) {
+                /* (d * (32 - a) + s * a) >> 5 on each channel */
+                inva = _mm_sub_epi16(v32, a);
+                b = _mm_add_epi16(_mm_mullo_epi16(b, a),
+                                  _mm_mullo_epi16(_mm_and_si128(d, v31),
+                                                  inva));
+                g = _mm_add_epi16(_mm_mullo_epi16(g, a),
+                                  _mm_mullo_epi16(_mm_and_si128
+                                                  (_mm_srli_epi16(d, 5),
+                                                   _mm_set1_epi16(gmask)),
+                                                  inva));
+                r = _mm_add_epi16(_mm_mullo_epi16(r, a),
+                                  _mm_mullo_epi16(_mm_and_si128
+                                                  (_mm_srli_epi16
+                                                   (d, rshift), v31), inva));
+                b = _mm_srli_epi16(b, 5);
+                g = _mm_slli_epi16(_mm_srli_epi16(g, 5), 5);
+                r = _mm_slli_epi16(_mm_srli_epi16(r, 5), rshift);
+                src = _mm_or_si128(_mm_and_si128(opaque, src),
+                                   _mm_andnot_si128(opaque,
+                                                    _mm_or_si128(_mm_or_si128
+                                                                 (b, g), r)));
+            }
+            /* transparent pixels keep the destination */
+            a = _mm_cmpeq_epi16(a, zero);
+            d = _mm_or_si128(_mm_and_si128(a, d), _mm_andnot_si128(a, src));
+        }
+    });
+}
+
+static void
+BlitARGBto565PixelAlphaSSE2(SDL_BlitInfo * info)
+{
+    BlitARGBto16PixelAlphaSSE2(info, 6);
+}
+
+static void
+BlitARGBto555PixelAlphaSSE2(SDL_BlitInfo * info)
+{
+    BlitARGBto16PixelAlphaSSE2(info, 5);
+}
+
+/* dst + (src - dst) * alpha / 255, rounded towards dst like ALPHA_BLEND(),
+   for 16-bit lanes of 8-bit values */
+static __inline__ __m128i
+SDL_AlphaBlendSSE2(__m128i s, __m128i d, __m128i a)
+{
+    const __m128i div255 = _mm_set1_epi16((short) 0x8081);
+    __m128i up = _mm_mullo_epi16(_mm_subs_epu16(s, d), a);
+    __m128i down = _mm_mullo_epi16(_mm_subs_epu16(d, s), a);
+    up = _mm_srli_epi16(_mm_mulhi_epu16(up, div255), 7);
+    down = _mm_srli_epi16(_mm_mulhi_epu16(down, div255), 7);
+    return _mm_sub_epi16(_mm_add_epi16(d, up), down);
+}
+
+/* fast RGB888->RGB565/555 blending with surface alpha, with the same
+   results as BlitNtoNSurfaceAlpha */
+static void
+BlitRGBto16SurfaceAlphaSSE2(SDL_BlitInfo * info, int gbits)
+{
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip >> 2;
+    Uint16 *dstp = (Uint16 *) info->dst;
+    int dstskip = info->dst_skip >> 1;
+    const int gmask = (1 << gbits) - 1;
+    const int rshift = 5 + gbits;
+    const __m128i alpha = _mm_set1_epi16(info->a);
+    const __m128i v31 = _mm_set1_epi16(31);
+    __m128i r, g, b;
+
+    if (!info->a) {
+        return;
+    }
+
+    BLIT32TO16_SSE2({
+        b = _mm_slli_epi16(_mm_and_si128(d, v31), 3);
+        g = _mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(d, 5),
+                                         _mm_set1_epi16(gmask)), 8 - gbits);
+        r = _mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(d, rshift), v31), 3);
+        b = SDL_AlphaBlendSSE2(SPLIT32_SSE2(0, 0xff), b, alpha);
+        g = SDL_AlphaBlendSSE2(SPLIT32_SSE2(8, 0xff), g, alpha);
+        r = SDL_AlphaBlendSSE2(SPLIT32_SSE2(16, 0xff), r, alpha);
+        d = _mm_or_si128(_mm_or_si128(_mm_srli_epi16(b, 3),
+                                      _mm_slli_epi16(_mm_srli_epi16
+                                                     (g, 8 - gbits), 5)),
+                         _mm_slli_epi16(_mm_srli_epi16(r, 3), rshift));
+    });
+}
+
+static void
+BlitRGBto565SurfaceAlphaSSE2(SDL_BlitInfo * info)
+{
+    BlitRGBto16SurfaceAlphaSSE2(info, 6);
+}
+
+static void
+BlitRGBto555SurfaceAlphaSSE2(SDL_BlitInfo * info)
+{
+    BlitRGBto16SurfaceAlphaSSE2(info, 5);
+}
+
+#undef SPLIT32_SSE2
+#undef BLIT32TO16_SSE2
+#undef BLIT32_SSE2
+
+#endif /* __SSE2__ */
+
 #if SDL_ALTIVEC_BLITTERS
 #if __MWERKS__
 #pragma altivec_model on
@@ -2141,6 +2465,14 @@ SDL_CalculateBlitA(SDL_Surface * surface)
                     && sf->Gmask == 0xff00
                     && ((sf->Rmask == 0xff && df->Rmask == 0x1f)
                         || (sf->Bmask == 0xff && df->Bmask == 0x1f))) {
+#ifdef __SSE2__
+                if (SDL_HasSSE2()) {
+                    if (df->Gmask == 0x7e0)
+                        return BlitARGBto565PixelAlphaSSE2;
+                    else if (df->Gmask == 0x3e0)
+                        return BlitARGBto555PixelAlphaSSE2;
+                }
+#endif
                 if (df->Gmask == 0x7e0)
                     return BlitARGBto565PixelAlpha;
                 else if (df->Gmask == 0x3e0)
@@ -2152,6 +2484,14 @@ SDL_CalculateBlitA(SDL_Surface * surface)
             if (sf->Rmask == df->Rmask
                 && sf->Gmask == df->Gmask
                 && sf->Bmask == df->Bmask && sf->BytesPerPixel == 4) {
+#ifdef __SSE2__
+                if (sf->Rshift % 8 == 0
+                    && sf->Gshift % 8 == 0
+                    && sf->Bshift % 8 == 0
+                    && sf->Ashift % 8 == 0 && sf->Aloss == 0
+                    && SDL_HasSSE2())
+                    return BlitRGBtoRGBPixelAlphaSSE2;
+#endif
 #if defined(__MMX__) || defined(__3dNOW__)
                 if (sf->Rshift % 8 == 0
                     && sf->Gshift % 8 == 0
@@ -2213,12 +2553,31 @@ SDL_CalculateBlitA(SDL_Surface * surface)
                             return Blit555to555SurfaceAlpha;
                     }
                 }
+#ifdef __SSE2__
+                if (sf->BytesPerPixel == 4 && df->Amask == 0
+                    && sf->Gmask == 0xff00
+                    && (sf->Rmask | sf->Gmask | sf->Bmask) == 0xffffff
+                    && ((sf->Rmask == 0xff && df->Rmask == 0x1f)
+                        || (sf->Bmask == 0xff && df->Bmask == 0x1f))
+                    && SDL_HasSSE2()) {
+                    if (df->Gmask == 0x7e0)
+                        return BlitRGBto565SurfaceAlphaSSE2;
+                    else if (df->Gmask == 0x3e0)
+                        return BlitRGBto555SurfaceAlphaSSE2;
+                }
+#endif
                 return BlitNtoNSurfaceAlpha;
 
             case 4:
                 if (sf->Rmask == df->Rmask
                     && sf->Gmask == df->Gmask
                     && sf->Bmask == df->Bmask && sf->BytesPerPixel == 4) {
+#ifdef __SSE2__
+                    if (sf->Rshift % 8 == 0
+                        && sf->Gshift % 8 == 0
+                        && sf->Bshift % 8 == 0 && SDL_HasSSE2())
+                        return BlitRGBtoRGBSurfaceAlphaSSE2;
+#endif
 #ifdef __MMX__
                     if (sf->Rshift % 8 == 0
                         && sf->Gshift % 8 == 0
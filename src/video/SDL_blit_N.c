@@ -855,6 +855,8 @@ GetBlitFeatures(void)
                         /* Feature 4 is dont-use-prefetch */
                         /* !!!! FIXME: Check for G5 or later, not the cache size! Always prefetch on a G4. */
                         | ((GetL3CacheSize() == 0) ? 4 : 0)
+                        /* Feature 8 is has-SSE2 */
+                        | ((SDL_HasSSE2())? 8 : 0)
                 );
         }
     }
@@ -865,8 +867,9 @@ GetBlitFeatures(void)
 #pragma altivec_model off
 #endif
 #else
-/* Feature 1 is has-MMX */
-#define GetBlitFeatures() ((Uint32)(SDL_HasMMX() ? 1 : 0))
+/* Feature 1 is has-MMX, feature 8 is has-SSE2 */
+#define GetBlitFeatures() ((Uint32)((SDL_HasMMX() ? 1 : 0) | \
+                                    (SDL_HasSSE2() ? 8 : 0)))
 #endif
 
 /* This is now endian dependent */
@@ -2329,6 +2332,424 @@ BlitNtoNKeyCopyAlpha(SDL_BlitInfo * info)
     }
 }
 
+#ifdef __SSE2__
+/* Colorkeyed blits, a vector of pixels at a time: pixels matching the key
+   are masked out with a compare, and the rest are merged into the
+   destination with a select. The end of each row goes through a small
+   buffer so no scalar version is needed. */
+
+static void
+Blit2to2KeySSE2(SDL_BlitInfo * info)
+{
+    DECLARE_ALIGNED(Uint16, srctail[8], 16);
+    DECLARE_ALIGNED(Uint16, dsttail[8], 16);
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint16 *srcp = (Uint16 *) info->src;
+    int srcskip = info->src_skip / 2;
+    Uint16 *dstp = (Uint16 *) info->dst;
+    int dstskip = info->dst_skip / 2;
+    Uint16 rgbmask = (Uint16) ~info->src_fmt->Amask;
+    __m128i vrgbmask = _mm_set1_epi16((short) rgbmask);
+    __m128i vckey = _mm_set1_epi16((short) (info->colorkey & rgbmask));
+    __m128i s, d, sel;
+
+    while (height--) {
+        int n = width;
+        while (n >= 8) {
+            s = _mm_loadu_si128((__m128i *) srcp);
+            d = _mm_loadu_si128((__m128i *) dstp);
+            sel = _mm_cmpeq_epi16(_mm_and_si128(s, vrgbmask), vckey);
+            d = _mm_or_si128(_mm_and_si128(sel, d), _mm_andnot_si128(sel, s));
+            _mm_storeu_si128((__m128i *) dstp, d);
+            srcp += 8;
+            dstp += 8;
+            n -= 8;
+        }
+        if (n > 0) {
+            SDL_memcpy(srctail, srcp, n * 2);
+            SDL_memcpy(dsttail, dstp, n * 2);
+            s = _mm_load_si128((__m128i *) srctail);
+            d = _mm_load_si128((__m128i *) dsttail);
+            sel = _mm_cmpeq_epi16(_mm_and_si128(s, vrgbmask), vckey);
+            d = _mm_or_si128(_mm_and_si128(sel, d), _mm_andnot_si128(sel, s));
+            _mm_store_si128((__m128i *) dsttail, d);
+            SDL_memcpy(dstp, dsttail, n * 2);
+            srcp += n;
+            dstp += n;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+
+/* How to move the channels of a 32-bit pixel into another 32-bit format
+   with the same depth per channel */
+typedef struct
+{
+    __m128i keep;               /* channels that stay where they are */
+    __m128i alpha;              /* alpha to set in the destination */
+    int nmoved;
+    struct
+    {
+        __m128i mask;
+        __m128i left, right;
+    } moved[4];
+} SDL_Swizzle32SSE2;
+
+static void
+SDL_AddSwizzleChannel(SDL_Swizzle32SSE2 * swizzle, Uint32 mask, int srcshift,
+                      int dstshift)
+{
+    if (!mask) {
+        return;
+    }
+    if (srcshift == dstshift) {
+        swizzle->keep = _mm_or_si128(swizzle->keep, _mm_set1_epi32(mask));
+    } else {
+        int i = swizzle->nmoved++;
+        swizzle->moved[i].mask = _mm_set1_epi32(mask);
+        swizzle->moved[i].left =
+            _mm_cvtsi32_si128(dstshift > srcshift ? dstshift - srcshift : 0);
+        swizzle->moved[i].right =
+            _mm_cvtsi32_si128(srcshift > dstshift ? srcshift - dstshift : 0);
+    }
+}
+
+static __inline__ __m128i
+SDL_Swizzle32(const SDL_Swizzle32SSE2 * swizzle, __m128i s)
+{
+    __m128i pixel = _mm_or_si128(_mm_and_si128(s, swizzle->keep),
+                                 swizzle->alpha);
+    int i;
+
+    for (i = 0; i < swizzle->nmoved; ++i) {
+        __m128i c = _mm_and_si128(s, swizzle->moved[i].mask);
+        c = _mm_srl_epi32(c, swizzle->moved[i].right);
+        c = _mm_sll_epi32(c, swizzle->moved[i].left);
+        pixel = _mm_or_si128(pixel, c);
+    }
+    return pixel;
+}
+
+/* Can Blit4to4KeySSE2 handle these formats? */
+static SDL_bool
+SDL_CanSwizzle32(const SDL_PixelFormat * srcfmt,
+                 const SDL_PixelFormat * dstfmt)
+{
+    if (srcfmt->BytesPerPixel != 4 || dstfmt->BytesPerPixel != 4) {
+        return SDL_FALSE;
+    }
+    if (srcfmt->Rloss != dstfmt->Rloss || srcfmt->Gloss != dstfmt->Gloss ||
+        srcfmt->Bloss != dstfmt->Bloss) {
+        return SDL_FALSE;
+    }
+    if (srcfmt->Amask && dstfmt->Amask && srcfmt->Aloss != dstfmt->Aloss) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+/* Same as BlitNtoNKey and BlitNtoNKeyCopyAlpha, for 32-bit formats
+   accepted by SDL_CanSwizzle32() */
+static void
+Blit4to4KeySSE2(SDL_BlitInfo * info)
+{
+    DECLARE_ALIGNED(Uint32, srctail[4], 16);
+    DECLARE_ALIGNED(Uint32, dsttail[4], 16);
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip / 4;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip / 4;
+    SDL_PixelFormat *srcfmt = info->src_fmt;
+    SDL_PixelFormat *dstfmt = info->dst_fmt;
+    Uint32 rgbmask = ~srcfmt->Amask;
+    SDL_Swizzle32SSE2 swizzle;
+    __m128i vrgbmask = _mm_set1_epi32(rgbmask);
+    __m128i vckey = _mm_set1_epi32(info->colorkey & rgbmask);
+    __m128i s, d, sel;
+
+    swizzle.keep = _mm_setzero_si128();
+    swizzle.alpha = _mm_setzero_si128();
+    swizzle.nmoved = 0;
+    SDL_AddSwizzleChannel(&swizzle, srcfmt->Rmask, srcfmt->Rshift,
+                          dstfmt->Rshift);
+    SDL_AddSwizzleChannel(&swizzle, srcfmt->Gmask, srcfmt->Gshift,
+                          dstfmt->Gshift);
+    SDL_AddSwizzleChannel(&swizzle, srcfmt->Bmask, srcfmt->Bshift,
+                          dstfmt->Bshift);
+    if (srcfmt->Amask && dstfmt->Amask) {
+        SDL_AddSwizzleChannel(&swizzle, srcfmt->Amask, srcfmt->Ashift,
+                              dstfmt->Ashift);
+    } else if (dstfmt->Amask) {
+        swizzle.alpha =
+            _mm_set1_epi32((info->a >> dstfmt->Aloss) << dstfmt->Ashift);
+    }
+
+    while (height--) {
+        int n = width;
+        while (n >= 4) {
+            s = _mm_loadu_si128((__m128i *) srcp);
+            d = _mm_loadu_si128((__m128i *) dstp);
+            sel = _mm_cmpeq_epi32(_mm_and_si128(s, vrgbmask), vckey);
+            d = _mm_or_si128(_mm_and_si128(sel, d),
+                             _mm_andnot_si128(sel, SDL_Swizzle32(&swizzle, s)));
+            _mm_storeu_si128((__m128i *) dstp, d);
+            srcp += 4;
+            dstp += 4;
+            n -= 4;
+        }
+        if (n > 0) {
+            SDL_memcpy(srctail, srcp, n * 4);
+            SDL_memcpy(dsttail, dstp, n * 4);
+            s = _mm_load_si128((__m128i *) srctail);
+            d = _mm_load_si128((__m128i *) dsttail);
+            sel = _mm_cmpeq_epi32(_mm_and_si128(s, vrgbmask), vckey);
+            d = _mm_or_si128(_mm_and_si128(sel, d),
+                             _mm_andnot_si128(sel, SDL_Swizzle32(&swizzle, s)));
+            _mm_store_si128((__m128i *) dsttail, d);
+            SDL_memcpy(dstp, dsttail, n * 4);
+            srcp += n;
+            dstp += n;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+#endif /* __SSE2__ */
+
+/*
+ * Specialized N->N conversions: where each channel goes is worked out once
+ * in SDL_CalculateBlitN() and kept in info->convert, so the per-pixel work
+ * is a few shifts and masks instead of DISEMBLE_RGBA and ASSEMBLE_RGBA.
+ */
+
+static void
+SDL_SetupBlitConvertChannel(SDL_BlitConvert * convert, int i,
+                            Uint32 srcmask, int srcshift, int srcloss,
+                            Uint32 dstmask, int dstshift, int dstloss)
+{
+    /* the same as ((srcmask >> srcshift << srcloss) >> dstloss << dstshift) */
+    int shift = (dstshift - dstloss) - (srcshift - srcloss);
+
+    if (!srcmask || !dstmask) {
+        /* a missing channel has a loss of 8, which can make the shift
+           32 bits or more, so leave it out of the conversion entirely */
+        srcmask = dstmask = 0;
+        shift = 0;
+    }
+    convert->srcmask[i] = srcmask;
+    convert->dstmask[i] = dstmask;
+    convert->rshift[i] = (shift < 0) ? -shift : 0;
+    convert->lshift[i] = (shift > 0) ? shift : 0;
+}
+
+static void
+SDL_SetupBlitConvert(SDL_BlitInfo * info, SDL_bool copy_alpha)
+{
+    SDL_PixelFormat *srcfmt = info->src_fmt;
+    SDL_PixelFormat *dstfmt = info->dst_fmt;
+    SDL_BlitConvert *convert = &info->convert;
+
+    SDL_SetupBlitConvertChannel(convert, 0,
+                                srcfmt->Rmask, srcfmt->Rshift, srcfmt->Rloss,
+                                dstfmt->Rmask, dstfmt->Rshift, dstfmt->Rloss);
+    SDL_SetupBlitConvertChannel(convert, 1,
+                                srcfmt->Gmask, srcfmt->Gshift, srcfmt->Gloss,
+                                dstfmt->Gmask, dstfmt->Gshift, dstfmt->Gloss);
+    SDL_SetupBlitConvertChannel(convert, 2,
+                                srcfmt->Bmask, srcfmt->Bshift, srcfmt->Bloss,
+                                dstfmt->Bmask, dstfmt->Bshift, dstfmt->Bloss);
+    if (copy_alpha) {
+        SDL_SetupBlitConvertChannel(convert, 3, srcfmt->Amask,
+                                    srcfmt->Ashift, srcfmt->Aloss,
+                                    dstfmt->Amask, dstfmt->Ashift,
+                                    dstfmt->Aloss);
+    } else {
+        SDL_SetupBlitConvertChannel(convert, 3, 0, 0, 0, 0, 0, 0);
+    }
+}
+
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+#define READ_PIXEL3(p)  ((p)[0] | ((p)[1] << 8) | ((p)[2] << 16))
+#define WRITE_PIXEL3(p, pixel) \
+    ((p)[0] = (Uint8) (pixel), (p)[1] = (Uint8) ((pixel) >> 8), \
+     (p)[2] = (Uint8) ((pixel) >> 16))
+#else
+#define READ_PIXEL3(p)  (((p)[0] << 16) | ((p)[1] << 8) | (p)[2])
+#define WRITE_PIXEL3(p, pixel) \
+    ((p)[0] = (Uint8) ((pixel) >> 16), (p)[1] = (Uint8) ((pixel) >> 8), \
+     (p)[2] = (Uint8) (pixel))
+#endif
+
+#define READ_PIXEL_2(p)     (*(Uint16 *) (p))
+#define READ_PIXEL_3(p)     READ_PIXEL3(p)
+#define READ_PIXEL_4(p)     (*(Uint32 *) (p))
+#define WRITE_PIXEL_2(p, pixel)     (*(Uint16 *) (p) = (Uint16) (pixel))
+#define WRITE_PIXEL_3(p, pixel)     WRITE_PIXEL3(p, pixel)
+#define WRITE_PIXEL_4(p, pixel)     (*(Uint32 *) (p) = (pixel))
+
+#define CONVERT_CHANNEL(pixel, i) \
+    ((((pixel) & srcmask##i) >> rshift##i << lshift##i) & dstmask##i)
+
+/* Define BlitConvert<srcbpp>to<dstbpp>, the same as BlitNtoN, or
+   BlitNtoNCopyAlpha when info->convert moves the alpha channel */
+#define DEFINE_BLIT_CONVERT(srcbpp, dstbpp) \
+static void \
+BlitConvert##srcbpp##to##dstbpp(SDL_BlitInfo * info) \
+{ \
+    int width = info->dst_w; \
+    int height = info->dst_h; \
+    Uint8 *src = info->src; \
+    int srcskip = info->src_skip; \
+    Uint8 *dst = info->dst; \
+    int dstskip = info->dst_skip; \
+    SDL_PixelFormat *dstfmt = info->dst_fmt; \
+    const SDL_BlitConvert *convert = &info->convert; \
+    const Uint32 srcmask0 = convert->srcmask[0], dstmask0 = convert->dstmask[0]; \
+    const Uint32 srcmask1 = convert->srcmask[1], dstmask1 = convert->dstmask[1]; \
+    const Uint32 srcmask2 = convert->srcmask[2], dstmask2 = convert->dstmask[2]; \
+    const Uint32 srcmask3 = convert->srcmask[3], dstmask3 = convert->dstmask[3]; \
+    const int rshift0 = convert->rshift[0], lshift0 = convert->lshift[0]; \
+    const int rshift1 = convert->rshift[1], lshift1 = convert->lshift[1]; \
+    const int rshift2 = convert->rshift[2], lshift2 = convert->lshift[2]; \
+    const int rshift3 = convert->rshift[3], lshift3 = convert->lshift[3]; \
+    Uint32 fill = 0; \
+ \
+    if (dstfmt->Amask && !convert->srcmask[3]) { \
+        fill = (info->a >> dstfmt->Aloss) << dstfmt->Ashift; \
+    } \
+    while (height--) { \
+        DUFFS_LOOP( \
+        { \
+            Uint32 Pixel = READ_PIXEL_##srcbpp(src); \
+            Pixel = CONVERT_CHANNEL(Pixel, 0) | CONVERT_CHANNEL(Pixel, 1) | \
+                    CONVERT_CHANNEL(Pixel, 2) | CONVERT_CHANNEL(Pixel, 3) | \
+                    fill; \
+            WRITE_PIXEL_##dstbpp(dst, Pixel); \
+            src += srcbpp; \
+            dst += dstbpp; \
+        }, \
+        width); \
+        src += srcskip; \
+        dst += dstskip; \
+    } \
+}
+
+/* *INDENT-OFF* */
+DEFINE_BLIT_CONVERT(2, 2)
+DEFINE_BLIT_CONVERT(2, 3)
+DEFINE_BLIT_CONVERT(2, 4)
+DEFINE_BLIT_CONVERT(3, 2)
+DEFINE_BLIT_CONVERT(3, 3)
+DEFINE_BLIT_CONVERT(3, 4)
+DEFINE_BLIT_CONVERT(4, 2)
+DEFINE_BLIT_CONVERT(4, 3)
+DEFINE_BLIT_CONVERT(4, 4)
+/* *INDENT-ON* */
+
+#undef DEFINE_BLIT_CONVERT
+#undef CONVERT_CHANNEL
+
+static const SDL_BlitFunc blit_convert[3][3] = {
+    {BlitConvert2to2, BlitConvert2to3, BlitConvert2to4},
+    {BlitConvert3to2, BlitConvert3to3, BlitConvert3to4},
+    {BlitConvert4to2, BlitConvert4to3, BlitConvert4to4}
+};
+
+#ifdef __SSE2__
+/* BlitConvert4to4 for formats accepted by SDL_CanSwizzle32(),
+   4 pixels at a time */
+static void
+BlitConvert4to4SSE2(SDL_BlitInfo * info)
+{
+    DECLARE_ALIGNED(Uint32, srctail[4], 16);
+    DECLARE_ALIGNED(Uint32, dsttail[4], 16);
+    int width = info->dst_w;
+    int height = info->dst_h;
+    Uint32 *srcp = (Uint32 *) info->src;
+    int srcskip = info->src_skip / 4;
+    Uint32 *dstp = (Uint32 *) info->dst;
+    int dstskip = info->dst_skip / 4;
+    SDL_PixelFormat *srcfmt = info->src_fmt;
+    SDL_PixelFormat *dstfmt = info->dst_fmt;
+    SDL_Swizzle32SSE2 swizzle;
+
+    swizzle.keep = _mm_setzero_si128();
+    swizzle.alpha = _mm_setzero_si128();
+    swizzle.nmoved = 0;
+    SDL_AddSwizzleChannel(&swizzle, srcfmt->Rmask, srcfmt->Rshift,
+                          dstfmt->Rshift);
+    SDL_AddSwizzleChannel(&swizzle, srcfmt->Gmask, srcfmt->Gshift,
+                          dstfmt->Gshift);
+    SDL_AddSwizzleChannel(&swizzle, srcfmt->Bmask, srcfmt->Bshift,
+                          dstfmt->Bshift);
+    if (info->convert.srcmask[3]) {
+        SDL_AddSwizzleChannel(&swizzle, srcfmt->Amask, srcfmt->Ashift,
+                              dstfmt->Ashift);
+    } else if (dstfmt->Amask) {
+        swizzle.alpha =
+            _mm_set1_epi32((info->a >> dstfmt->Aloss) << dstfmt->Ashift);
+    }
+
+    while (height--) {
+        int n = width;
+        while (n >= 4) {
+            __m128i s = _mm_loadu_si128((__m128i *) srcp);
+            _mm_storeu_si128((__m128i *) dstp, SDL_Swizzle32(&swizzle, s));
+            srcp += 4;
+            dstp += 4;
+            n -= 4;
+        }
+        if (n > 0) {
+            SDL_memcpy(srctail, srcp, n * 4);
+            _mm_store_si128((__m128i *) dsttail,
+                            SDL_Swizzle32(&swizzle,
+                                          _mm_load_si128((__m128i *)
+                                                         srctail)));
+            SDL_memcpy(dstp, dsttail, n * 4);
+            srcp += n;
+            dstp += n;
+        }
+        srcp += srcskip;
+        dstp += dstskip;
+    }
+}
+#endif /* __SSE2__ */
+
+/* Channels wider than 8 bits can't be expressed as a single shift */
+static SDL_bool
+SDL_IsBlitConvertFormat(const SDL_PixelFormat * fmt)
+{
+    return (fmt->Rloss <= 8 && fmt->Gloss <= 8 && fmt->Bloss <= 8 &&
+            fmt->Aloss <= 8) ? SDL_TRUE : SDL_FALSE;
+}
+
+/* Pick a specialized version of BlitNtoN or BlitNtoNCopyAlpha */
+static SDL_BlitFunc
+SDL_ChooseBlitConvert(SDL_Surface * surface, SDL_bool copy_alpha)
+{
+    SDL_BlitInfo *info = &surface->map->info;
+    int srcbpp = info->src_fmt->BytesPerPixel;
+    int dstbpp = info->dst_fmt->BytesPerPixel;
+
+    if (srcbpp < 2 || dstbpp < 2 ||
+        !SDL_IsBlitConvertFormat(info->src_fmt) ||
+        !SDL_IsBlitConvertFormat(info->dst_fmt)) {
+        return copy_alpha ? BlitNtoNCopyAlpha : BlitNtoN;
+    }
+    SDL_SetupBlitConvert(info, copy_alpha);
+#ifdef __SSE2__
+    if ((GetBlitFeatures() & 8) &&
+        SDL_CanSwizzle32(info->src_fmt, info->dst_fmt)) {
+        return BlitConvert4to4SSE2;
+    }
+#endif
+    return blit_convert[srcbpp - 2][dstbpp - 2];
+}
+
 /* Normal N to N optimized blitters */
 struct blit_table
 {
@@ -2474,8 +2895,9 @@ SDL_CalculateBlitN(SDL_Surface * surface)
                     && srcfmt->Gmask == dstfmt->Gmask
                     && srcfmt->Bmask == dstfmt->Bmask) {
                     blitfun = Blit4to4MaskAlpha;
-                } else if (a_need == COPY_ALPHA) {
-                    blitfun = BlitNtoNCopyAlpha;
+                } else {
+                    blitfun = SDL_ChooseBlitConvert(surface,
+                                                    a_need == COPY_ALPHA);
                 }
             }
         }
@@ -2486,9 +2908,14 @@ SDL_CalculateBlitN(SDL_Surface * surface)
            because RLE is the preferred fast way to deal with this.
            If a particular case turns out to be useful we'll add it. */
 
-        if (srcfmt->BytesPerPixel == 2 && surface->map->identity)
+        if (srcfmt->BytesPerPixel == 2 && surface->map->identity) {
+#ifdef __SSE2__
+            if (GetBlitFeatures() & 8) {
+                return Blit2to2KeySSE2;
+            }
+#endif
             return Blit2to2Key;
-        else if (dstfmt->BytesPerPixel == 1)
+        } else if (dstfmt->BytesPerPixel == 1)
             return BlitNto1Key;
         else {
 #if SDL_ALTIVEC_BLITTERS
@@ -2496,6 +2923,11 @@ SDL_CalculateBlitN(SDL_Surface * surface)
                 && SDL_HasAltiVec()) {
                 return Blit32to32KeyAltivec;
             } else
+#endif
+#ifdef __SSE2__
+            if ((GetBlitFeatures() & 8) && SDL_CanSwizzle32(srcfmt, dstfmt)) {
+                return Blit4to4KeySSE2;
+            } else
 #endif
             if (srcfmt->Amask && dstfmt->Amask) {
                 return BlitNtoNKeyCopyAlpha;
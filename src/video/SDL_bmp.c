@@ -30,7 +30,8 @@
    and save, and since PNG is so complex that it would bloat the library,
    BMP is a good alternative. 
 
-   This code currently supports Win32 DIBs in uncompressed 8 and 24 bpp.
+   This code currently supports Win32 DIBs in uncompressed 1, 4, 8, 16, 24
+   and 32 bpp, and RLE compressed 4 and 8 bpp.
 */
 
 #include "SDL_video.h"
@@ -45,24 +46,226 @@
 #define BI_BITFIELDS	3
 #endif
 
+/* How much of the file is read at a time while decoding RLE data */
+#define BMP_BUFFER_SIZE 4096
 
-SDL_Surface *
-SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
+struct SDL_BMPStream
 {
-    SDL_bool was_error;
+    SDL_RWops *src;
+    int freesrc;
     long fp_offset;
-    int bmpPitch;
-    int i, pad;
-    SDL_Surface *surface;
+
+    SDL_Surface *surface;       /* the rows read by SDL_ReadBMPStream() */
+    int w, h;                   /* the size of the whole image */
+    SDL_bool topDown;
+    int bitCount;               /* bits per pixel in the file */
+    Uint32 compression;
+    int rowBytes;               /* size of an uncompressed row in the file */
+    int row;                    /* rows read so far, in file order */
+
+    /* RLE decoding state */
+    int rle_x;                  /* where the next row starts */
+    int rle_skip;               /* empty rows before the next one */
+    SDL_bool rle_end;           /* the end of the bitmap has been reached */
+    int bufpos;
+    int buflen;
+    Uint8 buffer[BMP_BUFFER_SIZE];
+};
+
+/* Read a palette of BGR or BGRA entries with a single read */
+static int
+SDL_ReadBMPPalette(SDL_RWops * src, SDL_Color * colors, int ncolors,
+                   int entrysize)
+{
+    Uint8 *entry;
+    int i;
+
+    /* The entries are unpacked forward, so put them at the end */
+    entry = (Uint8 *) colors + ncolors * (sizeof(*colors) - entrysize);
+    if (SDL_RWread(src, entry, entrysize, ncolors) != ncolors) {
+        SDL_Error(SDL_EFREAD);
+        return -1;
+    }
+    for (i = 0; i < ncolors; ++i) {
+        Uint8 b = entry[0];
+        Uint8 g = entry[1];
+        Uint8 r = entry[2];
+        Uint8 a = (entrysize == 4) ? entry[3] : SDL_ALPHA_OPAQUE;
+
+        colors[i].r = r;
+        colors[i].g = g;
+        colors[i].b = b;
+        colors[i].unused = a;
+        entry += entrysize;
+    }
+    return 0;
+}
+
+/* Read an uncompressed row straight into the surface */
+static int
+SDL_ReadBMPRow(SDL_BMPStream * stream, Uint8 * bits)
+{
+    int i;
+
+    if (SDL_RWread(stream->src, bits, 1, stream->rowBytes) !=
+        stream->rowBytes) {
+        SDL_Error(SDL_EFREAD);
+        return -1;
+    }
+
+    /* Expand 1 and 4 bit pixels in place, from the end of the row */
+    switch (stream->bitCount) {
+    case 1:
+        for (i = stream->w - 1; i >= 0; --i) {
+            bits[i] = (bits[i >> 3] >> (7 - (i & 7))) & 0x01;
+        }
+        break;
+    case 4:
+        for (i = stream->w - 1; i >= 0; --i) {
+            bits[i] = (i & 1) ? (bits[i >> 1] & 0x0F) : (bits[i >> 1] >> 4);
+        }
+        break;
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+    /* Byte-swap the pixels if needed. Note that the 24bpp
+       case has already been taken care of by the masks. */
+    case 15:
+    case 16:
+        {
+            Uint16 *pix = (Uint16 *) bits;
+            for (i = 0; i < stream->w; i++)
+                pix[i] = SDL_Swap16(pix[i]);
+        }
+        break;
+    case 32:
+        {
+            Uint32 *pix = (Uint32 *) bits;
+            for (i = 0; i < stream->w; i++)
+                pix[i] = SDL_Swap32(pix[i]);
+        }
+        break;
+#endif
+    default:
+        break;
+    }
+    return 0;
+}
+
+static int
+SDL_GetBMPByte(SDL_BMPStream * stream)
+{
+    if (stream->bufpos == stream->buflen) {
+        stream->bufpos = 0;
+        stream->buflen =
+            SDL_RWread(stream->src, stream->buffer, 1, BMP_BUFFER_SIZE);
+        if (stream->buflen <= 0) {
+            stream->buflen = 0;
+            SDL_SetError("Error reading from BMP");
+            return -1;
+        }
+    }
+    return stream->buffer[stream->bufpos++];
+}
+
+/* Decode a row of RLE8 or RLE4 data, pixels it skips are left at 0 */
+static int
+SDL_ReadBMPRowRLE(SDL_BMPStream * stream, Uint8 * bits)
+{
+    SDL_bool rle4 = (stream->compression == BI_RLE4);
+    int x, i, count, value, dx, dy;
+
+    SDL_memset(bits, 0, stream->w);
+    if (stream->rle_end) {
+        return 0;
+    }
+    if (stream->rle_skip > 0) {
+        --stream->rle_skip;
+        return 0;
+    }
+    x = stream->rle_x;
+    stream->rle_x = 0;
+
+    for (;;) {
+        if ((count = SDL_GetBMPByte(stream)) < 0 ||
+            (value = SDL_GetBMPByte(stream)) < 0) {
+            return -1;
+        }
+
+        if (count > 0) {
+            /* A run of one color, or of two alternating colors for RLE4 */
+            for (i = 0; i < count && x < stream->w; ++i, ++x) {
+                if (rle4) {
+                    bits[x] = (i & 1) ? (value & 0x0F) : (value >> 4);
+                } else {
+                    bits[x] = value;
+                }
+            }
+            continue;
+        }
+
+        switch (value) {
+        case 0:                /* End of line */
+            return 0;
+
+        case 1:                /* End of bitmap */
+            stream->rle_end = SDL_TRUE;
+            return 0;
+
+        case 2:                /* Move right and down */
+            if ((dx = SDL_GetBMPByte(stream)) < 0 ||
+                (dy = SDL_GetBMPByte(stream)) < 0) {
+                return -1;
+            }
+            x += dx;
+            if (dy > 0) {
+                stream->rle_x = x;
+                stream->rle_skip = dy - 1;
+                return 0;
+            }
+            break;
+
+        default:               /* Pixels stored as is, padded to 16 bits */
+            count = rle4 ? (value + 1) / 2 : value;
+            for (i = 0; i < count; ++i) {
+                int pixels = SDL_GetBMPByte(stream);
+                if (pixels < 0) {
+                    return -1;
+                }
+                if (!rle4) {
+                    if (x < stream->w) {
+                        bits[x] = pixels;
+                    }
+                    ++x;
+                    continue;
+                }
+                if (x < stream->w) {
+                    bits[x] = pixels >> 4;
+                }
+                ++x;
+                if (i * 2 + 1 < value) {
+                    if (x < stream->w) {
+                        bits[x] = pixels & 0x0F;
+                    }
+                    ++x;
+                }
+            }
+            if ((count & 1) && SDL_GetBMPByte(stream) < 0) {
+                return -1;
+            }
+            break;
+        }
+    }
+}
+
+SDL_BMPStream *
+SDL_OpenBMPStream_RW(SDL_RWops * src, int freesrc, int rows)
+{
+    SDL_BMPStream *stream;
+    int depth;
     Uint32 Rmask;
     Uint32 Gmask;
     Uint32 Bmask;
     Uint32 Amask;
     SDL_Palette *palette;
-    Uint8 *bits;
-    Uint8 *top, *end;
-    SDL_bool topDown;
-    int ExpandBMP;
 
     /* The Win32 BMP file header (14 bytes) */
     char magic[2];
@@ -85,25 +288,30 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
     Uint32 biClrImportant;
 
     /* Make sure we are passed a valid data source */
-    surface = NULL;
-    was_error = SDL_FALSE;
     if (src == NULL) {
-        was_error = SDL_TRUE;
-        goto done;
+        return NULL;
     }
+    stream = (SDL_BMPStream *) SDL_calloc(1, sizeof(*stream));
+    if (!stream) {
+        SDL_OutOfMemory();
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+        return NULL;
+    }
+    stream->src = src;
+    stream->freesrc = freesrc;
 
     /* Read in the BMP file header */
-    fp_offset = SDL_RWtell(src);
+    stream->fp_offset = SDL_RWtell(src);
     SDL_ClearError();
     if (SDL_RWread(src, magic, 1, 2) != 2) {
         SDL_Error(SDL_EFREAD);
-        was_error = SDL_TRUE;
-        goto done;
+        goto error;
     }
     if (SDL_strncmp(magic, "BM", 2) != 0) {
         SDL_SetError("File is not a Windows BMP file");
-        was_error = SDL_TRUE;
-        goto done;
+        goto error;
     }
     bfSize = SDL_ReadLE32(src);
     bfReserved1 = SDL_ReadLE16(src);
@@ -136,31 +344,32 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
         biClrImportant = SDL_ReadLE32(src);
     }
     if (biHeight < 0) {
-        topDown = SDL_TRUE;
+        stream->topDown = SDL_TRUE;
         biHeight = -biHeight;
     } else {
-        topDown = SDL_FALSE;
+        stream->topDown = SDL_FALSE;
     }
 
     /* Check for read error */
     if (SDL_strcmp(SDL_GetError(), "") != 0) {
-        was_error = SDL_TRUE;
-        goto done;
+        goto error;
+    }
+    if (biWidth < 0) {
+        SDL_SetError("Invalid BMP width");
+        goto error;
     }
 
     /* Expand 1 and 4 bit bitmaps to 8 bits per pixel */
     switch (biBitCount) {
     case 1:
     case 4:
-        ExpandBMP = biBitCount;
-        biBitCount = 8;
+        depth = 8;
         break;
     default:
-        ExpandBMP = 0;
+        depth = biBitCount;
         break;
     }
 
-    /* We don't support any BMP compression right now */
     Rmask = Gmask = Bmask = Amask = 0;
     switch (biCompression) {
     case BI_RGB:
@@ -216,26 +425,49 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
             break;
         }
         break;
+
+    case BI_RLE8:
+    case BI_RLE4:
+        if (biBitCount != ((biCompression == BI_RLE8) ? 8 : 4)) {
+            SDL_SetError("Invalid RLE compressed BMP file");
+            goto error;
+        }
+        break;
+
     default:
         SDL_SetError("Compressed BMP files not supported");
-        was_error = SDL_TRUE;
-        goto done;
+        goto error;
     }
 
+    stream->w = biWidth;
+    stream->h = biHeight;
+    stream->bitCount = biBitCount;
+    stream->compression = biCompression;
+    stream->rowBytes =
+        (((biBitCount < 8 ? biBitCount : ((depth + 7) / 8) * 8) * biWidth +
+          31) / 32) * 4;
+
     /* Create a compatible surface, note that the colors are RGB ordered */
-    surface =
-        SDL_CreateRGBSurface(0, biWidth, biHeight, biBitCount, Rmask, Gmask,
-                             Bmask, Amask);
-    if (surface == NULL) {
-        was_error = SDL_TRUE;
-        goto done;
+    if (rows <= 0 || rows > biHeight) {
+        rows = biHeight;
+    }
+    stream->surface =
+        SDL_CreateRGBSurface(0, biWidth, rows, depth, Rmask, Gmask, Bmask,
+                             Amask);
+    if (stream->surface == NULL) {
+        goto error;
     }
 
     /* Load the palette, if any */
-    palette = (surface->format)->palette;
+    palette = (stream->surface->format)->palette;
     if (palette) {
+        if (SDL_RWseek(src, stream->fp_offset + 14 + biSize, RW_SEEK_SET) <
+            0) {
+            SDL_Error(SDL_EFSEEK);
+            goto error;
+        }
         if (biClrUsed == 0) {
-            biClrUsed = 1 << biBitCount;
+            biClrUsed = 1 << depth;
         }
         if ((int) biClrUsed > palette->ncolors) {
             palette->ncolors = biClrUsed;
@@ -245,130 +477,128 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
                                           sizeof(*palette->colors));
             if (!palette->colors) {
                 SDL_OutOfMemory();
-                was_error = SDL_TRUE;
-                goto done;
+                goto error;
             }
         } else if ((int) biClrUsed < palette->ncolors) {
             palette->ncolors = biClrUsed;
         }
-        if (biSize == 12) {
-            for (i = 0; i < (int) biClrUsed; ++i) {
-                SDL_RWread(src, &palette->colors[i].b, 1, 1);
-                SDL_RWread(src, &palette->colors[i].g, 1, 1);
-                SDL_RWread(src, &palette->colors[i].r, 1, 1);
-                palette->colors[i].unused = SDL_ALPHA_OPAQUE;
-            }
-        } else {
-            for (i = 0; i < (int) biClrUsed; ++i) {
-                SDL_RWread(src, &palette->colors[i].b, 1, 1);
-                SDL_RWread(src, &palette->colors[i].g, 1, 1);
-                SDL_RWread(src, &palette->colors[i].r, 1, 1);
-                SDL_RWread(src, &palette->colors[i].unused, 1, 1);
-            }
+        if (SDL_ReadBMPPalette(src, palette->colors, biClrUsed,
+                               (biSize == 12) ? 3 : 4) < 0) {
+            goto error;
         }
     }
 
-    /* Read the surface pixels.  Note that the bmp image is upside down */
-    if (SDL_RWseek(src, fp_offset + bfOffBits, RW_SEEK_SET) < 0) {
+    /* The pixels are read from here on */
+    if (SDL_RWseek(src, stream->fp_offset + bfOffBits, RW_SEEK_SET) < 0) {
         SDL_Error(SDL_EFSEEK);
-        was_error = SDL_TRUE;
-        goto done;
+        goto error;
     }
-    top = (Uint8 *)surface->pixels;
-    end = (Uint8 *)surface->pixels+(surface->h*surface->pitch);
-    switch (ExpandBMP) {
-    case 1:
-        bmpPitch = (biWidth + 7) >> 3;
-        pad = (((bmpPitch) % 4) ? (4 - ((bmpPitch) % 4)) : 0);
-        break;
-    case 4:
-        bmpPitch = (biWidth + 1) >> 1;
-        pad = (((bmpPitch) % 4) ? (4 - ((bmpPitch) % 4)) : 0);
-        break;
-    default:
-        pad = ((surface->pitch % 4) ? (4 - (surface->pitch % 4)) : 0);
-        break;
+    return stream;
+
+  error:
+    SDL_RWseek(src, stream->fp_offset, RW_SEEK_SET);
+    SDL_CloseBMPStream(stream);
+    return NULL;
+}
+
+SDL_Surface *
+SDL_GetBMPStreamSurface(SDL_BMPStream * stream, int *h)
+{
+    if (!stream) {
+        SDL_SetError("Invalid BMP stream");
+        return NULL;
     }
-    if (topDown) {
-        bits = top;
-    } else {
-        bits = end - surface->pitch;
-    }
-    while (bits >= top && bits < end) {
-        switch (ExpandBMP) {
-        case 1:
-        case 4:{
-                Uint8 pixel = 0;
-                int shift = (8 - ExpandBMP);
-                for (i = 0; i < surface->w; ++i) {
-                    if (i % (8 / ExpandBMP) == 0) {
-                        if (!SDL_RWread(src, &pixel, 1, 1)) {
-                            SDL_SetError("Error reading from BMP");
-                            was_error = SDL_TRUE;
-                            goto done;
-                        }
-                    }
-                    *(bits + i) = (pixel >> shift);
-                    pixel <<= ExpandBMP;
-                }
-            }
-            break;
+    if (h) {
+        *h = stream->h;
+    }
+    return stream->surface;
+}
 
-        default:
-            if (SDL_RWread(src, bits, 1, surface->pitch)
-                != surface->pitch) {
-                SDL_Error(SDL_EFREAD);
-                was_error = SDL_TRUE;
-                goto done;
-            }
-#if SDL_BYTEORDER == SDL_BIG_ENDIAN
-            /* Byte-swap the pixels if needed. Note that the 24bpp
-               case has already been taken care of above. */
-            switch (biBitCount) {
-            case 15:
-            case 16:{
-                    Uint16 *pix = (Uint16 *) bits;
-                    for (i = 0; i < surface->w; i++)
-                        pix[i] = SDL_Swap16(pix[i]);
-                    break;
-                }
+int
+SDL_ReadBMPStream(SDL_BMPStream * stream, int *y)
+{
+    SDL_Surface *surface;
+    Uint8 *bits;
+    int rows, i;
 
-            case 32:{
-                    Uint32 *pix = (Uint32 *) bits;
-                    for (i = 0; i < surface->w; i++)
-                        pix[i] = SDL_Swap32(pix[i]);
-                    break;
-                }
+    if (!stream) {
+        SDL_SetError("Invalid BMP stream");
+        return -1;
+    }
+    surface = stream->surface;
+
+    rows = SDL_min(surface->h, stream->h - stream->row);
+    if (rows <= 0) {
+        return 0;
+    }
+    if (y) {
+        *y = stream->topDown ? stream->row : stream->h - stream->row - rows;
+    }
+
+    /* The rows of bottom-up images are filled in from the last one */
+    if (stream->topDown) {
+        bits = (Uint8 *) surface->pixels;
+    } else {
+        bits = (Uint8 *) surface->pixels + (rows - 1) * surface->pitch;
+    }
+    for (i = 0; i < rows; ++i) {
+        if (stream->compression == BI_RLE8 ||
+            stream->compression == BI_RLE4) {
+            if (SDL_ReadBMPRowRLE(stream, bits) < 0) {
+                return -1;
             }
-#endif
-            break;
-        }
-        /* Skip padding bytes, ugh */
-        if (pad) {
-            Uint8 padbyte;
-            for (i = 0; i < pad; ++i) {
-                SDL_RWread(src, &padbyte, 1, 1);
+        } else {
+            if (SDL_ReadBMPRow(stream, bits) < 0) {
+                return -1;
             }
         }
-        if (topDown) {
+        ++stream->row;
+        if (stream->topDown) {
             bits += surface->pitch;
         } else {
             bits -= surface->pitch;
         }
     }
-  done:
-    if (was_error) {
-        if (src) {
-            SDL_RWseek(src, fp_offset, RW_SEEK_SET);
-        }
-        if (surface) {
-            SDL_FreeSurface(surface);
-        }
-        surface = NULL;
+    return rows;
+}
+
+void
+SDL_CloseBMPStream(SDL_BMPStream * stream)
+{
+    if (!stream) {
+        return;
+    }
+    if (stream->freesrc) {
+        SDL_RWclose(stream->src);
+    } else if (stream->bufpos < stream->buflen) {
+        /* Leave the source right after what was decoded */
+        SDL_RWseek(stream->src, stream->bufpos - stream->buflen, RW_SEEK_CUR);
     }
-    if (freesrc && src) {
-        SDL_RWclose(src);
+    if (stream->surface) {
+        SDL_FreeSurface(stream->surface);
+    }
+    SDL_free(stream);
+}
+
+SDL_Surface *
+SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
+{
+    SDL_BMPStream *stream;
+    SDL_Surface *surface = NULL;
+
+    /* Read the whole image straight into the surface */
+    stream = SDL_OpenBMPStream_RW(src, freesrc, 0);
+    if (!stream) {
+        return NULL;
+    }
+    if (SDL_ReadBMPStream(stream, NULL) < 0) {
+        SDL_RWseek(src, stream->fp_offset, RW_SEEK_SET);
+        stream->bufpos = stream->buflen = 0;
+    } else {
+        surface = stream->surface;
+        stream->surface = NULL;
     }
+    SDL_CloseBMPStream(stream);
     return (surface);
 }
 
@@ -482,7 +712,7 @@ SDL_SaveBMP_RW(SDL_Surface * saveme, SDL_RWops * dst, int freedst)
         biPlanes = 1;
         biBitCount = surface->format->BitsPerPixel;
         biCompression = BI_RGB;
-        biSizeImage = surface->h * surface->pitch;
+        biSizeImage = surface->h * ((bw + 3) & ~3);
         biXPelsPerMeter = 0;
         biYPelsPerMeter = 0;
         if (surface->format->palette) {
@@ -29,6 +29,13 @@
 
 #define DRAW_MUL(_a, _b) (((unsigned)(_a)*(_b))/255)
 
+#ifdef __SSE2__
+/* Exact DRAW_MUL() division for 16-bit lanes, using a 'div255' vector
+   of 0x8081 from the enclosing scope */
+#define SSE2_DIV255(x) \
+    _mm_srli_epi16(_mm_mulhi_epu16(x, div255), 7)
+#endif
+
 #define DRAW_FASTSETPIXEL(type) \
     *pixel = (type) color
 
@@ -314,6 +321,25 @@ do { \
     } \
 }
 
+/* Horizontal line, written as a single span with 'fill' */
+#define HLINE_FILL(type, fill, draw_end) \
+{ \
+    int length; \
+    int pitch = (dst->pitch / dst->format->BytesPerPixel); \
+    type *pixel; \
+    if (x1 <= x2) { \
+        pixel = (type *)dst->pixels + y1 * pitch + x1; \
+        length = draw_end ? (x2-x1+1) : (x2-x1); \
+    } else { \
+        pixel = (type *)dst->pixels + y1 * pitch + x2; \
+        if (!draw_end) { \
+            ++pixel; \
+        } \
+        length = draw_end ? (x1-x2+1) : (x1-x2); \
+    } \
+    fill(pixel, color, length); \
+}
+
 /* Vertical line */
 #define VLINE(type, op, draw_end) \
 { \
@@ -371,6 +397,9 @@ do { \
     } \
 }
 
+/* Lines at least this shallow are drawn as horizontal runs by BLINE_FILL */
+#define BLINE_FILL_RUN  8
+
 /* Bresenham's line algorithm */
 #define BLINE(x1, y1, x2, y2, op, draw_end) \
 { \
@@ -431,6 +460,67 @@ do { \
     } \
 }
 
+/* Bresenham's line algorithm for solid lines, visiting the same pixels as
+   BLINE but stepping through them directly.  The error term only picks
+   between two increments, which is written so it compiles to conditional
+   moves instead of a branch the CPU can't predict.  Shallow lines are
+   written a horizontal run at a time with 'fill'. */
+#define BLINE_FILL(type, op, fill, draw_end) \
+{ \
+    int i, deltax, deltay, numpixels, run; \
+    int d, dinc1, dinc2, pinc1, pinc2; \
+    int pitch = (dst->pitch / dst->format->BytesPerPixel); \
+    int xinc = (x1 <= x2) ? 1 : -1; \
+    int yinc = (y1 <= y2) ? pitch : -pitch; \
+    type *pixel = (type *)dst->pixels + y1 * pitch + x1; \
+ \
+    deltax = ABS(x2 - x1); \
+    deltay = ABS(y2 - y1); \
+ \
+    if (deltax >= deltay) { \
+        numpixels = deltax + 1; \
+        d = (2 * deltay) - deltax; \
+        dinc1 = deltay * 2; \
+        dinc2 = (deltay - deltax) * 2; \
+        pinc1 = xinc; \
+        pinc2 = xinc + yinc; \
+    } else { \
+        numpixels = deltay + 1; \
+        d = (2 * deltax) - deltay; \
+        dinc1 = deltax * 2; \
+        dinc2 = (deltax - deltay) * 2; \
+        pinc1 = yinc; \
+        pinc2 = xinc + yinc; \
+    } \
+    if (!draw_end) { \
+        --numpixels; \
+    } \
+ \
+    if (deltax >= BLINE_FILL_RUN * deltay) { \
+        while (numpixels > 0) { \
+            /* The row continues until the error term turns positive */ \
+            run = 1; \
+            if (d < 0) { \
+                run += (-d + dinc1 - 1) / dinc1; \
+            } \
+            if (run > numpixels) { \
+                run = numpixels; \
+            } \
+            fill((xinc > 0) ? pixel : pixel - (run - 1), color, run); \
+            d += (run - 1) * dinc1 + dinc2; \
+            pixel += xinc * run + yinc; \
+            numpixels -= run; \
+        } \
+    } else { \
+        for (i = 0; i < numpixels; ++i) { \
+            int minor = (d >= 0); \
+            op; \
+            d += minor ? dinc2 : dinc1; \
+            pixel += minor ? pinc2 : pinc1; \
+        } \
+    } \
+}
+
 /* Xiaolin Wu's line algorithm, based on Michael Abrash's implementation */
 #define WULINE(x1, y1, x2, y2, opaque_op, blend_op, draw_end) \
 { \
@@ -548,6 +638,27 @@ do { \
             BLINE(x1, y1, x2, y2, opaque_op, draw_end)
 #endif
 
+/*
+ * Define point drawing macro
+ */
+
+#define DRAWPOINTS(op) \
+do { \
+    int minx = dst->clip_rect.x; \
+    int maxx = dst->clip_rect.x + dst->clip_rect.w - 1; \
+    int miny = dst->clip_rect.y; \
+    int maxy = dst->clip_rect.y + dst->clip_rect.h - 1; \
+    int i, x, y; \
+    for (i = 0; i < count; ++i) { \
+        x = points[i].x; \
+        y = points[i].y; \
+        if (x < minx || x > maxx || y < miny || y > maxy) { \
+            continue; \
+        } \
+        op(x, y); \
+    } \
+} while (0)
+
 /*
  * Define fill rect macro
  */
@@ -573,4 +684,66 @@ do { \
     } \
 } while (0)
 
+/*
+ * Define coverage span macros, which blend the color into 'width' pixels
+ * starting at x, y, each weighted by an 8-bit value from 'coverage'.
+ * These expect the unweighted color in _r, _g, _b, _a.
+ */
+
+/* Scale the alpha by the coverage, for the blend and add operators */
+#define COVERAGE_BLEND(weight) \
+do { \
+    a = DRAW_MUL(_a, weight); \
+    r = DRAW_MUL(_r, a); \
+    g = DRAW_MUL(_g, a); \
+    b = DRAW_MUL(_b, a); \
+    inva = (a ^ 0xff); \
+} while (0)
+
+/* Fade the color towards white, for the modulate operator */
+#define COVERAGE_MOD(weight) \
+do { \
+    r = DRAW_MUL(weight, _r ^ 0xff) ^ 0xff; \
+    g = DRAW_MUL(weight, _g ^ 0xff) ^ 0xff; \
+    b = DRAW_MUL(weight, _b ^ 0xff) ^ 0xff; \
+} while (0)
+
+#define COVERAGESPAN(type, weight_op, op) \
+do { \
+    type *pixel = (type *)((Uint8 *)dst->pixels + y * dst->pitch) + x; \
+    unsigned r = 0, g = 0, b = 0, a = 0, inva = 0; \
+    int i; \
+    for (i = 0; i < width; ++i, ++pixel) { \
+        if (coverage[i]) { \
+            weight_op(coverage[i]); \
+            op; \
+        } \
+    } \
+    (void) a; (void) inva; \
+} while (0)
+
+/* Fully covered pixels are set, and the edges are blended by coverage */
+#define COVERAGESPAN_OPAQUE(type, opaque_op, blend_op) \
+do { \
+    type *pixel = (type *)((Uint8 *)dst->pixels + y * dst->pitch) + x; \
+    unsigned r, g, b, a, inva; \
+    int i; \
+    for (i = 0; i < width; ++i, ++pixel) { \
+        if (coverage[i] == 0xff) { \
+            r = _r; \
+            g = _g; \
+            b = _b; \
+            a = _a; \
+            opaque_op; \
+        } else if (coverage[i]) { \
+            a = coverage[i]; \
+            r = DRAW_MUL(_r, a); \
+            g = DRAW_MUL(_g, a); \
+            b = DRAW_MUL(_b, a); \
+            inva = (a ^ 0xff); \
+            blend_op; \
+        } \
+    } \
+} while (0)
+
 /* vi: set ts=4 sw=4 expandtab: */
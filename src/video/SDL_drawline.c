@@ -22,33 +22,66 @@
 #include "SDL_config.h"
 
 #include "SDL_draw.h"
+#include "SDL_rect_c.h"
+
+/* Spans shorter than this are written a pixel at a time, since they don't
+   make up for the setup cost of a block fill */
+#define SPAN_FILL_MIN   8
+
+static __inline__ void
+SDL_FillSpan1(Uint8 * pixel, Uint32 color, int length)
+{
+    if (length >= SPAN_FILL_MIN) {
+        SDL_memset(pixel, color, length);
+        return;
+    }
+    while (length--) {
+        *pixel++ = (Uint8) color;
+    }
+}
+
+static __inline__ void
+SDL_FillSpan2(Uint16 * pixel, Uint32 color, int length)
+{
+    if (length >= SPAN_FILL_MIN) {
+        if ((uintptr_t) pixel & 2) {
+            *pixel++ = (Uint16) color;
+            --length;
+        }
+        color &= 0xFFFF;
+        SDL_memset4(pixel, color | (color << 16), length >> 1);
+        pixel += length & ~1;
+        length &= 1;
+    }
+    while (length--) {
+        *pixel++ = (Uint16) color;
+    }
+}
+
+static __inline__ void
+SDL_FillSpan4(Uint32 * pixel, Uint32 color, int length)
+{
+    if (length >= SPAN_FILL_MIN) {
+        SDL_memset4(pixel, color, length);
+        return;
+    }
+    while (length--) {
+        *pixel++ = color;
+    }
+}
 
 static void
 SDL_DrawLine1(SDL_Surface * dst, int x1, int y1, int x2, int y2, Uint32 color,
               SDL_bool draw_end)
 {
     if (y1 == y2) {
-        //HLINE(Uint8, DRAW_FASTSETPIXEL1, draw_end);
-        int length;
-        int pitch = (dst->pitch / dst->format->BytesPerPixel);
-        Uint8 *pixel;
-        if (x1 <= x2) {
-            pixel = (Uint8 *)dst->pixels + y1 * pitch + x1;
-            length = draw_end ? (x2-x1+1) : (x2-x1);
-        } else {
-            pixel = (Uint8 *)dst->pixels + y1 * pitch + x2;
-            if (!draw_end) {
-                ++pixel;
-            }
-            length = draw_end ? (x1-x2+1) : (x1-x2);
-        }
-        SDL_memset(pixel, color, length);
+        HLINE_FILL(Uint8, SDL_FillSpan1, draw_end);
     } else if (x1 == x2) {
         VLINE(Uint8, DRAW_FASTSETPIXEL1, draw_end);
     } else if (ABS(x1 - x2) == ABS(y1 - y2)) {
         DLINE(Uint8, DRAW_FASTSETPIXEL1, draw_end);
     } else {
-        BLINE(x1, y1, x2, y2, DRAW_FASTSETPIXELXY1, draw_end);
+        BLINE_FILL(Uint8, DRAW_FASTSETPIXEL1, SDL_FillSpan1, draw_end);
     }
 }
 
@@ -57,12 +90,13 @@ SDL_DrawLine2(SDL_Surface * dst, int x1, int y1, int x2, int y2, Uint32 color,
               SDL_bool draw_end)
 {
     if (y1 == y2) {
-        HLINE(Uint16, DRAW_FASTSETPIXEL2, draw_end);
+        HLINE_FILL(Uint16, SDL_FillSpan2, draw_end);
     } else if (x1 == x2) {
         VLINE(Uint16, DRAW_FASTSETPIXEL2, draw_end);
     } else if (ABS(x1 - x2) == ABS(y1 - y2)) {
         DLINE(Uint16, DRAW_FASTSETPIXEL2, draw_end);
     } else {
+#ifdef AA_LINES
         Uint8 _r, _g, _b, _a;
         const SDL_PixelFormat * fmt = dst->format;
         SDL_GetRGBA(color, fmt, &_r, &_g, &_b, &_a);
@@ -79,6 +113,9 @@ SDL_DrawLine2(SDL_Surface * dst, int x1, int y1, int x2, int y2, Uint32 color,
                    DRAW_FASTSETPIXELXY2, DRAW_SETPIXELXY2_BLEND_RGB,
                    draw_end);
         }
+#else
+        BLINE_FILL(Uint16, DRAW_FASTSETPIXEL2, SDL_FillSpan2, draw_end);
+#endif
     }
 }
 
@@ -87,12 +124,13 @@ SDL_DrawLine4(SDL_Surface * dst, int x1, int y1, int x2, int y2, Uint32 color,
               SDL_bool draw_end)
 {
     if (y1 == y2) {
-        HLINE(Uint32, DRAW_FASTSETPIXEL4, draw_end);
+        HLINE_FILL(Uint32, SDL_FillSpan4, draw_end);
     } else if (x1 == x2) {
         VLINE(Uint32, DRAW_FASTSETPIXEL4, draw_end);
     } else if (ABS(x1 - x2) == ABS(y1 - y2)) {
         DLINE(Uint32, DRAW_FASTSETPIXEL4, draw_end);
     } else {
+#ifdef AA_LINES
         Uint8 _r, _g, _b, _a;
         const SDL_PixelFormat * fmt = dst->format;
         SDL_GetRGBA(color, fmt, &_r, &_g, &_b, &_a);
@@ -111,6 +149,9 @@ SDL_DrawLine4(SDL_Surface * dst, int x1, int y1, int x2, int y2, Uint32 color,
                    DRAW_FASTSETPIXELXY4, DRAW_SETPIXELXY4_BLEND_RGB,
                    draw_end);
         }
+#else
+        BLINE_FILL(Uint32, DRAW_FASTSETPIXEL4, SDL_FillSpan4, draw_end);
+#endif
     }
 }
 
@@ -169,6 +210,7 @@ SDL_DrawLines(SDL_Surface * dst, const SDL_Point * points, int count,
     int x1, y1;
     int x2, y2;
     SDL_bool draw_end;
+    SDL_bool inside;
     DrawLineFunc func;
 
     if (!dst) {
@@ -182,20 +224,29 @@ SDL_DrawLines(SDL_Surface * dst, const SDL_Point * points, int count,
         return -1;
     }
 
+    /* Long polylines are usually entirely visible, check that once up front
+       instead of clipping every segment */
+    inside = SDL_PointsInRect(points, count, &dst->clip_rect);
+
     for (i = 1; i < count; ++i) {
         x1 = points[i-1].x;
         y1 = points[i-1].y;
         x2 = points[i].x;
         y2 = points[i].y;
 
-        /* Perform clipping */
-        /* FIXME: We don't actually want to clip, as it may change line slope */
-        if (!SDL_IntersectRectAndLine(&dst->clip_rect, &x1, &y1, &x2, &y2)) {
-            continue;
-        }
+        if (inside) {
+            draw_end = SDL_FALSE;
+        } else {
+            /* Perform clipping */
+            /* FIXME: We don't actually want to clip, as it may change line slope */
+            if (!SDL_IntersectRectAndLine(&dst->clip_rect,
+                                          &x1, &y1, &x2, &y2)) {
+                continue;
+            }
 
-        /* Draw the end if it was clipped */
-        draw_end = (x2 != points[i].x || y2 != points[i].y);
+            /* Draw the end if it was clipped */
+            draw_end = (x2 != points[i].x || y2 != points[i].y);
+        }
 
         func(dst, x1, y1, x2, y2, color, draw_end);
     }
@@ -66,11 +66,6 @@ int
 SDL_DrawPoints(SDL_Surface * dst, const SDL_Point * points, int count,
                Uint32 color)
 {
-    int minx, miny;
-    int maxx, maxy;
-    int i;
-    int x, y;
-
     if (!dst) {
         SDL_SetError("Passed NULL destination surface");
         return -1;
@@ -82,33 +77,19 @@ SDL_DrawPoints(SDL_Surface * dst, const SDL_Point * points, int count,
         return -1;
     }
 
-    minx = dst->clip_rect.x;
-    maxx = dst->clip_rect.x + dst->clip_rect.w - 1;
-    miny = dst->clip_rect.y;
-    maxy = dst->clip_rect.y + dst->clip_rect.h - 1;
-
-    for (i = 0; i < count; ++i) {
-        x = points[i].x;
-        y = points[i].y;
-
-        if (x < minx || x > maxx || y < miny || y > maxy) {
-            continue;
-        }
-
-        switch (dst->format->BytesPerPixel) {
-        case 1:
-            DRAW_FASTSETPIXELXY1(x, y);
-            break;
-        case 2:
-            DRAW_FASTSETPIXELXY2(x, y);
-            break;
-        case 3:
-            SDL_Unsupported();
-            return -1;
-        case 4:
-            DRAW_FASTSETPIXELXY4(x, y);
-            break;
-        }
+    switch (dst->format->BytesPerPixel) {
+    case 1:
+        DRAWPOINTS(DRAW_FASTSETPIXELXY1);
+        break;
+    case 2:
+        DRAWPOINTS(DRAW_FASTSETPIXELXY2);
+        break;
+    case 3:
+        SDL_Unsupported();
+        return -1;
+    case 4:
+        DRAWPOINTS(DRAW_FASTSETPIXELXY4);
+        break;
     }
     return 0;
 }
@@ -23,20 +23,27 @@
 
 #include "SDL_video.h"
 #include "SDL_blit.h"
+#include "SDL_rect_c.h"
+
+/* Fills larger than this bypass the cache with non-temporal stores, smaller
+   ones are likely to be read back soon and are better left in the cache. */
+#define SDL_FILLRECT_STREAM_BYTES   (256 * 1024)
 
 
 #ifdef __SSE__
 /* *INDENT-OFF* */
 
 #ifdef _MSC_VER
-#define SSE_BEGIN \
+#define SSE_BEGIN(bpp) \
+    const int stream = (w * h * bpp >= SDL_FILLRECT_STREAM_BYTES); \
     __m128 c128; \
     c128.m128_u32[0] = color; \
     c128.m128_u32[1] = color; \
     c128.m128_u32[2] = color; \
     c128.m128_u32[3] = color;
 #else
-#define SSE_BEGIN \
+#define SSE_BEGIN(bpp) \
+    const int stream = (w * h * bpp >= SDL_FILLRECT_STREAM_BYTES); \
     DECLARE_ALIGNED(Uint32, cccc[4], 16); \
     cccc[0] = color; \
     cccc[1] = color; \
@@ -46,21 +53,34 @@
 #endif
 
 #define SSE_WORK \
-    for (i = n / 64; i--;) { \
-        _mm_stream_ps((float *)(p+0), c128); \
-        _mm_stream_ps((float *)(p+16), c128); \
-        _mm_stream_ps((float *)(p+32), c128); \
-        _mm_stream_ps((float *)(p+48), c128); \
-        p += 64; \
+    if (stream) { \
+        for (i = n / 64; i--;) { \
+            _mm_stream_ps((float *)(p+0), c128); \
+            _mm_stream_ps((float *)(p+16), c128); \
+            _mm_stream_ps((float *)(p+32), c128); \
+            _mm_stream_ps((float *)(p+48), c128); \
+            p += 64; \
+        } \
+    } else { \
+        for (i = n / 64; i--;) { \
+            _mm_store_ps((float *)(p+0), c128); \
+            _mm_store_ps((float *)(p+16), c128); \
+            _mm_store_ps((float *)(p+32), c128); \
+            _mm_store_ps((float *)(p+48), c128); \
+            p += 64; \
+        } \
     }
 
-#define SSE_END
+#define SSE_END \
+    if (stream) { \
+        _mm_sfence(); \
+    }
 
 #define DEFINE_SSE_FILLRECT(bpp, type) \
 static void \
 SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
 { \
-    SSE_BEGIN; \
+    SSE_BEGIN(bpp); \
  \
     while (h--) { \
         int i, n = w * bpp; \
@@ -95,7 +115,7 @@ SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
 static void
 SDL_FillRect1SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
 {
-    SSE_BEGIN;
+    SSE_BEGIN(1);
 
     while (h--) {
         int i, n = w;
@@ -124,36 +144,117 @@ SDL_FillRect1SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
 DEFINE_SSE_FILLRECT(2, Uint16)
 DEFINE_SSE_FILLRECT(4, Uint32)
 
+static void
+SDL_FillRect3SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
+{
+    /* 16 pixels are exactly three vectors, starting at a pixel boundary */
+    DECLARE_ALIGNED(Uint8, pattern[48], 16);
+    const int stream = (w * h * 3 >= SDL_FILLRECT_STREAM_BYTES);
+    Uint8 r = (Uint8) ((color >> 16) & 0xFF);
+    Uint8 g = (Uint8) ((color >> 8) & 0xFF);
+    Uint8 b = (Uint8) (color & 0xFF);
+    __m128 c0, c1, c2;
+    int i;
+
+    for (i = 0; i < 48; i += 3) {
+        pattern[i + 0] = r;
+        pattern[i + 1] = g;
+        pattern[i + 2] = b;
+    }
+    c0 = _mm_load_ps((float *)(pattern+0));
+    c1 = _mm_load_ps((float *)(pattern+16));
+    c2 = _mm_load_ps((float *)(pattern+32));
+
+    while (h--) {
+        int n = w;
+        Uint8 *p = pixels;
+
+        if (n > 31) {
+            /* Every 16 pixels one of them lands on a 16 byte boundary */
+            while ((uintptr_t)p & 15) {
+                *p++ = r;
+                *p++ = g;
+                *p++ = b;
+                --n;
+            }
+            if (stream) {
+                for (i = n / 16; i--;) {
+                    _mm_stream_ps((float *)(p+0), c0);
+                    _mm_stream_ps((float *)(p+16), c1);
+                    _mm_stream_ps((float *)(p+32), c2);
+                    p += 48;
+                }
+            } else {
+                for (i = n / 16; i--;) {
+                    _mm_store_ps((float *)(p+0), c0);
+                    _mm_store_ps((float *)(p+16), c1);
+                    _mm_store_ps((float *)(p+32), c2);
+                    p += 48;
+                }
+            }
+            n &= 15;
+        }
+        while (n--) {
+            *p++ = r;
+            *p++ = g;
+            *p++ = b;
+        }
+        pixels += pitch;
+    }
+
+    if (stream) {
+        _mm_sfence();
+    }
+}
+
 /* *INDENT-ON* */
 #endif /* __SSE__ */
 
 #ifdef __MMX__
 /* *INDENT-OFF* */
 
-#define MMX_BEGIN \
+#define MMX_BEGIN(bpp) \
+    const int stream = (w * h * bpp >= SDL_FILLRECT_STREAM_BYTES); \
     __m64 c64 = _mm_set_pi32(color, color)
 
 #define MMX_WORK \
-    for (i = n / 64; i--;) { \
-        _mm_stream_pi((__m64 *)(p+0), c64); \
-        _mm_stream_pi((__m64 *)(p+8), c64); \
-        _mm_stream_pi((__m64 *)(p+16), c64); \
-        _mm_stream_pi((__m64 *)(p+24), c64); \
-        _mm_stream_pi((__m64 *)(p+32), c64); \
-        _mm_stream_pi((__m64 *)(p+40), c64); \
-        _mm_stream_pi((__m64 *)(p+48), c64); \
-        _mm_stream_pi((__m64 *)(p+56), c64); \
-        p += 64; \
+    if (stream) { \
+        for (i = n / 64; i--;) { \
+            _mm_stream_pi((__m64 *)(p+0), c64); \
+            _mm_stream_pi((__m64 *)(p+8), c64); \
+            _mm_stream_pi((__m64 *)(p+16), c64); \
+            _mm_stream_pi((__m64 *)(p+24), c64); \
+            _mm_stream_pi((__m64 *)(p+32), c64); \
+            _mm_stream_pi((__m64 *)(p+40), c64); \
+            _mm_stream_pi((__m64 *)(p+48), c64); \
+            _mm_stream_pi((__m64 *)(p+56), c64); \
+            p += 64; \
+        } \
+    } else { \
+        for (i = n / 64; i--;) { \
+            *(__m64 *)(p+0) = c64; \
+            *(__m64 *)(p+8) = c64; \
+            *(__m64 *)(p+16) = c64; \
+            *(__m64 *)(p+24) = c64; \
+            *(__m64 *)(p+32) = c64; \
+            *(__m64 *)(p+40) = c64; \
+            *(__m64 *)(p+48) = c64; \
+            *(__m64 *)(p+56) = c64; \
+            p += 64; \
+        } \
     }
 
 #define MMX_END \
+    if (stream) { \
+        _mm_sfence(); \
+    } \
     _mm_empty()
 
 #define DEFINE_MMX_FILLRECT(bpp, type) \
 static void \
 SDL_FillRect##bpp##MMX(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
 { \
-    MMX_BEGIN; \
+    MMX_BEGIN(bpp); \
  \
     while (h--) { \
         int i, n = w * bpp; \
@@ -188,7 +289,7 @@ SDL_FillRect##bpp##MMX(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
 static void
 SDL_FillRect1MMX(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
 {
-    MMX_BEGIN;
+    MMX_BEGIN(1);
 
     while (h--) {
         int i, n = w;
@@ -387,8 +488,13 @@ SDL_FillRect(SDL_Surface * dst, const SDL_Rect * rect, Uint32 color)
         }
 
     case 3:
-        /* 24-bit RGB is a slow path, at least for now. */
         {
+#ifdef __SSE__
+            if (SDL_HasSSE()) {
+                SDL_FillRect3SSE(pixels, dst->pitch, color, rect->w, rect->h);
+                break;
+            }
+#endif
             SDL_FillRect3(pixels, dst->pitch, color, rect->w, rect->h);
             break;
         }
@@ -420,11 +526,37 @@ int
 SDL_FillRects(SDL_Surface * dst, const SDL_Rect ** rects, int count,
               Uint32 color)
 {
+    SDL_Rect stack_rects[64];
+    SDL_Rect *merged;
     int i;
     int status = 0;
 
+    if (!dst) {
+        SDL_SetError("Passed NULL destination surface");
+        return -1;
+    }
+    if (count == 1) {
+        return SDL_FillRect(dst, rects[0], color);
+    }
+
+    if (count <= (int) SDL_arraysize(stack_rects)) {
+        merged = stack_rects;
+    } else {
+        merged = (SDL_Rect *) SDL_malloc(count * sizeof(*merged));
+        if (!merged) {
+            SDL_OutOfMemory();
+            return -1;
+        }
+    }
+
+    /* Filling is idempotent, so overlapping rects only need to be done once */
+    count = SDL_MergeRects(rects, count, &dst->clip_rect, SDL_TRUE, merged);
     for (i = 0; i < count; ++i) {
-        status = SDL_FillRect(dst, rects[i], color);
+        status = SDL_FillRect(dst, &merged[i], color);
+    }
+
+    if (merged != stack_rects) {
+        SDL_free(merged);
     }
     return status;
 }
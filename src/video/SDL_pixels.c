@@ -24,11 +24,13 @@
 /* General (mostly internal) pixel/color manipulation routines for SDL */
 
 #include "SDL_endian.h"
+#include "SDL_atomic.h"
 #include "SDL_video.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_pixels_c.h"
 #include "SDL_RLEaccel_c.h"
+#include "SDL_surfacepool_c.h"
 
 struct SDL_PaletteWatch
 {
@@ -411,21 +413,91 @@ SDL_FreePalette(SDL_Palette * palette)
 /*
  * Allocate a pixel format structure and fill it according to the given info.
  */
+/*
+ * Formats with more than 8 bits per pixel are shared by all the surfaces
+ * using them, palettized formats each need a palette of their own.
+ */
+typedef struct SDL_SharedFormat
+{
+    SDL_PixelFormat format;     /* must be first */
+
+    /* What SDL_AllocFormat() was asked for */
+    int bpp;
+    Uint32 Rmask, Gmask, Bmask, Amask;
+
+    int refcount;
+    struct SDL_SharedFormat *next;
+} SDL_SharedFormat;
+
+static SDL_SharedFormat *shared_formats;
+static SDL_SpinLock shared_formats_lock;
+
 SDL_PixelFormat *
 SDL_AllocFormat(int bpp,
                 Uint32 Rmask, Uint32 Gmask, Uint32 Bmask, Uint32 Amask)
 {
-    SDL_PixelFormat *format;
+    SDL_SharedFormat *entry;
+
+    SDL_AtomicLock(&shared_formats_lock);
+
+    /* See if there is one already */
+    if (bpp > 8) {
+        for (entry = shared_formats; entry; entry = entry->next) {
+            if (entry->bpp == bpp && entry->Rmask == Rmask &&
+                entry->Gmask == Gmask && entry->Bmask == Bmask &&
+                entry->Amask == Amask) {
+                ++entry->refcount;
+                SDL_AtomicUnlock(&shared_formats_lock);
+                return &entry->format;
+            }
+        }
+    }
 
     /* Allocate an empty pixel format structure */
-    format = SDL_malloc(sizeof(*format));
-    if (format == NULL) {
-        SDL_OutOfMemory();
+    entry = (SDL_SharedFormat *) SDL_AllocSurfaceMemory(sizeof(*entry));
+    if (entry == NULL) {
+        SDL_AtomicUnlock(&shared_formats_lock);
         return (NULL);
     }
 
     /* Set up the format */
-    return SDL_InitFormat(format, bpp, Rmask, Gmask, Bmask, Amask);
+    SDL_InitFormat(&entry->format, bpp, Rmask, Gmask, Bmask, Amask);
+    entry->bpp = bpp;
+    entry->Rmask = Rmask;
+    entry->Gmask = Gmask;
+    entry->Bmask = Bmask;
+    entry->Amask = Amask;
+    entry->refcount = 1;
+    entry->next = NULL;
+    if (bpp > 8) {
+        entry->next = shared_formats;
+        shared_formats = entry;
+    }
+
+    SDL_AtomicUnlock(&shared_formats_lock);
+
+    return &entry->format;
+}
+
+/*
+ * Take another reference to a format from SDL_AllocFormat() that is shared
+ * between surfaces, returns SDL_FALSE for any other format.
+ */
+SDL_bool
+SDL_RetainSharedFormat(SDL_PixelFormat * format)
+{
+    SDL_SharedFormat *entry;
+
+    SDL_AtomicLock(&shared_formats_lock);
+    for (entry = shared_formats; entry; entry = entry->next) {
+        if (&entry->format == format) {
+            ++entry->refcount;
+            break;
+        }
+    }
+    SDL_AtomicUnlock(&shared_formats_lock);
+
+    return entry ? SDL_TRUE : SDL_FALSE;
 }
 
 SDL_PixelFormat *
@@ -529,10 +601,27 @@ SDL_FormatChanged(SDL_Surface * surface)
 void
 SDL_FreeFormat(SDL_PixelFormat * format)
 {
+    SDL_SharedFormat *entry = (SDL_SharedFormat *) format;
+    SDL_SharedFormat **prev;
+
     if (!format) {
         return;
     }
-    SDL_free(format);
+
+    SDL_AtomicLock(&shared_formats_lock);
+    if (--entry->refcount > 0) {
+        SDL_AtomicUnlock(&shared_formats_lock);
+        return;
+    }
+    for (prev = &shared_formats; *prev; prev = &(*prev)->next) {
+        if (*prev == entry) {
+            *prev = entry->next;
+            break;
+        }
+    }
+    SDL_AtomicUnlock(&shared_formats_lock);
+
+    SDL_FreeSurfaceMemory(entry);
 }
 
 /*
@@ -571,7 +660,7 @@ SDL_CalculatePitch(SDL_Surface * surface)
 {
     int pitch;
 
-    /* Surface should be 4-byte aligned for speed */
+    /* Rows should start on a cache line for speed */
     pitch = surface->w * surface->format->BytesPerPixel;
     switch (surface->format->BitsPerPixel) {
     case 1:
@@ -583,7 +672,7 @@ SDL_CalculatePitch(SDL_Surface * surface)
     default:
         break;
     }
-    pitch = (pitch + 3) & ~3;   /* 4-byte aligning */
+    pitch = (pitch + SDL_SURFACE_ALIGNMENT - 1) & ~(SDL_SURFACE_ALIGNMENT - 1);
     return (pitch);
 }
 
@@ -804,11 +893,11 @@ SDL_AllocBlitMap(void)
     SDL_BlitMap *map;
 
     /* Allocate the empty map */
-    map = (SDL_BlitMap *) SDL_calloc(1, sizeof(*map));
+    map = (SDL_BlitMap *) SDL_AllocSurfaceMemory(sizeof(*map));
     if (map == NULL) {
-        SDL_OutOfMemory();
         return (NULL);
     }
+    SDL_zerop(map);
     map->info.r = 0xFF;
     map->info.g = 0xFF;
     map->info.b = 0xFF;
@@ -826,6 +915,10 @@ SDL_InvalidateMap(SDL_BlitMap * map)
     }
     map->dst = NULL;
     map->format_version = (unsigned int) -1;
+    if (map->dst_format) {
+        SDL_FreeFormat(map->dst_format);
+        map->dst_format = NULL;
+    }
     if (map->info.table) {
         SDL_free(map->info.table);
         map->info.table = NULL;
@@ -891,7 +984,7 @@ SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst)
             break;
         default:
             /* BitField --> BitField */
-            if (FORMAT_EQUAL(srcfmt, dstfmt))
+            if (srcfmt == dstfmt || FORMAT_EQUAL(srcfmt, dstfmt))
                 map->identity = 1;
             break;
         }
@@ -902,7 +995,16 @@ SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst)
     map->format_version = dst->format_version;
 
     /* Choose your blitters wisely */
-    return (SDL_CalculateBlit(src));
+    if (SDL_CalculateBlit(src) < 0) {
+        return (-1);
+    }
+
+    /* Keep the destination format around, so the mapping can be used for
+       other surfaces sharing it (see SDL_ValidateMap()) */
+    if (src != dst && SDL_RetainSharedFormat(dstfmt)) {
+        map->dst_format = dstfmt;
+    }
+    return (0);
 }
 
 void
@@ -910,7 +1012,7 @@ SDL_FreeBlitMap(SDL_BlitMap * map)
 {
     if (map) {
         SDL_InvalidateMap(map);
-        SDL_free(map);
+        SDL_FreeSurfaceMemory(map);
     }
 }
 
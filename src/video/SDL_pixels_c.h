@@ -33,6 +33,7 @@ extern SDL_PixelFormat *SDL_InitFormat(SDL_PixelFormat * format, int bpp,
                                        Uint32 Rmask, Uint32 Gmask,
                                        Uint32 Bmask, Uint32 Amask);
 extern void SDL_FormatChanged(SDL_Surface * surface);
+extern SDL_bool SDL_RetainSharedFormat(SDL_PixelFormat * format);
 extern void SDL_FreeFormat(SDL_PixelFormat * format);
 
 /* Blit mapping functions */
@@ -196,6 +196,43 @@ SDL_EnclosePoints(const SDL_Point * points, int count, const SDL_Rect * clip,
     return SDL_TRUE;
 }
 
+SDL_bool
+SDL_PointsInRect(const SDL_Point * points, int count, const SDL_Rect * rect)
+{
+    int minx = rect->x;
+    int maxx = rect->x + rect->w - 1;
+    int miny = rect->y;
+    int maxy = rect->y + rect->h - 1;
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        if (points[i].x < minx || points[i].x > maxx ||
+            points[i].y < miny || points[i].y > maxy) {
+            return SDL_FALSE;
+        }
+    }
+    return SDL_TRUE;
+}
+
+void
+SDL_RectOutline(const SDL_Rect * rect, SDL_Point * points)
+{
+    int x1 = rect->x;
+    int y1 = rect->y;
+    int x2 = rect->x + rect->w - 1;
+    int y2 = rect->y + rect->h - 1;
+
+    points[0].x = x1;
+    points[0].y = y1;
+    points[1].x = x2;
+    points[1].y = y1;
+    points[2].x = x2;
+    points[2].y = y2;
+    points[3].x = x1;
+    points[3].y = y2;
+    points[4] = points[0];
+}
+
 /* Use the Cohen-Sutherland algorithm for line clipping */
 #define CODE_BOTTOM 1
 #define CODE_TOP    2
@@ -337,6 +374,118 @@ SDL_IntersectRectAndLine(const SDL_Rect * rect, int *X1, int *Y1, int *X2,
     return SDL_TRUE;
 }
 
+static int
+SDL_CompareRects(const void *a, const void *b)
+{
+    const SDL_Rect *A = (const SDL_Rect *) a;
+    const SDL_Rect *B = (const SDL_Rect *) b;
+
+    if (A->y != B->y) {
+        return A->y - B->y;
+    }
+    return A->x - B->x;
+}
+
+/* Fold B into A if together they cover exactly one rectangle.
+   A must not come after B in sorted order. */
+static SDL_bool
+SDL_MergeRect(SDL_Rect * A, const SDL_Rect * B, SDL_bool overlap)
+{
+    int Amax, Bmax;
+
+    if (A->x == B->x && A->w == B->w) {
+        Amax = A->y + A->h;
+        Bmax = B->y + B->h;
+        if (B->y == Amax || (overlap && B->y < Amax)) {
+            if (Bmax > Amax) {
+                A->h = Bmax - A->y;
+            }
+            return SDL_TRUE;
+        }
+    }
+    if (A->y == B->y && A->h == B->h) {
+        Amax = A->x + A->w;
+        Bmax = B->x + B->w;
+        if (B->x == Amax || (overlap && B->x < Amax)) {
+            if (Bmax > Amax) {
+                A->w = Bmax - A->x;
+            }
+            return SDL_TRUE;
+        }
+    }
+    if (overlap) {
+        Amax = A->x + A->w;
+        Bmax = B->x + B->w;
+        if (B->x >= A->x && Bmax <= Amax &&
+            B->y + B->h <= A->y + A->h) {
+            /* B is inside A */
+            return SDL_TRUE;
+        }
+        if (A->x >= B->x && Amax <= Bmax &&
+            A->y == B->y && A->y + A->h <= B->y + B->h) {
+            /* A is inside B */
+            *A = *B;
+            return SDL_TRUE;
+        }
+    }
+    return SDL_FALSE;
+}
+
+int
+SDL_MergeRects(const SDL_Rect ** rects, int count, const SDL_Rect * clip,
+               SDL_bool overlap, SDL_Rect * merged)
+{
+    int i, j, n;
+
+    n = 0;
+    for (i = 0; i < count; ++i) {
+        /* A NULL rect covers the whole clip rect */
+        if (!rects[i]) {
+            if (overlap) {
+                merged[0] = *clip;
+                return 1;
+            }
+            merged[n++] = *clip;
+        } else if (SDL_IntersectRect(rects[i], clip, &merged[n])) {
+            ++n;
+        }
+    }
+    if (n < 2) {
+        return n;
+    }
+
+    SDL_qsort(merged, n, sizeof(*merged), SDL_CompareRects);
+
+    for (i = 0; i < n; ++i) {
+        if (merged[i].w == 0) {
+            continue;
+        }
+        for (j = i + 1; j < n; ++j) {
+            /* Sorted by y, so nothing further down can touch this one */
+            if (merged[j].y > merged[i].y + merged[i].h) {
+                break;
+            }
+            if (merged[j].w == 0) {
+                continue;
+            }
+            if (SDL_MergeRect(&merged[i], &merged[j], overlap)) {
+                merged[j].w = 0;
+                /* The rect grew, so earlier candidates may fit now */
+                j = i;
+            }
+        }
+    }
+
+    count = n;
+    n = 0;
+    for (i = 0; i < count; ++i) {
+        if (merged[i].w != 0) {
+            merged[n++] = merged[i];
+        }
+    }
+    return n;
+}
+
 void
 SDL_AddDirtyRect(SDL_DirtyRectList * list, const SDL_Rect * rect)
 {
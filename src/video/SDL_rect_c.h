@@ -33,6 +33,24 @@ typedef struct SDL_DirtyRectList
     SDL_DirtyRect *free;
 } SDL_DirtyRectList;
 
+/* Returns SDL_TRUE if every point lies within 'rect' */
+extern SDL_bool SDL_PointsInRect(const SDL_Point * points, int count,
+                                 const SDL_Rect * rect);
+
+/* Fill in the 5 points of the closed polyline through the edge pixels of
+   'rect', the same pixels SDL_DrawRect() draws */
+extern void SDL_RectOutline(const SDL_Rect * rect, SDL_Point * points);
+
+/* Clip a list of rects and combine the ones that can be filled as one,
+   returning the number of rects written to 'merged', which must have room
+   for 'count' rects.  Unless 'overlap' is set, each pixel stays covered by
+   as many rects as before, so the result is also right for blended fills.
+   With 'overlap' set, rects hidden by others are dropped as well.
+ */
+extern int SDL_MergeRects(const SDL_Rect ** rects, int count,
+                          const SDL_Rect * clip, SDL_bool overlap,
+                          SDL_Rect * merged);
+
 extern void SDL_AddDirtyRect(SDL_DirtyRectList * list, const SDL_Rect * rect);
 extern void SDL_ClearDirtyRects(SDL_DirtyRectList * list);
 extern void SDL_FreeDirtyRects(SDL_DirtyRectList * list);
@@ -97,6 +97,7 @@ static void GL_UnlockTexture(SDL_Renderer * renderer, SDL_Texture * texture);
 static void GL_DirtyTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                             int numrects, const SDL_Rect * rects);
 static int GL_RenderClear(SDL_Renderer * renderer);
+static int GL_SetDrawLineStyle(SDL_Renderer * renderer);
 static int GL_RenderDrawPoints(SDL_Renderer * renderer,
                                const SDL_Point * points, int count);
 static int GL_RenderDrawLines(SDL_Renderer * renderer,
@@ -107,8 +108,14 @@ static int GL_RenderFillRects(SDL_Renderer * renderer,
                               const SDL_Rect ** rects, int count);
 static int GL_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
                          const SDL_Rect * srcrect, const SDL_Rect * dstrect);
+static int GL_RenderCopyMany(SDL_Renderer * renderer,
+                             const SDL_TextureCopy * copies, int count);
 static int GL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                                Uint32 pixel_format, void * pixels, int pitch);
+static int GL_RenderReadPixelsAsync(SDL_Renderer * renderer,
+                                    const SDL_Rect * rect,
+                                    Uint32 pixel_format, void * pixels,
+                                    int pitch);
 static int GL_RenderWritePixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                                 Uint32 pixel_format, const void * pixels, int pitch);
 static void GL_RenderPresent(SDL_Renderer * renderer);
@@ -150,6 +157,16 @@ SDL_RenderDriver GL_RenderDriver = {
      0}
 };
 
+/* Maximum number of vertices queued before the batch is drawn */
+#define GL_BATCH_VERTICES   4096
+
+typedef struct
+{
+    GLfloat x, y;
+    GLfloat u, v;
+    GLubyte r, g, b, a;
+} GL_Vertex;
+
 typedef struct
 {
     SDL_GLContext context;
@@ -159,6 +176,7 @@ typedef struct
     SDL_bool GL_APPLE_ycbcr_422_supported;
     SDL_bool GL_MESA_ycbcr_texture_supported;
     SDL_bool GL_ARB_fragment_program_supported;
+    SDL_bool GL_ARB_pixel_buffer_object_supported;
     int blendMode;
     int scaleMode;
 
@@ -179,9 +197,38 @@ typedef struct
     PFNGLBINDPROGRAMARBPROC glBindProgramARB;
     PFNGLPROGRAMSTRINGARBPROC glProgramStringARB;
 
+    PFNGLGENBUFFERSARBPROC glGenBuffersARB;
+    PFNGLDELETEBUFFERSARBPROC glDeleteBuffersARB;
+    PFNGLBINDBUFFERARBPROC glBindBufferARB;
+    PFNGLBUFFERDATAARBPROC glBufferDataARB;
+    PFNGLMAPBUFFERARBPROC glMapBufferARB;
+    PFNGLUNMAPBUFFERARBPROC glUnmapBufferARB;
+
     /* (optional) fragment programs */
     GLuint fragment_program_mask;
     GLuint fragment_program_UYVY;
+
+    /* Primitives queued with the current draw state */
+    struct
+    {
+        GLenum mode;
+        GLenum textype;
+        SDL_Texture *texture;
+        GLuint shader;
+        int count;
+        GL_Vertex vertices[GL_BATCH_VERTICES];
+    } batch;
+
+    /* Pixel buffers for double buffered asynchronous readback */
+    struct
+    {
+        GLuint buffer;
+        int size;
+        int w, h;
+        Uint32 format;
+        SDL_bool pending;
+    } readback[2];
+    int readback_index;
 } GL_RenderData;
 
 typedef struct
@@ -196,6 +243,8 @@ typedef struct
     Uint8 *palette;
     void *pixels;
     int pitch;
+    GLuint pbo;
+    void *mapped;
     SDL_DirtyRectList dirty;
     int HACK_RYAN_FIXME;
 } GL_TextureData;
@@ -262,6 +311,101 @@ GL_LoadFunctions(GL_RenderData * data)
     return 0;
 }
 
+/* Draw everything queued in the batch with the current GL state */
+static void
+GL_FlushBatch(GL_RenderData * data)
+{
+    GL_Vertex *vertices = data->batch.vertices;
+
+    if (!data->batch.count) {
+        return;
+    }
+    data->glVertexPointer(2, GL_FLOAT, sizeof(*vertices), &vertices->x);
+    data->glTexCoordPointer(2, GL_FLOAT, sizeof(*vertices), &vertices->u);
+    data->glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(*vertices),
+                         &vertices->r);
+    data->glDrawArrays(data->batch.mode, 0, data->batch.count);
+    data->batch.count = 0;
+}
+
+/* Forget the texture binding after it was changed outside of the batch */
+static void
+GL_ResetTextureState(GL_RenderData * data, GLenum textype)
+{
+    data->batch.textype = textype;
+    data->batch.texture = NULL;
+}
+
+/* Switch the draw state, flushing anything queued with the old state */
+static void
+GL_SetDrawState(GL_RenderData * data, GLenum mode, SDL_Texture * texture,
+                GLuint shader)
+{
+    GL_TextureData *texturedata = NULL;
+    GLenum textype = 0;
+
+    if (texture) {
+        texturedata = (GL_TextureData *) texture->driverdata;
+        textype = texturedata->type;
+    }
+    if (mode != data->batch.mode) {
+        GL_FlushBatch(data);
+        data->batch.mode = mode;
+    }
+    if (textype != data->batch.textype) {
+        GL_FlushBatch(data);
+        if (data->batch.textype) {
+            data->glDisable(data->batch.textype);
+        }
+        if (textype) {
+            data->glEnable(textype);
+        }
+        data->batch.textype = textype;
+    }
+    if (texture && texture != data->batch.texture) {
+        GL_FlushBatch(data);
+        data->glBindTexture(textype, texturedata->texture);
+        data->batch.texture = texture;
+    }
+    if (shader != data->batch.shader) {
+        GL_FlushBatch(data);
+        if (shader) {
+            if (!data->batch.shader) {
+                data->glEnable(GL_FRAGMENT_PROGRAM_ARB);
+            }
+            data->glBindProgramARB(GL_FRAGMENT_PROGRAM_ARB, shader);
+        } else {
+            data->glDisable(GL_FRAGMENT_PROGRAM_ARB);
+        }
+        data->batch.shader = shader;
+    }
+}
+
+/* Reserve room for 'count' vertices of the given color in the batch.
+   The caller fills in the positions and texture coordinates. */
+static GL_Vertex *
+GL_QueueVertices(GL_RenderData * data, int count,
+                 Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    GL_Vertex *vertices;
+    int i;
+
+    if (data->batch.count + count > GL_BATCH_VERTICES) {
+        GL_FlushBatch(data);
+    }
+    vertices = &data->batch.vertices[data->batch.count];
+    data->batch.count += count;
+    for (i = 0; i < count; ++i) {
+        vertices[i].u = 0.0f;
+        vertices[i].v = 0.0f;
+        vertices[i].r = r;
+        vertices[i].g = g;
+        vertices[i].b = b;
+        vertices[i].a = a;
+    }
+    return vertices;
+}
+
 SDL_Renderer *
 GL_CreateRenderer(SDL_Window * window, Uint32 flags)
 {
@@ -310,12 +454,15 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
     renderer->UnlockTexture = GL_UnlockTexture;
     renderer->DirtyTexture = GL_DirtyTexture;
     renderer->RenderClear = GL_RenderClear;
+    renderer->SetDrawLineStyle = GL_SetDrawLineStyle;
     renderer->RenderDrawPoints = GL_RenderDrawPoints;
     renderer->RenderDrawLines = GL_RenderDrawLines;
     renderer->RenderDrawRects = GL_RenderDrawRects;
     renderer->RenderFillRects = GL_RenderFillRects;
     renderer->RenderCopy = GL_RenderCopy;
+    renderer->RenderCopyMany = GL_RenderCopyMany;
     renderer->RenderReadPixels = GL_RenderReadPixels;
+    renderer->RenderReadPixelsAsync = GL_RenderReadPixelsAsync;
     renderer->RenderWritePixels = GL_RenderWritePixels;
     renderer->RenderPresent = GL_RenderPresent;
     renderer->DestroyTexture = GL_DestroyTexture;
@@ -421,6 +568,30 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
         data->GL_ARB_fragment_program_supported = SDL_TRUE;
     }
 
+    /* pixel buffer objects let texture uploads and readback run async */
+    if (SDL_GL_ExtensionSupported("GL_ARB_pixel_buffer_object")) {
+        const char *env = SDL_getenv("SDL_VIDEO_GL_PBO");
+        if (!env || SDL_atoi(env)) {
+            data->glGenBuffersARB = (PFNGLGENBUFFERSARBPROC)
+                SDL_GL_GetProcAddress("glGenBuffersARB");
+            data->glDeleteBuffersARB = (PFNGLDELETEBUFFERSARBPROC)
+                SDL_GL_GetProcAddress("glDeleteBuffersARB");
+            data->glBindBufferARB = (PFNGLBINDBUFFERARBPROC)
+                SDL_GL_GetProcAddress("glBindBufferARB");
+            data->glBufferDataARB = (PFNGLBUFFERDATAARBPROC)
+                SDL_GL_GetProcAddress("glBufferDataARB");
+            data->glMapBufferARB = (PFNGLMAPBUFFERARBPROC)
+                SDL_GL_GetProcAddress("glMapBufferARB");
+            data->glUnmapBufferARB = (PFNGLUNMAPBUFFERARBPROC)
+                SDL_GL_GetProcAddress("glUnmapBufferARB");
+            if (data->glGenBuffersARB && data->glDeleteBuffersARB &&
+                data->glBindBufferARB && data->glBufferDataARB &&
+                data->glMapBufferARB && data->glUnmapBufferARB) {
+                data->GL_ARB_pixel_buffer_object_supported = SDL_TRUE;
+            }
+        }
+    }
+
     /* Set up parameters for rendering */
     data->blendMode = -1;
     data->scaleMode = -1;
@@ -428,11 +599,10 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
     data->glDisable(GL_CULL_FACE);
     /* This ended up causing video discrepancies between OpenGL and Direct3D */
     /*data->glEnable(GL_LINE_SMOOTH);*/
-    if (data->GL_ARB_texture_rectangle_supported) {
-        data->glEnable(GL_TEXTURE_RECTANGLE_ARB);
-    } else {
-        data->glEnable(GL_TEXTURE_2D);
-    }
+    data->glEnableClientState(GL_VERTEX_ARRAY);
+    data->glEnableClientState(GL_COLOR_ARRAY);
+    data->glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    data->batch.mode = GL_POINTS;
     data->updateSize = SDL_TRUE;
 
     return renderer;
@@ -448,6 +618,7 @@ GL_ActivateRenderer(SDL_Renderer * renderer)
         return -1;
     }
     if (data->updateSize) {
+        GL_FlushBatch(data);
         data->glMatrixMode(GL_PROJECTION);
         data->glLoadIdentity();
         data->glMatrixMode(GL_MODELVIEW);
@@ -801,11 +972,21 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 
     if (texture->access == SDL_TEXTUREACCESS_STREAMING) {
         data->pitch = texture->w * bytes_per_pixel(texture->format);
-        data->pixels = SDL_malloc(texture->h * data->pitch);
-        if (!data->pixels) {
-            SDL_OutOfMemory();
-            SDL_free(data);
-            return -1;
+        if (renderdata->GL_ARB_pixel_buffer_object_supported) {
+            /* The pixels are uploaded from here when the texture is unlocked */
+            renderdata->glGenBuffersARB(1, &data->pbo);
+            renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, data->pbo);
+            renderdata->glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB,
+                                        texture->h * data->pitch, NULL,
+                                        GL_STREAM_DRAW_ARB);
+            renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+        } else {
+            data->pixels = SDL_malloc(texture->h * data->pitch);
+            if (!data->pixels) {
+                SDL_OutOfMemory();
+                SDL_free(data);
+                return -1;
+            }
         }
     }
 
@@ -840,6 +1021,7 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 
     data->format = format;
     data->formattype = type;
+    GL_FlushBatch(renderdata);
     renderdata->glEnable(data->type);
     renderdata->glBindTexture(data->type, data->texture);
     renderdata->glTexParameteri(data->type, GL_TEXTURE_MIN_FILTER,
@@ -889,6 +1071,7 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
                                  texture_h, 0, format, type, NULL);
     }
     renderdata->glDisable(data->type);
+    GL_ResetTextureState(renderdata, 0);
     result = renderdata->glGetError();
     if (result != GL_NO_ERROR) {
         GL_SetError("glTexImage2D()", result);
@@ -903,6 +1086,10 @@ GL_QueryTexturePixels(SDL_Renderer * renderer, SDL_Texture * texture,
 {
     GL_TextureData *data = (GL_TextureData *) texture->driverdata;
 
+    if (data->pbo) {
+        SDL_SetError("Texture pixels are only available while locked");
+        return -1;
+    }
     *pixels = data->pixels;
     *pitch = data->pitch;
     return 0;
@@ -927,8 +1114,9 @@ GL_SetTexturePalette(SDL_Renderer * renderer, SDL_Texture * texture,
         *palette++ = colors->b;
         ++colors;
     }
-    renderdata->glEnable(data->type);
-    renderdata->glBindTexture(data->type, data->texture);
+    GL_SetDrawState(renderdata, renderdata->batch.mode, texture,
+                    renderdata->batch.shader);
+    GL_FlushBatch(renderdata);
     renderdata->glColorTableEXT(data->type, GL_RGB8, 256, GL_RGB,
                                 GL_UNSIGNED_BYTE, data->palette);
     return 0;
@@ -973,6 +1161,44 @@ SetupTextureUpdate(GL_RenderData * renderdata, SDL_Texture * texture,
                               HACK_RYAN_FIXME);
 }
 
+/* Upload the dirty parts of a streaming texture */
+static void
+GL_UploadDirtyRects(GL_RenderData * data, SDL_Texture * texture)
+{
+    GL_TextureData *texturedata = (GL_TextureData *) texture->driverdata;
+    SDL_DirtyRect *dirty;
+    Uint8 *pixels;
+    int bpp = bytes_per_pixel(texture->format);
+    int pitch = texturedata->pitch;
+
+    if (!texturedata->dirty.list || texturedata->mapped) {
+        return;
+    }
+
+    GL_SetDrawState(data, data->batch.mode, texture, data->batch.shader);
+
+    /* Earlier copies of this texture must use the old contents */
+    GL_FlushBatch(data);
+    SetupTextureUpdate(data, texture, pitch);
+    if (texturedata->pbo) {
+        /* Pixel offsets are relative to the start of the buffer object */
+        data->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, texturedata->pbo);
+    }
+    for (dirty = texturedata->dirty.list; dirty; dirty = dirty->next) {
+        SDL_Rect *rect = &dirty->rect;
+        pixels =
+            (Uint8 *) texturedata->pixels + rect->y * pitch + rect->x * bpp;
+        data->glTexSubImage2D(texturedata->type, 0, rect->x, rect->y,
+                              rect->w / texturedata->HACK_RYAN_FIXME,
+                              rect->h, texturedata->format,
+                              texturedata->formattype, pixels);
+    }
+    if (texturedata->pbo) {
+        data->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+    }
+    SDL_ClearDirtyRects(&texturedata->dirty);
+}
+
 static int
 GL_SetTextureColorMod(SDL_Renderer * renderer, SDL_Texture * texture)
 {
@@ -1029,6 +1255,27 @@ GL_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
     GL_TextureData *data = (GL_TextureData *) texture->driverdata;
     GLenum result;
 
+    if (data->pbo) {
+        /* Go through the buffer object so the upload is asynchronous */
+        int length = rect->w * bytes_per_pixel(texture->format);
+        int row;
+        Uint8 *dst;
+        int dstpitch;
+
+        if (GL_LockTexture(renderer, texture, rect, 1,
+                           (void **) &dst, &dstpitch) < 0) {
+            return -1;
+        }
+        for (row = 0; row < rect->h; ++row) {
+            SDL_memcpy(dst, pixels, length);
+            dst += dstpitch;
+            pixels = (const Uint8 *) pixels + pitch;
+        }
+        GL_UnlockTexture(renderer, texture);
+        return 0;
+    }
+
+    GL_FlushBatch(renderdata);
     renderdata->glGetError();
     SetupTextureUpdate(renderdata, texture, pitch);
     renderdata->glEnable(data->type);
@@ -1037,6 +1284,7 @@ GL_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                                 rect->h, data->format, data->formattype,
                                 pixels);
     renderdata->glDisable(data->type);
+    GL_ResetTextureState(renderdata, 0);
     result = renderdata->glGetError();
     if (result != GL_NO_ERROR) {
         GL_SetError("glTexSubImage2D()", result);
@@ -1050,14 +1298,43 @@ GL_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                const SDL_Rect * rect, int markDirty, void **pixels,
                int *pitch)
 {
+    GL_RenderData *renderdata = (GL_RenderData *) renderer->driverdata;
     GL_TextureData *data = (GL_TextureData *) texture->driverdata;
+    Uint8 *base = (Uint8 *) data->pixels;
+
+    if (data->pbo) {
+        if (!data->mapped) {
+            GLenum access = GL_READ_WRITE_ARB;
+
+            renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB,
+                                        data->pbo);
+            if (!data->dirty.list && rect->x == 0 && rect->y == 0 &&
+                rect->w == texture->w && rect->h == texture->h) {
+                /* The whole texture is being replaced, so orphan the
+                   buffer and mapping doesn't wait on the last upload */
+                renderdata->glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB,
+                                            texture->h * data->pitch, NULL,
+                                            GL_STREAM_DRAW_ARB);
+                access = GL_WRITE_ONLY_ARB;
+            }
+            data->mapped =
+                renderdata->glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB,
+                                           access);
+            renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+            if (!data->mapped) {
+                SDL_SetError("Couldn't map texture pixel buffer");
+                return -1;
+            }
+        }
+        base = (Uint8 *) data->mapped;
+    }
 
     if (markDirty) {
         SDL_AddDirtyRect(&data->dirty, rect);
     }
 
     *pixels =
-        (void *) ((Uint8 *) data->pixels + rect->y * data->pitch +
+        (void *) (base + rect->y * data->pitch +
                   rect->x * bytes_per_pixel(texture->format));
     *pitch = data->pitch;
     return 0;
@@ -1066,6 +1343,18 @@ GL_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
 static void
 GL_UnlockTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 {
+    GL_RenderData *renderdata = (GL_RenderData *) renderer->driverdata;
+    GL_TextureData *data = (GL_TextureData *) texture->driverdata;
+
+    if (data->mapped) {
+        renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, data->pbo);
+        renderdata->glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB);
+        renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+        data->mapped = NULL;
+
+        /* Start the upload now so it overlaps with other work */
+        GL_UploadDirtyRects(renderdata, texture);
+    }
 }
 
 static void
@@ -1083,23 +1372,21 @@ GL_DirtyTexture(SDL_Renderer * renderer, SDL_Texture * texture, int numrects,
 static void
 GL_SetBlendMode(GL_RenderData * data, int blendMode, int isprimitive)
 {
+    if (isprimitive && blendMode == SDL_BLENDMODE_MASK) {
+        /* The same as SDL_BLENDMODE_NONE */
+        blendMode = SDL_BLENDMODE_NONE;
+    }
     if (blendMode != data->blendMode) {
+        GL_FlushBatch(data);
         switch (blendMode) {
         case SDL_BLENDMODE_NONE:
             data->glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
             data->glDisable(GL_BLEND);
             break;
         case SDL_BLENDMODE_MASK:
-            if (isprimitive) {
-                /* The same as SDL_BLENDMODE_NONE */
-                blendMode = SDL_BLENDMODE_NONE;
-                data->glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
-                data->glDisable(GL_BLEND);
-            } else {
-                data->glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
-                data->glEnable(GL_BLEND);
-                data->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            }
+            data->glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+            data->glEnable(GL_BLEND);
+            data->glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
             break;
         case SDL_BLENDMODE_BLEND:
             data->glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
@@ -1121,11 +1408,29 @@ GL_SetBlendMode(GL_RenderData * data, int blendMode, int isprimitive)
     }
 }
 
+static int
+GL_SetDrawLineStyle(SDL_Renderer * renderer)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+
+    GL_FlushBatch(data);
+
+    data->glLineWidth((GLfloat) renderer->lineWidth);
+    if (renderer->lineFlags & SDL_LINE_ANTIALIAS) {
+        data->glEnable(GL_LINE_SMOOTH);
+    } else {
+        data->glDisable(GL_LINE_SMOOTH);
+    }
+    return 0;
+}
+
 static int
 GL_RenderClear(SDL_Renderer * renderer)
 {
     GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
 
+    GL_FlushBatch(data);
+
     data->glClearColor((GLfloat) renderer->r * inv255f,
                        (GLfloat) renderer->g * inv255f,
                        (GLfloat) renderer->b * inv255f,
@@ -1141,20 +1446,18 @@ GL_RenderDrawPoints(SDL_Renderer * renderer, const SDL_Point * points,
                     int count)
 {
     GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GL_Vertex *vertex;
     int i;
 
+    GL_SetDrawState(data, GL_POINTS, NULL, 0);
     GL_SetBlendMode(data, renderer->blendMode, 1);
 
-    data->glColor4f((GLfloat) renderer->r * inv255f,
-                    (GLfloat) renderer->g * inv255f,
-                    (GLfloat) renderer->b * inv255f,
-                    (GLfloat) renderer->a * inv255f);
-
-    data->glBegin(GL_POINTS);
     for (i = 0; i < count; ++i) {
-        data->glVertex2f(0.5f + points[i].x, 0.5f + points[i].y);
+        vertex = GL_QueueVertices(data, 1, renderer->r, renderer->g,
+                                  renderer->b, renderer->a);
+        vertex->x = 0.5f + points[i].x;
+        vertex->y = 0.5f + points[i].y;
     }
-    data->glEnd();
 
     return 0;
 }
@@ -1164,60 +1467,74 @@ GL_RenderDrawLines(SDL_Renderer * renderer, const SDL_Point * points,
                    int count)
 {
     GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GL_Vertex *vertex;
     int i;
 
+    GL_SetDrawState(data, GL_LINES, NULL, 0);
     GL_SetBlendMode(data, renderer->blendMode, 1);
 
-    data->glColor4f((GLfloat) renderer->r * inv255f,
-                    (GLfloat) renderer->g * inv255f,
-                    (GLfloat) renderer->b * inv255f,
-                    (GLfloat) renderer->a * inv255f);
+    /* Each segment is queued separately so lines from multiple calls
+       can be drawn together.  A closed polyline doesn't need any extra
+       handling since the final segment ends at the first point.
+     */
+    for (i = 1; i < count; ++i) {
+        vertex = GL_QueueVertices(data, 2, renderer->r, renderer->g,
+                                  renderer->b, renderer->a);
+        vertex[0].x = 0.5f + points[i-1].x;
+        vertex[0].y = 0.5f + points[i-1].y;
+        vertex[1].x = 0.5f + points[i].x;
+        vertex[1].y = 0.5f + points[i].y;
+    }
 
     if (count > 2 && 
         points[0].x == points[count-1].x && points[0].y == points[count-1].y) {
-        data->glBegin(GL_LINE_LOOP);
-        /* GL_LINE_LOOP takes care of the final segment */
-        --count;
-        for (i = 0; i < count; ++i) {
-            data->glVertex2f(0.5f + points[i].x, 0.5f + points[i].y);
-        }
-        data->glEnd();
-    } else {
-        data->glBegin(GL_LINE_STRIP);
-        for (i = 0; i < count; ++i) {
-            data->glVertex2f(0.5f + points[i].x, 0.5f + points[i].y);
-        }
-        data->glEnd();
-
-        /* The line is half open, so we need one more point to complete it.
-         * http://www.opengl.org/documentation/specs/version1.1/glspec1.1/node47.html
-         * If we have to, we can use vertical line and horizontal line textures
-         * for vertical and horizontal lines, and then create custom textures
-         * for diagonal lines and software render those.  It's terrible, but at
-         * least it would be pixel perfect.
-         */
-        data->glBegin(GL_POINTS);
+        return 0;
+    }
+
+    /* The line is half open, so we need one more point to complete it.
+     * http://www.opengl.org/documentation/specs/version1.1/glspec1.1/node47.html
+     * If we have to, we can use vertical line and horizontal line textures
+     * for vertical and horizontal lines, and then create custom textures
+     * for diagonal lines and software render those.  It's terrible, but at
+     * least it would be pixel perfect.
+     */
+    {
 #if defined(__APPLE__) || defined(__WIN32__)
         /* Mac OS X and Windows seem to always leave the second point open */
-        data->glVertex2f(0.5f + points[count-1].x, 0.5f + points[count-1].y);
+        int x = points[count-1].x;
+        int y = points[count-1].y;
 #else
         /* Linux seems to leave the right-most or bottom-most point open */
         int x1 = points[0].x;
         int y1 = points[0].y;
         int x2 = points[count-1].x;
         int y2 = points[count-1].y;
+        int x, y;
 
         if (x1 > x2) {
-            data->glVertex2f(0.5f + x1, 0.5f + y1);
+            x = x1;
+            y = y1;
         } else if (x2 > x1) {
-            data->glVertex2f(0.5f + x2, 0.5f + y2);
+            x = x2;
+            y = y2;
         } else if (y1 > y2) {
-            data->glVertex2f(0.5f + x1, 0.5f + y1);
+            x = x1;
+            y = y1;
         } else if (y2 > y1) {
-            data->glVertex2f(0.5f + x2, 0.5f + y2);
+            x = x2;
+            y = y2;
+        } else {
+            return 0;
         }
 #endif
-        data->glEnd();
+        /* A segment to the next pixel center draws just this pixel, and
+           keeps the batch in GL_LINES so it isn't flushed. */
+        vertex = GL_QueueVertices(data, 2, renderer->r, renderer->g,
+                                  renderer->b, renderer->a);
+        vertex[0].x = 0.5f + x;
+        vertex[0].y = 0.5f + y;
+        vertex[1].x = 1.5f + x;
+        vertex[1].y = 0.5f + y;
     }
 
     return 0;
@@ -1227,36 +1544,40 @@ static int
 GL_RenderDrawRects(SDL_Renderer * renderer, const SDL_Rect ** rects, int count)
 {
     GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
-    int i, x, y;
+    GL_Vertex *vertex;
+    GLfloat minx, miny, maxx, maxy;
+    int i;
 
+    GL_SetDrawState(data, GL_LINES, NULL, 0);
     GL_SetBlendMode(data, renderer->blendMode, 1);
 
-    data->glColor4f((GLfloat) renderer->r * inv255f,
-                    (GLfloat) renderer->g * inv255f,
-                    (GLfloat) renderer->b * inv255f,
-                    (GLfloat) renderer->a * inv255f);
-
-    data->glBegin(GL_LINE_LOOP);
     for (i = 0; i < count; ++i) {
         const SDL_Rect *rect = rects[i];
 
-        x = rect->x;
-        y = rect->y;
-        data->glVertex2f(0.5f + x, 0.5f + y);
-
-        x = rect->x+rect->w-1;
-        y = rect->y;
-        data->glVertex2f(0.5f + x, 0.5f + y);
-
-        x = rect->x+rect->w-1;
-        y = rect->y+rect->h-1;
-        data->glVertex2f(0.5f + x, 0.5f + y);
-
-        x = rect->x;
-        y = rect->y+rect->h-1;
-        data->glVertex2f(0.5f + x, 0.5f + y);
+        minx = 0.5f + rect->x;
+        miny = 0.5f + rect->y;
+        maxx = 0.5f + (rect->x+rect->w-1);
+        maxy = 0.5f + (rect->y+rect->h-1);
+
+        vertex = GL_QueueVertices(data, 8, renderer->r, renderer->g,
+                                  renderer->b, renderer->a);
+        vertex[0].x = minx;
+        vertex[0].y = miny;
+        vertex[1].x = maxx;
+        vertex[1].y = miny;
+        vertex[2].x = maxx;
+        vertex[2].y = miny;
+        vertex[3].x = maxx;
+        vertex[3].y = maxy;
+        vertex[4].x = maxx;
+        vertex[4].y = maxy;
+        vertex[5].x = minx;
+        vertex[5].y = maxy;
+        vertex[6].x = minx;
+        vertex[6].y = maxy;
+        vertex[7].x = minx;
+        vertex[7].y = miny;
     }
-    data->glEnd();
 
     return 0;
 }
@@ -1265,19 +1586,25 @@ static int
 GL_RenderFillRects(SDL_Renderer * renderer, const SDL_Rect ** rects, int count)
 {
     GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GL_Vertex *vertex;
     int i;
 
+    GL_SetDrawState(data, GL_QUADS, NULL, 0);
     GL_SetBlendMode(data, renderer->blendMode, 1);
 
-    data->glColor4f((GLfloat) renderer->r * inv255f,
-                    (GLfloat) renderer->g * inv255f,
-                    (GLfloat) renderer->b * inv255f,
-                    (GLfloat) renderer->a * inv255f);
-
     for (i = 0; i < count; ++i) {
         const SDL_Rect *rect = rects[i];
 
-        data->glRecti(rect->x, rect->y, rect->x + rect->w, rect->y + rect->h);
+        vertex = GL_QueueVertices(data, 4, renderer->r, renderer->g,
+                                  renderer->b, renderer->a);
+        vertex[0].x = (GLfloat) rect->x;
+        vertex[0].y = (GLfloat) rect->y;
+        vertex[1].x = (GLfloat) (rect->x + rect->w);
+        vertex[1].y = (GLfloat) rect->y;
+        vertex[2].x = (GLfloat) (rect->x + rect->w);
+        vertex[2].y = (GLfloat) (rect->y + rect->h);
+        vertex[3].x = (GLfloat) rect->x;
+        vertex[3].y = (GLfloat) (rect->y + rect->h);
     }
 
     return 0;
@@ -1289,60 +1616,11 @@ GL_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
 {
     GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
     GL_TextureData *texturedata = (GL_TextureData *) texture->driverdata;
+    GL_Vertex *vertex;
     GLuint shader = 0;
-    int minx, miny, maxx, maxy;
+    GLfloat minx, miny, maxx, maxy;
     GLfloat minu, maxu, minv, maxv;
 
-    if (texturedata->dirty.list) {
-        SDL_DirtyRect *dirty;
-        void *pixels;
-        int bpp = bytes_per_pixel(texture->format);
-        int pitch = texturedata->pitch;
-
-        SetupTextureUpdate(data, texture, pitch);
-        data->glEnable(texturedata->type);
-        data->glBindTexture(texturedata->type, texturedata->texture);
-        for (dirty = texturedata->dirty.list; dirty; dirty = dirty->next) {
-            SDL_Rect *rect = &dirty->rect;
-            pixels =
-                (void *) ((Uint8 *) texturedata->pixels + rect->y * pitch +
-                          rect->x * bpp);
-            data->glTexSubImage2D(texturedata->type, 0, rect->x, rect->y,
-                                  rect->w / texturedata->HACK_RYAN_FIXME,
-                                  rect->h, texturedata->format,
-                                  texturedata->formattype, pixels);
-        }
-        SDL_ClearDirtyRects(&texturedata->dirty);
-    }
-
-    minx = dstrect->x;
-    miny = dstrect->y;
-    maxx = dstrect->x + dstrect->w;
-    maxy = dstrect->y + dstrect->h;
-
-    minu = (GLfloat) srcrect->x / texture->w;
-    minu *= texturedata->texw;
-    maxu = (GLfloat) (srcrect->x + srcrect->w) / texture->w;
-    maxu *= texturedata->texw;
-    minv = (GLfloat) srcrect->y / texture->h;
-    minv *= texturedata->texh;
-    maxv = (GLfloat) (srcrect->y + srcrect->h) / texture->h;
-    maxv *= texturedata->texh;
-
-    data->glEnable(texturedata->type);
-    data->glBindTexture(texturedata->type, texturedata->texture);
-
-    if (texture->modMode) {
-        data->glColor4f((GLfloat) texture->r * inv255f,
-                        (GLfloat) texture->g * inv255f,
-                        (GLfloat) texture->b * inv255f,
-                        (GLfloat) texture->a * inv255f);
-    } else {
-        data->glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
-    }
-
-    GL_SetBlendMode(data, texture->blendMode, 0);
-
     /* Set up the shader for the copy, we have a special one for MASK */
     shader = texturedata->shader;
     if (texture->blendMode == SDL_BLENDMODE_MASK && !shader) {
@@ -1360,7 +1638,13 @@ GL_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
         }
     }
 
+    GL_SetDrawState(data, GL_QUADS, texture, shader);
+    GL_UploadDirtyRects(data, texture);
+
+    GL_SetBlendMode(data, texture->blendMode, 0);
+
     if (texture->scaleMode != data->scaleMode) {
+        GL_FlushBatch(data);
         switch (texture->scaleMode) {
         case SDL_TEXTURESCALEMODE_NONE:
         case SDL_TEXTURESCALEMODE_FAST:
@@ -1380,28 +1664,59 @@ GL_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
         data->scaleMode = texture->scaleMode;
     }
 
-    if (shader) {
-        data->glEnable(GL_FRAGMENT_PROGRAM_ARB);
-        data->glBindProgramARB(GL_FRAGMENT_PROGRAM_ARB, shader);
-    }
+    minx = (GLfloat) dstrect->x;
+    miny = (GLfloat) dstrect->y;
+    maxx = (GLfloat) (dstrect->x + dstrect->w);
+    maxy = (GLfloat) (dstrect->y + dstrect->h);
 
-    data->glBegin(GL_TRIANGLE_STRIP);
-    data->glTexCoord2f(minu, minv);
-    data->glVertex2f((GLfloat) minx, (GLfloat) miny);
-    data->glTexCoord2f(maxu, minv);
-    data->glVertex2f((GLfloat) maxx, (GLfloat) miny);
-    data->glTexCoord2f(minu, maxv);
-    data->glVertex2f((GLfloat) minx, (GLfloat) maxy);
-    data->glTexCoord2f(maxu, maxv);
-    data->glVertex2f((GLfloat) maxx, (GLfloat) maxy);
-    data->glEnd();
+    minu = (GLfloat) srcrect->x / texture->w;
+    minu *= texturedata->texw;
+    maxu = (GLfloat) (srcrect->x + srcrect->w) / texture->w;
+    maxu *= texturedata->texw;
+    minv = (GLfloat) srcrect->y / texture->h;
+    minv *= texturedata->texh;
+    maxv = (GLfloat) (srcrect->y + srcrect->h) / texture->h;
+    maxv *= texturedata->texh;
 
-    if (shader) {
-        data->glDisable(GL_FRAGMENT_PROGRAM_ARB);
-    }
+    if (texture->modMode) {
+        vertex = GL_QueueVertices(data, 4, texture->r, texture->g,
+                                  texture->b, texture->a);
+    } else {
+        vertex = GL_QueueVertices(data, 4, 255, 255, 255, 255);
+    }
+    vertex[0].x = minx;
+    vertex[0].y = miny;
+    vertex[0].u = minu;
+    vertex[0].v = minv;
+    vertex[1].x = maxx;
+    vertex[1].y = miny;
+    vertex[1].u = maxu;
+    vertex[1].v = minv;
+    vertex[2].x = maxx;
+    vertex[2].y = maxy;
+    vertex[2].u = maxu;
+    vertex[2].v = maxv;
+    vertex[3].x = minx;
+    vertex[3].y = maxy;
+    vertex[3].u = minu;
+    vertex[3].v = maxv;
 
-    data->glDisable(texturedata->type);
+    return 0;
+}
 
+static int
+GL_RenderCopyMany(SDL_Renderer * renderer, const SDL_TextureCopy * copies,
+                  int count)
+{
+    int i;
+
+    /* The copies are queued into as few batches as their state allows */
+    for (i = 0; i < count; ++i) {
+        if (GL_RenderCopy(renderer, copies[i].texture, &copies[i].srcrect,
+                          &copies[i].dstrect) < 0) {
+            return -1;
+        }
+    }
     return 0;
 }
 
@@ -1422,6 +1737,8 @@ GL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
         return -1;
     }
 
+    GL_FlushBatch(data);
+
     if (pixel_format == SDL_PIXELFORMAT_INDEX1LSB) {
         data->glPixelStorei(GL_PACK_LSB_FIRST, 1);
     } else if (pixel_format == SDL_PIXELFORMAT_INDEX1MSB) {
@@ -1452,6 +1769,93 @@ GL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
     return 0;
 }
 
+static int
+GL_RenderReadPixelsAsync(SDL_Renderer * renderer, const SDL_Rect * rect,
+                         Uint32 pixel_format, void * pixels, int pitch)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    SDL_Window *window = renderer->window;
+    GLint internalFormat;
+    GLenum format, type;
+    Uint8 *src, *dst;
+    int length, size, row;
+    int retval = 1;
+    int current = data->readback_index;
+    int previous = !current;
+
+    if (!data->GL_ARB_pixel_buffer_object_supported) {
+        return GL_RenderReadPixels(renderer, rect, pixel_format, pixels,
+                                   pitch);
+    }
+
+    if (!convert_format(data, pixel_format, &internalFormat, &format, &type)) {
+        /* FIXME: Do a temp copy to a format that is supported */
+        SDL_SetError("Unsupported pixel format");
+        return -1;
+    }
+
+    GL_FlushBatch(data);
+
+    /* Start reading this frame into a buffer object, which doesn't wait */
+    length = rect->w * bytes_per_pixel(pixel_format);
+    size = rect->h * length;
+    if (!data->readback[current].buffer) {
+        data->glGenBuffersARB(1, &data->readback[current].buffer);
+    }
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB,
+                          data->readback[current].buffer);
+    if (size > data->readback[current].size) {
+        data->glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB, size, NULL,
+                              GL_STREAM_READ_ARB);
+        data->readback[current].size = size;
+    }
+
+    if (pixel_format == SDL_PIXELFORMAT_INDEX1LSB) {
+        data->glPixelStorei(GL_PACK_LSB_FIRST, 1);
+    } else if (pixel_format == SDL_PIXELFORMAT_INDEX1MSB) {
+        data->glPixelStorei(GL_PACK_LSB_FIRST, 0);
+    }
+    data->glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    data->glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+
+    data->glReadPixels(rect->x, (window->h-rect->y)-rect->h, rect->w, rect->h,
+                       format, type, NULL);
+    data->readback[current].w = rect->w;
+    data->readback[current].h = rect->h;
+    data->readback[current].format = pixel_format;
+    data->readback[current].pending = SDL_TRUE;
+
+    /* The previous read has had a whole frame to finish */
+    if (data->readback[previous].pending) {
+        if (data->readback[previous].w == rect->w &&
+            data->readback[previous].h == rect->h &&
+            data->readback[previous].format == pixel_format) {
+            data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB,
+                                  data->readback[previous].buffer);
+            src = (Uint8 *) data->glMapBufferARB(GL_PIXEL_PACK_BUFFER_ARB,
+                                                 GL_READ_ONLY_ARB);
+            if (src) {
+                /* Flip the rows to be top-down */
+                dst = (Uint8 *) pixels;
+                for (row = rect->h - 1; row >= 0; --row) {
+                    SDL_memcpy(dst, src + row * length, length);
+                    dst += pitch;
+                }
+                data->glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB);
+                retval = 0;
+            } else {
+                SDL_SetError("Couldn't map readback pixel buffer");
+                retval = -1;
+            }
+        }
+        data->readback[previous].pending = SDL_FALSE;
+    }
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+    data->readback_index = previous;
+    return retval;
+}
+
 static int
 GL_RenderWritePixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                      Uint32 pixel_format, const void * pixels, int pitch)
@@ -1469,6 +1873,10 @@ GL_RenderWritePixels(SDL_Renderer * renderer, const SDL_Rect * rect,
         return -1;
     }
 
+    /* glDrawPixels() fragments would be textured too */
+    GL_SetDrawState(data, data->batch.mode, NULL, 0);
+    GL_FlushBatch(data);
+
     if (pixel_format == SDL_PIXELFORMAT_INDEX1LSB) {
         data->glPixelStorei(GL_UNPACK_LSB_FIRST, 1);
     } else if (pixel_format == SDL_PIXELFORMAT_INDEX1MSB) {
@@ -1500,6 +1908,10 @@ GL_RenderWritePixels(SDL_Renderer * renderer, const SDL_Rect * rect,
 static void
 GL_RenderPresent(SDL_Renderer * renderer)
 {
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+
+    GL_FlushBatch(data);
+
     SDL_GL_SwapWindow(renderer->window);
 }
 
@@ -1512,9 +1924,22 @@ GL_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     if (!data) {
         return;
     }
+    if (renderdata->batch.texture == texture) {
+        GL_FlushBatch(renderdata);
+        GL_ResetTextureState(renderdata, renderdata->batch.textype);
+    }
     if (data->texture) {
         renderdata->glDeleteTextures(1, &data->texture);
     }
+    if (data->pbo) {
+        if (data->mapped) {
+            renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB,
+                                        data->pbo);
+            renderdata->glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB);
+            renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+        }
+        renderdata->glDeleteBuffersARB(1, &data->pbo);
+    }
     if (data->palette) {
         SDL_free(data->palette);
     }
@@ -1548,6 +1973,16 @@ GL_DestroyRenderer(SDL_Renderer * renderer)
                 }
             }
 
+            if (data->GL_ARB_pixel_buffer_object_supported) {
+                int i;
+                for (i = 0; i < SDL_arraysize(data->readback); ++i) {
+                    if (data->readback[i].buffer) {
+                        data->glDeleteBuffersARB(1,
+                                                 &data->readback[i].buffer);
+                    }
+                }
+            }
+
             /* SDL_GL_MakeCurrent(0, NULL); *//* doesn't do anything */
             SDL_GL_DeleteContext(data->context);
         }
@@ -96,6 +96,8 @@ static int GLES_RenderFillRects(SDL_Renderer * renderer,
 static int GLES_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
                            const SDL_Rect * srcrect,
                            const SDL_Rect * dstrect);
+static int GLES_RenderCopyMany(SDL_Renderer * renderer,
+                               const SDL_TextureCopy * copies, int count);
 static void GLES_RenderPresent(SDL_Renderer * renderer);
 static void GLES_DestroyTexture(SDL_Renderer * renderer,
                                 SDL_Texture * texture);
@@ -251,6 +253,7 @@ GLES_CreateRenderer(SDL_Window * window, Uint32 flags)
     renderer->RenderDrawRects = GLES_RenderDrawRects;
     renderer->RenderFillRects = GLES_RenderFillRects;
     renderer->RenderCopy = GLES_RenderCopy;
+    renderer->RenderCopyMany = GLES_RenderCopyMany;
     renderer->RenderPresent = GLES_RenderPresent;
     renderer->DestroyTexture = GLES_DestroyTexture;
     renderer->DestroyRenderer = GLES_DestroyRenderer;
@@ -787,15 +790,11 @@ GLES_RenderFillRects(SDL_Renderer * renderer, const SDL_Rect ** rects,
     return 0;
 }
 
-static int
-GLES_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
-                const SDL_Rect * srcrect, const SDL_Rect * dstrect)
+/* Bind a texture and set up the state for copying from it */
+static void
+GLES_SetupCopy(GLES_RenderData * data, SDL_Texture * texture)
 {
-
-    GLES_RenderData *data = (GLES_RenderData *) renderer->driverdata;
     GLES_TextureData *texturedata = (GLES_TextureData *) texture->driverdata;
-    int minx, miny, maxx, maxy;
-    GLfloat minu, maxu, minv, maxv;
     int i;
     void *temp_buffer;          /* used for reformatting dirty rect pixels */
     void *temp_ptr;
@@ -869,55 +868,106 @@ GLES_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
                               GL_LINEAR);
         break;
     }
+}
 
-    if (data->GL_OES_draw_texture_supported && data->useDrawTexture) {
-        /* this code is a little funny because the viewport is upside down vs SDL's coordinate system */
-        SDL_Window *window = renderer->window;
-        GLint cropRect[4];
-        cropRect[0] = srcrect->x;
-        cropRect[1] = srcrect->y + srcrect->h;
-        cropRect[2] = srcrect->w;
-        cropRect[3] = -srcrect->h;
-        data->glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_CROP_RECT_OES,
-                               cropRect);
-        data->glDrawTexiOES(dstrect->x, window->h - dstrect->y - dstrect->h,
-                            0, dstrect->w, dstrect->h);
-    } else {
+/* Draw a copy with GL_OES_draw_texture */
+static void
+GLES_DrawTexture(SDL_Renderer * renderer, const SDL_Rect * srcrect,
+                 const SDL_Rect * dstrect)
+{
+    /* this code is a little funny because the viewport is upside down vs SDL's coordinate system */
+    GLES_RenderData *data = (GLES_RenderData *) renderer->driverdata;
+    SDL_Window *window = renderer->window;
+    GLint cropRect[4];
+
+    cropRect[0] = srcrect->x;
+    cropRect[1] = srcrect->y + srcrect->h;
+    cropRect[2] = srcrect->w;
+    cropRect[3] = -srcrect->h;
+    data->glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_CROP_RECT_OES,
+                           cropRect);
+    data->glDrawTexiOES(dstrect->x, window->h - dstrect->y - dstrect->h,
+                        0, dstrect->w, dstrect->h);
+}
+
+/* Fill in the corners of a copy, in triangle strip order */
+static void
+GLES_SetCopyVertices(SDL_Texture * texture, const SDL_Rect * srcrect,
+                     const SDL_Rect * dstrect, GLshort * vertices,
+                     GLfloat * texCoords)
+{
+    GLES_TextureData *texturedata = (GLES_TextureData *) texture->driverdata;
+    GLshort minx, miny, maxx, maxy;
+    GLfloat minu, maxu, minv, maxv;
+
+    minx = dstrect->x;
+    miny = dstrect->y;
+    maxx = dstrect->x + dstrect->w;
+    maxy = dstrect->y + dstrect->h;
+
+    minu = (GLfloat) srcrect->x / texture->w;
+    minu *= texturedata->texw;
+    maxu = (GLfloat) (srcrect->x + srcrect->w) / texture->w;
+    maxu *= texturedata->texw;
+    minv = (GLfloat) srcrect->y / texture->h;
+    minv *= texturedata->texh;
+    maxv = (GLfloat) (srcrect->y + srcrect->h) / texture->h;
+    maxv *= texturedata->texh;
+
+    vertices[0] = minx;
+    vertices[1] = miny;
+    vertices[2] = maxx;
+    vertices[3] = miny;
+    vertices[4] = minx;
+    vertices[5] = maxy;
+    vertices[6] = maxx;
+    vertices[7] = maxy;
+
+    texCoords[0] = minu;
+    texCoords[1] = minv;
+    texCoords[2] = maxu;
+    texCoords[3] = minv;
+    texCoords[4] = minu;
+    texCoords[5] = maxv;
+    texCoords[6] = maxu;
+    texCoords[7] = maxv;
+}
+
+/* Spread the strip corners 0 1 2 3 out into the triangles 0 1 2, 2 1 3,
+   so separate copies can share one GL_TRIANGLES draw */
+static void
+GLES_SetCopyTriangles(SDL_Texture * texture, const SDL_Rect * srcrect,
+                      const SDL_Rect * dstrect, GLshort * vertices,
+                      GLfloat * texCoords)
+{
+    int i;
 
-        minx = dstrect->x;
-        miny = dstrect->y;
-        maxx = dstrect->x + dstrect->w;
-        maxy = dstrect->y + dstrect->h;
+    GLES_SetCopyVertices(texture, srcrect, dstrect, vertices, texCoords);
+    for (i = 0; i < 2; ++i) {
+        vertices[10 + i] = vertices[6 + i];
+        vertices[8 + i] = vertices[2 + i];
+        vertices[6 + i] = vertices[4 + i];
+        texCoords[10 + i] = texCoords[6 + i];
+        texCoords[8 + i] = texCoords[2 + i];
+        texCoords[6 + i] = texCoords[4 + i];
+    }
+}
+
+static int
+GLES_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
+                const SDL_Rect * srcrect, const SDL_Rect * dstrect)
+{
+    GLES_RenderData *data = (GLES_RenderData *) renderer->driverdata;
 
-        minu = (GLfloat) srcrect->x / texture->w;
-        minu *= texturedata->texw;
-        maxu = (GLfloat) (srcrect->x + srcrect->w) / texture->w;
-        maxu *= texturedata->texw;
-        minv = (GLfloat) srcrect->y / texture->h;
-        minv *= texturedata->texh;
-        maxv = (GLfloat) (srcrect->y + srcrect->h) / texture->h;
-        maxv *= texturedata->texh;
+    GLES_SetupCopy(data, texture);
 
+    if (data->GL_OES_draw_texture_supported && data->useDrawTexture) {
+        GLES_DrawTexture(renderer, srcrect, dstrect);
+    } else {
         GLshort vertices[8];
         GLfloat texCoords[8];
 
-        vertices[0] = minx;
-        vertices[1] = miny;
-        vertices[2] = maxx;
-        vertices[3] = miny;
-        vertices[4] = minx;
-        vertices[5] = maxy;
-        vertices[6] = maxx;
-        vertices[7] = maxy;
-
-        texCoords[0] = minu;
-        texCoords[1] = minv;
-        texCoords[2] = maxu;
-        texCoords[3] = minv;
-        texCoords[4] = minu;
-        texCoords[5] = maxv;
-        texCoords[6] = maxu;
-        texCoords[7] = maxv;
+        GLES_SetCopyVertices(texture, srcrect, dstrect, vertices, texCoords);
 
         data->glVertexPointer(2, GL_SHORT, 0, vertices);
         data->glEnableClientState(GL_VERTEX_ARRAY);
@@ -933,6 +983,63 @@ GLES_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     return 0;
 }
 
+/* The number of copies drawn with each glDrawArrays() call */
+#define GLES_COPY_BATCH 64
+
+static int
+GLES_RenderCopyMany(SDL_Renderer * renderer, const SDL_TextureCopy * copies,
+                    int count)
+{
+    GLES_RenderData *data = (GLES_RenderData *) renderer->driverdata;
+    SDL_Texture *texture = NULL;
+    GLshort vertices[GLES_COPY_BATCH * 12];
+    GLfloat texCoords[GLES_COPY_BATCH * 12];
+    SDL_bool drawTexture;
+    int i, n;
+
+    drawTexture = (data->GL_OES_draw_texture_supported &&
+                   data->useDrawTexture);
+
+    data->glVertexPointer(2, GL_SHORT, 0, vertices);
+    data->glEnableClientState(GL_VERTEX_ARRAY);
+    data->glTexCoordPointer(2, GL_FLOAT, 0, texCoords);
+    data->glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+
+    /* Consecutive copies from the same texture share one draw call */
+    n = 0;
+    for (i = 0; i < count; ++i) {
+        if (copies[i].texture != texture) {
+            if (n) {
+                data->glDrawArrays(GL_TRIANGLES, 0, n * 6);
+                n = 0;
+            }
+            texture = copies[i].texture;
+            GLES_SetupCopy(data, texture);
+        }
+        if (drawTexture) {
+            GLES_DrawTexture(renderer, &copies[i].srcrect,
+                             &copies[i].dstrect);
+            continue;
+        }
+        GLES_SetCopyTriangles(texture, &copies[i].srcrect,
+                              &copies[i].dstrect, &vertices[n * 12],
+                              &texCoords[n * 12]);
+        if (++n == GLES_COPY_BATCH) {
+            data->glDrawArrays(GL_TRIANGLES, 0, n * 6);
+            n = 0;
+        }
+    }
+    if (n) {
+        data->glDrawArrays(GL_TRIANGLES, 0, n * 6);
+    }
+
+    data->glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    data->glDisableClientState(GL_VERTEX_ARRAY);
+    data->glDisable(GL_TEXTURE_2D);
+
+    return 0;
+}
+
 static void
 GLES_RenderPresent(SDL_Renderer * renderer)
 {
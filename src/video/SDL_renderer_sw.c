@@ -59,6 +59,7 @@ static int SW_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                           const SDL_Rect * rect, int markDirty, void **pixels,
                           int *pitch);
 static void SW_UnlockTexture(SDL_Renderer * renderer, SDL_Texture * texture);
+static int SW_SetDrawLineStyle(SDL_Renderer * renderer);
 static int SW_RenderDrawPoints(SDL_Renderer * renderer,
                                const SDL_Point * points, int count);
 static int SW_RenderDrawLines(SDL_Renderer * renderer,
@@ -69,6 +70,8 @@ static int SW_RenderFillRects(SDL_Renderer * renderer,
                               const SDL_Rect ** rects, int count);
 static int SW_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
                          const SDL_Rect * srcrect, const SDL_Rect * dstrect);
+static int SW_RenderCopyMany(SDL_Renderer * renderer,
+                             const SDL_TextureCopy * copies, int count);
 static int SW_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                                Uint32 format, void * pixels, int pitch);
 static int SW_RenderWritePixels(SDL_Renderer * renderer, const SDL_Rect * rect,
@@ -232,11 +235,13 @@ SW_CreateRenderer(SDL_Window * window, Uint32 flags)
     renderer->ActivateRenderer = SW_ActivateRenderer;
     renderer->DisplayModeChanged = SW_DisplayModeChanged;
 
+    renderer->SetDrawLineStyle = SW_SetDrawLineStyle;
     renderer->RenderDrawPoints = SW_RenderDrawPoints;
     renderer->RenderDrawLines = SW_RenderDrawLines;
     renderer->RenderDrawRects = SW_RenderDrawRects;
     renderer->RenderFillRects = SW_RenderFillRects;
     renderer->RenderCopy = SW_RenderCopy;
+    renderer->RenderCopyMany = SW_RenderCopyMany;
     renderer->RenderReadPixels = SW_RenderReadPixels;
     renderer->RenderWritePixels = SW_RenderWritePixels;
     renderer->RenderPresent = SW_RenderPresent;
@@ -605,6 +610,77 @@ SW_RenderDrawPoints(SDL_Renderer * renderer, const SDL_Point * points,
     return status;
 }
 
+static int
+SW_SetDrawLineStyle(SDL_Renderer * renderer)
+{
+    /* Any width and style can be drawn with SDL_StrokeLines() */
+    return 0;
+}
+
+/* Draw lines in the current line style, which reach past the points
+   by up to half the line width */
+static int
+SW_StrokeLines(SDL_Renderer * renderer, const SDL_Point * points, int count)
+{
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
+    SDL_Texture *texture = data->texture[data->current_texture];
+    SDL_Rect clip, rect;
+    SDL_Point *local;
+    int i, pad;
+    int status;
+
+    clip.x = 0;
+    clip.y = 0;
+    clip.w = texture->w;
+    clip.h = texture->h;
+    SDL_EnclosePoints(points, count, NULL, &rect);
+    pad = renderer->lineWidth / 2 + 1;
+    rect.x -= pad;
+    rect.y -= pad;
+    rect.w += 2 * pad;
+    rect.h += 2 * pad;
+    if (!SDL_IntersectRect(&rect, &clip, &rect)) {
+        /* Nothing to draw */
+        return 0;
+    }
+
+    /* The points are relative to the locked area, and may lie outside it */
+    local = SDL_stack_alloc(SDL_Point, count);
+    if (!local) {
+        SDL_OutOfMemory();
+        return -1;
+    }
+    for (i = 0; i < count; ++i) {
+        local[i].x = points[i].x - rect.x;
+        local[i].y = points[i].y - rect.y;
+    }
+
+    if (data->renderer->info.flags & SDL_RENDERER_PRESENTCOPY) {
+        SDL_AddDirtyRect(&data->dirty, &rect);
+    }
+
+    if (data->renderer->LockTexture(data->renderer, texture, &rect, 1,
+                                    &data->surface.pixels,
+                                    &data->surface.pitch) < 0) {
+        SDL_stack_free(local);
+        return -1;
+    }
+
+    data->surface.clip_rect.w = data->surface.w = rect.w;
+    data->surface.clip_rect.h = data->surface.h = rect.h;
+
+    status = SDL_StrokeLines(&data->surface, local, count,
+                             renderer->lineWidth, renderer->lineFlags,
+                             renderer->blendMode,
+                             renderer->r, renderer->g, renderer->b,
+                             renderer->a);
+
+    data->renderer->UnlockTexture(data->renderer, texture);
+    SDL_stack_free(local);
+
+    return status;
+}
+
 static int
 SW_RenderDrawLines(SDL_Renderer * renderer, const SDL_Point * points,
                    int count)
@@ -616,6 +692,10 @@ SW_RenderDrawLines(SDL_Renderer * renderer, const SDL_Point * points,
     int x1, y1, x2, y2;
     int status = 0;
 
+    if (renderer->lineWidth > 1 || renderer->lineFlags) {
+        return SW_StrokeLines(renderer, points, count);
+    }
+
     /* Get the smallest rectangle that contains everything */
     clip.x = 0;
     clip.y = 0;
@@ -698,6 +778,16 @@ SW_RenderDrawRects(SDL_Renderer * renderer, const SDL_Rect ** rects,
     }
 
     for (i = 0; i < count; ++i) {
+        if (renderer->lineWidth > 1 || renderer->lineFlags) {
+            SDL_Point outline[5];
+
+            SDL_RectOutline(rects[i], outline);
+            if (SW_StrokeLines(renderer, outline, 5) < 0) {
+                status = -1;
+            }
+            continue;
+        }
+
         /* FIXME: We don't want to draw clipped edges */
         if (!SDL_IntersectRect(rects[i], &clip, &rect)) {
             /* Nothing to draw */
@@ -739,6 +829,9 @@ SW_RenderFillRects(SDL_Renderer * renderer, const SDL_Rect ** rects,
     SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
     SDL_Texture *texture = data->texture[data->current_texture];
     SDL_Rect clip, rect;
+    SDL_Rect stack_rects[64];
+    SDL_Rect *merged;
+    SDL_bool solid;
     Uint32 color = 0;
     int i;
     int status = 0;
@@ -748,18 +841,29 @@ SW_RenderFillRects(SDL_Renderer * renderer, const SDL_Rect ** rects,
     clip.w = texture->w;
     clip.h = texture->h;
 
-    if (renderer->blendMode == SDL_BLENDMODE_NONE ||
-        renderer->blendMode == SDL_BLENDMODE_MASK) {
+    solid = (renderer->blendMode == SDL_BLENDMODE_NONE ||
+             renderer->blendMode == SDL_BLENDMODE_MASK);
+    if (solid) {
         color = SDL_MapRGBA(data->surface.format,
                             renderer->r, renderer->g, renderer->b,
                             renderer->a);
     }
 
-    for (i = 0; i < count; ++i) {
-        if (!SDL_IntersectRect(rects[i], &clip, &rect)) {
-            /* Nothing to draw */
-            continue;
+    if (count <= (int) SDL_arraysize(stack_rects)) {
+        merged = stack_rects;
+    } else {
+        merged = (SDL_Rect *) SDL_malloc(count * sizeof(*merged));
+        if (!merged) {
+            SDL_OutOfMemory();
+            return -1;
         }
+    }
+
+    /* Each merged rect costs one lock, so combine as many as we can */
+    count = SDL_MergeRects(rects, count, &clip, solid, merged);
+
+    for (i = 0; i < count; ++i) {
+        rect = merged[i];
 
         if (data->renderer->info.flags & SDL_RENDERER_PRESENTCOPY) {
             SDL_AddDirtyRect(&data->dirty, &rect);
@@ -768,14 +872,14 @@ SW_RenderFillRects(SDL_Renderer * renderer, const SDL_Rect ** rects,
         if (data->renderer->LockTexture(data->renderer, texture, &rect, 1,
                                         &data->surface.pixels,
                                         &data->surface.pitch) < 0) {
-            return -1;
+            status = -1;
+            break;
         }
 
         data->surface.clip_rect.w = data->surface.w = rect.w;
         data->surface.clip_rect.h = data->surface.h = rect.h;
 
-        if (renderer->blendMode == SDL_BLENDMODE_NONE ||
-            renderer->blendMode == SDL_BLENDMODE_MASK) {
+        if (solid) {
             status = SDL_FillRect(&data->surface, NULL, color);
         } else {
             status = SDL_BlendFillRect(&data->surface, NULL,
@@ -786,6 +890,10 @@ SW_RenderFillRects(SDL_Renderer * renderer, const SDL_Rect ** rects,
 
         data->renderer->UnlockTexture(data->renderer, texture);
     }
+
+    if (merged != stack_rects) {
+        SDL_free(merged);
+    }
     return status;
 }
 
@@ -833,6 +941,80 @@ SW_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     return status;
 }
 
+static int
+SW_RenderCopyMany(SDL_Renderer * renderer, const SDL_TextureCopy * copies,
+                  int count)
+{
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
+    SDL_Renderer *target_renderer = data->renderer;
+    SDL_Texture *target = data->texture[data->current_texture];
+    SDL_Rect bounds;
+    Uint8 *pixels;
+    int pitch, bpp;
+    int i;
+    int status = 0;
+
+    bounds = copies[0].dstrect;
+    for (i = 1; i < count; ++i) {
+        SDL_UnionRect(&bounds, &copies[i].dstrect, &bounds);
+    }
+
+    /* Lock the area covered by all the copies once, and only mark the
+       parts that are actually drawn as dirty */
+    if (target_renderer->LockTexture(target_renderer, target, &bounds,
+                                     target_renderer->DirtyTexture ? 0 : 1,
+                                     (void **) &pixels, &pitch) < 0) {
+        return -1;
+    }
+    bpp = data->surface.format->BytesPerPixel;
+
+    for (i = 0; i < count; ++i) {
+        SDL_Texture *texture = copies[i].texture;
+        const SDL_Rect *srcrect = &copies[i].srcrect;
+        const SDL_Rect *dstrect = &copies[i].dstrect;
+
+        if (data->renderer->info.flags & SDL_RENDERER_PRESENTCOPY) {
+            SDL_AddDirtyRect(&data->dirty, dstrect);
+        }
+        if (target_renderer->DirtyTexture) {
+            target_renderer->DirtyTexture(target_renderer, target, 1,
+                                          dstrect);
+        }
+
+        data->surface.pixels =
+            pixels + (dstrect->y - bounds.y) * pitch +
+            (dstrect->x - bounds.x) * bpp;
+        data->surface.pitch = pitch;
+
+        if (SDL_ISPIXELFORMAT_FOURCC(texture->format)) {
+            if (SDL_SW_CopyYUVToRGB((SDL_SW_YUVTexture *) texture->driverdata,
+                                    srcrect, data->format, dstrect->w,
+                                    dstrect->h, data->surface.pixels,
+                                    data->surface.pitch) < 0) {
+                status = -1;
+            }
+        } else {
+            SDL_Surface *surface = (SDL_Surface *) texture->driverdata;
+            SDL_Rect real_srcrect = *srcrect;
+            SDL_Rect real_dstrect;
+
+            data->surface.w = dstrect->w;
+            data->surface.h = dstrect->h;
+            data->surface.clip_rect.w = dstrect->w;
+            data->surface.clip_rect.h = dstrect->h;
+            real_dstrect = data->surface.clip_rect;
+
+            if (SDL_LowerBlit(surface, &real_srcrect, &data->surface,
+                              &real_dstrect) < 0) {
+                status = -1;
+            }
+        }
+    }
+
+    target_renderer->UnlockTexture(target_renderer, target);
+    return status;
+}
+
 static int
 SW_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                     Uint32 format, void * pixels, int pitch)
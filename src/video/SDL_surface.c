@@ -27,6 +27,7 @@
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
 #include "SDL_pixels_c.h"
+#include "SDL_surfacepool_c.h"
 #include "SDL_leaks.h"
 
 
@@ -120,10 +121,9 @@ SDL_CreateRGBSurface(Uint32 flags,
 
     /* Get the pixels */
     if (surface->w && surface->h) {
-        surface->pixels = SDL_malloc(surface->h * surface->pitch);
+        surface->pixels = SDL_AllocSurfaceMemory(surface->h * surface->pitch);
         if (!surface->pixels) {
             SDL_FreeSurface(surface);
-            SDL_OutOfMemory();
             return NULL;
         }
         /* This is important for bitmaps */
@@ -193,7 +193,8 @@ SDL_SetSurfacePalette(SDL_Surface * surface, SDL_Palette * palette)
         return -1;
     }
 
-    if (palette && palette->ncolors != (1 << surface->format->BitsPerPixel)) {
+    if (palette && (surface->format->BitsPerPixel > 8 ||
+                    palette->ncolors != (1 << surface->format->BitsPerPixel))) {
         SDL_SetError
             ("SDL_SetSurfacePalette() passed a palette that doesn't match the surface format");
         return -1;
@@ -238,6 +239,54 @@ SDL_SetSurfaceRLE(SDL_Surface * surface, int flag)
     return 0;
 }
 
+/*
+ * Make sure the blit mapping of src is set up for dst
+ */
+static int
+SDL_ValidateMap(SDL_Surface * src, SDL_Surface * dst)
+{
+    SDL_BlitMap *map = src->map;
+
+    if ((map->dst == dst) && (dst->format_version == map->format_version)) {
+        return 0;
+    }
+
+    /* The mapping only depends on the destination's format, so it holds for
+       any other surface sharing the format */
+    if (map->dst_format && (map->dst_format == dst->format) && (src != dst)) {
+        map->dst = dst;
+        map->format_version = dst->format_version;
+        return 0;
+    }
+
+    return SDL_MapSurface(src, dst);
+}
+
+int
+SDL_PrepareSurfaceRLE(SDL_Surface * surface, SDL_Surface * dst)
+{
+    if (!surface || !dst) {
+        SDL_SetError("SDL_PrepareSurfaceRLE() passed a NULL surface");
+        return -1;
+    }
+    if (surface->locked) {
+        SDL_SetError("Surfaces must not be locked during RLE encoding");
+        return -1;
+    }
+
+    SDL_SetSurfaceRLE(surface, 1);
+
+    /* Encode now, the same way the next blit would */
+    if (SDL_ValidateMap(surface, dst) < 0) {
+        return -1;
+    }
+    if (!(surface->flags & SDL_RLEACCEL)) {
+        SDL_SetError("Surface can't be RLE accelerated");
+        return -1;
+    }
+    return 0;
+}
+
 int
 SDL_SetColorKey(SDL_Surface * surface, int flag, Uint32 key)
 {
@@ -624,16 +673,8 @@ SDL_LowerBlit(SDL_Surface * src, SDL_Rect * srcrect,
               SDL_Surface * dst, SDL_Rect * dstrect)
 {
     /* Check to make sure the blit mapping is valid */
-    if ((src->map->dst != dst) ||
-        (src->map->dst->format_version != src->map->format_version)) {
-        if (SDL_MapSurface(src, dst) < 0) {
-            return (-1);
-        }
-        /* just here for debugging */
-/*         printf */
-/*             ("src = 0x%08X src->flags = %08X src->map->info.flags = %08x\ndst = 0x%08X dst->flags = %08X dst->map->info.flags = %08X\nsrc->map->blit = 0x%08x\n", */
-/*              src, dst->flags, src->map->info.flags, dst, dst->flags, */
-/*              dst->map->info.flags, src->map->blit); */
+    if (SDL_ValidateMap(src, dst) < 0) {
+        return (-1);
     }
     return (src->map->blit(src, srcrect, dst, dstrect));
 }
@@ -993,7 +1034,7 @@ SDL_FreeSurface(SDL_Surface * surface)
         surface->map = NULL;
     }
     if (surface->pixels && ((surface->flags & SDL_PREALLOC) != SDL_PREALLOC)) {
-        SDL_free(surface->pixels);
+        SDL_FreeSurfaceMemory(surface->pixels);
     }
     SDL_free(surface);
 #ifdef CHECK_LEAKS
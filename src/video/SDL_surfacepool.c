@@ -0,0 +1,185 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2010 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* A size class allocator for surface memory, so surfaces that are created
+   and freed every frame don't go back to the heap each time */
+
+#include "SDL_atomic.h"
+#include "SDL_surfacepool_c.h"
+
+/* Blocks from 64 bytes to 4 MB are pooled, in four size classes for each
+   power of two so no more than a fifth of a block goes unused */
+#define POOL_MIN_SHIFT  6
+#define POOL_MAX_SHIFT  22
+#define POOL_CLASSES    (1 + (POOL_MAX_SHIFT - POOL_MIN_SHIFT) * 4)
+
+/* The most memory the pool holds on to */
+#define POOL_MAX_CACHED (8 * 1024 * 1024)
+
+/* This sits right before the memory handed out */
+typedef struct SDL_PoolBlock
+{
+    void *mem;                  /* what SDL_malloc() returned */
+    int sizeclass;              /* -1 if the block is too big to pool */
+    struct SDL_PoolBlock *next; /* the next free block in the class */
+} SDL_PoolBlock;
+
+static SDL_SpinLock pool_lock;
+static SDL_PoolBlock *pool_free[POOL_CLASSES];
+static SDL_SurfacePoolStats pool_stats;
+
+/* Find the size class for a block of 'size' bytes, or -1 if it's too big */
+static int
+SDL_GetPoolSizeClass(size_t size, size_t * blocksize)
+{
+    int shift;
+    size_t step;
+
+    if (size <= (1 << POOL_MIN_SHIFT)) {
+        *blocksize = (1 << POOL_MIN_SHIFT);
+        return 0;
+    }
+    if (size > (1 << POOL_MAX_SHIFT)) {
+        *blocksize = size;
+        return -1;
+    }
+
+    /* Classes between 2^shift and 2^(shift+1) are 2^(shift-2) apart */
+    shift = POOL_MIN_SHIFT;
+    while ((size - 1) >> (shift + 1)) {
+        ++shift;
+    }
+    step = ((size - 1) >> (shift - 2)) - 3;
+    *blocksize = (4 + step) << (shift - 2);
+    return 1 + (shift - POOL_MIN_SHIFT) * 4 + (int) (step - 1);
+}
+
+static size_t
+SDL_GetPoolBlockSize(int sizeclass)
+{
+    int shift = POOL_MIN_SHIFT + (sizeclass - 1) / 4;
+    size_t step = 1 + (sizeclass - 1) % 4;
+
+    if (sizeclass == 0) {
+        return (1 << POOL_MIN_SHIFT);
+    }
+    return (4 + step) << (shift - 2);
+}
+
+void *
+SDL_AllocSurfaceMemory(size_t size)
+{
+    SDL_PoolBlock *block = NULL;
+    size_t blocksize;
+    int sizeclass;
+    Uint8 *mem;
+
+    sizeclass = SDL_GetPoolSizeClass(size, &blocksize);
+
+    SDL_AtomicLock(&pool_lock);
+    ++pool_stats.allocs;
+    if (sizeclass >= 0 && pool_free[sizeclass]) {
+        block = pool_free[sizeclass];
+        pool_free[sizeclass] = block->next;
+        ++pool_stats.reuses;
+        --pool_stats.cached;
+        pool_stats.cached_bytes -= blocksize;
+    }
+    SDL_AtomicUnlock(&pool_lock);
+
+    if (block) {
+        return block + 1;
+    }
+
+    mem = (Uint8 *) SDL_malloc(sizeof(*block) + blocksize +
+                               SDL_SURFACE_ALIGNMENT - 1);
+    if (!mem) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    block = (SDL_PoolBlock *)
+        ((((uintptr_t) mem + sizeof(*block) + SDL_SURFACE_ALIGNMENT - 1) &
+          ~(uintptr_t) (SDL_SURFACE_ALIGNMENT - 1)) - sizeof(*block));
+    block->mem = mem;
+    block->sizeclass = sizeclass;
+    block->next = NULL;
+    return block + 1;
+}
+
+void
+SDL_FreeSurfaceMemory(void *mem)
+{
+    SDL_PoolBlock *block;
+    size_t blocksize;
+
+    if (!mem) {
+        return;
+    }
+    block = (SDL_PoolBlock *) mem - 1;
+
+    if (block->sizeclass >= 0) {
+        blocksize = SDL_GetPoolBlockSize(block->sizeclass);
+
+        SDL_AtomicLock(&pool_lock);
+        if (pool_stats.cached_bytes + blocksize <= POOL_MAX_CACHED) {
+            block->next = pool_free[block->sizeclass];
+            pool_free[block->sizeclass] = block;
+            ++pool_stats.cached;
+            pool_stats.cached_bytes += blocksize;
+            block = NULL;
+        }
+        SDL_AtomicUnlock(&pool_lock);
+    }
+    if (block) {
+        SDL_free(block->mem);
+    }
+}
+
+void
+SDL_GetSurfacePoolStats(SDL_SurfacePoolStats * stats)
+{
+    SDL_AtomicLock(&pool_lock);
+    *stats = pool_stats;
+    SDL_AtomicUnlock(&pool_lock);
+}
+
+void
+SDL_FlushSurfacePool(void)
+{
+    SDL_PoolBlock *block;
+    int i;
+
+    SDL_AtomicLock(&pool_lock);
+    for (i = 0; i < POOL_CLASSES; ++i) {
+        while (pool_free[i]) {
+            block = pool_free[i];
+            pool_free[i] = block->next;
+            SDL_free(block->mem);
+        }
+    }
+    pool_stats.cached = 0;
+    pool_stats.cached_bytes = 0;
+    SDL_AtomicUnlock(&pool_lock);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
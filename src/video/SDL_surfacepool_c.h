@@ -0,0 +1,49 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 1997-2010 Sam Lantinga
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Sam Lantinga
+    slouken@libsdl.org
+*/
+#include "SDL_config.h"
+
+/* Memory for surface pixels, pixel formats and blit maps */
+
+#include "SDL_video.h"
+
+/* Rows of surface pixels start on a cache line */
+#define SDL_SURFACE_ALIGNMENT   64
+
+typedef struct
+{
+    Uint32 allocs;              /* blocks handed out */
+    Uint32 reuses;              /* blocks handed out again from the pool */
+    Uint32 cached;              /* blocks waiting in the pool */
+    size_t cached_bytes;        /* memory held by those blocks */
+} SDL_SurfacePoolStats;
+
+/* Allocate memory aligned to SDL_SURFACE_ALIGNMENT, reusing a freed block
+   of the same size class when there is one */
+extern void *SDL_AllocSurfaceMemory(size_t size);
+extern void SDL_FreeSurfaceMemory(void *mem);
+
+extern void SDL_GetSurfacePoolStats(SDL_SurfacePoolStats * stats);
+
+/* Release all the memory kept for reuse */
+extern void SDL_FlushSurfacePool(void);
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -88,6 +88,7 @@ struct SDL_Renderer
                           int numrects, const SDL_Rect * rects);
     int (*SetDrawColor) (SDL_Renderer * renderer);
     int (*SetDrawBlendMode) (SDL_Renderer * renderer);
+    int (*SetDrawLineStyle) (SDL_Renderer * renderer);
     int (*RenderClear) (SDL_Renderer * renderer);
     int (*RenderDrawPoints) (SDL_Renderer * renderer, const SDL_Point * points,
                              int count);
@@ -103,8 +104,13 @@ struct SDL_Renderer
                               int w, int h);
     int (*RenderCopy) (SDL_Renderer * renderer, SDL_Texture * texture,
                        const SDL_Rect * srcrect, const SDL_Rect * dstrect);
+    int (*RenderCopyMany) (SDL_Renderer * renderer,
+                           const SDL_TextureCopy * copies, int count);
     int (*RenderReadPixels) (SDL_Renderer * renderer, const SDL_Rect * rect,
                              Uint32 format, void * pixels, int pitch);
+    int (*RenderReadPixelsAsync) (SDL_Renderer * renderer,
+                                  const SDL_Rect * rect, Uint32 format,
+                                  void * pixels, int pitch);
     int (*RenderWritePixels) (SDL_Renderer * renderer, const SDL_Rect * rect,
                               Uint32 format, const void * pixels, int pitch);
     void (*RenderPresent) (SDL_Renderer * renderer);
@@ -123,6 +129,8 @@ struct SDL_Renderer
 
     Uint8 r, g, b, a;                   /**< Color for drawing operations values */
     int blendMode;                      /**< The drawing blend mode */
+    int lineWidth;                      /**< The drawing line width */
+    Uint32 lineFlags;                   /**< The drawing line style flags */
 
     void *driverdata;
 };
@@ -1597,6 +1597,7 @@ SDL_CreateRenderer(SDL_Window * window, int index, Uint32 flags)
         /* Assuming renderer set its error */
         return -1;
     }
+    window->renderer->lineWidth = 1;
 
     SDL_SelectRenderer(window);
 
@@ -2341,6 +2342,49 @@ SDL_GetRenderDrawBlendMode(int *blendMode)
     return 0;
 }
 
+int
+SDL_SetRenderDrawLineStyle(int width, Uint32 flags)
+{
+    SDL_Renderer *renderer;
+
+    renderer = SDL_GetCurrentRenderer(SDL_TRUE);
+    if (!renderer) {
+        return -1;
+    }
+    if (width < 1) {
+        SDL_SetError("SDL_SetRenderDrawLineStyle(): Invalid line width");
+        return -1;
+    }
+    if (!renderer->SetDrawLineStyle) {
+        if (width != 1 || flags) {
+            SDL_Unsupported();
+            return -1;
+        }
+        return 0;
+    }
+    renderer->lineWidth = width;
+    renderer->lineFlags = flags;
+    return renderer->SetDrawLineStyle(renderer);
+}
+
+int
+SDL_GetRenderDrawLineStyle(int *width, Uint32 * flags)
+{
+    SDL_Renderer *renderer;
+
+    renderer = SDL_GetCurrentRenderer(SDL_TRUE);
+    if (!renderer) {
+        return -1;
+    }
+    if (width) {
+        *width = renderer->lineWidth;
+    }
+    if (flags) {
+        *flags = renderer->lineFlags;
+    }
+    return 0;
+}
+
 int
 SDL_RenderClear()
 {
@@ -2530,12 +2574,52 @@ SDL_RenderFillRects(const SDL_Rect ** rects, int count)
     return renderer->RenderFillRects(renderer, rects, count);
 }
 
+/* Clip a copy to the texture and window, returning SDL_FALSE if it's empty */
+static SDL_bool
+SDL_ClipRenderCopy(SDL_Window * window, SDL_Texture * texture,
+                   const SDL_Rect * srcrect, const SDL_Rect * dstrect,
+                   SDL_Rect * real_srcrect, SDL_Rect * real_dstrect)
+{
+    real_srcrect->x = 0;
+    real_srcrect->y = 0;
+    real_srcrect->w = texture->w;
+    real_srcrect->h = texture->h;
+    if (srcrect) {
+        if (!SDL_IntersectRect(srcrect, real_srcrect, real_srcrect)) {
+            return SDL_FALSE;
+        }
+    }
+
+    real_dstrect->x = 0;
+    real_dstrect->y = 0;
+    real_dstrect->w = window->w;
+    real_dstrect->h = window->h;
+    if (dstrect) {
+        if (!SDL_IntersectRect(dstrect, real_dstrect, real_dstrect)) {
+            return SDL_FALSE;
+        }
+        /* Clip srcrect by the same amount as dstrect was clipped */
+        if (dstrect->w != real_dstrect->w) {
+            int deltax = (real_dstrect->x - dstrect->x);
+            int deltaw = (real_dstrect->w - dstrect->w);
+            real_srcrect->x += (deltax * real_srcrect->w) / dstrect->w;
+            real_srcrect->w += (deltaw * real_srcrect->w) / dstrect->w;
+        }
+        if (dstrect->h != real_dstrect->h) {
+            int deltay = (real_dstrect->y - dstrect->y);
+            int deltah = (real_dstrect->h - dstrect->h);
+            real_srcrect->y += (deltay * real_srcrect->h) / dstrect->h;
+            real_srcrect->h += (deltah * real_srcrect->h) / dstrect->h;
+        }
+    }
+    return SDL_TRUE;
+}
+
 int
 SDL_RenderCopy(SDL_Texture * texture, const SDL_Rect * srcrect,
                const SDL_Rect * dstrect)
 {
     SDL_Renderer *renderer;
-    SDL_Window *window;
     SDL_Rect real_srcrect;
     SDL_Rect real_dstrect;
 
@@ -2553,43 +2637,90 @@ SDL_RenderCopy(SDL_Texture * texture, const SDL_Rect * srcrect,
         SDL_Unsupported();
         return -1;
     }
-    window = renderer->window;
 
-    real_srcrect.x = 0;
-    real_srcrect.y = 0;
-    real_srcrect.w = texture->w;
-    real_srcrect.h = texture->h;
-    if (srcrect) {
-        if (!SDL_IntersectRect(srcrect, &real_srcrect, &real_srcrect)) {
-            return 0;
+    if (!SDL_ClipRenderCopy(renderer->window, texture, srcrect, dstrect,
+                            &real_srcrect, &real_dstrect)) {
+        return 0;
+    }
+
+    return renderer->RenderCopy(renderer, texture, &real_srcrect,
+                                &real_dstrect);
+}
+
+int
+SDL_RenderCopyMany(const SDL_TextureCopy * copies, int count)
+{
+    SDL_Renderer *renderer;
+    SDL_TextureCopy stack_copies[64];
+    SDL_TextureCopy *real_copies;
+    int i, real_count;
+    int status = 0;
+
+    renderer = SDL_GetCurrentRenderer(SDL_TRUE);
+    if (!renderer) {
+        return -1;
+    }
+    if (!renderer->RenderCopy) {
+        SDL_Unsupported();
+        return -1;
+    }
+    if (count < 1) {
+        return 0;
+    }
+
+    if (count <= (int) SDL_arraysize(stack_copies)) {
+        real_copies = stack_copies;
+    } else {
+        real_copies =
+            (SDL_TextureCopy *) SDL_malloc(count * sizeof(*real_copies));
+        if (!real_copies) {
+            SDL_OutOfMemory();
+            return -1;
         }
     }
 
-    real_dstrect.x = 0;
-    real_dstrect.y = 0;
-    real_dstrect.w = window->w;
-    real_dstrect.h = window->h;
-    if (dstrect) {
-        if (!SDL_IntersectRect(dstrect, &real_dstrect, &real_dstrect)) {
-            return 0;
+    real_count = 0;
+    for (i = 0; i < count; ++i) {
+        SDL_Texture *texture = copies[i].texture;
+        SDL_TextureCopy *copy = &real_copies[real_count];
+
+        if (!texture || texture->magic != &_this->texture_magic) {
+            SDL_SetError("Invalid texture");
+            status = -1;
+            break;
         }
-        /* Clip srcrect by the same amount as dstrect was clipped */
-        if (dstrect->w != real_dstrect.w) {
-            int deltax = (real_dstrect.x - dstrect->x);
-            int deltaw = (real_dstrect.w - dstrect->w);
-            real_srcrect.x += (deltax * real_srcrect.w) / dstrect->w;
-            real_srcrect.w += (deltaw * real_srcrect.w) / dstrect->w;
+        if (texture->renderer != renderer) {
+            SDL_SetError("Texture was not created with this renderer");
+            status = -1;
+            break;
         }
-        if (dstrect->h != real_dstrect.h) {
-            int deltay = (real_dstrect.y - dstrect->y);
-            int deltah = (real_dstrect.h - dstrect->h);
-            real_srcrect.y += (deltay * real_srcrect.h) / dstrect->h;
-            real_srcrect.h += (deltah * real_srcrect.h) / dstrect->h;
+        if (SDL_ClipRenderCopy(renderer->window, texture,
+                               &copies[i].srcrect, &copies[i].dstrect,
+                               &copy->srcrect, &copy->dstrect)) {
+            copy->texture = texture;
+            ++real_count;
         }
     }
 
-    return renderer->RenderCopy(renderer, texture, &real_srcrect,
-                                &real_dstrect);
+    if (status == 0 && real_count > 0) {
+        if (renderer->RenderCopyMany) {
+            status = renderer->RenderCopyMany(renderer, real_copies,
+                                              real_count);
+        } else {
+            for (i = 0; i < real_count; ++i) {
+                if (renderer->RenderCopy(renderer, real_copies[i].texture,
+                                         &real_copies[i].srcrect,
+                                         &real_copies[i].dstrect) < 0) {
+                    status = -1;
+                }
+            }
+        }
+    }
+
+    if (real_copies != stack_copies) {
+        SDL_free(real_copies);
+    }
+    return status;
 }
 
 int
@@ -2636,6 +2767,48 @@ SDL_RenderReadPixels(const SDL_Rect * rect, Uint32 format,
                                       format, pixels, pitch);
 }
 
+int
+SDL_RenderReadPixelsAsync(const SDL_Rect * rect, Uint32 format,
+                          void * pixels, int pitch)
+{
+    SDL_Renderer *renderer;
+    SDL_Window *window;
+    SDL_Rect real_rect;
+
+    renderer = SDL_GetCurrentRenderer(SDL_TRUE);
+    if (!renderer) {
+        return -1;
+    }
+    if (!renderer->RenderReadPixelsAsync) {
+        return SDL_RenderReadPixels(rect, format, pixels, pitch);
+    }
+    window = renderer->window;
+
+    if (!format) {
+        format = window->display->current_mode.format;
+    }
+
+    real_rect.x = 0;
+    real_rect.y = 0;
+    real_rect.w = window->w;
+    real_rect.h = window->h;
+    if (rect) {
+        if (!SDL_IntersectRect(rect, &real_rect, &real_rect)) {
+            return 0;
+        }
+        if (real_rect.y > rect->y) {
+            pixels = (Uint8 *)pixels + pitch * (real_rect.y - rect->y);
+        }
+        if (real_rect.x > rect->x) {
+            int bpp = SDL_BYTESPERPIXEL(format);
+            pixels = (Uint8 *)pixels + bpp * (real_rect.x - rect->x);
+        }
+    }
+
+    return renderer->RenderReadPixelsAsync(renderer, &real_rect,
+                                           format, pixels, pitch);
+}
+
 int
 SDL_RenderWritePixels(const SDL_Rect * rect, Uint32 format,
                       const void * pixels, int pitch)
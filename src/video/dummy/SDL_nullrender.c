@@ -23,6 +23,7 @@
 
 #include "SDL_video.h"
 #include "../SDL_sysvideo.h"
+#include "../SDL_rect_c.h"
 #include "../SDL_yuv_sw_c.h"
 #include "../SDL_renderer_sw.h"
 
@@ -31,6 +32,7 @@
 
 static SDL_Renderer *SDL_DUMMY_CreateRenderer(SDL_Window * window,
                                               Uint32 flags);
+static int SDL_DUMMY_SetDrawLineStyle(SDL_Renderer * renderer);
 static int SDL_DUMMY_RenderDrawPoints(SDL_Renderer * renderer,
                                       const SDL_Point * points, int count);
 static int SDL_DUMMY_RenderDrawLines(SDL_Renderer * renderer,
@@ -102,6 +104,7 @@ SDL_DUMMY_CreateRenderer(SDL_Window * window, Uint32 flags)
     }
     SDL_zerop(data);
 
+    renderer->SetDrawLineStyle = SDL_DUMMY_SetDrawLineStyle;
     renderer->RenderDrawPoints = SDL_DUMMY_RenderDrawPoints;
     renderer->RenderDrawLines = SDL_DUMMY_RenderDrawLines;
     renderer->RenderDrawRects = SDL_DUMMY_RenderDrawRects;
@@ -164,6 +167,12 @@ SDL_DUMMY_RenderDrawPoints(SDL_Renderer * renderer,
     }
 }
 
+static int
+SDL_DUMMY_SetDrawLineStyle(SDL_Renderer * renderer)
+{
+    return 0;
+}
+
 static int
 SDL_DUMMY_RenderDrawLines(SDL_Renderer * renderer,
                           const SDL_Point * points, int count)
@@ -172,6 +181,14 @@ SDL_DUMMY_RenderDrawLines(SDL_Renderer * renderer,
         (SDL_DUMMY_RenderData *) renderer->driverdata;
     SDL_Surface *target = data->screens[data->current_screen];
 
+    if (renderer->lineWidth > 1 || renderer->lineFlags) {
+        return SDL_StrokeLines(target, points, count,
+                               renderer->lineWidth, renderer->lineFlags,
+                               renderer->blendMode,
+                               renderer->r, renderer->g, renderer->b,
+                               renderer->a);
+    }
+
     if (renderer->blendMode == SDL_BLENDMODE_NONE ||
         renderer->blendMode == SDL_BLENDMODE_MASK) {
         Uint32 color = SDL_MapRGBA(target->format,
@@ -194,6 +211,23 @@ SDL_DUMMY_RenderDrawRects(SDL_Renderer * renderer, const SDL_Rect ** rects,
         (SDL_DUMMY_RenderData *) renderer->driverdata;
     SDL_Surface *target = data->screens[data->current_screen];
 
+    if (renderer->lineWidth > 1 || renderer->lineFlags) {
+        SDL_Point outline[5];
+        int i, status = 0;
+
+        for (i = 0; i < count; ++i) {
+            SDL_RectOutline(rects[i], outline);
+            if (SDL_StrokeLines(target, outline, 5,
+                                renderer->lineWidth, renderer->lineFlags,
+                                renderer->blendMode,
+                                renderer->r, renderer->g, renderer->b,
+                                renderer->a) < 0) {
+                status = -1;
+            }
+        }
+        return status;
+    }
+
     if (renderer->blendMode == SDL_BLENDMODE_NONE ||
         renderer->blendMode == SDL_BLENDMODE_MASK) {
         Uint32 color = SDL_MapRGBA(target->format,
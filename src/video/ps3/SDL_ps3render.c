@@ -210,15 +210,7 @@ SDL_PS3_CreateRenderer(SDL_Window * window, Uint32 flags)
         SDL_PS3_DestroyRenderer(renderer);
         return NULL;
     }
-    /* Allocate aligned memory for pixels */
-    SDL_free(data->screen->pixels);
-    data->screen->pixels = (void *)memalign(16, data->screen->h * data->screen->pitch);
-    if (!data->screen->pixels) {
-        SDL_FreeSurface(data->screen);
-        SDL_OutOfMemory();
-        return NULL;
-    }
-    SDL_memset(data->screen->pixels, 0, data->screen->h * data->screen->pitch);
+    /* Surface pixels are already aligned enough for the SPUs */
     SDL_SetSurfacePalette(data->screen, display->palette);
 
     data->current_screen = 0;
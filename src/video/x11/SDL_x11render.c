@@ -29,6 +29,7 @@
 #include "../SDL_rect_c.h"
 #include "../SDL_pixels_c.h"
 #include "../SDL_yuv_sw_c.h"
+#include "../SDL_alphamult.h"
 
 /* X11 renderer implementation */
 
@@ -60,6 +61,8 @@ static int X11_RenderFillRects(SDL_Renderer * renderer,
                                const SDL_Rect ** rects, int count);
 static int X11_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
                           const SDL_Rect * srcrect, const SDL_Rect * dstrect);
+static int X11_RenderCopyMany(SDL_Renderer * renderer,
+                              const SDL_TextureCopy * copies, int count);
 static int X11_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                                 Uint32 format, void * pixels, int pitch);
 static int X11_RenderWritePixels(SDL_Renderer * renderer, const SDL_Rect * rect,
@@ -101,17 +104,38 @@ typedef struct
     GC gc;
     SDL_DirtyRectList dirty;
     SDL_bool makedirty;
+    SDL_bool shm_pending;
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+    SDL_bool use_xrender;
+    XRenderPictFormat *xwindow_pict_fmt;
+    Picture xwindow_pict;
+    Picture pixmap_picts[3];
+    Picture drawable_pict;
+    Pixmap stencil;
+    Picture stencil_pict;
+    GC stencil_gc;
+    Pixmap brush;
+    Picture brush_pict;
+    GC argb_gc;
+#endif
 } X11_RenderData;
 
 typedef struct
 {
     SDL_SW_YUVTexture *yuv;
     Uint32 format;
+    int depth;
     Pixmap pixmap;
     XImage *image;
 #ifndef NO_SHARED_MEMORY
     /* MIT shared memory extension information */
     XShmSegmentInfo shminfo;
+    SDL_bool shm_pixmap;
+#endif
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+    Picture picture;
+    SDL_bool premultiplied;
+    XImage *upload_image;
 #endif
     XImage *scaling_image;
     void *pixels;
@@ -132,14 +156,245 @@ shm_errhandler(Display * d, XErrorEvent * e)
         return (X_handler(d, e));
     }
 }
+
+static SDL_bool
+X11_AttachShm(Display * display, XShmSegmentInfo * shminfo, size_t size)
+{
+    shm_error = True;
+
+    if (SDL_X11_HAVE_SHM) {
+        shminfo->shmid = shmget(IPC_PRIVATE, size, IPC_CREAT | 0777);
+        if (shminfo->shmid >= 0) {
+            shminfo->shmaddr = (char *) shmat(shminfo->shmid, 0, 0);
+            shminfo->readOnly = False;
+            if (shminfo->shmaddr != (char *) -1) {
+                shm_error = False;
+                X_handler = XSetErrorHandler(shm_errhandler);
+                XShmAttach(display, shminfo);
+                XSync(display, False);
+                XSetErrorHandler(X_handler);
+                if (shm_error) {
+                    shmdt(shminfo->shmaddr);
+                }
+            }
+            shmctl(shminfo->shmid, IPC_RMID, NULL);
+        }
+    }
+    if (shm_error) {
+        shminfo->shmaddr = NULL;
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+static void
+X11_DetachShm(Display * display, XShmSegmentInfo * shminfo)
+{
+    XShmDetach(display, shminfo);
+    XSync(display, False);
+    shmdt(shminfo->shmaddr);
+    shminfo->shmaddr = NULL;
+}
+
+/* Requests sourcing shared memory are processed asynchronously, so wait
+   for the server to catch up before the client modifies that memory.
+ */
+static void
+X11_WaitShm(X11_RenderData * data)
+{
+    if (data->shm_pending) {
+        XSync(data->display, False);
+        data->shm_pending = SDL_FALSE;
+    }
+}
 #endif /* ! NO_SHARED_MEMORY */
 
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+static SDL_bool
+CheckXRender(Display * display, int *major, int *minor)
+{
+    const char *env;
+
+    /* Default the extension not available */
+    *major = *minor = 0;
+
+    /* Allow environment override */
+    env = SDL_getenv("SDL_VIDEO_X11_XRENDER");
+    if (env && !SDL_atoi(env)) {
+        return SDL_FALSE;
+    }
+
+    if (!SDL_X11_HAVE_XRENDER) {
+        return SDL_FALSE;
+    }
+
+    /* Query the extension version, we need transforms and filters */
+    if (!XRenderQueryVersion(display, major, minor)) {
+        return SDL_FALSE;
+    }
+    if (*major == 0 && *minor < 6) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+static int
+xrenderblendop(int blendMode)
+{
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+        return PictOpOver;
+    case SDL_BLENDMODE_ADD:
+        return PictOpAdd;
+    default:
+        return PictOpSrc;
+    }
+}
+
+static XRenderColor
+xrenderdrawcolor(SDL_Renderer * renderer)
+{
+    /* Xrender colors are premultiplied 16-bit channels */
+    XRenderColor xrender_color;
+    int a = renderer->a;
+
+    xrender_color.red = (unsigned short) ((renderer->r * a * 257) / 255);
+    xrender_color.green = (unsigned short) ((renderer->g * a * 257) / 255);
+    xrender_color.blue = (unsigned short) ((renderer->b * a * 257) / 255);
+    xrender_color.alpha = (unsigned short) (a * 257);
+    return xrender_color;
+}
+
+static int
+X11_CreateDrawablePictures(SDL_Renderer * renderer)
+{
+    X11_RenderData *data = (X11_RenderData *) renderer->driverdata;
+    SDL_Window *window = renderer->window;
+    XRenderPictFormat *stencil_fmt;
+    XGCValues gcv;
+    int i;
+
+    for (i = 0; i < SDL_arraysize(data->pixmaps); ++i) {
+        if (data->pixmaps[i] != None) {
+            data->pixmap_picts[i] =
+                XRenderCreatePicture(data->display, data->pixmaps[i],
+                                     data->xwindow_pict_fmt, 0, NULL);
+            if (!data->pixmap_picts[i]) {
+                SDL_SetError("XRenderCreatePicture() failed");
+                return -1;
+            }
+        }
+    }
+    if (data->drawable == data->xwindow) {
+        data->drawable_pict = data->xwindow_pict;
+    } else {
+        data->drawable_pict = data->pixmap_picts[data->current_pixmap];
+    }
+
+    /* Lines are rasterized into an alpha stencil and blended through it */
+    stencil_fmt = XRenderFindStandardFormat(data->display, PictStandardA8);
+    data->stencil =
+        XCreatePixmap(data->display, data->xwindow, window->w, window->h, 8);
+    if (!stencil_fmt || data->stencil == None) {
+        SDL_SetError("XCreatePixmap() failed");
+        return -1;
+    }
+    data->stencil_pict =
+        XRenderCreatePicture(data->display, data->stencil, stencil_fmt, 0,
+                             NULL);
+    gcv.graphics_exposures = False;
+    data->stencil_gc =
+        XCreateGC(data->display, data->stencil, GCGraphicsExposures, &gcv);
+    if (!data->stencil_pict || !data->stencil_gc) {
+        SDL_SetError("Couldn't create stencil");
+        return -1;
+    }
+    return 0;
+}
+
+static void
+X11_DestroyDrawablePictures(SDL_Renderer * renderer)
+{
+    X11_RenderData *data = (X11_RenderData *) renderer->driverdata;
+    int i;
+
+    for (i = 0; i < SDL_arraysize(data->pixmap_picts); ++i) {
+        if (data->pixmap_picts[i]) {
+            XRenderFreePicture(data->display, data->pixmap_picts[i]);
+            data->pixmap_picts[i] = None;
+        }
+    }
+    data->drawable_pict = None;
+    if (data->stencil_gc) {
+        XFreeGC(data->display, data->stencil_gc);
+        data->stencil_gc = NULL;
+    }
+    if (data->stencil_pict) {
+        XRenderFreePicture(data->display, data->stencil_pict);
+        data->stencil_pict = None;
+    }
+    if (data->stencil != None) {
+        XFreePixmap(data->display, data->stencil);
+        data->stencil = None;
+    }
+}
+
+static int
+X11_CreatePictures(SDL_Renderer * renderer)
+{
+    X11_RenderData *data = (X11_RenderData *) renderer->driverdata;
+    XRenderPictFormat *argb_fmt;
+    XRenderPictureAttributes attributes;
+    XGCValues gcv;
+
+    data->xwindow_pict_fmt =
+        XRenderFindVisualFormat(data->display, data->visual);
+    argb_fmt = XRenderFindStandardFormat(data->display, PictStandardARGB32);
+    if (!data->xwindow_pict_fmt || !argb_fmt) {
+        SDL_SetError("Couldn't find Xrender picture formats");
+        return -1;
+    }
+    data->xwindow_pict =
+        XRenderCreatePicture(data->display, data->xwindow,
+                             data->xwindow_pict_fmt, 0, NULL);
+    if (!data->xwindow_pict) {
+        SDL_SetError("XRenderCreatePicture() failed");
+        return -1;
+    }
+
+    /* A repeating 1x1 picture holds the draw color for stencilled drawing */
+    data->brush = XCreatePixmap(data->display, data->xwindow, 1, 1, 32);
+    if (data->brush == None) {
+        SDL_SetError("XCreatePixmap() failed");
+        return -1;
+    }
+    attributes.repeat = True;
+    data->brush_pict =
+        XRenderCreatePicture(data->display, data->brush, argb_fmt, CPRepeat,
+                             &attributes);
+    gcv.graphics_exposures = False;
+    data->argb_gc =
+        XCreateGC(data->display, data->brush, GCGraphicsExposures, &gcv);
+    if (!data->brush_pict || !data->argb_gc) {
+        SDL_SetError("Couldn't create brush");
+        return -1;
+    }
+
+    return X11_CreateDrawablePictures(renderer);
+}
+#endif /* SDL_VIDEO_DRIVER_X11_XRENDER */
+
 static void
 UpdateYUVTextureData(SDL_Texture * texture)
 {
     X11_TextureData *data = (X11_TextureData *) texture->driverdata;
     SDL_Rect rect;
 
+#ifndef NO_SHARED_MEMORY
+    if (data->shminfo.shmaddr) {
+        X11_WaitShm((X11_RenderData *) texture->renderer->driverdata);
+    }
+#endif
     rect.x = 0;
     rect.y = 0;
     rect.w = texture->w;
@@ -151,23 +406,109 @@ UpdateYUVTextureData(SDL_Texture * texture)
 void
 X11_AddRenderDriver(_THIS)
 {
-    SDL_VideoData *data = (SDL_VideoData *) _this->driverdata;
-    SDL_RendererInfo *info = &X11_RenderDriver.info;
-    SDL_DisplayMode *mode = &SDL_CurrentDisplay->desktop_mode;
+    SDL_bool xrender = SDL_FALSE;
     int i;
 
-    info->texture_formats[info->num_texture_formats++] = mode->format;
-    info->texture_formats[info->num_texture_formats++] = SDL_PIXELFORMAT_YV12;
-    info->texture_formats[info->num_texture_formats++] = SDL_PIXELFORMAT_IYUV;
-    info->texture_formats[info->num_texture_formats++] = SDL_PIXELFORMAT_YUY2;
-    info->texture_formats[info->num_texture_formats++] = SDL_PIXELFORMAT_UYVY;
-    info->texture_formats[info->num_texture_formats++] = SDL_PIXELFORMAT_YVYU;
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+    {
+        SDL_VideoData *data = (SDL_VideoData *) _this->driverdata;
+        int major, minor;
+
+        xrender = CheckXRender(data->display, &major, &minor);
+    }
+#endif
 
+    /* Each display gets its own copy of the driver info */
     for (i = 0; i < _this->num_displays; ++i) {
-        SDL_AddRenderDriver(&_this->displays[i], &X11_RenderDriver);
+        SDL_RenderDriver driver = X11_RenderDriver;
+        SDL_RendererInfo *info = &driver.info;
+        SDL_DisplayMode *mode = &_this->displays[i].desktop_mode;
+
+        info->texture_formats[info->num_texture_formats++] = mode->format;
+        info->texture_formats[info->num_texture_formats++] =
+            SDL_PIXELFORMAT_YV12;
+        info->texture_formats[info->num_texture_formats++] =
+            SDL_PIXELFORMAT_IYUV;
+        info->texture_formats[info->num_texture_formats++] =
+            SDL_PIXELFORMAT_YUY2;
+        info->texture_formats[info->num_texture_formats++] =
+            SDL_PIXELFORMAT_UYVY;
+        info->texture_formats[info->num_texture_formats++] =
+            SDL_PIXELFORMAT_YVYU;
+        if (xrender) {
+            if (mode->format != SDL_PIXELFORMAT_ARGB8888) {
+                info->texture_formats[info->num_texture_formats++] =
+                    SDL_PIXELFORMAT_ARGB8888;
+            }
+            info->blend_modes |= (SDL_BLENDMODE_BLEND | SDL_BLENDMODE_ADD);
+            info->scale_modes |=
+                (SDL_TEXTURESCALEMODE_FAST | SDL_TEXTURESCALEMODE_SLOW);
+        }
+        SDL_AddRenderDriver(&_this->displays[i], &driver);
+    }
+}
+
+/* Find the info the display was given in X11_AddRenderDriver() */
+static void
+X11_GetDisplayRendererInfo(SDL_VideoDisplay * display, SDL_RendererInfo * info)
+{
+    int i;
+
+    for (i = 0; i < display->num_render_drivers; ++i) {
+        if (display->render_drivers[i].CreateRenderer == X11_CreateRenderer) {
+            *info = display->render_drivers[i].info;
+            return;
+        }
     }
+    *info = X11_RenderDriver.info;
 }
 
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+/* Drop the Xrender features from the info when drawing with core X11 */
+static void
+X11_RemoveXRenderInfo(SDL_RendererInfo * info, Uint32 display_format)
+{
+    int i;
+
+    info->blend_modes = SDL_BLENDMODE_NONE;
+    info->scale_modes = SDL_TEXTURESCALEMODE_NONE;
+    if (display_format == SDL_PIXELFORMAT_ARGB8888) {
+        return;
+    }
+    for (i = 0; i < info->num_texture_formats; ++i) {
+        if (info->texture_formats[i] == SDL_PIXELFORMAT_ARGB8888) {
+            info->texture_formats[i] =
+                info->texture_formats[--info->num_texture_formats];
+            return;
+        }
+    }
+}
+
+static void
+X11_DestroyPictures(SDL_Renderer * renderer)
+{
+    X11_RenderData *data = (X11_RenderData *) renderer->driverdata;
+
+    X11_DestroyDrawablePictures(renderer);
+    if (data->xwindow_pict) {
+        XRenderFreePicture(data->display, data->xwindow_pict);
+        data->xwindow_pict = None;
+    }
+    if (data->brush_pict) {
+        XRenderFreePicture(data->display, data->brush_pict);
+        data->brush_pict = None;
+    }
+    if (data->brush != None) {
+        XFreePixmap(data->display, data->brush);
+        data->brush = None;
+    }
+    if (data->argb_gc) {
+        XFreeGC(data->display, data->argb_gc);
+        data->argb_gc = NULL;
+    }
+}
+#endif /* SDL_VIDEO_DRIVER_X11_XRENDER */
+
 SDL_Renderer *
 X11_CreateRenderer(SDL_Window * window, Uint32 flags)
 {
@@ -215,12 +556,13 @@ X11_CreateRenderer(SDL_Window * window, Uint32 flags)
     renderer->RenderDrawRects = X11_RenderDrawRects;
     renderer->RenderFillRects = X11_RenderFillRects;
     renderer->RenderCopy = X11_RenderCopy;
+    renderer->RenderCopyMany = X11_RenderCopyMany;
     renderer->RenderReadPixels = X11_RenderReadPixels;
     renderer->RenderWritePixels = X11_RenderWritePixels;
     renderer->RenderPresent = X11_RenderPresent;
     renderer->DestroyTexture = X11_DestroyTexture;
     renderer->DestroyRenderer = X11_DestroyRenderer;
-    renderer->info = X11_RenderDriver.info;
+    X11_GetDisplayRendererInfo(display, &renderer->info);
     renderer->window = window;
     renderer->driverdata = data;
 
@@ -279,6 +621,22 @@ X11_CreateRenderer(SDL_Window * window, Uint32 flags)
         return NULL;
     }
 
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+    {
+        int major, minor;
+
+        if (CheckXRender(data->display, &major, &minor) &&
+            X11_CreatePictures(renderer) == 0) {
+            data->use_xrender = SDL_TRUE;
+        } else {
+            /* Draw with the core X11 calls instead */
+            X11_DestroyPictures(renderer);
+            X11_RemoveXRenderInfo(&renderer->info,
+                                  display->desktop_mode.format);
+        }
+    }
+#endif
+
     return renderer;
 }
 
@@ -289,6 +647,11 @@ X11_DisplayModeChanged(SDL_Renderer * renderer)
     SDL_Window *window = renderer->window;
     int i, n;
 
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+    if (data->use_xrender) {
+        X11_DestroyDrawablePictures(renderer);
+    }
+#endif
     if (renderer->info.flags & SDL_RENDERER_SINGLEBUFFER) {
         n = 0;
     } else if (renderer->info.flags & SDL_RENDERER_PRESENTFLIP2) {
@@ -318,6 +681,11 @@ X11_DisplayModeChanged(SDL_Renderer * renderer)
     }
     data->current_pixmap = 0;
 
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+    if (data->use_xrender) {
+        return X11_CreateDrawablePictures(renderer);
+    }
+#endif
     return 0;
 }
 
@@ -328,6 +696,7 @@ X11_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     SDL_Window *window = renderer->window;
     SDL_VideoDisplay *display = window->display;
     X11_TextureData *data;
+    Visual *visual = renderdata->visual;
     int pitch_alignmask = ((renderdata->scanline_pad / 8) - 1);
 
     data = (X11_TextureData *) SDL_calloc(1, sizeof(*data));
@@ -337,6 +706,7 @@ X11_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     }
 
     texture->driverdata = data;
+    data->depth = renderdata->depth;
 
     if (SDL_ISPIXELFORMAT_FOURCC(texture->format)) {
         data->yuv =
@@ -346,6 +716,18 @@ X11_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
         }
         data->format = display->current_mode.format;
     } else {
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+        if (renderdata->use_xrender
+            && texture->format == SDL_PIXELFORMAT_ARGB8888
+            && texture->format != display->current_mode.format) {
+            /* Alpha textures are kept premultiplied in 32-bit pixmaps,
+               which can only be drawn through Xrender.
+             */
+            visual = NULL;
+            data->depth = 32;
+            data->premultiplied = SDL_TRUE;
+        } else
+#endif
         /* The image/pixmap depth must be the same as the window or you
            get a BadMatch error when trying to putimage or copyarea.
          */
@@ -362,45 +744,18 @@ X11_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 #ifndef NO_SHARED_MEMORY
         XShmSegmentInfo *shminfo = &data->shminfo;
 
-        shm_error = True;
-
-        if (SDL_X11_HAVE_SHM) {
-            shminfo->shmid =
-                shmget(IPC_PRIVATE, texture->h * data->pitch,
-                       IPC_CREAT | 0777);
-            if (shminfo->shmid >= 0) {
-                shminfo->shmaddr = (char *) shmat(shminfo->shmid, 0, 0);
-                shminfo->readOnly = False;
-                if (shminfo->shmaddr != (char *) -1) {
-                    shm_error = False;
-                    X_handler = XSetErrorHandler(shm_errhandler);
-                    XShmAttach(renderdata->display, shminfo);
-                    XSync(renderdata->display, False);
-                    XSetErrorHandler(X_handler);
-                    if (shm_error) {
-                        shmdt(shminfo->shmaddr);
-                    }
-                }
-                shmctl(shminfo->shmid, IPC_RMID, NULL);
-            }
-        }
-        if (!shm_error) {
+        if (X11_AttachShm
+            (renderdata->display, shminfo, texture->h * data->pitch)) {
             data->pixels = shminfo->shmaddr;
 
             data->image =
-                XShmCreateImage(renderdata->display, renderdata->visual,
-                                renderdata->depth, ZPixmap, shminfo->shmaddr,
-                                shminfo, texture->w, texture->h);
+                XShmCreateImage(renderdata->display, visual, data->depth,
+                                ZPixmap, shminfo->shmaddr, shminfo,
+                                texture->w, texture->h);
             if (!data->image) {
-                XShmDetach(renderdata->display, shminfo);
-                XSync(renderdata->display, False);
-                shmdt(shminfo->shmaddr);
-                shm_error = True;
+                X11_DetachShm(renderdata->display, shminfo);
             }
         }
-        if (shm_error) {
-            shminfo->shmaddr = NULL;
-        }
         if (!data->image)
 #endif /* not NO_SHARED_MEMORY */
         {
@@ -412,10 +767,9 @@ X11_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
             }
 
             data->image =
-                XCreateImage(renderdata->display, renderdata->visual,
-                             renderdata->depth, ZPixmap, 0, data->pixels,
-                             texture->w, texture->h,
-                             SDL_BYTESPERPIXEL(data->format) * 8,
+                XCreateImage(renderdata->display, visual, data->depth,
+                             ZPixmap, 0, data->pixels, texture->w,
+                             texture->h, SDL_BYTESPERPIXEL(data->format) * 8,
                              data->pitch);
             if (!data->image) {
                 X11_DestroyTexture(renderer, texture);
@@ -423,21 +777,58 @@ X11_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
                 return -1;
             }
         }
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+        /* The pixels are uploaded into a pixmap when composited */
+        if (renderdata->use_xrender) {
+            data->pixmap =
+                XCreatePixmap(renderdata->display, renderdata->xwindow,
+                              texture->w, texture->h, data->depth);
+            if (data->pixmap == None) {
+                X11_DestroyTexture(renderer, texture);
+                SDL_SetError("XCreatePixmap() failed");
+                return -1;
+            }
+        }
+#endif
     } else {
-        data->pixmap =
-            XCreatePixmap(renderdata->display, renderdata->xwindow, texture->w,
-                          texture->h, renderdata->depth);
-        if (data->pixmap == None) {
-            X11_DestroyTexture(renderer, texture);
-            SDL_SetError("XCreatePixmap() failed");
-            return -1;
+#ifndef NO_SHARED_MEMORY
+        /* Prefer a shared memory pixmap, so updates are simply written
+           into the pixmap instead of being sent through the X protocol.
+         */
+        XShmSegmentInfo *shminfo = &data->shminfo;
+
+        if (SDL_X11_HAVE_SHM
+            && XShmPixmapFormat(renderdata->display) == ZPixmap
+            && X11_AttachShm(renderdata->display, shminfo,
+                             texture->h * data->pitch)) {
+            data->pixmap =
+                XShmCreatePixmap(renderdata->display, renderdata->xwindow,
+                                 shminfo->shmaddr, shminfo, texture->w,
+                                 texture->h, data->depth);
+            if (data->pixmap == None) {
+                X11_DetachShm(renderdata->display, shminfo);
+            } else {
+                data->pixels = shminfo->shmaddr;
+                data->shm_pixmap = SDL_TRUE;
+            }
+        }
+        if (data->pixmap == None)
+#endif /* not NO_SHARED_MEMORY */
+        {
+            data->pixmap =
+                XCreatePixmap(renderdata->display, renderdata->xwindow,
+                              texture->w, texture->h, data->depth);
+            if (data->pixmap == None) {
+                X11_DestroyTexture(renderer, texture);
+                SDL_SetError("XCreatePixmap() failed");
+                return -1;
+            }
         }
 
         data->image =
-            XCreateImage(renderdata->display, renderdata->visual,
-                         renderdata->depth, ZPixmap, 0, NULL, texture->w,
-                         texture->h, SDL_BYTESPERPIXEL(data->format) * 8,
-                         data->pitch);
+            XCreateImage(renderdata->display, visual, data->depth, ZPixmap, 0,
+                         NULL, texture->w, texture->h,
+                         SDL_BYTESPERPIXEL(data->format) * 8, data->pitch);
         if (!data->image) {
             X11_DestroyTexture(renderer, texture);
             SDL_SetError("XCreateImage() failed");
@@ -445,6 +836,28 @@ X11_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
         }
     }
 
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+    if (renderdata->use_xrender) {
+        XRenderPictFormat *pict_fmt;
+
+        if (data->premultiplied) {
+            pict_fmt =
+                XRenderFindStandardFormat(renderdata->display,
+                                          PictStandardARGB32);
+        } else {
+            pict_fmt = renderdata->xwindow_pict_fmt;
+        }
+        data->picture =
+            XRenderCreatePicture(renderdata->display, data->pixmap, pict_fmt,
+                                 0, NULL);
+        if (!data->picture) {
+            X11_DestroyTexture(renderer, texture);
+            SDL_SetError("XRenderCreatePicture() failed");
+            return -1;
+        }
+    }
+#endif
+
     return 0;
 }
 
@@ -456,6 +869,12 @@ X11_QueryTexturePixels(SDL_Renderer * renderer, SDL_Texture * texture,
 
     if (data->yuv) {
         return SDL_SW_QueryYUVTexturePixels(data->yuv, pixels, pitch);
+#ifndef NO_SHARED_MEMORY
+    } else if (data->shm_pixmap) {
+        /* The pixmap memory has to be synchronized with the server */
+        SDL_SetError("Texture pixels can't be accessed directly");
+        return -1;
+#endif
     } else {
         *pixels = data->pixels;
         *pitch = data->pitch;
@@ -466,14 +885,27 @@ X11_QueryTexturePixels(SDL_Renderer * renderer, SDL_Texture * texture,
 static int
 X11_SetTextureBlendMode(SDL_Renderer * renderer, SDL_Texture * texture)
 {
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+    X11_TextureData *data = (X11_TextureData *) texture->driverdata;
+#endif
+
     switch (texture->blendMode) {
     case SDL_BLENDMODE_NONE:
         return 0;
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+    case SDL_BLENDMODE_BLEND:
+    case SDL_BLENDMODE_ADD:
+        if (data->picture) {
+            return 0;
+        }
+        break;
+#endif
     default:
-        SDL_Unsupported();
-        texture->blendMode = SDL_BLENDMODE_NONE;
-        return -1;
+        break;
     }
+    SDL_Unsupported();
+    texture->blendMode = SDL_BLENDMODE_NONE;
+    return -1;
 }
 
 static int
@@ -481,6 +913,28 @@ X11_SetTextureScaleMode(SDL_Renderer * renderer, SDL_Texture * texture)
 {
     X11_TextureData *data = (X11_TextureData *) texture->driverdata;
 
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+    if (data->picture) {
+        X11_RenderData *renderdata = (X11_RenderData *) renderer->driverdata;
+
+        switch (texture->scaleMode) {
+        case SDL_TEXTURESCALEMODE_NONE:
+        case SDL_TEXTURESCALEMODE_FAST:
+            XRenderSetPictureFilter(renderdata->display, data->picture,
+                                    FilterNearest, NULL, 0);
+            return 0;
+        case SDL_TEXTURESCALEMODE_SLOW:
+            XRenderSetPictureFilter(renderdata->display, data->picture,
+                                    FilterBilinear, NULL, 0);
+            return 0;
+        default:
+            SDL_Unsupported();
+            texture->scaleMode = SDL_TEXTURESCALEMODE_NONE;
+            return -1;
+        }
+    }
+#endif
+
     switch (texture->scaleMode) {
     case SDL_TEXTURESCALEMODE_NONE:
         return 0;
@@ -498,6 +952,94 @@ X11_SetTextureScaleMode(SDL_Renderer * renderer, SDL_Texture * texture)
     return 0;
 }
 
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+static XImage *
+X11_GetUploadImage(X11_RenderData * renderdata, X11_TextureData * data,
+                   int w, int h)
+{
+    XImage *image = data->upload_image;
+    int pitch = w * SDL_BYTESPERPIXEL(data->format);
+
+    if (!image) {
+        void *pixels = SDL_malloc(h * pitch);
+        if (!pixels) {
+            SDL_OutOfMemory();
+            return NULL;
+        }
+        image =
+            XCreateImage(renderdata->display, NULL, data->depth, ZPixmap, 0,
+                         pixels, w, h, SDL_BYTESPERPIXEL(data->format) * 8,
+                         pitch);
+        if (!image) {
+            SDL_free(pixels);
+            SDL_SetError("XCreateImage() failed");
+            return NULL;
+        }
+        data->upload_image = image;
+    } else if (image->width * image->height < w * h) {
+        void *pixels = SDL_realloc(image->data, h * pitch);
+        if (!pixels) {
+            SDL_OutOfMemory();
+            return NULL;
+        }
+        image->data = (char *) pixels;
+    }
+    image->width = w;
+    image->height = h;
+    image->bytes_per_line = pitch;
+    return image;
+}
+
+/* Premultiply a rectangle of straight alpha pixels into the texture pixmap */
+static int
+X11_UploadPremultiplied(SDL_Renderer * renderer, SDL_Texture * texture,
+                        const SDL_Rect * rect, const void *pixels, int pitch)
+{
+    X11_RenderData *renderdata = (X11_RenderData *) renderer->driverdata;
+    X11_TextureData *data = (X11_TextureData *) texture->driverdata;
+    Uint8 *src, *dst;
+    int row, dstpitch;
+    size_t length;
+
+#ifndef NO_SHARED_MEMORY
+    if (data->shm_pixmap) {
+        X11_WaitShm(renderdata);
+        dst =
+            (Uint8 *) data->pixels + rect->y * data->pitch +
+            rect->x * SDL_BYTESPERPIXEL(data->format);
+        dstpitch = data->pitch;
+    } else
+#endif
+    {
+        XImage *image =
+            X11_GetUploadImage(renderdata, data, rect->w, rect->h);
+        if (!image) {
+            return -1;
+        }
+        dst = (Uint8 *) image->data;
+        dstpitch = image->bytes_per_line;
+    }
+
+    src = (Uint8 *) pixels;
+    length = rect->w * SDL_BYTESPERPIXEL(data->format);
+    for (row = 0; row < rect->h; ++row) {
+        SDL_memcpy(dst + row * dstpitch, src, length);
+        src += pitch;
+    }
+    SDL_PreMultiplyAlphaARGB8888(rect->w, rect->h, (Uint32 *) dst,
+                                 dstpitch);
+
+#ifndef NO_SHARED_MEMORY
+    if (data->shm_pixmap) {
+        return 0;
+    }
+#endif
+    XPutImage(renderdata->display, data->pixmap, renderdata->argb_gc,
+              data->upload_image, 0, 0, rect->x, rect->y, rect->w, rect->h);
+    return 0;
+}
+#endif /* SDL_VIDEO_DRIVER_X11_XRENDER */
+
 static int
 X11_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                   const SDL_Rect * rect, const void *pixels, int pitch)
@@ -513,11 +1055,23 @@ X11_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
     } else {
         X11_RenderData *renderdata = (X11_RenderData *) renderer->driverdata;
 
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+        if (data->premultiplied
+            && texture->access != SDL_TEXTUREACCESS_STREAMING) {
+            return X11_UploadPremultiplied(renderer, texture, rect, pixels,
+                                           pitch);
+        }
+#endif
         if (data->pixels) {
             Uint8 *src, *dst;
             int row;
             size_t length;
 
+#ifndef NO_SHARED_MEMORY
+            if (data->shminfo.shmaddr) {
+                X11_WaitShm(renderdata);
+            }
+#endif
             src = (Uint8 *) pixels;
             dst =
                 (Uint8 *) data->pixels + rect->y * data->pitch +
@@ -551,6 +1105,11 @@ X11_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
         return SDL_SW_LockYUVTexture(data->yuv, rect, markDirty, pixels,
                                      pitch);
     } else if (data->pixels) {
+#ifndef NO_SHARED_MEMORY
+        if (data->shminfo.shmaddr) {
+            X11_WaitShm((X11_RenderData *) renderer->driverdata);
+        }
+#endif
         *pixels =
             (void *) ((Uint8 *) data->pixels + rect->y * data->pitch +
                       rect->x * SDL_BYTESPERPIXEL(texture->format));
@@ -576,14 +1135,27 @@ X11_UnlockTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 static int
 X11_SetDrawBlendMode(SDL_Renderer * renderer)
 {
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+    X11_RenderData *data = (X11_RenderData *) renderer->driverdata;
+#endif
+
     switch (renderer->blendMode) {
     case SDL_BLENDMODE_NONE:
         return 0;
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+    case SDL_BLENDMODE_BLEND:
+    case SDL_BLENDMODE_ADD:
+        if (data->use_xrender) {
+            return 0;
+        }
+        break;
+#endif
     default:
-        SDL_Unsupported();
-        renderer->blendMode = SDL_BLENDMODE_NONE;
-        return -1;
+        break;
     }
+    SDL_Unsupported();
+    renderer->blendMode = SDL_BLENDMODE_NONE;
+    return -1;
 }
 
 static Uint32
@@ -627,6 +1199,37 @@ X11_RenderDrawPoints(SDL_Renderer * renderer, const SDL_Point * points,
         SDL_AddDirtyRect(&data->dirty, &rect);
     }
 
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+    if (data->use_xrender && renderer->blendMode != SDL_BLENDMODE_NONE) {
+        XRenderColor xrender_color = xrenderdrawcolor(renderer);
+        XRectangle *xrects, *xrect;
+
+        xrect = xrects = SDL_stack_alloc(XRectangle, count);
+        xcount = 0;
+        for (i = 0; i < count; ++i) {
+            int x = points[i].x;
+            int y = points[i].y;
+            if (x < 0 || x >= window->w || y < 0 || y >= window->h) {
+                continue;
+            }
+            xrect->x = (short)x;
+            xrect->y = (short)y;
+            xrect->width = 1;
+            xrect->height = 1;
+            ++xrect;
+            ++xcount;
+        }
+        if (xcount > 0) {
+            XRenderFillRectangles(data->display,
+                                  xrenderblendop(renderer->blendMode),
+                                  data->drawable_pict, &xrender_color,
+                                  xrects, xcount);
+        }
+        SDL_stack_free(xrects);
+        return 0;
+    }
+#endif
+
     foreground = renderdrawcolor(renderer, 1);
     XSetForeground(data->display, data->gc, foreground);
 
@@ -652,14 +1255,13 @@ X11_RenderDrawPoints(SDL_Renderer * renderer, const SDL_Point * points,
     return 0;
 }
 
-static int
-X11_RenderDrawLines(SDL_Renderer * renderer, const SDL_Point * points,
-                    int count)
+static void
+X11_DrawLinesTo(SDL_Renderer * renderer, Drawable drawable, GC gc,
+                const SDL_Point * points, int count, SDL_bool makedirty)
 {
     X11_RenderData *data = (X11_RenderData *) renderer->driverdata;
     SDL_Window *window = renderer->window;
-    SDL_Rect clip, rect;
-    unsigned long foreground;
+    SDL_Rect clip;
     XPoint *xpoints, *xpoint;
     int i, xcount;
     int minx, miny;
@@ -670,9 +1272,6 @@ X11_RenderDrawLines(SDL_Renderer * renderer, const SDL_Point * points,
     clip.w = window->w;
     clip.h = window->h;
 
-    foreground = renderdrawcolor(renderer, 1);
-    XSetForeground(data->display, data->gc, foreground);
-
     xpoint = xpoints = SDL_stack_alloc(XPoint, count);
     xcount = 0;
     minx = INT_MAX;
@@ -724,12 +1323,12 @@ X11_RenderDrawLines(SDL_Renderer * renderer, const SDL_Point * points,
                 ++xpoint;
                 ++xcount;
             }
-            XDrawLines(data->display, data->drawable, data->gc,
+            XDrawLines(data->display, drawable, gc,
                        xpoints, xcount, CoordModeOrigin);
             if (xpoints[0].x != x2 || xpoints[0].y != y2) {
-                XDrawPoint(data->display, data->drawable, data->gc, x2, y2);
+                XDrawPoint(data->display, drawable, gc, x2, y2);
             }
-            if (data->makedirty) {
+            if (makedirty) {
                 SDL_Rect rect;
 
                 rect.x = minx;
@@ -771,12 +1370,12 @@ X11_RenderDrawLines(SDL_Renderer * renderer, const SDL_Point * points,
     if (xcount > 1) {
         int x2 = xpoint[-1].x;
         int y2 = xpoint[-1].y;
-        XDrawLines(data->display, data->drawable, data->gc, xpoints, xcount,
+        XDrawLines(data->display, drawable, gc, xpoints, xcount,
                    CoordModeOrigin);
         if (xpoints[0].x != x2 || xpoints[0].y != y2) {
-            XDrawPoint(data->display, data->drawable, data->gc, x2, y2);
+            XDrawPoint(data->display, drawable, gc, x2, y2);
         }
-        if (data->makedirty) {
+        if (makedirty) {
             SDL_Rect rect;
 
             rect.x = minx;
@@ -787,7 +1386,79 @@ X11_RenderDrawLines(SDL_Renderer * renderer, const SDL_Point * points,
         }
     }
     SDL_stack_free(xpoints);
+}
+
+static int
+X11_RenderDrawLines(SDL_Renderer * renderer, const SDL_Point * points,
+                    int count)
+{
+    X11_RenderData *data = (X11_RenderData *) renderer->driverdata;
+    unsigned long foreground;
+
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+    if (data->use_xrender && renderer->blendMode != SDL_BLENDMODE_NONE) {
+        SDL_Window *window = renderer->window;
+        XRenderColor xrender_color = xrenderdrawcolor(renderer);
+        SDL_Rect clip, rect;
+        XRectangle xrect;
+        int i, minx, miny, maxx, maxy;
 
+        if (count < 1) {
+            return 0;
+        }
+        clip.x = 0;
+        clip.y = 0;
+        clip.w = window->w;
+        clip.h = window->h;
+
+        minx = maxx = points[0].x;
+        miny = maxy = points[0].y;
+        for (i = 1; i < count; ++i) {
+            minx = SDL_min(minx, points[i].x);
+            miny = SDL_min(miny, points[i].y);
+            maxx = SDL_max(maxx, points[i].x);
+            maxy = SDL_max(maxy, points[i].y);
+        }
+        rect.x = minx;
+        rect.y = miny;
+        rect.w = (maxx - minx) + 1;
+        rect.h = (maxy - miny) + 1;
+        if (!SDL_IntersectRect(&rect, &clip, &rect)) {
+            return 0;
+        }
+
+        /* Rasterize the lines into the stencil, then blend the draw
+           color through it in a single composite request.
+         */
+        xrect.x = (short)rect.x;
+        xrect.y = (short)rect.y;
+        xrect.width = (unsigned short)rect.w;
+        xrect.height = (unsigned short)rect.h;
+        XSetForeground(data->display, data->stencil_gc, 0);
+        XFillRectangles(data->display, data->stencil, data->stencil_gc,
+                        &xrect, 1);
+        XSetForeground(data->display, data->stencil_gc, 0xFF);
+        X11_DrawLinesTo(renderer, data->stencil, data->stencil_gc, points,
+                        count, SDL_FALSE);
+
+        XRenderFillRectangle(data->display, PictOpSrc, data->brush_pict,
+                             &xrender_color, 0, 0, 1, 1);
+        XRenderComposite(data->display, xrenderblendop(renderer->blendMode),
+                         data->brush_pict, data->stencil_pict,
+                         data->drawable_pict, 0, 0, rect.x, rect.y, rect.x,
+                         rect.y, rect.w, rect.h);
+        if (data->makedirty) {
+            SDL_AddDirtyRect(&data->dirty, &rect);
+        }
+        return 0;
+    }
+#endif
+
+    foreground = renderdrawcolor(renderer, 1);
+    XSetForeground(data->display, data->gc, foreground);
+
+    X11_DrawLinesTo(renderer, data->drawable, data->gc, points, count,
+                    data->makedirty);
     return 0;
 }
 
@@ -806,6 +1477,75 @@ X11_RenderDrawRects(SDL_Renderer * renderer, const SDL_Rect ** rects, int count)
     clip.w = window->w;
     clip.h = window->h;
 
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+    if (data->use_xrender && renderer->blendMode != SDL_BLENDMODE_NONE) {
+        XRenderColor xrender_color = xrenderdrawcolor(renderer);
+        SDL_Rect edges[4];
+        int j, nedges;
+
+        /* Fill the outline as separate edges so corners blend once */
+        xrect = xrects = SDL_stack_alloc(XRectangle, count * 4);
+        xcount = 0;
+        for (i = 0; i < count; ++i) {
+            const SDL_Rect *r = rects[i];
+
+            if (!SDL_IntersectRect(r, &clip, &rect)) {
+                continue;
+            }
+            if (data->makedirty) {
+                SDL_AddDirtyRect(&data->dirty, &rect);
+            }
+
+            nedges = 0;
+            edges[nedges].x = r->x;
+            edges[nedges].y = r->y;
+            edges[nedges].w = r->w;
+            edges[nedges].h = 1;
+            ++nedges;
+            if (r->h > 1) {
+                edges[nedges].x = r->x;
+                edges[nedges].y = r->y + r->h - 1;
+                edges[nedges].w = r->w;
+                edges[nedges].h = 1;
+                ++nedges;
+            }
+            if (r->h > 2) {
+                edges[nedges].x = r->x;
+                edges[nedges].y = r->y + 1;
+                edges[nedges].w = 1;
+                edges[nedges].h = r->h - 2;
+                ++nedges;
+                if (r->w > 1) {
+                    edges[nedges].x = r->x + r->w - 1;
+                    edges[nedges].y = r->y + 1;
+                    edges[nedges].w = 1;
+                    edges[nedges].h = r->h - 2;
+                    ++nedges;
+                }
+            }
+            for (j = 0; j < nedges; ++j) {
+                if (!SDL_IntersectRect(&edges[j], &clip, &rect)) {
+                    continue;
+                }
+                xrect->x = (short)rect.x;
+                xrect->y = (short)rect.y;
+                xrect->width = (unsigned short)rect.w;
+                xrect->height = (unsigned short)rect.h;
+                ++xrect;
+                ++xcount;
+            }
+        }
+        if (xcount > 0) {
+            XRenderFillRectangles(data->display,
+                                  xrenderblendop(renderer->blendMode),
+                                  data->drawable_pict, &xrender_color,
+                                  xrects, xcount);
+        }
+        SDL_stack_free(xrects);
+        return 0;
+    }
+#endif
+
     foreground = renderdrawcolor(renderer, 1);
     XSetForeground(data->display, data->gc, foreground);
 
@@ -873,6 +1613,16 @@ X11_RenderFillRects(SDL_Renderer * renderer, const SDL_Rect ** rects, int count)
         }
     }
     if (xcount > 0) {
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+        if (data->use_xrender && renderer->blendMode != SDL_BLENDMODE_NONE) {
+            XRenderColor xrender_color = xrenderdrawcolor(renderer);
+
+            XRenderFillRectangles(data->display,
+                                  xrenderblendop(renderer->blendMode),
+                                  data->drawable_pict, &xrender_color,
+                                  xrects, xcount);
+        } else
+#endif
         XFillRectangles(data->display, data->drawable, data->gc,
                         xrects, xcount);
     }
@@ -881,6 +1631,79 @@ X11_RenderFillRects(SDL_Renderer * renderer, const SDL_Rect ** rects, int count)
     return 0;
 }
 
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+static int
+X11_RenderComposite(SDL_Renderer * renderer, SDL_Texture * texture,
+                    const SDL_Rect * srcrect, const SDL_Rect * dstrect)
+{
+    X11_RenderData *data = (X11_RenderData *) renderer->driverdata;
+    X11_TextureData *texturedata = (X11_TextureData *) texture->driverdata;
+    int op = xrenderblendop(texture->blendMode);
+
+    /* Bring the pixmap up to date with the client side pixels */
+    if (texturedata->yuv || texture->access == SDL_TEXTUREACCESS_STREAMING) {
+        if (texturedata->premultiplied) {
+            const Uint8 *pixels =
+                (const Uint8 *) texturedata->pixels +
+                srcrect->y * texturedata->pitch +
+                srcrect->x * SDL_BYTESPERPIXEL(texturedata->format);
+            if (X11_UploadPremultiplied(renderer, texture, srcrect, pixels,
+                                        texturedata->pitch) < 0) {
+                return -1;
+            }
+        } else
+#ifndef NO_SHARED_MEMORY
+        if (texturedata->shminfo.shmaddr) {
+            XShmPutImage(data->display, texturedata->pixmap, data->gc,
+                         texturedata->image, srcrect->x, srcrect->y,
+                         srcrect->x, srcrect->y, srcrect->w, srcrect->h,
+                         False);
+            data->shm_pending = SDL_TRUE;
+        } else
+#endif
+        {
+            XPutImage(data->display, texturedata->pixmap, data->gc,
+                      texturedata->image, srcrect->x, srcrect->y,
+                      srcrect->x, srcrect->y, srcrect->w, srcrect->h);
+        }
+    }
+
+    if (srcrect->w == dstrect->w && srcrect->h == dstrect->h) {
+        XRenderComposite(data->display, op, texturedata->picture, None,
+                         data->drawable_pict, srcrect->x, srcrect->y, 0, 0,
+                         dstrect->x, dstrect->y, dstrect->w, dstrect->h);
+    } else {
+        /* Map destination pixels back onto the source rectangle */
+        XTransform xform;
+
+        SDL_zero(xform);
+        xform.matrix[0][0] = XDoubleToFixed((double) srcrect->w / dstrect->w);
+        xform.matrix[0][2] = XDoubleToFixed(srcrect->x);
+        xform.matrix[1][1] = XDoubleToFixed((double) srcrect->h / dstrect->h);
+        xform.matrix[1][2] = XDoubleToFixed(srcrect->y);
+        xform.matrix[2][2] = XDoubleToFixed(1);
+        XRenderSetPictureTransform(data->display, texturedata->picture,
+                                   &xform);
+        XRenderComposite(data->display, op, texturedata->picture, None,
+                         data->drawable_pict, 0, 0, 0, 0, dstrect->x,
+                         dstrect->y, dstrect->w, dstrect->h);
+
+        SDL_zero(xform);
+        xform.matrix[0][0] = XDoubleToFixed(1);
+        xform.matrix[1][1] = XDoubleToFixed(1);
+        xform.matrix[2][2] = XDoubleToFixed(1);
+        XRenderSetPictureTransform(data->display, texturedata->picture,
+                                   &xform);
+    }
+#ifndef NO_SHARED_MEMORY
+    if (texturedata->shm_pixmap) {
+        data->shm_pending = SDL_TRUE;
+    }
+#endif
+    return 0;
+}
+#endif /* SDL_VIDEO_DRIVER_X11_XRENDER */
+
 static int
 X11_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
                const SDL_Rect * srcrect, const SDL_Rect * dstrect)
@@ -891,16 +1714,26 @@ X11_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     if (data->makedirty) {
         SDL_AddDirtyRect(&data->dirty, dstrect);
     }
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+    if (texturedata->picture
+        && (texture->blendMode != SDL_BLENDMODE_NONE
+            || texturedata->premultiplied
+            || srcrect->w != dstrect->w || srcrect->h != dstrect->h)) {
+        return X11_RenderComposite(renderer, texture, srcrect, dstrect);
+    }
+#endif
     if (srcrect->w == dstrect->w && srcrect->h == dstrect->h) {
+        if (texturedata->yuv
+            || texture->access == SDL_TEXTUREACCESS_STREAMING) {
 #ifndef NO_SHARED_MEMORY
-        if (texturedata->shminfo.shmaddr) {
-            XShmPutImage(data->display, data->drawable, data->gc,
-                         texturedata->image, srcrect->x, srcrect->y,
-                         dstrect->x, dstrect->y, srcrect->w, srcrect->h,
-                         False);
-        } else
+            if (texturedata->shminfo.shmaddr) {
+                XShmPutImage(data->display, data->drawable, data->gc,
+                             texturedata->image, srcrect->x, srcrect->y,
+                             dstrect->x, dstrect->y, srcrect->w, srcrect->h,
+                             False);
+                data->shm_pending = SDL_TRUE;
+            } else
 #endif
-        if (texturedata->pixels) {
             XPutImage(data->display, data->drawable, data->gc,
                       texturedata->image, srcrect->x, srcrect->y, dstrect->x,
                       dstrect->y, srcrect->w, srcrect->h);
@@ -908,6 +1741,11 @@ X11_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
             XCopyArea(data->display, texturedata->pixmap, data->drawable,
                       data->gc, srcrect->x, srcrect->y, dstrect->w,
                       dstrect->h, dstrect->x, dstrect->y);
+#ifndef NO_SHARED_MEMORY
+            if (texturedata->shm_pixmap) {
+                data->shm_pending = SDL_TRUE;
+            }
+#endif
         }
     } else if (texturedata->yuv
                || texture->access == SDL_TEXTUREACCESS_STREAMING) {
@@ -993,6 +1831,22 @@ X11_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     return 0;
 }
 
+static int
+X11_RenderCopyMany(SDL_Renderer * renderer, const SDL_TextureCopy * copies,
+                   int count)
+{
+    int i;
+
+    /* Xlib queues the requests, so they go to the server together */
+    for (i = 0; i < count; ++i) {
+        if (X11_RenderCopy(renderer, copies[i].texture, &copies[i].srcrect,
+                           &copies[i].dstrect) < 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
 static int
 X11_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                      Uint32 format, void * pixels, int pitch)
@@ -1073,7 +1927,11 @@ X11_RenderPresent(SDL_Renderer * renderer)
         }
         SDL_ClearDirtyRects(&data->dirty);
     }
-    XSync(data->display, False);
+
+    /* Push the batched requests out without waiting for a round trip,
+       shared memory users wait for the server only when they need to.
+     */
+    XFlush(data->display);
 
     /* Update the flipping chain, if any */
     if (renderer->info.flags & SDL_RENDERER_PRESENTFLIP2) {
@@ -1083,6 +1941,11 @@ X11_RenderPresent(SDL_Renderer * renderer)
         data->current_pixmap = (data->current_pixmap + 1) % 3;
         data->drawable = data->pixmaps[data->current_pixmap];
     }
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+    if (data->use_xrender && data->drawable != data->xwindow) {
+        data->drawable_pict = data->pixmap_picts[data->current_pixmap];
+    }
+#endif
 }
 
 static void
@@ -1097,6 +1960,16 @@ X11_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     if (data->yuv) {
         SDL_SW_DestroyYUVTexture(data->yuv);
     }
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+    if (data->picture) {
+        XRenderFreePicture(renderdata->display, data->picture);
+    }
+    if (data->upload_image) {
+        SDL_free(data->upload_image->data);
+        data->upload_image->data = NULL;
+        XDestroyImage(data->upload_image);
+    }
+#endif
     if (data->pixmap != None) {
         XFreePixmap(renderdata->display, data->pixmap);
     }
@@ -1106,9 +1979,7 @@ X11_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     }
 #ifndef NO_SHARED_MEMORY
     if (data->shminfo.shmaddr) {
-        XShmDetach(renderdata->display, &data->shminfo);
-        XSync(renderdata->display, False);
-        shmdt(data->shminfo.shmaddr);
+        X11_DetachShm(renderdata->display, &data->shminfo);
         data->pixels = NULL;
     }
 #endif
@@ -1131,6 +2002,9 @@ X11_DestroyRenderer(SDL_Renderer * renderer)
     int i;
 
     if (data) {
+#if SDL_VIDEO_DRIVER_X11_XRENDER
+        X11_DestroyPictures(renderer);
+#endif
         for (i = 0; i < SDL_arraysize(data->pixmaps); ++i) {
             if (data->pixmaps[i] != None) {
                 XFreePixmap(data->display, data->pixmaps[i]);
@@ -68,6 +68,949 @@ static void audio_testOpen (void)
 }
 
 
+/**
+ * @brief Checks a WAVE stream against the same file loaded all at once.
+ */
+static int audio_compareWAVStream( SDL_WAVStream *stream, const Uint8 *buf,
+      Uint32 len, int framesize )
+{
+   int i, ret;
+   Uint32 frame, frames;
+   Uint8 data[4096];
+   /* Blocks of sample.wav are 1012 frames long. */
+   const Uint32 seeks[] = { 0, 1, 1011, 1012, 1013, 123456 };
+
+   frames = SDL_GetWAVStreamLength( stream );
+   if (SDL_ATassert( "SDL_GetWAVStreamLength", frames * framesize == len ))
+      return -1;
+
+   /* Read all of it, in pieces that don't line up with the blocks. */
+   for (frame=0; frame<frames; frame+=ret) {
+      ret = SDL_ReadWAVStream( stream, data, 333 );
+      if (SDL_ATvassert( ret > 0, "SDL_ReadWAVStream: %s", SDL_GetError() ))
+         return -1;
+      if (SDL_ATassert( "WAVE stream output not the same.",
+               SDL_memcmp( data, buf + frame * framesize,
+                  ret * framesize ) == 0 ))
+         return -1;
+   }
+   ret = SDL_ReadWAVStream( stream, data, 333 );
+   if (SDL_ATassert( "SDL_ReadWAVStream past the end", ret == 0 ))
+      return -1;
+
+   /* Read after seeking. */
+   for (i=0; i<(int)SDL_arraysize(seeks); i++) {
+      frame = SDL_min( seeks[i], frames );
+      ret = SDL_SeekWAVStream( stream, frame );
+      if (SDL_ATvassert( ret == 0, "SDL_SeekWAVStream: %s", SDL_GetError() ))
+         return -1;
+      ret = SDL_ReadWAVStream( stream, data, 2 );
+      if (SDL_ATassert( "WAVE stream output not the same after seeking.",
+               ret == (int)SDL_min( 2, frames - frame ) &&
+               SDL_memcmp( data, buf + frame * framesize,
+                  ret * framesize ) == 0 ))
+         return -1;
+   }
+   ret = SDL_SeekWAVStream( stream, frames + 1 );
+   if (SDL_ATassert( "SDL_SeekWAVStream past the end", ret == -1 ))
+      return -1;
+
+   return 0;
+}
+
+
+/**
+ * @brief Tests decoding WAVE files a few frames at a time.
+ */
+static void audio_testWAVStream (void)
+{
+   int i, ret;
+   SDL_AudioSpec spec, stream_spec;
+   SDL_WAVStream *stream;
+   SDL_RWops *rw;
+   Uint8 *buf;
+   Uint32 len;
+   Uint8 wav[44 + 24 + 12];
+   /* Extensible 24-bit stereo PCM, two frames. */
+   const Uint8 header[] = {
+      'R', 'I', 'F', 'F', 36 + 24 + 12, 0, 0, 0, 'W', 'A', 'V', 'E',
+      'f', 'm', 't', ' ', 40, 0, 0, 0,
+      0xFE, 0xFF, 2, 0, 0x80, 0xBB, 0, 0, 0x00, 0x65, 0x04, 0, 6, 0, 24, 0,
+      22, 0, 24, 0, 3, 0, 0, 0,
+      1, 0, 0, 0, 0, 0, 0x10, 0, 0x80, 0, 0, 0xAA, 0, 0x38, 0x9B, 0x71,
+      'd', 'a', 't', 'a', 12, 0, 0, 0
+   };
+
+   SDL_ATbegin( "WAVE Stream" );
+
+   /* MS ADPCM */
+   if (SDL_ATvassert( SDL_LoadWAV( "../sample.wav", &spec, &buf, &len ) != NULL,
+            "SDL_LoadWAV: %s", SDL_GetError() ))
+      return;
+   stream = SDL_OpenWAVStream( "../sample.wav", &stream_spec );
+   if (SDL_ATvassert( stream != NULL, "SDL_OpenWAVStream: %s", SDL_GetError() )) {
+      SDL_FreeWAV( buf );
+      return;
+   }
+   if (SDL_ATassert( "WAVE stream format not the same.",
+            stream_spec.format == spec.format &&
+            stream_spec.channels == spec.channels &&
+            stream_spec.freq == spec.freq ))
+      goto err;
+   ret = audio_compareWAVStream( stream, buf, len,
+         SDL_AUDIO_BITSIZE(spec.format) / 8 * spec.channels );
+   if (ret != 0)
+      goto err;
+   SDL_CloseWAVStream( stream );
+   SDL_FreeWAV( buf );
+
+   /* 24-bit samples are expanded to 32 bits. */
+   SDL_memcpy( wav, header, sizeof(header) );
+   for (i=0; i<12; i++)
+      wav[sizeof(header) + i] = i + 1;
+   rw = SDL_RWFromConstMem( wav, sizeof(header) + 12 );
+   if (SDL_ATassert( "SDL_RWFromConstMem", rw != NULL ))
+      return;
+   if (SDL_ATvassert( SDL_LoadWAV_RW( rw, 1, &spec, &buf, &len ) != NULL,
+            "SDL_LoadWAV_RW: %s", SDL_GetError() ))
+      return;
+   if (SDL_ATassert( "24-bit WAVE file not expanded.",
+            spec.format == AUDIO_S32 && spec.channels == 2 && len == 16 ))
+      goto err_buf;
+   for (i=0; i<16; i++) {
+      if (SDL_ATassert( "24-bit WAVE output not the same.",
+               buf[i] == ((i & 3) ? (i / 4) * 3 + (i & 3) : 0) ))
+         goto err_buf;
+   }
+   SDL_FreeWAV( buf );
+
+   SDL_ATend();
+   return;
+
+err:
+   SDL_CloseWAVStream( stream );
+err_buf:
+   SDL_FreeWAV( buf );
+}
+
+
+/**
+ * @brief Converts a mono buffer in place from one sample type to another.
+ */
+static int audio_convertType( Uint8 *buf, int samples,
+      SDL_AudioFormat src_fmt, SDL_AudioFormat dst_fmt )
+{
+   int ret;
+   SDL_AudioCVT cvt;
+
+   ret = SDL_BuildAudioCVT( &cvt, src_fmt, 1, 22050, dst_fmt, 1, 22050 );
+   if (SDL_ATvassert( ret == 1, "SDL_BuildAudioCVT(0x%.4x, 0x%.4x): %s",
+            src_fmt, dst_fmt, SDL_GetError() ))
+      return -1;
+   cvt.buf = buf;
+   cvt.len = samples * SDL_AUDIO_BITSIZE(src_fmt) / 8;
+   ret = SDL_ConvertAudio( &cvt );
+   if (SDL_ATvassert( ret == 0, "SDL_ConvertAudio: %s", SDL_GetError() ))
+      return -1;
+   if (SDL_ATassert( "Converted length not the same.",
+            cvt.len_cvt == samples * SDL_AUDIO_BITSIZE(dst_fmt) / 8 ))
+      return -1;
+   return 0;
+}
+
+
+/**
+ * @brief Tests sample type conversions, including the leftover samples
+ *        that vectorized converters handle one at a time.
+ */
+static void audio_testConvert (void)
+{
+   int i, samples;
+   Sint16 in[37];
+   Sint16 out[37];
+   Uint8 buf[37 * 4];
+   const SDL_AudioFormat formats[] = {
+      AUDIO_S16LSB, AUDIO_F32MSB, AUDIO_S32MSB, AUDIO_F32LSB, AUDIO_S16MSB,
+      AUDIO_S32LSB, AUDIO_F32LSB, AUDIO_S16LSB
+   };
+
+   SDL_ATbegin( "Audio Type Conversion" );
+
+   for (samples=1; samples<=37; samples+=6) {
+      for (i=0; i<samples; i++)
+         in[i] = (i == 0) ? 32767 : (i == 1) ? -32767 : (Sint16)(i * 1789 - 30000);
+      SDL_memcpy( buf, in, samples * sizeof(Sint16) );
+
+      /* Step through float, 32-bit and both byte orders and back. */
+      for (i=1; i<(int)SDL_arraysize(formats); i++) {
+         if (audio_convertType( buf, samples, formats[i-1], formats[i] ))
+            return;
+         if (formats[i] == AUDIO_F32LSB) {
+            float f;
+            SDL_memcpy( &f, buf + 4 * (samples - 1), sizeof(f) );
+            if (SDL_ATvassert( f > (in[samples-1] - 4) / 32767.0f &&
+                     f < (in[samples-1] + 4) / 32767.0f,
+                     "Float sample %f too far from %d", f, in[samples-1] ))
+               return;
+         }
+      }
+
+      /* Truncating float to integer can lose a bit on each step. */
+      SDL_memcpy( out, buf, samples * sizeof(Sint16) );
+      for (i=0; i<samples; i++) {
+         if (SDL_ATvassert( SDL_abs((Sint16)SDL_SwapLE16(out[i]) - in[i]) <= 4,
+                  "Sample %d of %d is %d, expected %d", i, samples,
+                  (Sint16)SDL_SwapLE16(out[i]), in[i] ))
+            return;
+      }
+   }
+
+   SDL_ATend();
+}
+
+
+/**
+ * @brief Fills the buffer with a constant level.
+ */
+static void SDLCALL audio_fillConstant( void *userdata, Uint8 *stream, int len )
+{
+   int i;
+   Sint16 *samples = (Sint16*) stream;
+   (void) userdata;
+   for (i=0; i<len/2; i++)
+      samples[i] = 10000;
+}
+
+
+/**
+ * @brief Sets an environment variable, returning a copy of its old value.
+ */
+static char *audio_setEnv( const char *name, const char *value )
+{
+   const char *old = SDL_getenv( name );
+   char *saved = (old != NULL) ? SDL_strdup( old ) : NULL;
+   SDL_setenv( name, value, 1 );
+   return saved;
+}
+
+
+/**
+ * @brief Puts back an environment variable saved by audio_setEnv.
+ */
+static void audio_restoreEnv( const char *name, char *saved )
+{
+   if (saved != NULL) {
+      SDL_setenv( name, saved, 1 );
+      SDL_free( saved );
+   }
+   else {
+#ifdef HAVE_UNSETENV
+      unsetenv( name );
+#else
+      SDL_setenv( name, "", 1 );
+#endif
+   }
+}
+
+
+/**
+ * @brief Tests setting the volume of an audio device.
+ */
+static void audio_testVolume (void)
+{
+   int ret;
+   SDL_AudioSpec desired;
+
+   SDL_ATbegin( "Audio Device Volume" );
+
+   ret = SDL_Init( SDL_INIT_AUDIO );
+   if (SDL_ATvassert( ret==0, "SDL_Init( SDL_INIT_AUDIO ): %s", SDL_GetError()))
+      return;
+   ret = SDL_AudioInit( "dummy" );
+   if (SDL_ATvassert( ret==0, "SDL_AudioInit( dummy ): %s", SDL_GetError()))
+      goto err;
+
+   /* Not a valid device. */
+   ret = SDL_SetAudioDeviceVolume( 1, SDL_MIX_MAXVOLUME );
+   if (SDL_ATassert( "SDL_SetAudioDeviceVolume on closed device", ret == -1 ))
+      goto err;
+
+   SDL_memset( &desired, 0, sizeof(desired) );
+   desired.freq = 22050;
+   desired.format = AUDIO_S16SYS;
+   desired.channels = 2;
+   desired.samples = 512;
+   desired.callback = audio_fillConstant;
+   ret = SDL_OpenAudio( &desired, NULL );
+   if (SDL_ATvassert( ret==0, "SDL_OpenAudio: %s", SDL_GetError()))
+      goto err;
+
+   /* The dummy driver can't run out of audio. */
+   if (SDL_ATassert( "SDL_GetAudioDeviceUnderruns on new device",
+            SDL_GetAudioDeviceUnderruns( 1 ) == 0 ))
+      goto err_close;
+
+   /* Volume starts the float mixing bus while the device runs. */
+   SDL_PauseAudio( 0 );
+   ret = SDL_SetAudioDeviceVolume( 1, SDL_MIX_MAXVOLUME / 2 );
+   if (SDL_ATvassert( ret==0, "SDL_SetAudioDeviceVolume: %s", SDL_GetError()))
+      goto err_close;
+   SDL_Delay( 50 );
+   ret = SDL_SetAudioDeviceVolume( 1, 0 );
+   if (SDL_ATvassert( ret==0, "SDL_SetAudioDeviceVolume: %s", SDL_GetError()))
+      goto err_close;
+   SDL_Delay( 50 );
+
+   SDL_CloseAudio();
+   SDL_Quit();
+   SDL_ATend();
+   return;
+
+err_close:
+   SDL_CloseAudio();
+err:
+   SDL_Quit();
+}
+
+
+/**
+ * @brief Fills the buffer with a different level on each stereo channel.
+ *
+ * Counts the bytes it was asked for in the Uint32 at userdata.
+ */
+static void SDLCALL audio_fillStereo( void *userdata, Uint8 *stream, int len )
+{
+   int i;
+   Sint16 *samples = (Sint16*) stream;
+   for (i=0; i<len/2; i+=2) {
+      samples[i] = 10000;
+      samples[i+1] = 2000;
+   }
+   *(Uint32*) userdata += len;
+}
+
+
+/**
+ * @brief Reads back a whole file the disk driver wrote.
+ */
+static Sint16 *audio_readOutput( const char *file, int *len )
+{
+   SDL_RWops *rw;
+   Sint16 *buf;
+
+   rw = SDL_RWFromFile( file, "rb" );
+   if (rw == NULL)
+      return NULL;
+   *len = SDL_RWseek( rw, 0, RW_SEEK_END );
+   SDL_RWseek( rw, 0, RW_SEEK_SET );
+   buf = (*len > 0) ? (Sint16*) SDL_malloc( *len ) : NULL;
+   if ((buf != NULL) && (SDL_RWread( rw, buf, *len, 1 ) != 1)) {
+      SDL_free( buf );
+      buf = NULL;
+   }
+   SDL_RWclose( rw );
+   return buf;
+}
+
+
+/**
+ * @brief Checks what the float bus writes out on the disk driver.
+ *
+ * The callback is stereo at 22050 Hz, and the disk writer is made to take
+ *  four channels at 44100 Hz, so the bus maps, scales and resamples.
+ */
+static void audio_testBusOutput (void)
+{
+   int ret, len, frames, i, j;
+   SDL_AudioSpec desired, obtained;
+   SDL_AudioDeviceID dev;
+   Uint32 consumed;
+   Sint16 *out;
+   char *delay, *freq, *channels;
+   /* Front pair, then half the difference on the back, at half volume. */
+   const int expected[4] = { 5000, 1000, 2000, -2000 };
+
+   SDL_ATbegin( "Audio Bus Output" );
+
+   ret = SDL_Init( SDL_INIT_AUDIO );
+   if (SDL_ATvassert( ret==0, "SDL_Init( SDL_INIT_AUDIO ): %s", SDL_GetError()))
+      return;
+   delay = audio_setEnv( "SDL_DISKAUDIODELAY", "1" );
+   freq = audio_setEnv( "SDL_DISKAUDIOFREQUENCY", "44100" );
+   channels = audio_setEnv( "SDL_DISKAUDIOCHANNELS", "4" );
+   out = NULL;
+   ret = SDL_AudioInit( "disk" );
+   if (SDL_ATvassert( ret==0, "SDL_AudioInit( disk ): %s", SDL_GetError()))
+      goto err;
+
+   consumed = 0;
+   SDL_memset( &desired, 0, sizeof(desired) );
+   desired.freq = 22050;
+   desired.format = AUDIO_S16SYS;
+   desired.channels = 2;
+   desired.samples = 512;
+   desired.callback = audio_fillStereo;
+   desired.userdata = &consumed;
+   dev = SDL_OpenAudioDevice( "bus.raw", 0, &desired, &obtained, 0 );
+   if (SDL_ATvassert( dev != 0, "SDL_OpenAudioDevice: %s", SDL_GetError()))
+      goto err;
+   ret = SDL_SetAudioDeviceVolume( dev, SDL_MIX_MAXVOLUME / 2 );
+   if (SDL_ATvassert( ret==0, "SDL_SetAudioDeviceVolume: %s", SDL_GetError())) {
+      SDL_CloseAudioDevice( dev );
+      goto err;
+   }
+   SDL_PauseAudioDevice( dev, 0 );
+   SDL_Delay( 100 );
+   SDL_CloseAudioDevice( dev );
+
+   out = audio_readOutput( "bus.raw", &len );
+   if (SDL_ATassert( "Couldn't read back the disk output", out != NULL ))
+      goto err;
+   frames = len / (4 * 2);
+   if (SDL_ATvassert( frames >= 8 * 512, "Only wrote %d frames", frames ))
+      goto err;
+
+   /* Twice the frames the callback gave, less what the bus still holds. */
+   consumed /= 2 * 2;
+   if (SDL_ATvassert( (frames <= (int) consumed * 2) &&
+            (frames >= ((int) consumed - 2 * 512) * 2),
+            "Wrote %d frames from %u callback frames", frames, consumed ))
+      goto err;
+
+   /* The first frame is interpolated from silence. */
+   for (i=1; i<frames; i++) {
+      for (j=0; j<4; j++) {
+         if (SDL_ATvassert( SDL_abs( out[i*4 + j] - expected[j] ) <= 2,
+                  "Frame %d channel %d is %d, expected %d",
+                  i, j, out[i*4 + j], expected[j] ))
+            goto err;
+      }
+   }
+
+   SDL_free( out );
+   SDL_Quit();
+   audio_restoreEnv( "SDL_DISKAUDIODELAY", delay );
+   audio_restoreEnv( "SDL_DISKAUDIOFREQUENCY", freq );
+   audio_restoreEnv( "SDL_DISKAUDIOCHANNELS", channels );
+   remove( "bus.raw" );
+   SDL_ATend();
+   return;
+
+err:
+   SDL_free( out );
+   SDL_Quit();
+   audio_restoreEnv( "SDL_DISKAUDIODELAY", delay );
+   audio_restoreEnv( "SDL_DISKAUDIOFREQUENCY", freq );
+   audio_restoreEnv( "SDL_DISKAUDIOCHANNELS", channels );
+   remove( "bus.raw" );
+}
+
+
+/**
+ * @brief Plays clips on the voice mixer.
+ */
+static void audio_testVoices (void)
+{
+   int ret, i;
+   SDL_AudioSpec desired, clipspec;
+   SDL_AudioClip *clip;
+   SDL_AudioVoiceID loop, once;
+   Sint16 samples[441];
+
+   SDL_ATbegin( "Audio Voices" );
+
+   ret = SDL_Init( SDL_INIT_AUDIO );
+   if (SDL_ATvassert( ret==0, "SDL_Init( SDL_INIT_AUDIO ): %s", SDL_GetError()))
+      return;
+   ret = SDL_AudioInit( "dummy" );
+   if (SDL_ATvassert( ret==0, "SDL_AudioInit( dummy ): %s", SDL_GetError()))
+      goto err;
+
+   /* A mono clip at a different rate than the device. */
+   for (i=0; i<(int) SDL_arraysize(samples); i++)
+      samples[i] = (Sint16) ((i % 100) * 300 - 15000);
+   SDL_memset( &clipspec, 0, sizeof(clipspec) );
+   clipspec.freq = 44100;
+   clipspec.format = AUDIO_S16SYS;
+   clipspec.channels = 1;
+
+   /* Not a valid device. */
+   clip = SDL_CreateAudioClip( 1, &clipspec, (Uint8*) samples, sizeof(samples) );
+   if (SDL_ATassert( "SDL_CreateAudioClip on closed device", clip == NULL ))
+      goto err;
+
+   SDL_memset( &desired, 0, sizeof(desired) );
+   desired.freq = 22050;
+   desired.format = AUDIO_S16SYS;
+   desired.channels = 2;
+   desired.samples = 512;
+   desired.callback = audio_fillConstant;
+   ret = SDL_OpenAudio( &desired, NULL );
+   if (SDL_ATvassert( ret==0, "SDL_OpenAudio: %s", SDL_GetError()))
+      goto err;
+
+   clip = SDL_CreateAudioClip( 1, &clipspec, (Uint8*) samples, 0 );
+   if (SDL_ATassert( "SDL_CreateAudioClip with no samples", clip == NULL ))
+      goto err_close;
+   clipspec.format = 0;
+   clip = SDL_CreateAudioClip( 1, &clipspec, (Uint8*) samples, sizeof(samples) );
+   clipspec.format = AUDIO_S16SYS;
+   if (SDL_ATassert( "SDL_CreateAudioClip with invalid format", clip == NULL ))
+      goto err_close;
+   clip = SDL_CreateAudioClip( 1, &clipspec, (Uint8*) samples, sizeof(samples) );
+   if (SDL_ATvassert( clip != NULL, "SDL_CreateAudioClip: %s", SDL_GetError()))
+      goto err_close;
+
+   /* The clip lasts 10 ms, so a single play ends well before we check. */
+   SDL_PauseAudio( 0 );
+   loop = SDL_PlayAudioClip( clip, -1, SDL_MIX_MAXVOLUME, -SDL_MIX_MAXVOLUME );
+   once = SDL_PlayAudioClip( clip, 0, SDL_MIX_MAXVOLUME, 0 );
+   if (SDL_ATvassert( loop != 0 && once != 0 && loop != once,
+            "SDL_PlayAudioClip: %s", SDL_GetError()))
+      goto err_clip;
+   SDL_Delay( 100 );
+   if (SDL_ATassert( "Looping voice stopped", SDL_AudioVoicePlaying( 1, loop ) ))
+      goto err_clip;
+   if (SDL_ATassert( "Voice didn't stop", !SDL_AudioVoicePlaying( 1, once ) ))
+      goto err_clip;
+
+   ret = SDL_SetAudioVoiceVolume( 1, loop, SDL_MIX_MAXVOLUME / 2, SDL_MIX_MAXVOLUME );
+   if (SDL_ATvassert( ret==0, "SDL_SetAudioVoiceVolume: %s", SDL_GetError()))
+      goto err_clip;
+   ret = SDL_SetAudioVoiceVolume( 1, once, SDL_MIX_MAXVOLUME, 0 );
+   if (SDL_ATassert( "SDL_SetAudioVoiceVolume on stopped voice", ret == -1 ))
+      goto err_clip;
+
+   ret = SDL_StopAudioVoice( 1, loop );
+   if (SDL_ATvassert( ret==0, "SDL_StopAudioVoice: %s", SDL_GetError()))
+      goto err_clip;
+   if (SDL_ATassert( "Voice still playing", !SDL_AudioVoicePlaying( 1, loop ) ))
+      goto err_clip;
+   ret = SDL_StopAudioVoice( 1, loop );
+   if (SDL_ATassert( "SDL_StopAudioVoice on stopped voice", ret == -1 ))
+      goto err_clip;
+
+   /* Freeing the clip stops its voices. */
+   loop = SDL_PlayAudioClip( clip, -1, SDL_MIX_MAXVOLUME, 0 );
+   SDL_FreeAudioClip( clip );
+   if (SDL_ATassert( "Voice playing after freeing clip",
+            !SDL_AudioVoicePlaying( 1, loop ) ))
+      goto err_close;
+
+   SDL_CloseAudio();
+   SDL_Quit();
+   SDL_ATend();
+   return;
+
+err_clip:
+   SDL_FreeAudioClip( clip );
+err_close:
+   SDL_CloseAudio();
+err:
+   SDL_Quit();
+}
+
+
+/**
+ * @brief Fills the buffer with silence.
+ */
+static void SDLCALL audio_fillSilence( void *userdata, Uint8 *stream, int len )
+{
+   (void) userdata;
+   SDL_memset( stream, 0, len );
+}
+
+
+/**
+ * @brief Checks that voice gain and pan reach the disk driver's output.
+ */
+static void audio_testVoiceOutput (void)
+{
+   int ret, len, frames, i, j, state;
+   SDL_AudioSpec desired, obtained, clipspec;
+   SDL_AudioDeviceID dev;
+   SDL_AudioClip *clip;
+   SDL_AudioVoiceID voice;
+   Sint16 samples[441];
+   Sint16 *out;
+   char *delay;
+   /* Silence while paused, then half volume panned half right, then full
+      volume panned hard left. */
+   const int expected[3][2] = { { 0, 0 }, { 2000, 4000 }, { 8000, 0 } };
+   int seen[3];
+
+   SDL_ATbegin( "Audio Voice Output" );
+
+   ret = SDL_Init( SDL_INIT_AUDIO );
+   if (SDL_ATvassert( ret==0, "SDL_Init( SDL_INIT_AUDIO ): %s", SDL_GetError()))
+      return;
+   delay = audio_setEnv( "SDL_DISKAUDIODELAY", "1" );
+   out = NULL;
+   ret = SDL_AudioInit( "disk" );
+   if (SDL_ATvassert( ret==0, "SDL_AudioInit( disk ): %s", SDL_GetError()))
+      goto err;
+
+   SDL_memset( &desired, 0, sizeof(desired) );
+   desired.freq = 22050;
+   desired.format = AUDIO_S16SYS;
+   desired.channels = 2;
+   desired.samples = 512;
+   desired.callback = audio_fillSilence;
+   dev = SDL_OpenAudioDevice( "voices.raw", 0, &desired, &obtained, 0 );
+   if (SDL_ATvassert( dev != 0, "SDL_OpenAudioDevice: %s", SDL_GetError()))
+      goto err;
+
+   /* A constant mono clip at the device's rate, looping forever. */
+   for (i=0; i<(int) SDL_arraysize(samples); i++)
+      samples[i] = 8000;
+   SDL_memset( &clipspec, 0, sizeof(clipspec) );
+   clipspec.freq = 22050;
+   clipspec.format = AUDIO_S16SYS;
+   clipspec.channels = 1;
+   clip = SDL_CreateAudioClip( dev, &clipspec, (Uint8*) samples, sizeof(samples) );
+   if (SDL_ATvassert( clip != NULL, "SDL_CreateAudioClip: %s", SDL_GetError())) {
+      SDL_CloseAudioDevice( dev );
+      goto err;
+   }
+   voice = SDL_PlayAudioClip( clip, -1, SDL_MIX_MAXVOLUME / 2,
+         SDL_MIX_MAXVOLUME / 2 );
+   if (SDL_ATvassert( voice != 0, "SDL_PlayAudioClip: %s", SDL_GetError())) {
+      SDL_FreeAudioClip( clip );
+      SDL_CloseAudioDevice( dev );
+      goto err;
+   }
+   SDL_PauseAudioDevice( dev, 0 );
+   SDL_Delay( 50 );
+   ret = SDL_SetAudioVoiceVolume( dev, voice, SDL_MIX_MAXVOLUME,
+         -SDL_MIX_MAXVOLUME );
+   SDL_Delay( 50 );
+   SDL_FreeAudioClip( clip );
+   SDL_CloseAudioDevice( dev );
+   if (SDL_ATvassert( ret==0, "SDL_SetAudioVoiceVolume: %s", SDL_GetError()))
+      goto err;
+
+   out = audio_readOutput( "voices.raw", &len );
+   if (SDL_ATassert( "Couldn't read back the disk output", out != NULL ))
+      goto err;
+   frames = len / (2 * 2);
+
+   /* Each frame is in one of the states, and they only move forward. */
+   state = 0;
+   SDL_memset( seen, 0, sizeof(seen) );
+   for (i=0; i<frames; i++) {
+      for (j=state; j<3; j++) {
+         if ((SDL_abs( out[i*2] - expected[j][0] ) <= 2) &&
+               (SDL_abs( out[i*2 + 1] - expected[j][1] ) <= 2))
+            break;
+      }
+      if (SDL_ATvassert( j < 3, "Frame %d is %d,%d after state %d",
+               i, out[i*2], out[i*2 + 1], state ))
+         goto err;
+      state = j;
+      seen[state] = 1;
+   }
+   if (SDL_ATvassert( seen[1] && seen[2],
+            "Voice states seen: panned %d, hard left %d", seen[1], seen[2] ))
+      goto err;
+
+   SDL_free( out );
+   SDL_Quit();
+   audio_restoreEnv( "SDL_DISKAUDIODELAY", delay );
+   remove( "voices.raw" );
+   SDL_ATend();
+   return;
+
+err:
+   SDL_free( out );
+   SDL_Quit();
+   audio_restoreEnv( "SDL_DISKAUDIODELAY", delay );
+   remove( "voices.raw" );
+}
+
+
+/**
+ * @brief Checks the timing of a device.
+ */
+static void audio_testClock (void)
+{
+   int ret;
+   SDL_AudioSpec desired;
+   SDL_AudioClock clock;
+
+   SDL_ATbegin( "Audio Clock" );
+
+   ret = SDL_Init( SDL_INIT_AUDIO );
+   if (SDL_ATvassert( ret==0, "SDL_Init( SDL_INIT_AUDIO ): %s", SDL_GetError()))
+      return;
+   ret = SDL_AudioInit( "dummy" );
+   if (SDL_ATvassert( ret==0, "SDL_AudioInit( dummy ): %s", SDL_GetError()))
+      goto err;
+
+   /* Not a valid device. */
+   ret = SDL_GetAudioDeviceClock( 1, &clock );
+   if (SDL_ATassert( "SDL_GetAudioDeviceClock on closed device", ret == -1 ))
+      goto err;
+
+   SDL_memset( &desired, 0, sizeof(desired) );
+   desired.freq = 22050;
+   desired.format = AUDIO_S16SYS;
+   desired.channels = 2;
+   desired.samples = 512;
+   desired.callback = audio_fillConstant;
+   ret = SDL_OpenAudio( &desired, NULL );
+   if (SDL_ATvassert( ret==0, "SDL_OpenAudio: %s", SDL_GetError()))
+      goto err;
+
+   ret = SDL_GetAudioDeviceClock( 1, NULL );
+   if (SDL_ATassert( "SDL_GetAudioDeviceClock with NULL clock", ret == -1 ))
+      goto err_close;
+   ret = SDL_GetAudioDeviceClock( 1, &clock );
+   if (SDL_ATvassert( ret==0, "SDL_GetAudioDeviceClock: %s", SDL_GetError()))
+      goto err_close;
+   if (SDL_ATassert( "Paused device submitted frames",
+            clock.frames_submitted == 0 && clock.callback_ticks == 0 ))
+      goto err_close;
+
+   /* The dummy device plays in real time, a buffer at a time. */
+   SDL_PauseAudio( 0 );
+   SDL_Delay( 100 );
+   ret = SDL_GetAudioDeviceClock( 1, &clock );
+   if (SDL_ATvassert( ret==0, "SDL_GetAudioDeviceClock: %s", SDL_GetError()))
+      goto err_close;
+   if (SDL_ATvassert( clock.frames_submitted > 0 &&
+            clock.frames_submitted % 512 == 0,
+            "Submitted %d frames", (int) clock.frames_submitted ))
+      goto err_close;
+   if (SDL_ATvassert( clock.frames_played <= clock.frames_submitted &&
+            clock.latency <= 2 * 512 * 1000000 / 22050,
+            "Played %d frames with %u usec latency",
+            (int) clock.frames_played, clock.latency ))
+      goto err_close;
+   if (SDL_ATassert( "Clock not consistent",
+            clock.underruns == 0 &&
+            clock.callback_max_ticks <= clock.callback_ticks ))
+      goto err_close;
+
+   SDL_CloseAudio();
+   SDL_Quit();
+   SDL_ATend();
+   return;
+
+err_close:
+   SDL_CloseAudio();
+err:
+   SDL_Quit();
+}
+
+
+/**
+ * @brief Renders audio faster than real time on the dummy driver.
+ */
+static void audio_testSpeed (void)
+{
+   int ret;
+   Uint32 start, ticks;
+   SDL_AudioSpec desired;
+   SDL_AudioClock clock;
+   char *speed;
+
+   SDL_ATbegin( "Audio Speed" );
+
+   ret = SDL_Init( SDL_INIT_AUDIO );
+   if (SDL_ATvassert( ret==0, "SDL_Init( SDL_INIT_AUDIO ): %s", SDL_GetError()))
+      return;
+   speed = audio_setEnv( "SDL_DUMMYAUDIOSPEED", "0" );
+   ret = SDL_AudioInit( "dummy" );
+   if (SDL_ATvassert( ret==0, "SDL_AudioInit( dummy ): %s", SDL_GetError()))
+      goto err;
+
+   SDL_memset( &desired, 0, sizeof(desired) );
+   desired.freq = 22050;
+   desired.format = AUDIO_S16SYS;
+   desired.channels = 2;
+   desired.samples = 512;
+   desired.callback = audio_fillConstant;
+   ret = SDL_OpenAudio( &desired, NULL );
+   if (SDL_ATvassert( ret==0, "SDL_OpenAudio: %s", SDL_GetError()))
+      goto err;
+
+   /* Ten seconds of audio shouldn't take anywhere near that long. */
+   SDL_PauseAudio( 0 );
+   start = SDL_GetTicks();
+   do {
+      SDL_Delay( 10 );
+      ret = SDL_GetAudioDeviceClock( 1, &clock );
+      if (SDL_ATvassert( ret==0, "SDL_GetAudioDeviceClock: %s", SDL_GetError()))
+         goto err_close;
+      ticks = SDL_GetTicks() - start;
+   } while ((clock.frames_played < 10 * 22050) && (ticks < 5000));
+   if (SDL_ATvassert( clock.frames_played >= 10 * 22050,
+            "Played %d frames in %u ms", (int) clock.frames_played, ticks ))
+      goto err_close;
+   SDL_CloseAudio();
+
+   /* At 16 MHz the elapsed milliseconds times the rate passes 32 bits
+      after 268 ms.  Slowed down, the device only plays 1600 frames a
+      second, which the clock must keep counting past the wrap. */
+   SDL_setenv( "SDL_DUMMYAUDIOSPEED", "0.0001", 1 );
+   desired.freq = 16000000;
+   desired.channels = 1;
+   desired.samples = 64;
+   ret = SDL_OpenAudio( &desired, NULL );
+   if (SDL_ATvassert( ret==0, "SDL_OpenAudio: %s", SDL_GetError()))
+      goto err;
+   SDL_PauseAudio( 0 );
+   start = SDL_GetTicks();
+   do {
+      SDL_Delay( 10 );
+      ret = SDL_GetAudioDeviceClock( 1, &clock );
+      if (SDL_ATvassert( ret==0, "SDL_GetAudioDeviceClock: %s", SDL_GetError()))
+         goto err_close;
+      ticks = SDL_GetTicks() - start;
+   } while ((clock.frames_played < 800) && (ticks < 5000));
+   if (SDL_ATvassert( clock.frames_played >= 800,
+            "Played %d frames in %u ms", (int) clock.frames_played, ticks ))
+      goto err_close;
+
+   SDL_CloseAudio();
+   SDL_Quit();
+   audio_restoreEnv( "SDL_DUMMYAUDIOSPEED", speed );
+   SDL_ATend();
+   return;
+
+err_close:
+   SDL_CloseAudio();
+err:
+   SDL_Quit();
+   audio_restoreEnv( "SDL_DUMMYAUDIOSPEED", speed );
+}
+
+
+/**
+ * @brief Dequeues audio from a capture device until there's len bytes.
+ */
+static Uint32 audio_dequeueAll( SDL_AudioDeviceID dev, Uint8 *buf, Uint32 len )
+{
+   Uint32 got = 0;
+   Uint32 start = SDL_GetTicks();
+   while ((got < len) && (SDL_GetTicks() - start < 5000)) {
+      got += SDL_DequeueAudio( dev, buf + got, len - got );
+      SDL_Delay( 1 );
+   }
+   return got;
+}
+
+
+/**
+ * @brief Records from a WAVE file with the disk driver.
+ */
+static void audio_testCapture (void)
+{
+   int ret, i;
+   SDL_AudioSpec desired, obtained;
+   SDL_AudioDeviceID dev;
+   SDL_AudioClock clock;
+   SDL_RWops *rw;
+   Uint32 got;
+   char *delay;
+   Uint8 wav[44 + 4410 * 2];
+   static float converted[8820 * 2];
+   static Sint16 direct[4410];
+   /* 16-bit mono PCM at 22050 Hz, 0.2 seconds of it. */
+   const Uint8 header[] = {
+      'R', 'I', 'F', 'F', 0x98, 0x22, 0, 0, 'W', 'A', 'V', 'E',
+      'f', 'm', 't', ' ', 16, 0, 0, 0,
+      1, 0, 1, 0, 0x22, 0x56, 0, 0, 0x44, 0xAC, 0, 0, 2, 0, 16, 0,
+      'd', 'a', 't', 'a', 0x74, 0x22, 0, 0
+   };
+
+   SDL_ATbegin( "Audio Capture" );
+
+   /* A constant level of half the full scale. */
+   SDL_memcpy( wav, header, sizeof(header) );
+   for (i=0; i<4410; i++) {
+      wav[sizeof(header) + i*2] = 0x00;
+      wav[sizeof(header) + i*2 + 1] = 0x40;
+   }
+   rw = SDL_RWFromFile( "capture.wav", "wb" );
+   if (SDL_ATvassert( rw != NULL, "SDL_RWFromFile: %s", SDL_GetError() ))
+      return;
+   ret = (int) SDL_RWwrite( rw, wav, sizeof(wav), 1 );
+   SDL_RWclose( rw );
+   if (SDL_ATassert( "SDL_RWwrite", ret == 1 ))
+      goto err_file;
+
+   ret = SDL_Init( SDL_INIT_AUDIO );
+   if (SDL_ATvassert( ret==0, "SDL_Init( SDL_INIT_AUDIO ): %s", SDL_GetError()))
+      goto err_file;
+   delay = audio_setEnv( "SDL_DISKAUDIODELAY", "1" );
+   ret = SDL_AudioInit( "disk" );
+   if (SDL_ATvassert( ret==0, "SDL_AudioInit( disk ): %s", SDL_GetError()))
+      goto err;
+
+   /* Not a valid device. */
+   got = SDL_DequeueAudio( 2, converted, sizeof(converted) );
+   if (SDL_ATassert( "SDL_DequeueAudio on closed device", got == 0 ))
+      goto err;
+
+   /* Converted to float stereo at twice the rate. */
+   SDL_memset( &desired, 0, sizeof(desired) );
+   desired.freq = 44100;
+   desired.format = AUDIO_F32SYS;
+   desired.channels = 2;
+   desired.samples = 1024;
+   dev = SDL_OpenAudioDevice( "capture.wav", 1, &desired, &obtained, 0 );
+   if (SDL_ATvassert( dev != 0, "SDL_OpenAudioDevice: %s", SDL_GetError()))
+      goto err;
+   SDL_PauseAudioDevice( dev, 0 );
+   got = audio_dequeueAll( dev, (Uint8*) converted, sizeof(converted) );
+   ret = SDL_GetAudioDeviceClock( dev, &clock );
+   SDL_CloseAudioDevice( dev );
+   if (SDL_ATvassert( got == sizeof(converted),
+            "SDL_DequeueAudio returned %u bytes", got ))
+      goto err;
+   /* Frames are counted as they're recorded, before conversion. */
+   if (SDL_ATvassert( ret == 0 && clock.frames_submitted >= 4410,
+            "Recorded %d frames", (int) clock.frames_submitted ))
+      goto err;
+   /* The last frames are interpolated towards the silence after the file. */
+   for (i=0; i<(8820 - 2) * 2; i++) {
+      if (SDL_ATvassert( SDL_fabs( converted[i] - 0.5f ) < 0.001f,
+               "Captured sample %d is %f", i, converted[i] ))
+         goto err;
+   }
+
+   /* Recorded as is. */
+   desired.freq = 22050;
+   desired.format = AUDIO_S16LSB;
+   desired.channels = 1;
+   dev = SDL_OpenAudioDevice( "capture.wav", 1, &desired, &obtained, 0 );
+   if (SDL_ATvassert( dev != 0, "SDL_OpenAudioDevice: %s", SDL_GetError()))
+      goto err;
+   SDL_PauseAudioDevice( dev, 0 );
+   got = audio_dequeueAll( dev, (Uint8*) direct, sizeof(direct) );
+   SDL_CloseAudioDevice( dev );
+   if (SDL_ATvassert( got == sizeof(direct),
+            "SDL_DequeueAudio returned %u bytes", got ))
+      goto err;
+   if (SDL_ATassert( "Captured audio not the same.",
+            SDL_memcmp( direct, wav + sizeof(header), sizeof(direct) ) == 0 ))
+      goto err;
+
+   SDL_Quit();
+   audio_restoreEnv( "SDL_DISKAUDIODELAY", delay );
+   remove( "capture.wav" );
+   SDL_ATend();
+   return;
+
+err:
+   SDL_Quit();
+   audio_restoreEnv( "SDL_DISKAUDIODELAY", delay );
+err_file:
+   remove( "capture.wav" );
+}
+
+
 /**
  * @brief Entry point.
  */
@@ -84,6 +1027,15 @@ int test_audio (void)
    SDL_ATinit( "SDL_Audio" );
 
    audio_testOpen();
+   audio_testWAVStream();
+   audio_testConvert();
+   audio_testVolume();
+   audio_testBusOutput();
+   audio_testVoices();
+   audio_testVoiceOutput();
+   audio_testClock();
+   audio_testSpeed();
+   audio_testCapture();
 
    return SDL_ATfinish();
 }
@@ -41,6 +41,8 @@ static int render_testReadWrite (void);
 static int render_testPrimitives (void);
 static int render_testPrimitivesBlend (void);
 static int render_testBlit (void);
+static int render_testBlitMany (void);
+static int render_testBlitStreaming (void);
 static int render_testBlitColour (void);
 static int render_testBlitAlpha (void);
 static int render_testBlitBlendMode( SDL_Texture * tface, int mode );
@@ -225,13 +227,9 @@ static int render_hasBlendModes (void)
 /**
  * @brief Loads the test face.
  */
-static SDL_Texture * render_loadTestFace (void)
+static SDL_Surface * render_createTestFace (void)
 {
-   SDL_Surface *face;
-   SDL_Texture *tface;
-
-   /* Create face surface. */
-   face = SDL_CreateRGBSurfaceFrom( (void*)img_face.pixel_data,
+   return SDL_CreateRGBSurfaceFrom( (void*)img_face.pixel_data,
          img_face.width, img_face.height, 32, img_face.width*4,
 #if (SDL_BYTEORDER == SDL_BIG_ENDIAN)
          0xff000000, /* Red bit mask. */
@@ -245,6 +243,19 @@ static SDL_Texture * render_loadTestFace (void)
          0xff000000 /* Alpha bit mask. */
 #endif
          );
+}
+
+
+/**
+ * @brief Loads the test face as a texture.
+ */
+static SDL_Texture * render_loadTestFace (void)
+{
+   SDL_Surface *face;
+   SDL_Texture *tface;
+
+   /* Create face surface. */
+   face = render_createTestFace();
    if (face == NULL)
       return 0;
    tface = SDL_CreateTextureFromSurface( 0, face );
@@ -370,6 +381,8 @@ static int render_testReadWrite (void)
 {
    int ret;
    SDL_Rect rect;
+   Uint8 pix[4*80*60];
+   SDL_Surface *testsur;
 
    /* Write pixels. */
    rect.x = 0;
@@ -384,6 +397,24 @@ static int render_testReadWrite (void)
    if (render_compare( "Read/write output not the same.", &img_primitives, ALLOWABLE_ERROR_OPAQUE ))
       return -1;
 
+   /* Asynchronous reads give back what the previous read saw. */
+   ret = SDL_RenderReadPixelsAsync( &rect, FORMAT, pix, 80*4 );
+   if (SDL_ATassert( "SDL_RenderReadPixelsAsync", ret>=0) )
+      return 1;
+   if (ret > 0) {
+      ret = SDL_RenderReadPixelsAsync( &rect, FORMAT, pix, 80*4 );
+      if (SDL_ATassert( "SDL_RenderReadPixelsAsync", ret==0) )
+         return 1;
+   }
+   testsur = SDL_CreateRGBSurfaceFrom( pix, 80, 60, 32, 80*4,
+                                       RMASK, GMASK, BMASK, AMASK);
+   if (SDL_ATassert( "SDL_CreateRGBSurfaceFrom", testsur!=NULL ))
+      return 1;
+   ret = surface_compare( testsur, &img_primitives, ALLOWABLE_ERROR_OPAQUE );
+   SDL_FreeSurface( testsur );
+   if (SDL_ATassert( "Asynchronous read output not the same.", ret==0 ))
+      return 1;
+
    return 0;
 }
 
@@ -651,6 +682,178 @@ static int render_testBlit (void)
 }
 
 
+/**
+ * @brief Tests blitting a streaming texture filled through SDL_LockTexture.
+ *
+ * On the OpenGL renderer this goes through a pixel buffer object when
+ *  GL_ARB_pixel_buffer_object is available.
+ */
+static int render_testBlitStreaming (void)
+{
+   int ret;
+   SDL_Rect rect;
+   SDL_Texture *tface;
+   SDL_RendererInfo info;
+   Uint32 format;
+   Uint8 *pixels;
+   int pitch;
+   int i, j, ni, nj, half;
+
+   /* Clear surface. */
+   if (render_clearScreen())
+      return -1;
+
+   /* Need drawcolour or just skip test. */
+   if (!render_hasDrawColor())
+      return 0;
+
+   ret = SDL_GetRendererInfo( &info );
+   if (SDL_ATassert( "SDL_GetRendererInfo", ret == 0))
+      return -1;
+   if ((SDL_strcmp( info.name, "opengl" ) == 0) &&
+         SDL_GL_ExtensionSupported( "GL_ARB_pixel_buffer_object" ))
+      SDL_ATprintVerbose( 1, "      Pixel Buffer Objects supported\n" );
+
+   /* Not every renderer streams the face's format. */
+#if (SDL_BYTEORDER == SDL_BIG_ENDIAN)
+   format = SDL_PIXELFORMAT_RGBA8888;
+#else
+   format = SDL_PIXELFORMAT_ABGR8888;
+#endif
+   tface = SDL_CreateTexture( format, SDL_TEXTUREACCESS_STREAMING,
+         img_face.width, img_face.height );
+   if (tface == 0)
+      return 0;
+   if (SDL_SetTextureBlendMode( tface, SDL_BLENDMODE_BLEND )) {
+      SDL_DestroyTexture( tface );
+      return 0;
+   }
+
+   /* Fill it in two locks, so the second keeps the first's pending rows. */
+   half = img_face.height / 2;
+   rect.x = 0;
+   rect.y = 0;
+   rect.w = img_face.width;
+   rect.h = half;
+   for (i=0; i<2; i++) {
+      ret = SDL_LockTexture( tface, &rect, 1, (void**) &pixels, &pitch );
+      if (SDL_ATassert( "SDL_LockTexture", ret == 0))
+         return -1;
+      for (j=0; j<rect.h; j++)
+         SDL_memcpy( pixels + j*pitch,
+               &img_face.pixel_data[ (rect.y+j) * img_face.width * 4 ],
+               img_face.width * 4 );
+      SDL_UnlockTexture( tface );
+      rect.y = half;
+      rect.h = img_face.height - half;
+   }
+
+   /* Constant values. */
+   rect.w = img_face.width;
+   rect.h = img_face.height;
+   ni     = SCREEN_W - img_face.width;
+   nj     = SCREEN_H - img_face.height;
+
+   /* Loop blit. */
+   for (j=0; j <= nj; j+=4) {
+      for (i=0; i <= ni; i+=4) {
+         /* Blitting. */
+         rect.x = i;
+         rect.y = j;
+         ret = SDL_RenderCopy( tface, NULL, &rect );
+         if (SDL_ATassert( "SDL_RenderCopy", ret == 0))
+            return -1;
+      }
+   }
+
+   /* Clean up. */
+   SDL_DestroyTexture( tface );
+
+   /* See if it's the same. */
+   if (render_compare( "Streaming blit output not the same.", &img_blit, ALLOWABLE_ERROR_OPAQUE ))
+      return -1;
+
+   return 0;
+}
+
+
+/**
+ * @brief Tests packing into an atlas and blitting many copies at once.
+ */
+static int render_testBlitMany (void)
+{
+   int ret;
+   SDL_Surface *face;
+   SDL_TextureAtlas *atlas;
+   SDL_Texture *tfaces[3];
+   SDL_Rect rects[3];
+   SDL_TextureCopy copies[256];
+   int i, j, ni, nj, n;
+
+   /* Clear surface. */
+   if (render_clearScreen())
+      return -1;
+
+   /* Need drawcolour or just skip test. */
+   if (!render_hasDrawColor())
+      return 0;
+
+   /* Pack the face a few times, the atlas only fits two per texture. */
+   atlas = SDL_CreateTextureAtlas( SDL_PIXELFORMAT_ARGB8888,
+         2*(img_face.width + 1), img_face.height + 1 );
+   if (SDL_ATassert( "SDL_CreateTextureAtlas", atlas != NULL))
+      return -1;
+   face = render_createTestFace();
+   if (SDL_ATassert( "render_createTestFace()", face != NULL))
+      return -1;
+   for (i=0; i<3; i++) {
+      ret = SDL_AddSurfaceToAtlas( atlas, face, &tfaces[i], &rects[i] );
+      if (SDL_ATassert( "SDL_AddSurfaceToAtlas", ret == 0))
+         return -1;
+      if (SDL_ATassert( "Atlas rect has the wrong size",
+               (rects[i].w == img_face.width) && (rects[i].h == img_face.height)))
+         return -1;
+   }
+   SDL_FreeSurface( face );
+   if (SDL_ATassert( "Atlas texture not shared", tfaces[0] == tfaces[1]))
+      return -1;
+   if (SDL_ATassert( "Atlas texture not full", tfaces[2] != tfaces[0]))
+      return -1;
+   if (SDL_ATassert( "Atlas rects overlap", !SDL_HasIntersection( &rects[0], &rects[1] )))
+      return -1;
+
+   /* Constant values. */
+   ni     = SCREEN_W - img_face.width;
+   nj     = SCREEN_H - img_face.height;
+
+   /* Same pattern as render_testBlit, alternating atlas entries. */
+   n = 0;
+   for (j=0; j <= nj; j+=4) {
+      for (i=0; i <= ni; i+=4) {
+         copies[n].texture    = tfaces[n % 3];
+         copies[n].srcrect    = rects[n % 3];
+         copies[n].dstrect.x  = i;
+         copies[n].dstrect.y  = j;
+         copies[n].dstrect.w  = img_face.width;
+         copies[n].dstrect.h  = img_face.height;
+         n++;
+      }
+   }
+   ret = SDL_RenderCopyMany( copies, n );
+   if (SDL_ATassert( "SDL_RenderCopyMany", ret == 0))
+      return -1;
+
+   /* Clean up. */
+   SDL_DestroyTextureAtlas( atlas );
+
+   /* See if it's the same. */
+   if (render_compare( "Blit many output not the same.", &img_blit, ALLOWABLE_ERROR_OPAQUE ))
+      return -1;
+
+   return 0;
+}
+
+
 /**
  * @brief Blits doing colour tests.
  */
@@ -968,6 +1171,12 @@ int render_runTests (void)
    if (ret)
       return -1;
    ret = render_testBlit();
+   if (ret)
+      return -1;
+   ret = render_testBlitMany();
+   if (ret)
+      return -1;
+   ret = render_testBlitStreaming();
    if (ret)
       return -1;
    ret = render_testBlitColour();
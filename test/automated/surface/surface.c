@@ -28,9 +28,20 @@
 static void surface_testLoad( SDL_Surface *testsur );
 static void surface_testPrimitives( SDL_Surface *testsur );
 static void surface_testPrimitivesBlend( SDL_Surface *testsur );
+static void surface_testFillRects( SDL_Surface *testsur );
+static void surface_testStrokeLines( SDL_Surface *testsur );
+static void surface_testDrawLines( SDL_Surface *testsur );
 static void surface_testBlit( SDL_Surface *testsur );
 static int surface_testBlitBlendMode( SDL_Surface *testsur, SDL_Surface *face, int mode );
 static void surface_testBlitBlend( SDL_Surface *testsur );
+static void surface_testBlitColorKey( SDL_Surface *testsur );
+static void surface_testBlitConvert( SDL_Surface *testsur );
+static void surface_testBlitAlpha16( SDL_Surface *testsur );
+static void surface_testBlitRLE( SDL_Surface *testsur );
+static void surface_testBlitRLEAlpha( SDL_Surface *testsur );
+static void surface_testAlignment( SDL_Surface *testsur );
+static void surface_testSharedFormat( SDL_Surface *testsur );
+static void surface_testLoadBMPStream( SDL_Surface *testsur );
 
 
 /**
@@ -247,6 +258,208 @@ static void surface_testPrimitivesBlend( SDL_Surface *testsur )
 }
 
 
+/**
+ * @brief Tests filling many rectangles at once matches filling them one by one.
+ */
+static void surface_testFillRects( SDL_Surface *testsur )
+{
+   int ret;
+   int i, m;
+   SDL_Surface *refsur;
+   SDL_Rect rects[8];
+   const SDL_Rect *prects[8];
+   const int modes[] = { SDL_BLENDMODE_NONE, SDL_BLENDMODE_BLEND,
+                         SDL_BLENDMODE_ADD, SDL_BLENDMODE_MOD };
+
+   SDL_ATbegin( "Fill Rects Test" );
+
+   /* Create the reference surface. */
+   refsur = SDL_CreateRGBSurface( 0, testsur->w, testsur->h,
+         testsur->format->BitsPerPixel, testsur->format->Rmask,
+         testsur->format->Gmask, testsur->format->Bmask,
+         testsur->format->Amask );
+   if (SDL_ATassert( "SDL_CreateRGBSurface", refsur != NULL))
+      return;
+
+   /* Duplicated, nested, adjacent and overlapping rectangles. */
+   for (i=0; i<8; i++) {
+      rects[i].x = 5 + 7*i;
+      rects[i].y = 3 + 4*i;
+      rects[i].w = 20;
+      rects[i].h = 10;
+      prects[i] = &rects[i];
+   }
+   rects[1] = rects[0];
+   rects[2].x = rects[0].x + 5;
+   rects[2].y = rects[0].y + 2;
+   rects[2].w = 5;
+   rects[2].h = 5;
+   rects[3].x = rects[0].x;
+   rects[3].y = rects[0].y + rects[0].h;
+   rects[3].w = rects[0].w;
+   rects[4].x = -10;
+   rects[4].w = 100;
+
+   /* Solid fill. */
+   ret = SDL_FillRect( testsur, NULL, SDL_MapRGB( testsur->format, 0, 0, 0 ) );
+   if (SDL_ATassert( "SDL_FillRect", ret == 0))
+      goto err;
+   ret = SDL_FillRect( refsur, NULL, SDL_MapRGB( refsur->format, 0, 0, 0 ) );
+   if (SDL_ATassert( "SDL_FillRect", ret == 0))
+      goto err;
+   ret = SDL_FillRects( testsur, prects, 8,
+         SDL_MapRGB( testsur->format, 200, 100, 50 ) );
+   if (SDL_ATassert( "SDL_FillRects", ret == 0))
+      goto err;
+   for (i=0; i<8; i++) {
+      ret = SDL_FillRect( refsur, prects[i],
+            SDL_MapRGB( refsur->format, 200, 100, 50 ) );
+      if (SDL_ATassert( "SDL_FillRect", ret == 0))
+         goto err;
+   }
+   if (SDL_ATassert( "SDL_FillRects output not the same.",
+            SDL_memcmp( testsur->pixels, refsur->pixels,
+               testsur->pitch * testsur->h ) == 0 ))
+      goto err;
+
+   /* Blended fills, overlapping areas must get blended more than once. */
+   for (m=0; m<(int)SDL_arraysize(modes); m++) {
+      ret = SDL_BlendFillRects( testsur, prects, 8, modes[m],
+            60, 120, 240, 100 );
+      if (SDL_ATassert( "SDL_BlendFillRects", ret == 0))
+         goto err;
+      for (i=0; i<8; i++) {
+         ret = SDL_BlendFillRect( refsur, prects[i], modes[m],
+               60, 120, 240, 100 );
+         if (SDL_ATassert( "SDL_BlendFillRect", ret == 0))
+            goto err;
+      }
+      if (SDL_ATassert( "SDL_BlendFillRects output not the same.",
+               SDL_memcmp( testsur->pixels, refsur->pixels,
+                  testsur->pitch * testsur->h ) == 0 ))
+         goto err;
+   }
+
+   SDL_FreeSurface( refsur );
+   SDL_ATend();
+   return;
+
+err:
+   SDL_FreeSurface( refsur );
+}
+
+
+/**
+ * @brief Tests wide and anti-aliased lines.
+ */
+static void surface_testStrokeLines( SDL_Surface *testsur )
+{
+   int ret;
+   int x, y;
+   Uint32 *pixels;
+   Uint32 black, color, pixel;
+   SDL_Point points[5];
+   int pitch = testsur->pitch / 4;
+
+   SDL_ATbegin( "Stroke Lines Test" );
+
+   if (SDL_ATassert( "Expected a 32 bit surface",
+            testsur->format->BytesPerPixel == 4 ))
+      return;
+   pixels = (Uint32 *) testsur->pixels;
+   black = SDL_MapRGB( testsur->format, 0, 0, 0 );
+
+   /* An even width is centered between pixel rows. */
+   ret = SDL_FillRect( testsur, NULL, black );
+   if (SDL_ATassert( "SDL_FillRect", ret == 0))
+      return;
+   points[0].x = 10;
+   points[0].y = 20;
+   points[1].x = 60;
+   points[1].y = 20;
+   color = SDL_MapRGB( testsur->format, 200, 100, 50 );
+   ret = SDL_StrokeLines( testsur, points, 2, 4, 0,
+         SDL_BLENDMODE_NONE, 200, 100, 50, 255 );
+   if (SDL_ATassert( "SDL_StrokeLines", ret == 0))
+      return;
+   for (x=10; x<=61; x++) {
+      if (SDL_ATassert( "Wide line has the wrong rows",
+               pixels[18*pitch + x] == black &&
+               pixels[23*pitch + x] == black ))
+         return;
+   }
+   for (y=19; y<=22; y++) {
+      for (x=12; x<=59; x++) {
+         if (SDL_ATassert( "Wide line isn't filled",
+                  pixels[y*pitch + x] == color ))
+            return;
+      }
+   }
+
+   /* Overlapping segments and joins are only blended once. */
+   ret = SDL_FillRect( testsur, NULL, black );
+   if (SDL_ATassert( "SDL_FillRect", ret == 0))
+      return;
+   points[0].x = 5;
+   points[0].y = 5;
+   points[1].x = 70;
+   points[1].y = 50;
+   points[2].x = 70;
+   points[2].y = 5;
+   points[3].x = 5;
+   points[3].y = 50;
+   points[4] = points[0];
+   ret = SDL_StrokeLines( testsur, points, 5, 5, 0,
+         SDL_BLENDMODE_BLEND, 255, 255, 255, 128 );
+   if (SDL_ATassert( "SDL_StrokeLines", ret == 0))
+      return;
+   color = pixels[5*pitch + 5];
+   if (SDL_ATassert( "Wide line wasn't drawn", color != black ))
+      return;
+   for (y=0; y<testsur->h; y++) {
+      for (x=0; x<testsur->w; x++) {
+         pixel = pixels[y*pitch + x];
+         if (SDL_ATassert( "Wide line was blended more than once",
+                  pixel == black || pixel == color ))
+            return;
+      }
+   }
+
+   /* Anti-aliased lines are symmetric about their middle, and fully
+    * covered along the center. */
+   ret = SDL_FillRect( testsur, NULL, black );
+   if (SDL_ATassert( "SDL_FillRect", ret == 0))
+      return;
+   points[0].x = 10;
+   points[0].y = 10;
+   points[1].x = 60;
+   points[1].y = 40;
+   ret = SDL_StrokeLines( testsur, points, 2, 3, SDL_LINE_ANTIALIAS,
+         SDL_BLENDMODE_BLEND, 255, 255, 255, 255 );
+   if (SDL_ATassert( "SDL_StrokeLines", ret == 0))
+      return;
+   color = SDL_MapRGB( testsur->format, 255, 255, 255 );
+   if (SDL_ATassert( "Anti-aliased line isn't covered along the center",
+            pixels[10*pitch + 10] == color &&
+            pixels[25*pitch + 35] == color &&
+            pixels[40*pitch + 60] == color ))
+      return;
+   for (y=0; y<=50; y++) {
+      for (x=0; x<=70; x++) {
+         if (SDL_ATassert( "Anti-aliased line isn't symmetric",
+                  pixels[y*pitch + x] == pixels[(50-y)*pitch + (70-x)] ))
+            return;
+      }
+   }
+   if (SDL_ATassert( "Anti-aliased line has no partial coverage",
+            pixels[12*pitch + 10] != black &&
+            pixels[12*pitch + 10] != color ))
+      return;
+
+   SDL_ATend();
+}
+
+
 /**
  * @brief Tests some blitting routines.
  */
@@ -554,6 +767,1177 @@ static void surface_testBlitBlend( SDL_Surface *testsur )
 }
 
 
+/**
+ * @brief Tests colorkey blits between different formats against SDL_MapRGBA().
+ */
+static void surface_testBlitColorKey( SDL_Surface *testsur )
+{
+   int ret;
+   int f, x, y;
+   Uint32 key, seed;
+   SDL_Surface *src, *dst;
+   SDL_Rect srcrect, rect;
+   const struct {
+      int bpp;
+      Uint32 Rmask, Gmask, Bmask, Amask;
+   } formats[] = {
+      { 32, 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000 },
+      { 32, 0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000 },
+      { 32, 0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff },
+      { 32, 0x00ff0000, 0x0000ff00, 0x000000ff, 0 },
+      { 32, 0x000000ff, 0x0000ff00, 0x00ff0000, 0 },
+      { 16, 0xf800, 0x07e0, 0x001f, 0 }
+   };
+   const int nformats = (int)SDL_arraysize(formats);
+
+   (void) testsur;
+
+   SDL_ATbegin( "Blit Colorkey Tests" );
+
+   for (f=0; f<nformats*nformats; f++) {
+      int sf = f / nformats;
+      int df = f % nformats;
+
+      /* 16 bit sources only have a keyed blitter for the same format. */
+      if ((formats[sf].bpp == 16 || formats[df].bpp == 16) && sf != df)
+         continue;
+
+      src = SDL_CreateRGBSurface( 0, 45, 9, formats[sf].bpp,
+            formats[sf].Rmask, formats[sf].Gmask, formats[sf].Bmask,
+            formats[sf].Amask );
+      dst = SDL_CreateRGBSurface( 0, 45, 9, formats[df].bpp,
+            formats[df].Rmask, formats[df].Gmask, formats[df].Bmask,
+            formats[df].Amask );
+      if (SDL_ATassert( "SDL_CreateRGBSurface", src != NULL && dst != NULL))
+         goto err;
+
+      /* Noise, with a third of the pixels set to the key in some alpha. */
+      key = SDL_MapRGB( src->format, 255, 0, 255 );
+      seed = 12345;
+      for (y=0; y<src->h; y++) {
+         Uint8 *srow = (Uint8 *)src->pixels + y*src->pitch;
+         Uint8 *drow = (Uint8 *)dst->pixels + y*dst->pitch;
+         for (x=0; x<src->w; x++) {
+            Uint32 s, d;
+            seed = seed * 1103515245 + 12345;
+            s = seed >> 8;
+            seed = seed * 1103515245 + 12345;
+            d = seed >> 8;
+            if ((s % 3) == 0)
+               s = key | (s & src->format->Amask);
+            if (src->format->BytesPerPixel == 2) {
+               ((Uint16 *)srow)[x] = (Uint16)s;
+               ((Uint16 *)drow)[x] = (Uint16)d;
+            }
+            else {
+               ((Uint32 *)srow)[x] = s;
+               ((Uint32 *)drow)[x] = d & (dst->format->Rmask |
+                     dst->format->Gmask | dst->format->Bmask |
+                     dst->format->Amask);
+            }
+         }
+      }
+
+      ret = SDL_SetColorKey( src, 1, key );
+      if (SDL_ATassert( "SDL_SetColorKey", ret == 0))
+         goto err;
+      ret = SDL_SetSurfaceBlendMode( src, SDL_BLENDMODE_NONE );
+      if (SDL_ATassert( "SDL_SetSurfaceBlendMode", ret == 0))
+         goto err;
+
+      /* Blit all but the first column and row onto a reference copy. */
+      srcrect.x = 1;
+      srcrect.y = 1;
+      srcrect.w = src->w - 1;
+      srcrect.h = src->h - 1;
+      rect.x = 0;
+      rect.y = 0;
+      {
+         SDL_Surface *ref = SDL_ConvertSurface( dst, dst->format, 0 );
+         if (SDL_ATassert( "SDL_ConvertSurface", ref != NULL))
+            goto err;
+         ret = SDL_BlitSurface( src, &srcrect, dst, &rect );
+         if (SDL_ATassert( "SDL_BlitSurface", ret == 0)) {
+            SDL_FreeSurface( ref );
+            goto err;
+         }
+         for (y=0; y<srcrect.h; y++) {
+            for (x=0; x<srcrect.w; x++) {
+               Uint8 *sp = (Uint8 *)src->pixels + (y+1)*src->pitch +
+                     (x+1)*src->format->BytesPerPixel;
+               Uint8 *rp = (Uint8 *)ref->pixels + y*ref->pitch +
+                     x*ref->format->BytesPerPixel;
+               Uint8 *dp = (Uint8 *)dst->pixels + y*dst->pitch +
+                     x*dst->format->BytesPerPixel;
+               Uint32 s, expected, actual;
+               Uint8 r, g, b, a;
+               if (src->format->BytesPerPixel == 2) {
+                  s = *(Uint16 *)sp;
+                  expected = *(Uint16 *)rp;
+                  actual = *(Uint16 *)dp;
+               }
+               else {
+                  s = *(Uint32 *)sp;
+                  expected = *(Uint32 *)rp;
+                  actual = *(Uint32 *)dp;
+               }
+               if ((s & ~src->format->Amask) != (key & ~src->format->Amask)) {
+                  SDL_GetRGBA( s, src->format, &r, &g, &b, &a );
+                  expected = SDL_MapRGBA( dst->format, r, g, b, a );
+               }
+               if (SDL_ATassert( "Colorkey blit output not the same.",
+                        actual == expected )) {
+                  SDL_FreeSurface( ref );
+                  goto err;
+               }
+            }
+         }
+         SDL_FreeSurface( ref );
+      }
+
+      SDL_FreeSurface( src );
+      SDL_FreeSurface( dst );
+   }
+
+   SDL_ATend();
+   return;
+
+err:
+   SDL_FreeSurface( src );
+   SDL_FreeSurface( dst );
+}
+
+
+/**
+ * @brief Reads a 1, 2, 3 or 4 byte pixel.
+ */
+static Uint32 surface_getPixel( SDL_Surface *sur, int x, int y )
+{
+   Uint8 *p = (Uint8 *)sur->pixels + y*sur->pitch + x*sur->format->BytesPerPixel;
+   switch (sur->format->BytesPerPixel) {
+      case 1:
+         return *p;
+      case 2:
+         return *(Uint16 *)p;
+      case 3:
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+         return p[0] | (p[1] << 8) | (p[2] << 16);
+#else
+         return (p[0] << 16) | (p[1] << 8) | p[2];
+#endif
+      default:
+         return *(Uint32 *)p;
+   }
+}
+
+
+/**
+ * @brief Moves one channel of a pixel from one format to another, the way
+ *        the blitters do it (truncating, without replicating bits).
+ */
+static Uint32 surface_convertChannel( Uint32 pixel, Uint32 smask, int sshift,
+      int sloss, int dshift, int dloss )
+{
+   return ((((pixel & smask) >> sshift) << sloss) >> dloss) << dshift;
+}
+
+
+/**
+ * @brief Tests plain blits between RGB formats of different sizes.
+ */
+static void surface_testBlitConvert( SDL_Surface *testsur )
+{
+   int ret;
+   int f, x, y;
+   Uint32 seed;
+   SDL_Surface *src, *dst;
+   SDL_PixelFormat *sf, *df;
+   const struct {
+      int bpp;
+      Uint32 Rmask, Gmask, Bmask, Amask;
+   } formats[] = {
+      { 32, 0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000 },
+      { 32, 0xff000000, 0x00ff0000, 0x0000ff00, 0x000000ff },
+      { 32, 0x000000ff, 0x0000ff00, 0x00ff0000, 0 },
+      { 24, 0x00ff0000, 0x0000ff00, 0x000000ff, 0 },
+      { 24, 0x000000ff, 0x0000ff00, 0x00ff0000, 0 },
+      { 16, 0xf800, 0x07e0, 0x001f, 0 },
+      { 16, 0x7c00, 0x03e0, 0x001f, 0 },
+      { 16, 0x0f00, 0x00f0, 0x000f, 0xf000 }
+   };
+   const int nformats = (int)SDL_arraysize(formats);
+
+   (void) testsur;
+
+   SDL_ATbegin( "Blit Format Conversion Tests" );
+
+   for (f=0; f<nformats*nformats; f++) {
+      src = SDL_CreateRGBSurface( 0, 23, 5, formats[f / nformats].bpp,
+            formats[f / nformats].Rmask, formats[f / nformats].Gmask,
+            formats[f / nformats].Bmask, formats[f / nformats].Amask );
+      dst = SDL_CreateRGBSurface( 0, 23, 5, formats[f % nformats].bpp,
+            formats[f % nformats].Rmask, formats[f % nformats].Gmask,
+            formats[f % nformats].Bmask, formats[f % nformats].Amask );
+      if (SDL_ATassert( "SDL_CreateRGBSurface", src != NULL && dst != NULL))
+         goto err;
+      sf = src->format;
+      df = dst->format;
+
+      seed = 4321;
+      for (y=0; y<src->h; y++) {
+         Uint8 *row = (Uint8 *)src->pixels + y*src->pitch;
+         for (x=0; x<src->w*sf->BytesPerPixel; x++) {
+            seed = seed * 1103515245 + 12345;
+            row[x] = (Uint8)(seed >> 16);
+         }
+      }
+
+      ret = SDL_SetSurfaceBlendMode( src, SDL_BLENDMODE_NONE );
+      if (SDL_ATassert( "SDL_SetSurfaceBlendMode", ret == 0))
+         goto err;
+      ret = SDL_BlitSurface( src, NULL, dst, NULL );
+      if (SDL_ATassert( "SDL_BlitSurface", ret == 0))
+         goto err;
+
+      for (y=0; y<src->h; y++) {
+         for (x=0; x<src->w; x++) {
+            Uint32 s = surface_getPixel( src, x, y );
+            Uint32 expected, mask;
+            expected = surface_convertChannel( s, sf->Rmask, sf->Rshift,
+                  sf->Rloss, df->Rshift, df->Rloss ) |
+               surface_convertChannel( s, sf->Gmask, sf->Gshift,
+                  sf->Gloss, df->Gshift, df->Gloss ) |
+               surface_convertChannel( s, sf->Bmask, sf->Bshift,
+                  sf->Bloss, df->Bshift, df->Bloss );
+            if (sf->Amask)
+               expected |= surface_convertChannel( s, sf->Amask, sf->Ashift,
+                     sf->Aloss, df->Ashift, df->Aloss );
+            else
+               expected |= df->Amask;
+            /* Only the bits the source has, some blitters fill in the rest. */
+            mask = surface_convertChannel( sf->Rmask, sf->Rmask, sf->Rshift,
+                  sf->Rloss, df->Rshift, df->Rloss ) |
+               surface_convertChannel( sf->Gmask, sf->Gmask, sf->Gshift,
+                  sf->Gloss, df->Gshift, df->Gloss ) |
+               surface_convertChannel( sf->Bmask, sf->Bmask, sf->Bshift,
+                  sf->Bloss, df->Bshift, df->Bloss );
+            if (sf->Amask)
+               mask |= surface_convertChannel( sf->Amask, sf->Amask,
+                     sf->Ashift, sf->Aloss, df->Ashift, df->Aloss );
+            else
+               mask |= df->Amask;
+            mask &= df->Rmask | df->Gmask | df->Bmask | df->Amask;
+            if (SDL_ATassert( "Conversion blit output not the same.",
+                     (surface_getPixel( dst, x, y ) & mask) ==
+                     (expected & mask) ))
+               goto err;
+         }
+      }
+
+      SDL_FreeSurface( src );
+      SDL_FreeSurface( dst );
+   }
+
+   SDL_ATend();
+   return;
+
+err:
+   SDL_FreeSurface( src );
+   SDL_FreeSurface( dst );
+}
+
+
+/**
+ * @brief Writes a 1, 2 or 4 byte pixel.
+ */
+static void surface_setPixel( SDL_Surface *sur, int x, int y, Uint32 pixel )
+{
+   Uint8 *p = (Uint8 *)sur->pixels + y*sur->pitch + x*sur->format->BytesPerPixel;
+   switch (sur->format->BytesPerPixel) {
+      case 1:
+         *p = (Uint8)pixel;
+         break;
+      case 2:
+         *(Uint16 *)p = (Uint16)pixel;
+         break;
+      default:
+         *(Uint32 *)p = pixel;
+         break;
+   }
+}
+
+
+/**
+ * @brief Draws a line one pixel at a time with the classic Bresenham loop,
+ *        the way SDL drew lines before the span and branchless paths.
+ */
+static void surface_refLine( SDL_Surface *sur, int x1, int y1, int x2, int y2,
+      Uint32 pixel, int draw_end )
+{
+   int i, n, d, dinc1, dinc2, xinc1, xinc2, yinc1, yinc2;
+   int dx = (x2 > x1) ? x2 - x1 : x1 - x2;
+   int dy = (y2 > y1) ? y2 - y1 : y1 - y2;
+
+   if (dx >= dy) {
+      n = dx + 1;
+      d = 2*dy - dx;
+      dinc1 = 2*dy;
+      dinc2 = 2*(dy - dx);
+      xinc1 = 1; xinc2 = 1;
+      yinc1 = 0; yinc2 = 1;
+   }
+   else {
+      n = dy + 1;
+      d = 2*dx - dy;
+      dinc1 = 2*dx;
+      dinc2 = 2*(dx - dy);
+      xinc1 = 0; xinc2 = 1;
+      yinc1 = 1; yinc2 = 1;
+   }
+   if (x1 > x2) {
+      xinc1 = -xinc1;
+      xinc2 = -xinc2;
+   }
+   if (y1 > y2) {
+      yinc1 = -yinc1;
+      yinc2 = -yinc2;
+   }
+   if (!draw_end)
+      n--;
+   for (i=0; i<n; i++) {
+      surface_setPixel( sur, x1, y1, pixel );
+      if (d < 0) {
+         d += dinc1;
+         x1 += xinc1;
+         y1 += yinc1;
+      }
+      else {
+         d += dinc2;
+         x1 += xinc2;
+         y1 += yinc2;
+      }
+   }
+}
+
+
+/**
+ * @brief Compares random lines, polylines and points against a pixel at a
+ *        time reference on 8, 16 and 32 bit surfaces.
+ */
+static void surface_testDrawLines( SDL_Surface *testsur )
+{
+   int ret;
+   int f, i, j, x, y;
+   Uint32 seed, color;
+   SDL_Surface *dst, *ref;
+   SDL_Point points[6];
+   const int bpps[] = { 8, 16, 32 };
+
+   (void) testsur;
+
+   SDL_ATbegin( "Draw Lines Tests" );
+
+   dst = ref = NULL;
+   seed = 2468;
+   for (f=0; f<(int)SDL_arraysize(bpps); f++) {
+      if (bpps[f] == 8) {
+         dst = SDL_CreateRGBSurface( 0, 61, 37, 8, 0, 0, 0, 0 );
+         ref = SDL_CreateRGBSurface( 0, 61, 37, 8, 0, 0, 0, 0 );
+      }
+      else if (bpps[f] == 16) {
+         dst = SDL_CreateRGBSurface( 0, 61, 37, 16, 0xf800, 0x07e0, 0x001f, 0 );
+         ref = SDL_CreateRGBSurface( 0, 61, 37, 16, 0xf800, 0x07e0, 0x001f, 0 );
+      }
+      else {
+         dst = SDL_CreateRGBSurface( 0, 61, 37, 32,
+               RMASK, GMASK, BMASK, AMASK );
+         ref = SDL_CreateRGBSurface( 0, 61, 37, 32,
+               RMASK, GMASK, BMASK, AMASK );
+      }
+      if (SDL_ATassert( "SDL_CreateRGBSurface", dst != NULL && ref != NULL))
+         goto err;
+
+      for (i=0; i<300; i++) {
+         SDL_memset( dst->pixels, 0, dst->h * dst->pitch );
+         SDL_memset( ref->pixels, 0, ref->h * ref->pitch );
+         seed = seed * 1103515245 + 12345;
+         color = (seed >> 8) | 1;
+         if (bpps[f] < 32)
+            color &= (1 << bpps[f]) - 1;
+
+         /* A third each of lines, polylines and points. */
+         for (j=0; j<(int)SDL_arraysize(points); j++) {
+            seed = seed * 1103515245 + 12345;
+            points[j].x = (seed >> 8) % dst->w;
+            seed = seed * 1103515245 + 12345;
+            points[j].y = (seed >> 8) % dst->h;
+            /* Also cover horizontal and long shallow runs. */
+            if ((i % 5) == 1 && j > 0)
+               points[j].y = points[j-1].y;
+            else if ((i % 5) == 2 && j > 0)
+               points[j].y = SDL_min( points[j-1].y + (int)(seed >> 28) / 8,
+                     dst->h - 1 );
+         }
+         if ((i % 3) == 0) {
+            ret = SDL_DrawLine( dst, points[0].x, points[0].y,
+                  points[1].x, points[1].y, color );
+            surface_refLine( ref, points[0].x, points[0].y,
+                  points[1].x, points[1].y, color, 1 );
+         }
+         else if ((i % 3) == 1) {
+            ret = SDL_DrawLines( dst, points, SDL_arraysize(points), color );
+            for (j=1; j<(int)SDL_arraysize(points); j++)
+               surface_refLine( ref, points[j-1].x, points[j-1].y,
+                     points[j].x, points[j].y, color, 0 );
+            j = SDL_arraysize(points) - 1;
+            surface_setPixel( ref, points[j].x, points[j].y, color );
+         }
+         else {
+            ret = SDL_DrawPoints( dst, points, SDL_arraysize(points), color );
+            for (j=0; j<(int)SDL_arraysize(points); j++)
+               surface_setPixel( ref, points[j].x, points[j].y, color );
+         }
+         if (SDL_ATassert( "Drawing lines", ret == 0))
+            goto err;
+
+         for (y=0; y<dst->h; y++) {
+            for (x=0; x<dst->w; x++) {
+               if (SDL_ATvassert( surface_getPixel( dst, x, y ) ==
+                        surface_getPixel( ref, x, y ),
+                        "%d bit line output not the same at %d,%d",
+                        bpps[f], x, y ))
+                  goto err;
+            }
+         }
+      }
+
+      SDL_FreeSurface( dst );
+      SDL_FreeSurface( ref );
+   }
+
+   SDL_ATend();
+   return;
+
+err:
+   SDL_FreeSurface( dst );
+   SDL_FreeSurface( ref );
+}
+
+
+/**
+ * @brief Blends an ARGB8888 pixel onto a 565 or 555 pixel the way the scalar
+ *        pixel alpha blitters do, with 5 bit alpha on packed channels.
+ */
+static Uint16 surface_blendARGBto16( Uint32 s, Uint16 dpix, int gbits )
+{
+   unsigned alpha = s >> 27;
+   Uint32 mask = (gbits == 6) ? 0x07e0f81f : 0x03e07c1f;
+   Uint32 d = dpix;
+
+   if (alpha == 0)
+      return dpix;
+   if (gbits == 6) {
+      if (alpha == 31)
+         return (Uint16)((s >> 8 & 0xf800) + (s >> 5 & 0x7e0) + (s >> 3 & 0x1f));
+      s = ((s & 0xfc00) << 11) + (s >> 8 & 0xf800) + (s >> 3 & 0x1f);
+   }
+   else {
+      if (alpha == 31)
+         return (Uint16)((s >> 9 & 0x7c00) + (s >> 6 & 0x3e0) + (s >> 3 & 0x1f));
+      s = ((s & 0xf800) << 10) + (s >> 9 & 0x7c00) + (s >> 3 & 0x1f);
+   }
+   d = (d | d << 16) & mask;
+   d += (s - d) * alpha >> 5;
+   d &= mask;
+   return (Uint16)(d | d >> 16);
+}
+
+
+/**
+ * @brief Blends one channel with surface alpha the way ALPHA_BLEND() does.
+ */
+static Uint32 surface_blendChannel( Uint32 s, Uint32 d, Uint32 smask, int sshift,
+      int sloss, Uint32 dmask, int dshift, int dloss, int alpha )
+{
+   int sc = (int)(((s & smask) >> sshift) << sloss);
+   int dc = (int)(((d & dmask) >> dshift) << dloss);
+   dc = (sc - dc) * alpha / 255 + dc;
+   return (((Uint32)dc) >> dloss) << dshift;
+}
+
+
+/**
+ * @brief Tests 32 to 16 bit blits with pixel and surface alpha across widths
+ *        that leave every possible tail.
+ */
+static void surface_testBlitAlpha16( SDL_Surface *testsur )
+{
+   int ret;
+   int f, w, m, x, y, alpha;
+   Uint32 seed;
+   SDL_Surface *src, *dst, *ref;
+   SDL_PixelFormat *sf, *df;
+   const struct {
+      Uint32 Rmask, Gmask, Bmask;
+      Uint32 dRmask, dGmask, dBmask;
+   } formats[] = {
+      { 0x00ff0000, 0x0000ff00, 0x000000ff, 0xf800, 0x07e0, 0x001f },
+      { 0x00ff0000, 0x0000ff00, 0x000000ff, 0x7c00, 0x03e0, 0x001f },
+      { 0x000000ff, 0x0000ff00, 0x00ff0000, 0x001f, 0x07e0, 0xf800 },
+      { 0x000000ff, 0x0000ff00, 0x00ff0000, 0x001f, 0x03e0, 0x7c00 }
+   };
+   const int alphas[] = { 1, 77, 128, 254 };
+
+   (void) testsur;
+
+   SDL_ATbegin( "Blit 32 to 16 Alpha Tests" );
+
+   src = dst = ref = NULL;
+   seed = 8642;
+   for (f=0; f<(int)SDL_arraysize(formats); f++) {
+      for (w=1; w<=35; w+=(w < 18) ? 1 : 5) {
+         /* m is 0 for pixel alpha, then indexes the surface alphas plus 1. */
+         for (m=0; m<=(int)SDL_arraysize(alphas); m++) {
+            src = SDL_CreateRGBSurface( 0, w, 3, 32, formats[f].Rmask,
+                  formats[f].Gmask, formats[f].Bmask, m ? 0 : 0xff000000 );
+            dst = SDL_CreateRGBSurface( 0, w, 3, 16, formats[f].dRmask,
+                  formats[f].dGmask, formats[f].dBmask, 0 );
+            ref = SDL_CreateRGBSurface( 0, w, 3, 16, formats[f].dRmask,
+                  formats[f].dGmask, formats[f].dBmask, 0 );
+            if (SDL_ATassert( "SDL_CreateRGBSurface",
+                     src != NULL && dst != NULL && ref != NULL))
+               goto err;
+            sf = src->format;
+            df = dst->format;
+            alpha = m ? alphas[m-1] : 0;
+
+            /* Random pixels, with a lot of fully transparent and opaque ones. */
+            for (y=0; y<src->h; y++) {
+               Uint32 *sp = (Uint32 *)((Uint8 *)src->pixels + y*src->pitch);
+               Uint16 *dp = (Uint16 *)((Uint8 *)dst->pixels + y*dst->pitch);
+               Uint16 *rp = (Uint16 *)((Uint8 *)ref->pixels + y*ref->pitch);
+               for (x=0; x<w; x++) {
+                  seed = seed * 1103515245 + 12345;
+                  sp[x] = seed;
+                  if (m == 0) {
+                     if (((seed >> 4) & 3) == 0)
+                        sp[x] &= 0x00ffffff;
+                     else if (((seed >> 4) & 3) == 1)
+                        sp[x] |= 0xff000000;
+                  }
+                  else
+                     sp[x] &= 0x00ffffff;
+                  seed = seed * 1103515245 + 12345;
+                  dp[x] = (Uint16)(seed >> 12);
+                  if (m == 0)
+                     rp[x] = surface_blendARGBto16( sp[x], dp[x],
+                           (df->Gmask == 0x07e0) ? 6 : 5 );
+                  else
+                     rp[x] = (Uint16)(
+                        surface_blendChannel( sp[x], dp[x], sf->Rmask,
+                           sf->Rshift, sf->Rloss, df->Rmask, df->Rshift,
+                           df->Rloss, alpha ) |
+                        surface_blendChannel( sp[x], dp[x], sf->Gmask,
+                           sf->Gshift, sf->Gloss, df->Gmask, df->Gshift,
+                           df->Gloss, alpha ) |
+                        surface_blendChannel( sp[x], dp[x], sf->Bmask,
+                           sf->Bshift, sf->Bloss, df->Bmask, df->Bshift,
+                           df->Bloss, alpha ));
+               }
+            }
+
+            ret = SDL_SetSurfaceBlendMode( src, SDL_BLENDMODE_BLEND );
+            if (SDL_ATassert( "SDL_SetSurfaceBlendMode", ret == 0))
+               goto err;
+            if (m) {
+               ret = SDL_SetSurfaceAlphaMod( src, (Uint8)alpha );
+               if (SDL_ATassert( "SDL_SetSurfaceAlphaMod", ret == 0))
+                  goto err;
+            }
+            ret = SDL_BlitSurface( src, NULL, dst, NULL );
+            if (SDL_ATassert( "SDL_BlitSurface", ret == 0))
+               goto err;
+
+            for (y=0; y<dst->h; y++) {
+               for (x=0; x<w; x++) {
+                  if (SDL_ATvassert( surface_getPixel( dst, x, y ) ==
+                           surface_getPixel( ref, x, y ),
+                           "%s alpha blit to %04x wrong at %d,%d of width %d",
+                           m ? "Surface" : "Pixel", df->Gmask, x, y, w ))
+                     goto err;
+               }
+            }
+
+            SDL_FreeSurface( src );
+            SDL_FreeSurface( dst );
+            SDL_FreeSurface( ref );
+            src = dst = ref = NULL;
+         }
+      }
+   }
+
+   SDL_ATend();
+   return;
+
+err:
+   SDL_FreeSurface( src );
+   SDL_FreeSurface( dst );
+   SDL_FreeSurface( ref );
+}
+
+
+/**
+ * @brief Tests RLE accelerated blits that are clipped on all sides.
+ */
+static void surface_testBlitRLE( SDL_Surface *testsur )
+{
+   int ret;
+   int i, j, k, m, x, y;
+   Uint32 key;
+   SDL_Surface *face, *refsur, *rlesur;
+   SDL_Rect srcrect, rect;
+   const int cuts[] = { 0, 3, 17, 32 };
+   const Uint32 rgbmask = 0x00ffffff;
+
+   SDL_ATbegin( "RLE Blit Tests" );
+
+   /* Create face surface, the pixels stay around after encoding. */
+   face = SDL_CreateRGBSurfaceFrom( (void*)img_face.pixel_data,
+         img_face.width, img_face.height, 32, img_face.width*4,
+#if (SDL_BYTEORDER == SDL_BIG_ENDIAN)
+         0xff000000, /* Red bit mask. */
+         0x00ff0000, /* Green bit mask. */
+         0x0000ff00, /* Blue bit mask. */
+         0x000000ff /* Alpha bit mask. */
+#else
+         0x000000ff, /* Red bit mask. */
+         0x0000ff00, /* Green bit mask. */
+         0x00ff0000, /* Blue bit mask. */
+         0xff000000 /* Alpha bit mask. */
+#endif
+         );
+   if (SDL_ATassert( "SDL_CreateRGBSurfaceFrom", face != NULL))
+      return;
+   if (SDL_ATassert( "Face isn't as big as the cuts",
+            face->w == cuts[3] && face->h == cuts[3] ))
+      goto err_face;
+
+   /* The colorkey is blitted to the face format, pixel alpha to xRGB. */
+   refsur = SDL_CreateRGBSurface( 0, testsur->w, testsur->h, 32,
+         face->format->Rmask, face->format->Gmask, face->format->Bmask,
+         face->format->Amask );
+   rlesur = SDL_CreateRGBSurface( 0, testsur->w, testsur->h, 32,
+         face->format->Rmask, face->format->Gmask, face->format->Bmask,
+         face->format->Amask );
+   if (SDL_ATassert( "SDL_CreateRGBSurface", refsur != NULL && rlesur != NULL))
+      goto err;
+   key = *(Uint32 *)face->pixels;
+
+   for (m=0; m<2; m++) {
+      if (m == 1) {
+         SDL_FreeSurface( refsur );
+         SDL_FreeSurface( rlesur );
+         refsur = SDL_CreateRGBSurface( 0, testsur->w, testsur->h, 32,
+               0x00ff0000, 0x0000ff00, 0x000000ff, 0 );
+         rlesur = SDL_CreateRGBSurface( 0, testsur->w, testsur->h, 32,
+               0x00ff0000, 0x0000ff00, 0x000000ff, 0 );
+         if (SDL_ATassert( "SDL_CreateRGBSurface",
+                  refsur != NULL && rlesur != NULL))
+            goto err;
+         ret = SDL_SetColorKey( face, 0, 0 );
+         if (SDL_ATassert( "SDL_SetColorKey", ret == 0))
+            goto err;
+         ret = SDL_SetSurfaceBlendMode( face, SDL_BLENDMODE_BLEND );
+         if (SDL_ATassert( "SDL_SetSurfaceBlendMode", ret == 0))
+            goto err;
+      }
+      else {
+         ret = SDL_SetColorKey( face, 1, key );
+         if (SDL_ATassert( "SDL_SetColorKey", ret == 0))
+            goto err;
+      }
+      ret = SDL_FillRect( refsur, NULL, SDL_MapRGB( refsur->format, 40, 80, 120 ) );
+      if (SDL_ATassert( "SDL_FillRect", ret == 0))
+         goto err;
+      ret = SDL_FillRect( rlesur, NULL, SDL_MapRGB( rlesur->format, 40, 80, 120 ) );
+      if (SDL_ATassert( "SDL_FillRect", ret == 0))
+         goto err;
+
+      /* Reference: whole blits, partly outside of the surface. */
+      for (k=0; k<3; k++) {
+         rect.x = -11 + 40*k;
+         rect.y = (k == 1) ? testsur->h - 13 : -7 + 20*k;
+         if (m == 0) {
+            ret = SDL_SetSurfaceRLE( face, 0 );
+            if (SDL_ATassert( "SDL_SetSurfaceRLE", ret == 0))
+               goto err;
+         }
+         else {
+            ret = SDL_PrepareSurfaceRLE( face, refsur );
+            if (SDL_ATassert( "SDL_PrepareSurfaceRLE", ret == 0 &&
+                     (face->flags & SDL_RLEACCEL)))
+               goto err;
+         }
+         ret = SDL_BlitSurface( face, NULL, refsur, &rect );
+         if (SDL_ATassert( "SDL_BlitSurface", ret == 0))
+            goto err;
+      }
+
+      /* The same blits in clipped pieces, encoded up front. */
+      ret = SDL_PrepareSurfaceRLE( face, rlesur );
+      if (SDL_ATassert( "SDL_PrepareSurfaceRLE", ret == 0 &&
+               (face->flags & SDL_RLEACCEL)))
+         goto err;
+      for (k=0; k<3; k++) {
+         for (j=0; j<3; j++) {
+            for (i=0; i<3; i++) {
+               srcrect.x = cuts[i];
+               srcrect.y = cuts[j];
+               srcrect.w = cuts[i+1] - cuts[i];
+               srcrect.h = cuts[j+1] - cuts[j];
+               rect.x = -11 + 40*k + srcrect.x;
+               rect.y = ((k == 1) ? testsur->h - 13 : -7 + 20*k) + srcrect.y;
+               ret = SDL_BlitSurface( face, &srcrect, rlesur, &rect );
+               if (SDL_ATassert( "SDL_BlitSurface", ret == 0))
+                  goto err;
+            }
+         }
+      }
+      if (SDL_ATassert( "Clipped blits dropped the RLE encoding",
+               face->flags & SDL_RLEACCEL ))
+         goto err;
+
+      for (y=0; y<refsur->h; y++) {
+         Uint32 *refpix = (Uint32 *)((Uint8 *)refsur->pixels + y*refsur->pitch);
+         Uint32 *rlepix = (Uint32 *)((Uint8 *)rlesur->pixels + y*rlesur->pitch);
+         for (x=0; x<refsur->w; x++) {
+            if (SDL_ATassert( "RLE blit output not the same.",
+                     (refpix[x] & rgbmask) == (rlepix[x] & rgbmask) ))
+               goto err;
+         }
+      }
+   }
+
+   SDL_FreeSurface( refsur );
+   SDL_FreeSurface( rlesur );
+   SDL_FreeSurface( face );
+   SDL_ATend();
+   return;
+
+err:
+   SDL_FreeSurface( refsur );
+   SDL_FreeSurface( rlesur );
+err_face:
+   SDL_FreeSurface( face );
+}
+
+
+/**
+ * @brief Compares RLE pixel alpha blits against plain ones, over random runs
+ *        of transparent, translucent and opaque pixels.
+ */
+static void surface_testBlitRLEAlpha( SDL_Surface *testsur )
+{
+   int ret;
+   int i, x, y, run, kind;
+   Uint32 seed, alpha;
+   SDL_Surface *face, *refsur, *rlesur;
+   const Uint32 rgbmask = 0x00ffffff;
+
+   (void) testsur;
+
+   SDL_ATbegin( "RLE Alpha Blit Tests" );
+
+   face = SDL_CreateRGBSurface( 0, 67, 19, 32,
+         0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000 );
+   refsur = SDL_CreateRGBSurface( 0, 67, 19, 32,
+         0x00ff0000, 0x0000ff00, 0x000000ff, 0 );
+   rlesur = SDL_CreateRGBSurface( 0, 67, 19, 32,
+         0x00ff0000, 0x0000ff00, 0x000000ff, 0 );
+   if (SDL_ATassert( "SDL_CreateRGBSurface",
+            face != NULL && refsur != NULL && rlesur != NULL))
+      goto err;
+
+   /* Runs of 1 to 16 pixels, so the translucent ones hit every tail. */
+   seed = 97531;
+   run = 0;
+   kind = 0;
+   for (y=0; y<face->h; y++) {
+      Uint32 *src = (Uint32 *)((Uint8 *)face->pixels + y*face->pitch);
+      Uint32 *ref = (Uint32 *)((Uint8 *)refsur->pixels + y*refsur->pitch);
+      Uint32 *rle = (Uint32 *)((Uint8 *)rlesur->pixels + y*rlesur->pitch);
+      for (x=0; x<face->w; x++) {
+         if (run == 0) {
+            seed = seed * 1103515245 + 12345;
+            run = ((seed >> 16) & 15) + 1;
+            kind = (seed >> 24) % 3;
+         }
+         run--;
+         seed = seed * 1103515245 + 12345;
+         if (kind == 0)
+            alpha = 0;
+         else if (kind == 1)
+            alpha = 255;
+         else
+            alpha = (seed >> 24) % 254 + 1;
+         src[x] = (alpha << 24) | ((seed >> 4) & rgbmask);
+         seed = seed * 1103515245 + 12345;
+         ref[x] = rle[x] = (seed >> 8) & rgbmask;
+      }
+   }
+
+   ret = SDL_SetSurfaceBlendMode( face, SDL_BLENDMODE_BLEND );
+   if (SDL_ATassert( "SDL_SetSurfaceBlendMode", ret == 0))
+      goto err;
+   ret = SDL_BlitSurface( face, NULL, refsur, NULL );
+   if (SDL_ATassert( "SDL_BlitSurface", ret == 0))
+      goto err;
+   ret = SDL_PrepareSurfaceRLE( face, rlesur );
+   if (SDL_ATassert( "SDL_PrepareSurfaceRLE", ret == 0 &&
+            (face->flags & SDL_RLEACCEL)))
+      goto err;
+   ret = SDL_BlitSurface( face, NULL, rlesur, NULL );
+   if (SDL_ATassert( "SDL_BlitSurface", ret == 0))
+      goto err;
+
+   for (y=0; y<refsur->h; y++) {
+      Uint32 *refpix = (Uint32 *)((Uint8 *)refsur->pixels + y*refsur->pitch);
+      Uint32 *rlepix = (Uint32 *)((Uint8 *)rlesur->pixels + y*rlesur->pitch);
+      for (i=0; i<refsur->w; i++) {
+         if (SDL_ATvassert( (refpix[i] & rgbmask) == (rlepix[i] & rgbmask),
+                  "RLE alpha blit output not the same at %d,%d", i, y ))
+            goto err;
+      }
+   }
+
+   SDL_FreeSurface( face );
+   SDL_FreeSurface( refsur );
+   SDL_FreeSurface( rlesur );
+   SDL_ATend();
+   return;
+
+err:
+   SDL_FreeSurface( face );
+   SDL_FreeSurface( refsur );
+   SDL_FreeSurface( rlesur );
+}
+
+
+/**
+ * @brief Tests that surface rows start on 64 byte boundaries, also when the
+ *        memory of freed surfaces gets used again.
+ */
+static void surface_testAlignment( SDL_Surface *testsur )
+{
+   int i, j;
+   SDL_Surface *sur[8];
+   const int depths[] = { 1, 8, 16, 24, 32 };
+
+   (void) testsur;
+
+   SDL_ATbegin( "Surface Alignment Tests" );
+
+   for (j=0; j<2; j++) {
+      for (i=0; i<(int)SDL_arraysize(sur); i++) {
+         sur[i] = SDL_CreateRGBSurface( 0, 1 + i*37, 1 + i*5,
+               depths[i % SDL_arraysize(depths)], 0, 0, 0, 0 );
+         if (SDL_ATassert( "SDL_CreateRGBSurface", sur[i] != NULL))
+            goto err;
+         if (SDL_ATassert( "Surface pixels are not aligned.",
+                  ((uintptr_t)sur[i]->pixels & 63) == 0 &&
+                  (sur[i]->pitch & 63) == 0 )) {
+            SDL_FreeSurface( sur[i] );
+            goto err;
+         }
+      }
+      for (i=0; i<(int)SDL_arraysize(sur); i++)
+         SDL_FreeSurface( sur[i] );
+   }
+
+   SDL_ATend();
+   return;
+
+err:
+   while (i-- > 0)
+      SDL_FreeSurface( sur[i] );
+}
+
+
+/**
+ * @brief Tests surfaces sharing a pixel format, and blits from one source to
+ *        several destinations with the same format.
+ */
+static void surface_testSharedFormat( SDL_Surface *testsur )
+{
+   int ret;
+   int i, x, y;
+   SDL_Surface *src, *dst[3], *pal[2];
+   SDL_Rect rect;
+
+   (void) testsur;
+
+   SDL_ATbegin( "Shared Format Tests" );
+
+   src = SDL_CreateRGBSurface( 0, 16, 16, 32,
+         0x00ff0000, 0x0000ff00, 0x000000ff, 0 );
+   dst[0] = SDL_CreateRGBSurface( 0, 16, 16, 16, 0xf800, 0x07e0, 0x001f, 0 );
+   dst[1] = SDL_CreateRGBSurface( 0, 16, 16, 16, 0xf800, 0x07e0, 0x001f, 0 );
+   dst[2] = SDL_CreateRGBSurface( 0, 16, 16, 32,
+         0x000000ff, 0x0000ff00, 0x00ff0000, 0 );
+   pal[0] = SDL_CreateRGBSurface( 0, 16, 16, 8, 0, 0, 0, 0 );
+   pal[1] = SDL_CreateRGBSurface( 0, 16, 16, 8, 0, 0, 0, 0 );
+   if (SDL_ATassert( "SDL_CreateRGBSurface", src && dst[0] && dst[1] &&
+            dst[2] && pal[0] && pal[1] ))
+      goto err;
+
+   /* Only formats without palettes are shared. */
+   if (SDL_ATassert( "Pixel formats are not shared.",
+            dst[0]->format == dst[1]->format &&
+            pal[0]->format != pal[1]->format ))
+      goto err;
+
+   for (y=0; y<src->h; y++)
+      for (x=0; x<src->w; x++)
+         ((Uint32 *)((Uint8 *)src->pixels + y*src->pitch))[x] =
+               SDL_MapRGB( src->format, x*16, y*16, 255 - x*y );
+
+   /* Go back and forth between the destinations, at other places each time. */
+   for (i=0; i<12; i++) {
+      rect.x = (i % 4) - 2;
+      rect.y = (i % 3) - 1;
+      ret = SDL_BlitSurface( src, NULL, dst[i % 3], &rect );
+      if (SDL_ATassert( "SDL_BlitSurface", ret == 0))
+         goto err;
+   }
+
+   /* The last blit to each destination covered the first ones. */
+   for (i=0; i<3; i++) {
+      int dx = ((9 + i) % 4) - 2;
+      int dy = ((9 + i) % 3) - 1;
+      for (y=SDL_max(dy, 0); y<SDL_min(16 + dy, 16); y++) {
+         for (x=SDL_max(dx, 0); x<SDL_min(16 + dx, 16); x++) {
+            Uint8 *p = (Uint8 *)dst[i]->pixels + y*dst[i]->pitch +
+                  x*dst[i]->format->BytesPerPixel;
+            Uint32 pixel = (dst[i]->format->BytesPerPixel == 2) ?
+                  *(Uint16 *)p : *(Uint32 *)p;
+            Uint8 r, g, b;
+            SDL_GetRGB( pixel, dst[i]->format, &r, &g, &b );
+            if (SDL_ATassert( "Blit output not the same.",
+                     (r >> 3) == (((x - dx)*16) >> 3) &&
+                     (g >> 3) == (((y - dy)*16) >> 3) &&
+                     (b >> 3) == ((255 - (x - dx)*(y - dy)) >> 3) ))
+               goto err;
+         }
+      }
+   }
+
+   SDL_ATend();
+
+err:
+   SDL_FreeSurface( src );
+   for (i=0; i<3; i++)
+      SDL_FreeSurface( dst[i] );
+   for (i=0; i<2; i++)
+      SDL_FreeSurface( pal[i] );
+}
+
+
+/* Bottom-up RLE8 image: runs, an absolute run, a delta skipping a row. */
+static const Uint8 bmp_rle8[] = {
+   0x03, 0x01, 0x03, 0x02, 0x00, 0x00,
+   0x00, 0x03, 0x05, 0x06, 0x07, 0x00, 0x01, 0x04, 0x00, 0x02, 0x01, 0x02,
+   0x01, 0x03, 0x00, 0x00,
+   0x02, 0x01, 0x00, 0x01
+};
+static const Uint8 img_rle8[5][6] = {
+   { 1, 1, 0, 0, 0, 0 },
+   { 0, 0, 0, 0, 0, 3 },
+   { 0, 0, 0, 0, 0, 0 },
+   { 5, 6, 7, 4, 0, 0 },
+   { 1, 1, 1, 2, 2, 2 }
+};
+
+/* Bottom-up RLE4 image: alternating colors and a padded absolute run. */
+static const Uint8 bmp_rle4[] = {
+   0x05, 0x12, 0x00, 0x00,
+   0x00, 0x05, 0x34, 0x56, 0x70, 0x00, 0x00, 0x01
+};
+static const Uint8 img_rle4[2][5] = {
+   { 3, 4, 5, 6, 7 },
+   { 1, 2, 1, 2, 1 }
+};
+
+/**
+ * @brief Writes an 8 color BMP file with the given image data to memory.
+ */
+static int surface_writeBMP( Uint8 *buf, int size, int w, int h, int bits,
+      int compression, const Uint8 *data, int len )
+{
+   int i;
+   SDL_RWops *rw;
+
+   rw = SDL_RWFromMem( buf, size );
+   if (rw == NULL)
+      return -1;
+   SDL_RWwrite( rw, "BM", 1, 2 );
+   SDL_WriteLE32( rw, 14 + 40 + 8*4 + len );
+   SDL_WriteLE16( rw, 0 );
+   SDL_WriteLE16( rw, 0 );
+   SDL_WriteLE32( rw, 14 + 40 + 8*4 );
+   SDL_WriteLE32( rw, 40 );
+   SDL_WriteLE32( rw, w );
+   SDL_WriteLE32( rw, h );
+   SDL_WriteLE16( rw, 1 );
+   SDL_WriteLE16( rw, bits );
+   SDL_WriteLE32( rw, compression );
+   SDL_WriteLE32( rw, len );
+   SDL_WriteLE32( rw, 0 );
+   SDL_WriteLE32( rw, 0 );
+   SDL_WriteLE32( rw, 8 );
+   SDL_WriteLE32( rw, 0 );
+   for (i=0; i<8; i++) {
+      SDL_WriteLE32( rw, (i*10 << 16) | (i*20 << 8) | (i*30) );
+   }
+   SDL_RWwrite( rw, data, 1, len );
+   size = SDL_RWtell( rw );
+   SDL_RWclose( rw );
+   return size;
+}
+
+/**
+ * @brief Decodes a BMP file in bands and checks them against the whole image.
+ */
+static int surface_compareBMPStream( SDL_RWops *rw, SDL_Surface *face,
+      int rows )
+{
+   int ret, y, h, total;
+   SDL_BMPStream *stream;
+   SDL_Surface *band;
+
+   stream = SDL_OpenBMPStream_RW( rw, 0, rows );
+   if (SDL_ATassert( "SDL_OpenBMPStream_RW", stream != NULL))
+      return -1;
+   band = SDL_GetBMPStreamSurface( stream, &h );
+   if (SDL_ATassert( "BMP stream has the wrong size.",
+            band != NULL && band->w == face->w && band->h == rows &&
+            h == face->h ))
+      goto err;
+
+   total = 0;
+   while ((ret = SDL_ReadBMPStream( stream, &y )) > 0) {
+      /* Bottom-up files are decoded from the bottom band up. */
+      if (SDL_ATassert( "BMP stream read the wrong rows.",
+               y + ret == face->h - total ))
+         goto err;
+      for (h=0; h<ret; h++) {
+         if (SDL_ATassert( "BMP stream output not the same.",
+                  SDL_memcmp( (Uint8 *)band->pixels + h*band->pitch,
+                     (Uint8 *)face->pixels + (y + h)*face->pitch,
+                     face->w * face->format->BytesPerPixel ) == 0 ))
+            goto err;
+      }
+      total += ret;
+   }
+   if (SDL_ATassert( "SDL_ReadBMPStream", ret == 0 && total == face->h ))
+      goto err;
+
+   SDL_CloseBMPStream( stream );
+   return 0;
+
+err:
+   SDL_CloseBMPStream( stream );
+   return -1;
+}
+
+/**
+ * @brief Tests decoding RLE compressed BMP files, and decoding BMP files a
+ *        band of rows at a time.
+ */
+static void surface_testLoadBMPStream( SDL_Surface *testsur )
+{
+   int i, x, y, len;
+   Uint8 buf[256];
+   SDL_RWops *rw;
+   SDL_Surface *face;
+
+   (void) testsur;
+
+   SDL_ATbegin( "BMP Stream Tests" );
+
+   /* RLE8 */
+   len = surface_writeBMP( buf, sizeof(buf), 6, 5, 8, 1,
+         bmp_rle8, sizeof(bmp_rle8) );
+   rw = SDL_RWFromConstMem( buf, len );
+   if (SDL_ATassert( "SDL_RWFromConstMem", rw != NULL))
+      return;
+   face = SDL_LoadBMP_RW( rw, 0 );
+   if (SDL_ATassert( "SDL_LoadBMP_RW", face != NULL &&
+            face->w == 6 && face->h == 5 && face->format->BitsPerPixel == 8 ))
+      goto err_rw;
+   for (i=0; i<8; i++) {
+      SDL_Color *c = &face->format->palette->colors[i];
+      if (SDL_ATassert( "BMP palette not the same.",
+               c->r == i*10 && c->g == i*20 && c->b == i*30 ))
+         goto err;
+   }
+   for (y=0; y<5; y++)
+      for (x=0; x<6; x++)
+         if (SDL_ATassert( "RLE8 output not the same.",
+                  ((Uint8 *)face->pixels)[y*face->pitch + x] ==
+                  img_rle8[y][x] ))
+            goto err;
+
+   /* The delta escape skips rows across bands. */
+   for (i=1; i<=5; i++) {
+      SDL_RWseek( rw, 0, RW_SEEK_SET );
+      if (surface_compareBMPStream( rw, face, i ) != 0)
+         goto err;
+   }
+   SDL_FreeSurface( face );
+   SDL_RWclose( rw );
+
+   /* RLE4 */
+   len = surface_writeBMP( buf, sizeof(buf), 5, 2, 4, 2,
+         bmp_rle4, sizeof(bmp_rle4) );
+   rw = SDL_RWFromConstMem( buf, len );
+   if (SDL_ATassert( "SDL_RWFromConstMem", rw != NULL))
+      return;
+   face = SDL_LoadBMP_RW( rw, 0 );
+   if (SDL_ATassert( "SDL_LoadBMP_RW", face != NULL &&
+            face->w == 5 && face->h == 2 ))
+      goto err_rw;
+   for (y=0; y<2; y++)
+      for (x=0; x<5; x++)
+         if (SDL_ATassert( "RLE4 output not the same.",
+                  ((Uint8 *)face->pixels)[y*face->pitch + x] ==
+                  img_rle4[y][x] ))
+            goto err;
+   SDL_FreeSurface( face );
+   SDL_RWclose( rw );
+
+   /* Uncompressed */
+   face = SDL_LoadBMP("../icon.bmp");
+   if (SDL_ATassert( "SDL_LoadBMP", face != NULL))
+      return;
+   rw = SDL_RWFromFile( "../icon.bmp", "rb" );
+   if (SDL_ATassert( "SDL_RWFromFile", rw != NULL))
+      goto err_face;
+   if (surface_compareBMPStream( rw, face, 5 ) != 0)
+      goto err;
+
+   SDL_ATend();
+
+err:
+   SDL_FreeSurface( face );
+err_rw:
+   SDL_RWclose( rw );
+   return;
+
+err_face:
+   SDL_FreeSurface( face );
+}
+
+
 /**
  * @brief Runs all the tests on the surface.
  *
@@ -564,8 +1948,19 @@ void surface_runTests( SDL_Surface *testsur )
    /* Software surface blitting. */
    surface_testPrimitives( testsur );
    surface_testPrimitivesBlend( testsur );
+   surface_testFillRects( testsur );
+   surface_testStrokeLines( testsur );
+   surface_testDrawLines( testsur );
    surface_testBlit( testsur );
    surface_testBlitBlend( testsur );
+   surface_testBlitColorKey( testsur );
+   surface_testBlitConvert( testsur );
+   surface_testBlitAlpha16( testsur );
+   surface_testBlitRLE( testsur );
+   surface_testBlitRLEAlpha( testsur );
+   surface_testAlignment( testsur );
+   surface_testSharedFormat( testsur );
+   surface_testLoadBMPStream( testsur );
 }
 
 
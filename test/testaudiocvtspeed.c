@@ -0,0 +1,145 @@
+/*
+ * Benchmarks converting between audio sample types.
+ *
+ * Each conversion runs over the same samples for a while, and the result
+ *  is reported in megabytes of source samples per second.  Every pass
+ *  includes copying the samples back in, since conversion is in place.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define BENCH_SAMPLES   (64 * 1024)
+
+static int testSeconds = 2;
+
+static const struct
+{
+    SDL_AudioFormat format;
+    const char *name;
+} formats[] = {
+    { AUDIO_S16LSB, "S16LSB" },
+    { AUDIO_S16MSB, "S16MSB" },
+    { AUDIO_S32LSB, "S32LSB" },
+    { AUDIO_S32MSB, "S32MSB" },
+    { AUDIO_F32LSB, "F32LSB" },
+    { AUDIO_F32MSB, "F32MSB" },
+};
+
+static void
+fill_buffer(Uint8 * buf, SDL_AudioFormat format)
+{
+    int i;
+
+    for (i = 0; i < BENCH_SAMPLES; ++i) {
+        if (SDL_AUDIO_ISFLOAT(format)) {
+            float val = ((i % 2000) - 1000) / 1000.0f;
+            Uint32 bits;
+            SDL_memcpy(&bits, &val, sizeof(bits));
+            if (SDL_AUDIO_ISBIGENDIAN(format)) {
+                bits = SDL_SwapBE32(bits);
+            }
+            SDL_memcpy(buf + i * 4, &bits, sizeof(bits));
+        } else if (SDL_AUDIO_BITSIZE(format) == 32) {
+            Uint32 val = (Uint32) ((i % 2000) - 1000) * 2000000;
+            if (SDL_AUDIO_ISBIGENDIAN(format)) {
+                val = SDL_SwapBE32(val);
+            }
+            SDL_memcpy(buf + i * 4, &val, sizeof(val));
+        } else {
+            Uint16 val = (Uint16) ((i % 2000) - 1000) * 30;
+            if (SDL_AUDIO_ISBIGENDIAN(format)) {
+                val = SDL_SwapBE16(val);
+            }
+            SDL_memcpy(buf + i * 2, &val, sizeof(val));
+        }
+    }
+}
+
+static int
+bench_convert(Uint8 * buf, Uint8 * data, int src, int dst)
+{
+    SDL_AudioCVT cvt;
+    SDL_AudioFormat src_fmt = formats[src].format;
+    SDL_AudioFormat dst_fmt = formats[dst].format;
+    Uint32 start, now;
+    int iterations = 0;
+    double seconds, mb;
+
+    if (SDL_BuildAudioCVT(&cvt, src_fmt, 2, 44100, dst_fmt, 2, 44100) < 0) {
+        fprintf(stderr, "SDL_BuildAudioCVT failed: %s\n", SDL_GetError());
+        return -1;
+    }
+    cvt.buf = buf;
+    cvt.len = BENCH_SAMPLES * (SDL_AUDIO_BITSIZE(src_fmt) / 8);
+
+    fill_buffer(data, src_fmt);
+
+    start = now = SDL_GetTicks();
+    while ((now - start) < testSeconds * 1000) {
+        /* Conversion is in place, so copy in fresh samples each pass */
+        SDL_memcpy(buf, data, cvt.len);
+        if (SDL_ConvertAudio(&cvt) < 0) {
+            fprintf(stderr, "SDL_ConvertAudio failed: %s\n", SDL_GetError());
+            return -1;
+        }
+        ++iterations;
+        now = SDL_GetTicks();
+    }
+
+    seconds = (now - start) / 1000.0;
+    if (seconds <= 0.0) {
+        seconds = 0.001;
+    }
+    mb = (double) iterations * cvt.len / (1024.0 * 1024.0);
+    printf("%s to %s: %.1f MB/s\n", formats[src].name, formats[dst].name,
+           mb / seconds);
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    Uint8 *buf, *data;
+    int i, j;
+    int retval = 0;
+
+    if (argc > 1) {
+        testSeconds = atoi(argv[1]);
+    }
+
+    /* Load the SDL library */
+    if (SDL_Init(0) < 0) {
+        fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return (1);
+    }
+
+    /* Room for the largest conversion, 16 to 32 bits */
+    buf = (Uint8 *) malloc(BENCH_SAMPLES * 4);
+    data = (Uint8 *) malloc(BENCH_SAMPLES * 4);
+    if (buf == NULL || data == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        free(buf);
+        free(data);
+        SDL_Quit();
+        return (1);
+    }
+
+    printf("Converting %d samples for %d seconds each, %s SSE2...\n",
+           BENCH_SAMPLES, testSeconds, SDL_HasSSE2() ? "with" : "without");
+    for (i = 0; i < SDL_arraysize(formats) && retval == 0; ++i) {
+        for (j = 0; j < SDL_arraysize(formats); ++j) {
+            if (i != j && bench_convert(buf, data, i, j) < 0) {
+                retval = 1;
+                break;
+            }
+        }
+    }
+
+    free(buf);
+    free(data);
+    SDL_Quit();
+    return (retval);
+}
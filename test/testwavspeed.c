@@ -0,0 +1,158 @@
+/*
+ * Benchmarks loading and streaming WAVE files.
+ *
+ * The file is read into memory first, so only the parsing and decoding
+ *  are timed.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+static Uint8 *file_data = NULL;
+static int file_size = 0;
+static int testSeconds = 5;
+
+static int
+read_file(const char *file)
+{
+    SDL_RWops *rw = SDL_RWFromFile(file, "rb");
+    if (rw == NULL) {
+        return -1;
+    }
+    file_size = SDL_RWseek(rw, 0, RW_SEEK_END);
+    SDL_RWseek(rw, 0, RW_SEEK_SET);
+    file_data = (Uint8 *) malloc(file_size);
+    if (file_data == NULL ||
+        SDL_RWread(rw, file_data, file_size, 1) != 1) {
+        SDL_SetError("Couldn't read %s", file);
+        SDL_RWclose(rw);
+        return -1;
+    }
+    SDL_RWclose(rw);
+    return 0;
+}
+
+static void
+report(const char *what, int iterations, Uint32 ticks, Uint32 decoded)
+{
+    double seconds = ticks / 1000.0;
+    double mb = (double) iterations * decoded / (1024.0 * 1024.0);
+    double filemb = (double) iterations * file_size / (1024.0 * 1024.0);
+
+    if (seconds <= 0.0) {
+        seconds = 0.001;
+    }
+    printf("%s: %d times in %u ms, %.1f MB/s decoded, %.1f MB/s of file\n",
+           what, iterations, (unsigned int) ticks, mb / seconds,
+           filemb / seconds);
+}
+
+static int
+bench_load(void)
+{
+    SDL_AudioSpec spec;
+    Uint8 *buf;
+    Uint32 len = 0;
+    Uint32 start, now;
+    int iterations = 0;
+
+    start = now = SDL_GetTicks();
+    while ((now - start) < testSeconds * 1000) {
+        SDL_RWops *rw = SDL_RWFromConstMem(file_data, file_size);
+        if (SDL_LoadWAV_RW(rw, 1, &spec, &buf, &len) == NULL) {
+            fprintf(stderr, "SDL_LoadWAV_RW failed: %s\n", SDL_GetError());
+            return -1;
+        }
+        SDL_FreeWAV(buf);
+        ++iterations;
+        now = SDL_GetTicks();
+    }
+    printf("%d channels, %d Hz, format 0x%.4x, %u bytes decoded\n",
+           spec.channels, spec.freq, spec.format, (unsigned int) len);
+    report("SDL_LoadWAV_RW", iterations, now - start, len);
+    return 0;
+}
+
+static int
+bench_stream(int frames)
+{
+    SDL_AudioSpec spec;
+    SDL_WAVStream *stream;
+    Uint8 *buf;
+    Uint32 len = 0;
+    Uint32 start, now;
+    int iterations = 0;
+    int count;
+
+    /* Big enough for 32-bit samples with up to 8 channels */
+    buf = (Uint8 *) malloc(frames * 4 * 8);
+    if (buf == NULL) {
+        return -1;
+    }
+
+    start = now = SDL_GetTicks();
+    while ((now - start) < testSeconds * 1000) {
+        SDL_RWops *rw = SDL_RWFromConstMem(file_data, file_size);
+        stream = SDL_OpenWAVStream_RW(rw, 1, &spec);
+        if (stream == NULL) {
+            fprintf(stderr, "SDL_OpenWAVStream_RW failed: %s\n",
+                    SDL_GetError());
+            free(buf);
+            return -1;
+        }
+        len = 0;
+        while ((count = SDL_ReadWAVStream(stream, buf, frames)) > 0) {
+            len += count * (SDL_AUDIO_BITSIZE(spec.format) / 8) *
+                spec.channels;
+        }
+        SDL_CloseWAVStream(stream);
+        if (count < 0) {
+            fprintf(stderr, "SDL_ReadWAVStream failed: %s\n",
+                    SDL_GetError());
+            free(buf);
+            return -1;
+        }
+        ++iterations;
+        now = SDL_GetTicks();
+    }
+    report("SDL_ReadWAVStream", iterations, now - start, len);
+    free(buf);
+    return 0;
+}
+
+int
+main(int argc, char **argv)
+{
+    const char *file = "sample.wav";
+    int retval = 0;
+
+    if (argc > 1) {
+        file = argv[1];
+    }
+    if (argc > 2) {
+        testSeconds = atoi(argv[2]);
+    }
+
+    /* Load the SDL library */
+    if (SDL_Init(0) < 0) {
+        fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return (1);
+    }
+    if (read_file(file) < 0) {
+        fprintf(stderr, "Couldn't load %s: %s\n", file, SDL_GetError());
+        SDL_Quit();
+        return (1);
+    }
+
+    printf("Testing %s for %d seconds each, using %d CPUs...\n",
+           file, testSeconds, SDL_GetCPUCount());
+    if (bench_load() < 0 || bench_stream(4096) < 0) {
+        retval = 1;
+    }
+
+    free(file_data);
+    SDL_Quit();
+    return (retval);
+}